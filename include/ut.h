@@ -39,6 +39,15 @@
 #define __UT_H
 
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ut_log.h>
+
+/* While --log-async or --trace is set a UT_LOG* line goes through ut-core, otherwise it calls ut-control's UT_logPrefix() as is */
+extern bool UT_log_async_hooked(void);
+extern void UT_log_async_logPrefix(const char *file, int line, const char *prefix, const char *format, ...);
+#define UT_logPrefix(file, line, prefix, ...) \
+    (UT_log_async_hooked() ? UT_log_async_logPrefix(file, line, prefix, __VA_ARGS__) : (UT_logPrefix)(file, line, prefix, __VA_ARGS__))
 
 /**!
  * @brief Status codes for the unit testing (UT) framework.
@@ -111,6 +120,59 @@ void UT_exit(void);
  */
 UT_status_t UT_run_tests();
 
+/**
+ * @brief Reads the monotonic clock, as used by the duration assertions.
+ *
+ * @returns CLOCK_MONOTONIC time in nanoseconds.
+ */
+uint64_t UT_get_monotonic_ns(void);
+
+/**
+ * @brief Gets the budget of a duration assertion, which can be overridden from the `-p` profile.
+ *
+ * @param[in] pKey - Profile key holding the budget in milliseconds, or NULL for no override.
+ * @param[in] budgetMs - Budget in milliseconds used when the key is not in the profile.
+ * @returns The budget in milliseconds.
+ */
+double UT_get_duration_budget_ms(const char *pKey, double budgetMs);
+
+/**! Handle to a lazily set up fixture. */
+typedef void (UT_fixture_t);
+
+/**! Sets up a fixture, e.g. opens a decoder.
+ * @returns The fixture, passed to the tests and the teardown, or NULL on failure.
+ */
+typedef void *(*UT_FixtureSetupFunction_t)(void);
+
+/**! Tears down a fixture.
+ * @param pHandle - what the setup function returned
+ */
+typedef void (*UT_FixtureTeardownFunction_t)(void *pHandle);
+
+/**!
+ * @brief Registers a fixture shared by the tests of a suite, or of the whole run.
+ *
+ * The fixture is set up when a test first gets it with UT_get_fixture(), so a suite whose tests
+ * are all filtered out never sets it up. It is then shared, and torn down once: a suite fixture when
+ * its suite completes, a run fixture when the run ends. A fixture that fails to set up is not tried
+ * again until its scope ends.
+ *
+ * @param[in] pSuiteTitle - Title of the suite the fixture belongs to, or NULL for the run.
+ * @param[in] pName - Name of the fixture, for the log.
+ * @param[in] pSetup - Sets up the fixture.
+ * @param[in] pTeardown - Tears down the fixture (can be NULL).
+ * @returns Handle to the fixture, or NULL on error.
+ */
+UT_fixture_t *UT_add_fixture(const char *pSuiteTitle, const char *pName, UT_FixtureSetupFunction_t pSetup, UT_FixtureTeardownFunction_t pTeardown);
+
+/**!
+ * @brief Gets a fixture, setting it up on first use in its scope.
+ *
+ * @param[in] pFixture - Handle from UT_add_fixture().
+ * @returns The fixture, or NULL if it failed to set up.
+ */
+void *UT_get_fixture(UT_fixture_t *pFixture);
+
 #ifdef UT_CUNIT
 #include <ut_cunit.h>
 
@@ -130,6 +192,12 @@ typedef void (UT_test_t);
 /**! Function pointer for a unit test case. */
 typedef void (*UT_TestFunction_t)(void);
 
+/**! Function pointer for a parameterized test case, called once per element of a profile list.
+ * @param pElementKey - profile key of the element, e.g. "hal/ports/2"
+ * @param index - index of the element in the list
+ */
+typedef void (*UT_ParamTestFunction_t)(const char *pElementKey, uint32_t index);
+
 /**! Function pointer for a unit test case cleanup routine.
  * @returns An integer status code.
  */
@@ -180,6 +248,41 @@ UT_test_suite_t *UT_add_suite_withGroupID( const char *pTitle, UT_InitialiseFunc
  */
 UT_test_t *UT_add_test( UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunction_t pFunction);
 
+/**!
+ * @brief Adds a micro-benchmark to a suite.
+ *
+ * The function is warmed up, the iterations per sample are auto-calibrated, then timed samples are taken.
+ * The min / median / p99 / mean / stddev time per call is written to the log, and in automated mode
+ * to the properties of the testcase in the results file.
+ *
+ * @param[in] pSuite - Handle to the test suite to add the benchmark to.
+ * @param[in] pTitle - Name of the benchmark.
+ * @param[in] pFunction - Function to be benchmarked, called many times.
+ * @returns Handle to the added test case, or NULL on error.
+ */
+UT_test_t *UT_add_benchmark( UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunction_t pFunction);
+
+/**!
+ * @brief Adds one test case per element of a profile list to a suite.
+ *
+ * The list is read from the `-p` profile when the tests are registered, and each element becomes
+ * a test case named "pTitle[index]" with its own result and timing. With `-j` the cases are dealt
+ * across the workers one by one, rather than running with their suite.
+ *
+ * @param[in] pSuite - Handle to the test suite to add the test cases to.
+ * @param[in] pTitle - Name of the test cases, the element index is appended.
+ * @param[in] pFunction - Function called with the key and index of each element.
+ * @param[in] pListKey - Profile key of the list, with '/' or '.' separators.
+ * @returns Number of test cases added, 0 if the list is empty or not in the profile.
+ */
+uint32_t UT_add_param_tests( UT_test_suite_t *pSuite, const char *pTitle, UT_ParamTestFunction_t pFunction, const char *pListKey );
+
+/**! Registers one test case per profile list element, see UT_add_param_tests(). */
+#define UT_ADD_PARAM_TESTS(pSuite, pTitle, pFunction, pListKey) UT_add_param_tests(pSuite, pTitle, pFunction, pListKey)
+
+/**! Registers a micro-benchmark, see UT_add_benchmark(). */
+#define UT_ADD_BENCHMARK(pSuite, pTitle, pFunction) UT_add_benchmark(pSuite, pTitle, pFunction)
+
 /**!
  * @brief Retrieves the title of a test suite.
  *
@@ -29,10 +29,25 @@
 #ifndef __UT_CUNIT_H
 #define __UT_CUNIT_H
 
+#include <stdint.h>
 #include <TestRun.h>
 #include <CUnit.h>
 #include <ut_log.h>
 
+/**
+ * @brief Records the result of a duration assertion, used by UT_ASSERT_DURATION_LESS & friends
+ *
+ * The failure record condition holds the statement, the measured duration and the budget.
+ *
+ * @param elapsedMs - measured duration in milliseconds
+ * @param budgetMs - budget in milliseconds
+ * @param pStatement - the statement that was timed
+ * @param line - line of the assertion
+ * @param pFile - file of the assertion
+ * @param bFatal - CU_TRUE to exit the test on failure
+ */
+extern void UT_assert_duration(double elapsedMs, double budgetMs, const char *pStatement, unsigned int line, const char *pFile, CU_BOOL bFatal);
+
 /**
  * @brief Cause to test to pass always & continue processing
  * 
@@ -569,6 +584,96 @@
         CU_ASSERT_FATAL(_value);                                 \
     }
 
+/**
+ * @brief Assert(make sure) the statement completes within its budget, otherwise fail
+ * 
+ * The statement is timed with CLOCK_MONOTONIC, the failure records the measured duration
+ * 
+ * @param statement - statement to time
+ * @param budget_ms - budget in milliseconds
+ */
+#define UT_ASSERT_DURATION_LESS(statement, budget_ms)                                       \
+    {                                                                                       \
+        const double _budget = UT_get_duration_budget_ms(NULL, (budget_ms));                \
+        const uint64_t _start = UT_get_monotonic_ns();                                      \
+        statement;                                                                          \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6;             \
+        if (_elapsed >= _budget)                                                            \
+        {                                                                                   \
+            UT_LOG_ASSERT(UT_ASSERT_DURATION_LESS, #statement, "duration budget exceeded"); \
+        }                                                                                   \
+        UT_assert_duration(_elapsed, _budget, #statement, __LINE__, __FILE__, CU_FALSE);    \
+    }
+
+/**
+ * @brief Assert(make sure) the statement completes within its budget, otherwise fail and exit the test
+ * 
+ * The statement is timed with CLOCK_MONOTONIC, the failure records the measured duration
+ * 
+ * @param statement - statement to time
+ * @param budget_ms - budget in milliseconds
+ */
+#define UT_ASSERT_DURATION_LESS_FATAL(statement, budget_ms)                                       \
+    {                                                                                             \
+        const double _budget = UT_get_duration_budget_ms(NULL, (budget_ms));                      \
+        const uint64_t _start = UT_get_monotonic_ns();                                            \
+        statement;                                                                                \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6;                   \
+        if (_elapsed >= _budget)                                                                  \
+        {                                                                                         \
+            UT_LOG_ASSERT(UT_ASSERT_DURATION_LESS_FATAL, #statement, "duration budget exceeded"); \
+        }                                                                                         \
+        UT_assert_duration(_elapsed, _budget, #statement, __LINE__, __FILE__, CU_TRUE);           \
+    }
+
+/**
+ * @brief Assert(make sure) the statement completes within its budget, otherwise fail
+ * 
+ * The budget is overridden by the value of key in the `-p` profile, when present
+ * 
+ * The statement is timed with CLOCK_MONOTONIC, the failure records the measured duration
+ * 
+ * @param statement - statement to time
+ * @param budget_ms - budget in milliseconds
+ * @param key - profile key holding the budget in milliseconds
+ */
+#define UT_ASSERT_DURATION_LESS_PROFILE(statement, budget_ms, key)                                  \
+    {                                                                                               \
+        const double _budget = UT_get_duration_budget_ms((key), (budget_ms));                       \
+        const uint64_t _start = UT_get_monotonic_ns();                                              \
+        statement;                                                                                  \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6;                     \
+        if (_elapsed >= _budget)                                                                    \
+        {                                                                                           \
+            UT_LOG_ASSERT(UT_ASSERT_DURATION_LESS_PROFILE, #statement, "duration budget exceeded"); \
+        }                                                                                           \
+        UT_assert_duration(_elapsed, _budget, #statement, __LINE__, __FILE__, CU_FALSE);            \
+    }
+
+/**
+ * @brief Assert(make sure) the statement completes within its budget, otherwise fail and exit the test
+ * 
+ * The budget is overridden by the value of key in the `-p` profile, when present
+ * 
+ * The statement is timed with CLOCK_MONOTONIC, the failure records the measured duration
+ * 
+ * @param statement - statement to time
+ * @param budget_ms - budget in milliseconds
+ * @param key - profile key holding the budget in milliseconds
+ */
+#define UT_ASSERT_DURATION_LESS_PROFILE_FATAL(statement, budget_ms, key)                                  \
+    {                                                                                                     \
+        const double _budget = UT_get_duration_budget_ms((key), (budget_ms));                             \
+        const uint64_t _start = UT_get_monotonic_ns();                                                    \
+        statement;                                                                                        \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6;                           \
+        if (_elapsed >= _budget)                                                                          \
+        {                                                                                                 \
+            UT_LOG_ASSERT(UT_ASSERT_DURATION_LESS_PROFILE_FATAL, #statement, "duration budget exceeded"); \
+        }                                                                                                 \
+        UT_assert_duration(_elapsed, _budget, #statement, __LINE__, __FILE__, CU_TRUE);                   \
+    }
+
 #endif  /* UT -> CUNIT - Wrapper */
 
 /** @} */
@@ -31,9 +31,12 @@
 
 #include <gtest/gtest.h>
 #include <functional>
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+#include <ut_kvp.h>
 
 /**
  * @brief Verifies that condition is true.
@@ -195,6 +198,54 @@
  */
 #define UT_IGNORE_TEST() GTEST_SKIP()
 
+/**
+ * @brief Verifies that statement completes in less than budget_ms milliseconds.
+ */
+#define UT_ASSERT_DURATION_LESS(statement, budget_ms) \
+    { \
+        const double _budget = UT_get_duration_budget_ms(nullptr, (budget_ms)); \
+        const uint64_t _start = UT_get_monotonic_ns(); \
+        statement; \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6; \
+        EXPECT_LT(_elapsed, _budget) << #statement " took " << _elapsed << "ms, budget " << _budget << "ms"; \
+    }
+
+/**
+ * @brief Fatal assertion that statement completes in less than budget_ms milliseconds.
+ */
+#define UT_ASSERT_DURATION_LESS_FATAL(statement, budget_ms) \
+    { \
+        const double _budget = UT_get_duration_budget_ms(nullptr, (budget_ms)); \
+        const uint64_t _start = UT_get_monotonic_ns(); \
+        statement; \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6; \
+        ASSERT_LT(_elapsed, _budget) << #statement " took " << _elapsed << "ms, budget " << _budget << "ms"; \
+    }
+
+/**
+ * @brief Verifies that statement completes within budget_ms, or the budget set by key in the `-p` profile.
+ */
+#define UT_ASSERT_DURATION_LESS_PROFILE(statement, budget_ms, key) \
+    { \
+        const double _budget = UT_get_duration_budget_ms((key), (budget_ms)); \
+        const uint64_t _start = UT_get_monotonic_ns(); \
+        statement; \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6; \
+        EXPECT_LT(_elapsed, _budget) << #statement " took " << _elapsed << "ms, budget " << _budget << "ms"; \
+    }
+
+/**
+ * @brief Fatal assertion that statement completes within budget_ms, or the budget set by key in the `-p` profile.
+ */
+#define UT_ASSERT_DURATION_LESS_PROFILE_FATAL(statement, budget_ms, key) \
+    { \
+        const double _budget = UT_get_duration_budget_ms((key), (budget_ms)); \
+        const uint64_t _start = UT_get_monotonic_ns(); \
+        statement; \
+        const double _elapsed = (double)(UT_get_monotonic_ns() - _start) / 1e6; \
+        ASSERT_LT(_elapsed, _budget) << #statement " took " << _elapsed << "ms, budget " << _budget << "ms"; \
+    }
+
 /**
  * @brief Macro to add a test case to a test fixture or test suite.
  *
@@ -210,6 +261,23 @@
  */
 #define UT_ADD_TEST(test_suite_name, test_name) TEST_F(test_suite_name, test_name)
 
+/**
+ * @brief An element of a profile list, the parameter of a UT_ADD_PARAM_TEST() case.
+ */
+struct UTKVPListElement
+{
+    std::string key;    /*!< Profile key of the element, e.g. "hal/ports/2" */
+    uint32_t index;     /*!< Index of the element in the list */
+};
+
+/**
+ * @brief Prints an element as its key in the test output.
+ */
+inline void PrintTo(const UTKVPListElement &element, std::ostream *os)
+{
+    *os << element.key;
+}
+
 /**
  * @class UTCore
  * @brief A test fixture class for unit tests using Google Test framework.
@@ -268,9 +336,52 @@ public:
      * @return true if the test suite was successfully added, false otherwise.
      */
     static bool UT_add_suite_withGroupID(const std::string& testSuiteName, UT_groupID_t group);
+    /**
+     * @brief Runs a micro-benchmark of a function.
+     *
+     * The function is warmed up, the iterations per sample are auto-calibrated, then timed samples are taken.
+     * The min / median / p99 / mean / stddev time per call is written to the log and recorded as test properties.
+     *
+     * @param name The name of the benchmark.
+     * @param function The function to be benchmarked, called many times.
+     */
+    static void UT_run_benchmark(const char *name, void (*function)(void));
+    /**
+     * @brief Gets the elements of a profile list.
+     *
+     * @param pListKey The profile key of the list, with '/' or '.' separators.
+     * @return One element per list entry, empty if the list is not in the profile.
+     */
+    static std::vector<UTKVPListElement> UT_get_kvp_list_elements(const char *pListKey);
+    /**
+     * @brief Gets the elements of a list in a KVP instance, such as a fixture file opened by the test.
+     *
+     * @param pInstance The instance holding the list.
+     * @param pListKey The key of the list, with '/' or '.' separators.
+     * @return One element per list entry, empty if the list is not in the instance.
+     */
+    static std::vector<UTKVPListElement> UT_get_kvp_list_elements(ut_kvp_instance_t *pInstance, const char *pListKey);
+    /**
+     * @brief Marks a group as safe, or not, to run alongside other suites in `-j` worker processes.
+     *
+     * UT_TESTS_L1, UT_TESTS_L2 and UT_TESTS_L3 are parallel safe by default. The suites of the other
+     * groups, and suites without a group, run one after the other once the workers are done.
+     *
+     * @param group The group ID.
+     * @param parallelSafe true if the suites of the group may run in parallel.
+     */
+    static void UT_set_group_parallel_safe(UT_groupID_t group, bool parallelSafe);
+    /**
+     * @brief Checks whether a test suite may run in parallel with other suites.
+     *
+     * @param testSuiteName The name of the test suite.
+     * @return true if the suite belongs to a parallel safe group.
+     */
+    static bool UT_is_suite_parallel_safe(const std::string &testSuiteName);
 
 private:
     static std::unordered_map<std::string, UT_groupID_t> suiteToGroup;
+    static std::unordered_set<UT_groupID_t> parallelSafeGroups;
 };
 
 /**
@@ -294,6 +405,62 @@ private:
 #define UT_ADD_TEST_TO_GROUP(groupName, groupID) \
     static bool groupName##_group = UTCore::UT_add_suite_withGroupID(#groupName, groupID);
 
+/**
+ * @brief Defines a micro-benchmark within a test fixture.
+ *
+ * @param test_suite_name The name of the test fixture class or the test suite.
+ * @param test_name The name of the benchmark.
+ * @param function The function to be benchmarked, `void function(void)`.
+ *
+ * Example usage:
+ * @code
+ * UT_ADD_BENCHMARK(MyTestFixture, MyBenchmark, myFunction)
+ * @endcode
+ *
+ * @see UTCore::UT_run_benchmark()
+ */
+#define UT_ADD_BENCHMARK(test_suite_name, test_name, function) \
+    TEST_F(test_suite_name, test_name) { UT_run_benchmark(#test_name, function); }
+
+/**
+ * @brief A test fixture whose cases are run once per element of a profile list.
+ *
+ * GetParam() returns the UTKVPListElement of the running case.
+ */
+class UTKVPListTest : public UTCore, public ::testing::WithParamInterface<UTKVPListElement>
+{
+};
+
+/**
+ * @brief Defines a test case run once per element of a profile list.
+ *
+ * The fixture must derive from UTKVPListTest, and the list is bound with UT_ADD_KVP_LIST_TESTS().
+ *
+ * @param test_suite_name The name of the test fixture class.
+ * @param test_name The name of the test case, each case is named test_name/index.
+ */
+#define UT_ADD_PARAM_TEST(test_suite_name, test_name) TEST_P(test_suite_name, test_name)
+
+/**
+ * @brief Expands the UT_ADD_PARAM_TEST() cases of a fixture into one test per element of a profile list.
+ *
+ * The list is read from the `-p` profile when the tests are registered, every element becomes
+ * a test with its own result and timing. A list that is not in the profile adds no tests.
+ *
+ * Example usage:
+ * @code
+ * class HalPorts : public UTKVPListTest {};
+ * UT_ADD_PARAM_TEST(HalPorts, Open) { ... UT_KVP_PROFILE_GET_UINT32((GetParam().key + "/id").c_str()) ... }
+ * UT_ADD_KVP_LIST_TESTS(HalPorts, "hal/ports");
+ * @endcode
+ *
+ * @param test_suite_name The name of the test fixture class.
+ * @param pListKey The profile key of the list.
+ */
+#define UT_ADD_KVP_LIST_TESTS(test_suite_name, pListKey) \
+    GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(test_suite_name); \
+    INSTANTIATE_TEST_SUITE_P(, test_suite_name, ::testing::ValuesIn(UTCore::UT_get_kvp_list_elements(pListKey)))
+
 #endif  /* UT -> GTEST - Wrapper */
 
 /** @} */
\ No newline at end of file
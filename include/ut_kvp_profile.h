@@ -30,14 +30,41 @@ extern "C"
 {
 #endif
 
+    /**!
+     * @brief A profile value resolved once, read with a pointer dereference
+     *
+     * Every typed field is decoded when the handle is created and never changes after that.
+     * The handle stays valid until ut_kvp_profile_close(), a profile opened later does not update it.
+     */
+    typedef struct
+    {
+        const char *pKey;           /**!< Key the handle was resolved for */
+        ut_kvp_status_t status;     /**!< UT_KVP_STATUS_SUCCESS if the key holds a scalar value */
+        const char *pString;        /**!< Value as a string, "" if not a scalar */
+        uint32_t length;            /**!< Length of pString */
+        bool boolValue;             /**!< Value as a bool, false unless it is a boolean */
+        uint8_t uint8Value;         /**!< Value as a uint8_t, 0 unless it is a number */
+        uint16_t uint16Value;       /**!< Value as a uint16_t, 0 unless it is a number */
+        uint32_t uint32Value;       /**!< Value as a uint32_t, 0 unless it is a number */
+        uint64_t uint64Value;       /**!< Value as a uint64_t, 0 unless it is a number */
+        uint32_t listCount;         /**!< Number of list entries, 0 unless it is a list */
+    } ut_kvp_profile_handle_t;
+
     /**!
      * @brief Opens a profile configuration file for processing.
      *
-     * @param[in] fileName - Path to the configuration file.
+     * Every profile opened is kept as a layer, a key in a later profile overrides the same key in an earlier one.
+     *
+     * A profile compiled by scripts/ut_kvp_compile.py is mapped read only and used without parsing
+     * when fileName is the image itself. An image \<profile\>.kvpbin older than \<profile\> is
+     * ignored with a warning and \<profile\> is parsed instead. An image layer is read through the
+     * ut_kvp_profile_get*() getters and handles only, it is not part of ut_kvp_profile_getInstance().
+     *
+     * @param[in] fileName - Path to the configuration file, or to its compiled image.
      * @returns Status of the operation:
      * @retval UT_KVP_STATUS_SUCCESS - Success.
      * @retval UT_KVP_STATUS_FILE_OPEN_ERROR - Failed to open the file.
-     * @retval UT_KVP_STATUS_INVALID_PARAM - Invalid filename provided.
+     * @retval UT_KVP_STATUS_INVALID_PARAM - Invalid filename provided, or too many profiles open.
      * @retval UT_KVP_STATUS_PARSING_ERROR - Error parsing the file.
      */
     extern ut_kvp_status_t ut_kvp_profile_open(char *fileName);
@@ -50,26 +77,91 @@ extern "C"
 
     /**
      * @brief Retrieves the current KVP instance for the active configuration profile
+     *
+     * A single parsed profile is returned as is, several are merged into one instance from their
+     * parsed data when first needed. Compiled images are not merged, use the ut_kvp_profile_get*()
+     * getters to read every layer.
+     *
+     * @returns The instance, valid until ut_kvp_profile_close(), NULL when no profile is open
      */
     extern ut_kvp_instance_t *ut_kvp_profile_getInstance(void);
 
+    /**
+     * @brief Gets the number of profile layers opened
+     */
+    extern uint32_t ut_kvp_profile_getLayerCount(void);
+
+    /**
+     * @brief Gets a profile layer
+     *
+     * @param[in] index - layer, 0 is the first profile opened and has the lowest precedence
+     * @returns The layer instance, or NULL if out of range or the layer is a compiled image
+     */
+    extern ut_kvp_instance_t *ut_kvp_profile_getLayer(uint32_t index);
+
+    /**
+     * @brief Gets the instance a key is read from
+     *
+     * @param[in] pszKey - key, with '/' or '.' separators
+     * @returns The highest precedence layer holding the key, or the merged instance if none does.
+     *          NULL when the layer is a compiled image.
+     */
+    extern ut_kvp_instance_t *ut_kvp_profile_getInstanceForKey(const char *pszKey);
+
+    /**
+     * @brief Profile field getters, resolved across the layers
+     *
+     * Each key is resolved once and indexed, a repeated lookup of the same key is a hash lookup
+     * and returns the value read the first time. Opening or closing a profile clears the index.
+     */
+    extern bool ut_kvp_profile_getBoolField(const char *pszKey);
+    extern uint8_t ut_kvp_profile_getUInt8Field(const char *pszKey);
+    extern uint16_t ut_kvp_profile_getUInt16Field(const char *pszKey);
+    extern uint32_t ut_kvp_profile_getUInt32Field(const char *pszKey);
+    extern uint64_t ut_kvp_profile_getUInt64Field(const char *pszKey);
+    extern uint32_t ut_kvp_profile_getListCount(const char *pszKey);
+    extern ut_kvp_status_t ut_kvp_profile_getStringField(const char *pszKey, char *pszReturnedString, uint32_t uStringSize);
+
+    /**
+     * @brief Gets the handle of a profile key, resolving it across the layers on first use
+     *
+     * @param[in] pszKey - key, with '/' or '.' separators
+     * @returns The handle, never NULL. A missing key gives a handle with status UT_KVP_STATUS_KEY_NOT_FOUND.
+     */
+    extern const ut_kvp_profile_handle_t *ut_kvp_profile_getHandle(const char *pszKey);
+
 #ifdef __cplusplus
 }
 #endif
 
-#define UT_KVP_PROFILE_GET_BOOL(key) ut_kvp_getBoolField(ut_kvp_profile_getInstance(), key)
-#define UT_KVP_PROFILE_GET_UINT8(key) ut_kvp_getUInt8Field(ut_kvp_profile_getInstance(), key)
-#define UT_KVP_PROFILE_GET_UINT16(key) ut_kvp_getUInt16Field(ut_kvp_profile_getInstance(), key)
-#define UT_KVP_PROFILE_GET_UINT32(key) ut_kvp_getUInt32Field(ut_kvp_profile_getInstance(), key)
-#define UT_KVP_PROFILE_GET_UINT64(key) ut_kvp_getUInt64Field(ut_kvp_profile_getInstance(), key)
-#define UT_KVP_PROFILE_GET_LIST_COUNT(key) ut_kvp_getListCount(ut_kvp_profile_getInstance(), key)
+#define UT_KVP_PROFILE_GET_BOOL(key) ut_kvp_profile_getBoolField(key)
+#define UT_KVP_PROFILE_GET_UINT8(key) ut_kvp_profile_getUInt8Field(key)
+#define UT_KVP_PROFILE_GET_UINT16(key) ut_kvp_profile_getUInt16Field(key)
+#define UT_KVP_PROFILE_GET_UINT32(key) ut_kvp_profile_getUInt32Field(key)
+#define UT_KVP_PROFILE_GET_UINT64(key) ut_kvp_profile_getUInt64Field(key)
+#define UT_KVP_PROFILE_GET_LIST_COUNT(key) ut_kvp_profile_getListCount(key)
 #define UT_KVP_PROFILE_GET_STRING(key, pszReturnedString ) \
     { \
         ut_kvp_status_t status; \
-        status = ut_kvp_getStringField(ut_kvp_profile_getInstance(), key, pszReturnedString, UT_KVP_MAX_ELEMENT_SIZE); \
+        status = ut_kvp_profile_getStringField(key, pszReturnedString, UT_KVP_MAX_ELEMENT_SIZE); \
         status = status; \
     }
 
+#define UT_KVP_PROFILE_HANDLE(key) ut_kvp_profile_getHandle(key)
+
+/**! Asserts that the value of a handle matches the expected value, see ut_kvp_profile_getHandle(). */
+#define UT_ASSERT_KVP_EQUAL_HANDLE_BOOL(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->boolValue, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_UINT8(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->uint8Value, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_UINT16(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->uint16Value, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_UINT32(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->uint32Value, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_UINT64(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->uint64Value, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_LIST_COUNT(checkValue, pHandle) UT_ASSERT_EQUAL((pHandle)->listCount, checkValue);
+#define UT_ASSERT_KVP_EQUAL_HANDLE_STRING(checkValue, pHandle) \
+    { \
+        UT_ASSERT( (pHandle)->status == UT_KVP_STATUS_SUCCESS ); \
+        UT_ASSERT_STRING_EQUAL(checkValue, (pHandle)->pString); \
+    }
+
 /**! Asserts that a boolean KVP field matches the expected value. */
 #define UT_ASSERT_KVP_EQUAL_PROFILE_BOOL(checkValue, key) UT_ASSERT_EQUAL(UT_KVP_PROFILE_GET_BOOL(key), checkValue);
 
@@ -93,7 +185,7 @@ extern "C"
     { \
         char result_kvp[UT_KVP_MAX_ELEMENT_SIZE]={0}; \
         ut_kvp_status_t status; \
-        status = ut_kvp_getStringField(ut_kvp_profile_getInstance(), key, result_kvp, UT_KVP_MAX_ELEMENT_SIZE); \
+        status = ut_kvp_profile_getStringField(key, result_kvp, UT_KVP_MAX_ELEMENT_SIZE); \
         UT_ASSERT( status == UT_KVP_STATUS_SUCCESS ); \
         if ( status == UT_KVP_STATUS_SUCCESS ) \
         { \
@@ -110,7 +202,7 @@ extern "C"
     { \
         char result_kvp[UT_KVP_MAX_ELEMENT_SIZE]={0}; \
         ut_kvp_status_t status; \
-        status = ut_kvp_getStringField(ut_kvp_profile_getInstance(), key, result_kvp, UT_KVP_MAX_ELEMENT_SIZE); \
+        status = ut_kvp_profile_getStringField(key, result_kvp, UT_KVP_MAX_ELEMENT_SIZE); \
         UT_ASSERT( status == UT_KVP_STATUS_SUCCESS ); \
         if ( status == UT_KVP_STATUS_SUCCESS ) \
         { \
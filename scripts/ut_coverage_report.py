@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+# /*
+#  * If not stated otherwise in this file or this component's LICENSE file the
+#  * following copyright and licenses apply:
+#  *
+#  * Copyright 2023 RDK Management
+#  *
+#  * Licensed under the Apache License, Version 2.0 (the "License");
+#  * you may not use this file except in compliance with the License.
+#  * You may obtain a copy of the License at
+#  *
+#  * http://www.apache.org/licenses/LICENSE-2.0
+#  *
+#  * Unless required by applicable law or agreed to in writing, software
+#  * distributed under the License is distributed on an "AS IS" BASIS,
+#  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  * See the License for the specific language governing permissions and
+#  * limitations under the License.
+#  */
+
+# Reports the per test coverage written by a COVERAGE=1 build, see src/ut_coverage.h for the layout.
+# Run it on the host that built the binary, gcov needs the .gcno files from the build tree.
+#
+# Writes, in the coverage directory:
+#   merged/      the counters of every test and of outside-tests, merged with gcov-tool
+#   tests.tsv    suite, test, lines executed and functions entered by each test
+#   impact.map   the functions each test entered, in the --impact-record format for --impact-select
+#
+# Usage: ut_coverage_report.py <coverage dir> [--gcov gcov] [--gcov-tool gcov-tool]
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SUMMARY = re.compile(r"^(Function|File) '(.*)'\nLines executed:([0-9.]+)% of ([0-9]+)", re.MULTILINE)
+
+
+class TestCoverage:
+    def __init__(self, suite, name, path):
+        self.suite = suite
+        self.name = name
+        self.path = path
+        self.lines = 0
+        self.functions = set()
+
+
+def find_gcda(root):
+    found = []
+    for directory, _, files in os.walk(root):
+        found.extend(os.path.join(directory, name) for name in files if name.endswith(".gcda"))
+    return sorted(found)
+
+
+def link_gcno(tree):
+    """Links the .gcno of the build beside each .gcda of a tree, which holds the absolute build paths."""
+    linked = []
+    for gcda in find_gcda(tree):
+        gcno = gcda[:-len(".gcda")] + ".gcno"
+        built = "/" + os.path.relpath(gcno, tree)
+        if not os.path.exists(built):
+            print(f"No [{built}] for [{gcda}], skipped", file=sys.stderr)
+            continue
+        if not os.path.lexists(gcno):
+            os.symlink(built, gcno)
+        linked.append(gcda)
+    return linked
+
+
+def run_gcov(gcov, gcda_files):
+    """Returns {function: executed lines} and {file: (executed lines, lines)} from gcov summaries."""
+    functions = {}
+    files = {}
+    if not gcda_files:
+        return functions, files
+    with tempfile.TemporaryDirectory() as scratch:
+        result = subprocess.run([gcov, "-n", "-f"] + gcda_files, cwd=scratch, capture_output=True, text=True)
+    for kind, name, percent, lines in SUMMARY.findall(result.stdout):
+        executed = round(float(percent) * int(lines) / 100.0)
+        if kind == "Function":
+            functions[name] = max(functions.get(name, 0), executed)
+        else:
+            done, total = files.get(name, (0, 0))
+            files[name] = (max(done, executed), max(total, int(lines)))
+    return functions, files
+
+
+def merge(gcov_tool, trees, output):
+    """Merges the profile trees into output, two at a time as gcov-tool takes."""
+    if os.path.exists(output):
+        shutil.rmtree(output)
+    if not trees:
+        return
+    shutil.copytree(trees[0], output, ignore=shutil.ignore_patterns("*.gcno", "test.name"))
+    for tree in trees[1:]:
+        staged = output + ".next"
+        subprocess.run([gcov_tool, "merge", "-o", staged, output, tree], check=True, capture_output=True)
+        shutil.rmtree(output)
+        os.rename(staged, output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per test coverage report")
+    parser.add_argument("directory", help="coverage directory of the run")
+    parser.add_argument("--gcov", default="gcov", help="gcov of the toolchain that built the binary")
+    parser.add_argument("--gcov-tool", default="gcov-tool", help="gcov-tool of the same toolchain")
+    args = parser.parse_args()
+
+    tests = []
+    tests_root = os.path.join(args.directory, "tests")
+    for directory, _, files in os.walk(tests_root):
+        if "test.name" in files:
+            with open(os.path.join(directory, "test.name")) as name:
+                suite, _, test = name.readline().rstrip("\n").partition("\t")
+            tests.append(TestCoverage(suite, test, directory))
+    if not tests:
+        print(f"No tests under [{tests_root}], is the binary built with COVERAGE=1?", file=sys.stderr)
+        return 1
+    tests.sort(key=lambda t: (t.suite, t.name))
+
+    for test in tests:
+        functions, files = run_gcov(args.gcov, link_gcno(test.path))
+        test.functions = {name for name, executed in functions.items() if executed > 0}
+        test.lines = sum(done for done, _ in files.values())
+
+    trees = [test.path for test in tests]
+    outside = os.path.join(args.directory, "outside-tests")
+    if find_gcda(outside):
+        trees.append(outside)
+    merged = os.path.join(args.directory, "merged")
+    merge(args.gcov_tool, trees, merged)
+    _, files = run_gcov(args.gcov, link_gcno(merged))
+
+    with open(os.path.join(args.directory, "tests.tsv"), "w") as out:
+        out.write("suite\ttest\tlines\tfunctions\n")
+        for test in tests:
+            out.write(f"{test.suite}\t{test.name}\t{test.lines}\t{len(test.functions)}\n")
+
+    # A test without a function still has a line, so --impact-select knows its suite
+    with open(os.path.join(args.directory, "impact.map"), "w") as out:
+        for test in tests:
+            for function in sorted(test.functions) or [""]:
+                out.write(f"{test.suite}\t{test.name}\t{function}\n")
+
+    print(f"{'Lines':>14}  File")
+    for name in sorted(files):
+        done, total = files[name]
+        print(f"{done:>6} / {total:<6}  {name}")
+    done = sum(d for d, _ in files.values())
+    total = sum(t for _, t in files.values())
+    print(f"{done:>6} / {total:<6}  merged, {100.0 * done / total if total else 0.0:.1f}%")
+
+    dead = [test for test in tests if test.lines == 0]
+    print(f"\n{len(tests)} tests, {len(dead)} ran no instrumented line")
+    for test in dead:
+        print(f"  {test.suite}.{test.name}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
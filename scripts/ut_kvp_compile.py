@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+# /*
+#  * If not stated otherwise in this file or this component's LICENSE file the
+#  * following copyright and licenses apply:
+#  *
+#  * Copyright 2023 RDK Management
+#  *
+#  * Licensed under the Apache License, Version 2.0 (the "License");
+#  * you may not use this file except in compliance with the License.
+#  * You may obtain a copy of the License at
+#  *
+#  * http://www.apache.org/licenses/LICENSE-2.0
+#  *
+#  * Unless required by applicable law or agreed to in writing, software
+#  * distributed under the License is distributed on an "AS IS" BASIS,
+#  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  * See the License for the specific language governing permissions and
+#  * limitations under the License.
+#  */
+
+# Compiles a YAML or JSON profile into the binary image read by ut_kvp_profile_open().
+# The layout is described in src/ut_kvp_image.h, both must change together.
+#
+# Usage: ut_kvp_compile.py profile.yaml [-o profile.yaml.kvpbin]
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+MAGIC = b"UTKVPIMG"
+VERSION = 1
+SUFFIX = ".kvpbin"
+
+HEADER = struct.Struct("<8sIIIIIIII")   # magic, version, headerSize, entryCount, bucketCount, bucketsOffset, entriesOffset, stringsOffset, stringsSize
+ENTRY = struct.Struct("<QIIIIQIBBH")    # hash, keyOffset, keyLength, valueOffset, valueLength, number, listCount, kind, flags, reserved
+
+KIND_SCALAR = 0
+KIND_MAP = 1
+KIND_LIST = 2
+
+FLAG_NUMBER = 1 << 0
+FLAG_TRUE = 1 << 1
+FLAG_BOOL = 1 << 2
+
+FNV_OFFSET_BASIS = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+
+
+def fnv1a(data):
+    value = FNV_OFFSET_BASIS
+    for byte in data:
+        value ^= byte
+        value = (value * FNV_PRIME) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def parse_number(text):
+    """Parses a value as strtoull() with base 0 would, None unless the whole value is a number."""
+    text = text.strip()
+    if not text or not text[0].isdigit():
+        return None
+    try:
+        if text.startswith(("0x", "0X")):
+            value = int(text[2:], 16)
+        elif len(text) > 1 and text.startswith("0"):
+            value = int(text[1:], 8)
+        else:
+            value = int(text, 10)
+    except ValueError:
+        return None
+    return value if value <= 0xFFFFFFFFFFFFFFFF else None
+
+
+def to_text(value):
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    if value is None:
+        return ""
+    return str(value)
+
+
+def load_profile(path):
+    with open(path, "r", encoding="utf-8") as file:
+        if path.endswith(".json"):
+            return json.load(file)
+        import yaml
+        # BaseLoader keeps every scalar as the text written, as the profile reader sees it
+        root = {}
+        for document in yaml.load_all(file, Loader=yaml.BaseLoader):
+            if isinstance(document, dict):
+                root.update(document)
+            elif document is not None:
+                root = document
+        return root
+
+
+def flatten(node, prefix, entries):
+    if isinstance(node, dict):
+        if prefix:
+            entries.append((prefix, KIND_MAP, "", len(node)))
+        for key, child in node.items():
+            flatten(child, f"{prefix}/{to_text(key)}" if prefix else to_text(key), entries)
+    elif isinstance(node, list):
+        if prefix:
+            entries.append((prefix, KIND_LIST, "", len(node)))
+        for index, child in enumerate(node):
+            flatten(child, f"{prefix}/{index}" if prefix else str(index), entries)
+    elif prefix:
+        entries.append((prefix, KIND_SCALAR, to_text(node), 0))
+
+
+def compile_image(entries):
+    strings = bytearray()
+    packed = []
+
+    def add_string(text):
+        offset = len(strings)
+        data = text.encode("utf-8")
+        strings.extend(data + b"\0")
+        return offset, len(data)
+
+    for key, kind, value, count in entries:
+        key_offset, key_length = add_string(key)
+        value_offset, value_length = add_string(value)
+        flags = 0
+        number = 0
+        if kind == KIND_SCALAR:
+            parsed = parse_number(value)
+            if parsed is not None:
+                number = parsed
+                flags |= FLAG_NUMBER
+            if value.lower() in ("true", "false"):
+                flags |= FLAG_BOOL
+                if value.lower() == "true":
+                    flags |= FLAG_TRUE
+        list_count = count if kind == KIND_LIST else 0
+        packed.append((fnv1a(key.encode("utf-8")), key_offset, key_length, value_offset, value_length,
+                       number, list_count, kind, flags))
+
+    bucket_count = 16
+    while bucket_count < len(packed) * 2:
+        bucket_count *= 2
+    buckets = [0] * bucket_count
+    for index, entry in enumerate(packed):
+        slot = entry[0] & (bucket_count - 1)
+        while buckets[slot] != 0:
+            slot = (slot + 1) & (bucket_count - 1)
+        buckets[slot] = index + 1
+
+    buckets_offset = HEADER.size
+    entries_offset = buckets_offset + 4 * bucket_count
+    entries_offset = (entries_offset + 7) & ~7
+    strings_offset = entries_offset + ENTRY.size * len(packed)
+
+    image = bytearray(HEADER.pack(MAGIC, VERSION, HEADER.size, len(packed), bucket_count,
+                                  buckets_offset, entries_offset, strings_offset, len(strings)))
+    image.extend(struct.pack(f"<{bucket_count}I", *buckets))
+    image.extend(b"\0" * (entries_offset - len(image)))
+    for entry in packed:
+        image.extend(ENTRY.pack(*entry, 0))
+    image.extend(strings)
+    return image
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a YAML or JSON profile into a binary profile image.")
+    parser.add_argument("profile", help="YAML or JSON profile")
+    parser.add_argument("-o", "--output", help=f"image file, default is the profile name with '{SUFFIX}' appended")
+    args = parser.parse_args()
+
+    output = args.output if args.output else args.profile + SUFFIX
+    try:
+        root = load_profile(args.profile)
+    except (OSError, ValueError) as error:
+        print(f"Error: cannot load '{args.profile}': {error}", file=sys.stderr)
+        return 1
+    except Exception as error:  # yaml.YAMLError, without importing yaml for JSON profiles
+        print(f"Error: cannot parse '{args.profile}': {error}", file=sys.stderr)
+        return 1
+
+    entries = []
+    flatten(root, "", entries)
+    image = compile_image(entries)
+
+    temporary = output + ".tmp"
+    with open(temporary, "wb") as file:
+        file.write(image)
+    os.replace(temporary, output)
+    print(f"{output}: {len(entries)} keys, {len(image)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+# /*
+#  * If not stated otherwise in this file or this component's LICENSE file the
+#  * following copyright and licenses apply:
+#  *
+#  * Copyright 2023 RDK Management
+#  *
+#  * Licensed under the Apache License, Version 2.0 (the "License");
+#  * you may not use this file except in compliance with the License.
+#  * You may obtain a copy of the License at
+#  *
+#  * http://www.apache.org/licenses/LICENSE-2.0
+#  *
+#  * Unless required by applicable law or agreed to in writing, software
+#  * distributed under the License is distributed on an "AS IS" BASIS,
+#  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  * See the License for the specific language governing permissions and
+#  * limitations under the License.
+#  */
+
+# Decodes the NDJSON event trace written with --trace <file>. The events are described in
+# src/ut_trace.h, both must change together.
+#
+# Usage: ut_trace_decode.py timeline run.ndjson [--logs] [--failures]
+#        ut_trace_decode.py junit run.ndjson [-o report.xml]
+
+import argparse
+import json
+import sys
+from xml.sax.saxutils import escape, quoteattr
+
+
+class Test:
+    def __init__(self, suite, name, start):
+        self.suite = suite
+        self.name = name
+        self.start = start
+        self.end = None
+        self.result = None        # None until test_end, the process stopped in the test
+        self.asserts = 0
+        self.failures = []        # failed assert events
+        self.logs = []            # log events
+
+    def duration(self):
+        return ((self.end if self.end is not None else self.start) - self.start) / 1e6
+
+
+class Suite:
+    def __init__(self, pid, name, start):
+        self.pid = pid
+        self.name = name
+        self.start = start
+        self.end = None
+        self.tests = []
+
+
+class Process:
+    def __init__(self, pid):
+        self.pid = pid
+        self.start = None
+        self.end = None
+        self.version = ""
+        self.binary = ""
+        self.suites = []
+        self.suite = None
+        self.test = None
+        self.logs = []            # log events outside of a test
+
+
+def load_events(path):
+    """Reads the events, a line cut short by a crash is skipped."""
+    events = []
+    with open(path, "r", encoding="utf-8", errors="replace") as trace:
+        for number, line in enumerate(trace, 1):
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                events.append(json.loads(line))
+            except ValueError:
+                print(f"{path}:{number}: skipped a truncated event", file=sys.stderr)
+    return events
+
+
+def rebuild(events):
+    """Groups the events by process into suites and tests, in the order they were written."""
+    processes = {}
+    order = []
+    for event in events:
+        pid = event.get("pid", 0)
+        if pid not in processes:
+            processes[pid] = Process(pid)
+            order.append(pid)
+        process = processes[pid]
+        kind = event.get("ev")
+        ts = event.get("ts", 0)
+        if process.start is None:
+            process.start = ts
+        process.end = ts
+
+        if kind == "run_start":
+            process.version = event.get("version", "")
+            process.binary = event.get("binary", "")
+        elif kind == "suite_start":
+            process.suite = Suite(pid, event.get("suite", ""), ts)
+            process.suites.append(process.suite)
+        elif kind == "suite_end":
+            if process.suite is not None:
+                process.suite.end = ts
+            process.suite = None
+        elif kind == "test_start":
+            if process.suite is None or process.suite.name != event.get("suite", ""):
+                process.suite = Suite(pid, event.get("suite", ""), ts)
+                process.suites.append(process.suite)
+            process.test = Test(process.suite.name, event.get("test", ""), ts)
+            process.suite.tests.append(process.test)
+        elif kind == "assert":
+            if process.test is not None and not event.get("ok", True):
+                process.test.failures.append(event)
+        elif kind == "test_end":
+            if process.test is not None:
+                process.test.end = ts
+                process.test.result = event.get("result", "passed")
+                process.test.asserts = event.get("asserts", 0)
+            process.test = None
+        elif kind == "log":
+            (process.test.logs if process.test is not None else process.logs).append(event)
+
+    return [processes[pid] for pid in order]
+
+
+def xml_text(text):
+    """Drops the control characters XML 1.0 cannot hold."""
+    return "".join(c for c in text if c in "\t\n\r" or ord(c) >= 0x20)
+
+
+def log_text(event):
+    return f"{event.get('prefix', '')}[{event.get('file', '').rsplit('/', 1)[-1]}:{event.get('line', 0)}] {event.get('msg', '')}"
+
+
+def timeline(processes, show_logs, failures_only, out):
+    origin = min((p.start for p in processes if p.start is not None), default=0)
+
+    def stamp(ts):
+        return f"+{(ts - origin) / 1e6:12.6f}s"
+
+    for process in processes:
+        print(f"{stamp(process.start)} [pid {process.pid}] run {process.binary} {process.version}".rstrip(), file=out)
+        for suite in process.suites:
+            print(f"{stamp(suite.start)} [pid {process.pid}]   suite '{suite.name}'", file=out)
+            for test in suite.tests:
+                result = test.result if test.result is not None else "DID NOT COMPLETE"
+                if failures_only and result in ("passed", "skipped"):
+                    continue
+                print(f"{stamp(test.start)} [pid {process.pid}]     test '{test.name}' {result}, "
+                      f"{test.asserts} asserts, {test.duration() * 1000:.3f}ms", file=out)
+                for failure in test.failures:
+                    print(f"{stamp(failure['ts'])} [pid {process.pid}]       FAILED {failure.get('file', '')}:"
+                          f"{failure.get('line', 0)} {failure.get('cond', '')}", file=out)
+                if show_logs:
+                    for event in test.logs:
+                        print(f"{stamp(event['ts'])} [pid {process.pid}]       {log_text(event)}", file=out)
+            if suite.end is not None:
+                print(f"{stamp(suite.end)} [pid {process.pid}]   end of suite '{suite.name}', "
+                      f"{(suite.end - suite.start) / 1e6:.6f}s", file=out)
+        print(f"{stamp(process.end)} [pid {process.pid}] end", file=out)
+
+
+def junit(processes, out):
+    suites = [suite for process in processes for suite in process.suites]
+    tests = sum(len(s.tests) for s in suites)
+    failures = sum(1 for s in suites for t in s.tests if t.result == "failed")
+    errors = sum(1 for s in suites for t in s.tests if t.result is None)
+    total = sum(t.duration() for s in suites for t in s.tests)
+
+    out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+    out.write(f'<testsuites tests="{tests}" failures="{failures}" errors="{errors}" time="{total:.6f}">\n')
+    for suite in suites:
+        suite_failures = sum(1 for t in suite.tests if t.result == "failed")
+        suite_errors = sum(1 for t in suite.tests if t.result is None)
+        suite_skipped = sum(1 for t in suite.tests if t.result == "skipped")
+        suite_time = sum(t.duration() for t in suite.tests)
+        out.write(f'  <testsuite name={quoteattr(xml_text(suite.name))} tests="{len(suite.tests)}" failures="{suite_failures}" '
+                  f'errors="{suite_errors}" skipped="{suite_skipped}" time="{suite_time:.6f}">\n')
+        out.write(f'    <properties><property name="pid" value="{suite.pid}"/></properties>\n')
+        for test in suite.tests:
+            out.write(f'    <testcase classname={quoteattr(xml_text(suite.name))} name={quoteattr(xml_text(test.name))} time="{test.duration():.6f}">\n')
+            if test.result is None:
+                out.write('      <error message="The test did not complete" type="Error"/>\n')
+            elif test.result == "skipped":
+                out.write('      <skipped/>\n')
+            if test.failures:
+                first = test.failures[0].get("cond", "")
+                details = "\n".join(f"{f.get('file', '')}:{f.get('line', 0)} {f.get('cond', '')}" for f in test.failures)
+                out.write(f'      <failure message={quoteattr(xml_text(first))} type="Failure">{escape(xml_text(details))}</failure>\n')
+            if test.logs:
+                text = "\n".join(log_text(event) for event in test.logs)
+                out.write(f'      <system-out>{escape(xml_text(text))}</system-out>\n')
+            out.write('    </testcase>\n')
+        out.write('  </testsuite>\n')
+    out.write('</testsuites>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rebuild timelines and JUnit reports from a ut-core --trace file.")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    view = commands.add_parser("timeline", help="print the suites and tests of every process with their timestamps")
+    view.add_argument("trace", help="NDJSON trace file")
+    view.add_argument("--logs", action="store_true", help="include the log lines of every test")
+    view.add_argument("--failures", action="store_true", help="only list the tests that failed or did not complete")
+
+    report = commands.add_parser("junit", help="write a JUnit xml report")
+    report.add_argument("trace", help="NDJSON trace file")
+    report.add_argument("-o", "--output", help="report file, default is stdout")
+
+    args = parser.parse_args()
+    processes = rebuild(load_events(args.trace))
+
+    if args.command == "timeline":
+        timeline(processes, args.logs, args.failures, sys.stdout)
+    elif args.output:
+        with open(args.output, "w", encoding="utf-8") as out:
+            junit(processes, out)
+    else:
+        junit(processes, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
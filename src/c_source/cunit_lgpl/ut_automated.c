@@ -22,6 +22,8 @@
 /*
  *  Implementation of the Automated Test Interface.
  *
+ *  17-Oct-2026   Added per test wall clock & CPU timing, per suite total time. Closed the junit testsuite elements.
+ *
  *  11-Oct-2023   Changed Wrapper functions to support common logging & overrides. (Ulrond)
  *
  *  Feb 2002      Initial implementation. (AK)
@@ -58,6 +60,8 @@
 #include <string.h>
 #include <limits.h>
 #include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 
 #include "CUnit.h"
 #include "TestDB.h"
@@ -68,9 +72,22 @@
 #include "CUnit_intl.h"
 
 #include "ut_cunit_internal.h"
+#include "ut_xml_writer.h"
+#include "ut_trace.h"
 #include <ut_log.h>
 
 #define MAX_FILENAME_LENGTH		1025
+#define MAX_TEST_PROPERTIES		32    /**< Properties a test can add to its testcase. */
+#define MAX_PROPERTY_LENGTH		64
+#define SUITE_TIME_FIELD_WIDTH	24    /**< Characters reserved for the testsuite time attribute, filled in when the suite closes. */
+
+/** Wall clock and CPU time, in seconds. */
+typedef struct
+{
+  double wall;    /**< CLOCK_MONOTONIC time. */
+  double user;    /**< User CPU time from getrusage(). */
+  double system;  /**< System CPU time from getrusage(). */
+} automated_timing_t;
 
 /*=================================================================
  *  Global / Static data definitions
@@ -79,27 +96,48 @@ static CU_pSuite f_pRunningSuite = NULL;                    /**< The running tes
 static char      f_szDefaultFileRoot[] = "UTAutomated";  /**< Default filename root for automated output files. */
 static char      f_szTestListFileName[MAX_FILENAME_LENGTH] = "";   /**< Current output file name for the test listing file. */
 static char      f_szTestResultFileName[MAX_FILENAME_LENGTH] = ""; /**< Current output file name for the test results file. */
-static FILE*     f_pTestResultFile = NULL;                  /**< FILE pointer the test results file. */
+static UT_xml_writer_t* f_pResultWriter = NULL;            /**< Buffered writer for the test results file. */
 
 static CU_BOOL f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;       /**< Flag for keeping track of when a closing xml tag is required. */
 
 static CU_BOOL   bJUnitXmlOutput = CU_FALSE;                /**< Flag for toggling the xml junit output or keeping the original. Off is the default */
 static char _gPackageName[50] = "";
 
+static automated_timing_t f_testStart;                      /**< Timing snapshot taken when the running test started. */
+static automated_timing_t f_suiteTotal;                     /**< Accumulated timing of the tests in the open testsuite. */
+static long      f_lSuiteTimeOffset = -1;                   /**< Results file offset of the open testsuite time attribute, -1 if none. */
+
+/** Properties added by the running test, written with its testcase. */
+static struct
+{
+  char szName[MAX_PROPERTY_LENGTH];
+  char szValue[MAX_PROPERTY_LENGTH];
+} f_testProperties[MAX_TEST_PROPERTIES];
+static int       f_nTestProperties = 0;                     /**< Number of entries used in f_testProperties. */
+static const char** f_ppSplicedBlocks = NULL;               /**< Previous testsuite blocks written in place of skipped suites. */
+static int       f_nSplicedBlocks = 0;                      /**< Number of entries in f_ppSplicedBlocks. */
+
 /*=================================================================
  *  Static function forward declarations
  *=================================================================*/
-static CU_ErrorCode initialize_result_file(const char* szFilename);
+static CU_ErrorCode initialize_result_file(const char* szFilename, CU_pRunSummary pRunSummary);
 static CU_ErrorCode uninitialize_result_file(void);
 
 static void automated_run_all_tests(CU_pTestRegistry pRegistry);
 
 static void automated_test_start_message_handler(const CU_pTest pTest, const CU_pSuite pSuite);
 static void automated_test_complete_message_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+static void automated_suite_start_message_handler(const CU_pSuite pSuite);
+static void automated_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
 static void automated_all_tests_complete_message_handler(const CU_pFailureRecord pFailure);
 static void automated_suite_init_failure_message_handler(const CU_pSuite pSuite);
 static void automated_suite_cleanup_failure_message_handler(const CU_pSuite pSuite);
 
+static void automated_timing_snapshot(automated_timing_t *pTiming);
+static void automated_write_testcase(const CU_pTest pTest, const CU_pSuite pSuite, const automated_timing_t *pElapsed);
+static void automated_write_timing_properties(const automated_timing_t *pElapsed);
+static void automated_close_junit_suite(void);
+
 /*=================================================================
  *  Public Interface functions
  *=================================================================*/
@@ -150,13 +188,15 @@ void UT_automated_run_tests(void)
     UT_set_results_output_filename(f_szDefaultFileRoot);
   }
 
-  if (CUE_SUCCESS != initialize_result_file(f_szTestResultFileName)) {
+  if (CUE_SUCCESS != initialize_result_file(f_szTestResultFileName, CU_get_run_summary())) {
     fprintf(stderr, "\n%s", _("ERROR - Failed to create/initialize the result file."));
   }
   else {
     /* set up the message handlers for writing xml output */
+    CU_set_suite_start_handler(automated_suite_start_message_handler);
     CU_set_test_start_handler(automated_test_start_message_handler);
     CU_set_test_complete_handler(automated_test_complete_message_handler);
+    CU_set_suite_complete_handler(automated_suite_complete_message_handler);
     CU_set_all_test_complete_handler(automated_all_tests_complete_message_handler);
     CU_set_suite_init_failure_handler(automated_suite_init_failure_message_handler);
     CU_set_suite_cleanup_failure_handler(automated_suite_cleanup_failure_message_handler);
@@ -170,6 +210,119 @@ void UT_automated_run_tests(void)
     }
   }
 }
+/*------------------------------------------------------------------------*/
+const char *UT_automated_results_filename_get(void)
+{
+  /* if a filename root hasn't been set, use the default one */
+  if (0 == strlen(f_szTestResultFileName)) {
+    UT_set_results_output_filename(f_szDefaultFileRoot);
+  }
+
+  return f_szTestResultFileName;
+}
+
+/*------------------------------------------------------------------------*/
+void UT_automated_results_filename_set(const char* szFilename)
+{
+  assert(NULL != szFilename);
+
+  strncpy(f_szTestResultFileName, szFilename, MAX_FILENAME_LENGTH - 1);
+  f_szTestResultFileName[MAX_FILENAME_LENGTH - 1] = '\0';
+}
+
+/*------------------------------------------------------------------------*/
+CU_ErrorCode UT_automated_merge_results(const char** ppFilenames, int count,
+                                        const char** ppLostSuites, const char** ppLostTests, int lostCount,
+                                        const char* szLostReason, CU_pRunSummary pRunSummary)
+{
+  char szLine[MAX_FILENAME_LENGTH];
+  FILE* pWorkerFile;
+  int i;
+  int j;
+  int k;
+
+  assert(NULL != ppFilenames);
+  assert(NULL != pRunSummary);
+  assert((0 == lostCount) || ((NULL != ppLostSuites) && (NULL != ppLostTests) && (NULL != szLostReason)));
+
+  if (CUE_SUCCESS != initialize_result_file(UT_automated_results_filename_get(), pRunSummary)) {
+    fprintf(stderr, "\n%s", _("ERROR - Failed to create/initialize the result file."));
+    return CU_get_error();
+  }
+
+  /* Copy the body of each worker file, dropping its own header & footer */
+  for (i = 0; i < count; i++) {
+    if (NULL == ppFilenames[i]) {
+      continue;
+    }
+    if (NULL == (pWorkerFile = fopen(ppFilenames[i], "r"))) {
+      UT_LOG_ERROR("Failed to open worker results [%s]", ppFilenames[i]);
+      continue;
+    }
+    while (NULL != fgets(szLine, sizeof(szLine), pWorkerFile)) {
+      if ((0 == strncmp(szLine, "<?xml", 5)) || (0 == strncmp(szLine, "<testsuites ", 12))) {
+        continue;
+      }
+      if (0 == strncmp(szLine, "  <ut-core ", 11)) {
+        break;
+      }
+      UT_xml_writer_write(f_pResultWriter, szLine, strlen(szLine));
+    }
+    fclose(pWorkerFile);
+  }
+
+  /* The tests of a worker that died have no results of their own, each is written as a failed testcase.
+   * The tests of a suite are consecutive in ppLostSuites, they share its <testsuite> */
+  for (i = 0; i < lostCount; i = j) {
+    for (j = i + 1; (j < lostCount) && (ppLostSuites[j] == ppLostSuites[i]); j++) {
+    }
+    UT_xml_writer_printf(f_pResultWriter, "  <testsuite errors=\"0\" failures=\"%d\" tests=\"%d\" name=\"", j - i, j - i);
+    UT_xml_writer_escaped(f_pResultWriter, ppLostSuites[i]);
+    UT_xml_writer_printf(f_pResultWriter, "\" time=\"0.000000\"> \n");
+    for (k = i; k < j; k++) {
+      UT_xml_writer_printf(f_pResultWriter, "        <testcase classname=\"%s.", UT_automated_package_name_get());
+      UT_xml_writer_escaped(f_pResultWriter, ppLostSuites[k]);
+      UT_xml_writer_printf(f_pResultWriter, "\" name=\"");
+      UT_xml_writer_escaped(f_pResultWriter, ppLostTests[k]);
+      UT_xml_writer_printf(f_pResultWriter, "\" time=\"0.000000\">\n"
+                                            "            <failure message=\"");
+      UT_xml_writer_escaped(f_pResultWriter, szLostReason);
+      UT_xml_writer_printf(f_pResultWriter, "\" type=\"Failure\">\n"
+                                            "                     Condition: ");
+      UT_xml_writer_escaped(f_pResultWriter, szLostReason);
+      UT_xml_writer_printf(f_pResultWriter, "\n"
+                                            "            </failure>\n"
+                                            "        </testcase>\n");
+    }
+    UT_xml_writer_printf(f_pResultWriter, "    </testsuite>\n");
+  }
+
+  return uninitialize_result_file();
+}
+
+/*------------------------------------------------------------------------*/
+void UT_automated_set_spliced_results(const char** ppBlocks, int count)
+{
+  f_ppSplicedBlocks = ppBlocks;
+  f_nSplicedBlocks = (NULL != ppBlocks) ? count : 0;
+}
+
+/*------------------------------------------------------------------------*/
+void UT_automated_add_property(const char* szName, const char* szValue)
+{
+  assert(NULL != szName);
+  assert(NULL != szValue);
+
+  /* Only the automated interface writes properties */
+  if ((NULL == f_pResultWriter) || (f_nTestProperties >= MAX_TEST_PROPERTIES)) {
+    return;
+  }
+
+  CU_translate_special_characters(szName, f_testProperties[f_nTestProperties].szName, MAX_PROPERTY_LENGTH);
+  CU_translate_special_characters(szValue, f_testProperties[f_nTestProperties].szValue, MAX_PROPERTY_LENGTH);
+  f_nTestProperties++;
+}
+
 /*------------------------------------------------------------------------*/
 CU_ErrorCode UT_list_tests_to_file()
 {
@@ -195,7 +348,7 @@ static void automated_run_all_tests(CU_pTestRegistry pRegistry)
 {
   CU_pTestRegistry pOldRegistry = NULL;
 
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   f_pRunningSuite = NULL;
 
@@ -203,7 +356,7 @@ static void automated_run_all_tests(CU_pTestRegistry pRegistry)
     pOldRegistry = CU_set_registry(pRegistry);
   }
   if (bJUnitXmlOutput == CU_FALSE) {
-    fprintf(f_pTestResultFile, "  <CUNIT_RESULT_LISTING> \n");
+    UT_xml_writer_printf(f_pResultWriter, "  <CUNIT_RESULT_LISTING> \n");
   }
   CU_run_all_tests();
   if (NULL != pRegistry) {
@@ -213,37 +366,36 @@ static void automated_run_all_tests(CU_pTestRegistry pRegistry)
 
 /*------------------------------------------------------------------------*/
 /** Initializes the test results file generated by the automated interface.
- *  A file stream is opened and header information is written.
+ *  A buffered writer is opened and header information is written.
+ *  @param szFilename  Name of the results file to create.
+ *  @param pRunSummary Run summary used for the header totals.
  */
-static CU_ErrorCode initialize_result_file(const char* szFilename)
+static CU_ErrorCode initialize_result_file(const char* szFilename, CU_pRunSummary pRunSummary)
 {
-  CU_pRunSummary pRunSummary = CU_get_run_summary();
-
   CU_set_error(CUE_SUCCESS);
 
   if ((NULL == szFilename) || (strlen(szFilename) == 0)) {
     CU_set_error(CUE_BAD_FILENAME);
   }
-  else if (NULL == (f_pTestResultFile = fopen(szFilename, "w"))) {
+  else if (NULL == (f_pResultWriter = UT_xml_writer_open(szFilename))) {
     CU_set_error(CUE_FOPEN_FAILED);
   }
   else {
-    setvbuf(f_pTestResultFile, NULL, _IONBF, 0);
-
     if (bJUnitXmlOutput == CU_TRUE) {
-      fprintf(f_pTestResultFile,
-              "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-              "<testsuites errors=\"0\" failures=\"%d\" tests=\"%d\" name=\"\"> \n",
-              pRunSummary->nTestsFailed,
-              pRunSummary->nTestsRun);
+      UT_xml_writer_printf(f_pResultWriter,
+                           "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                           "<testsuites errors=\"0\" failures=\"%d\" tests=\"%d\" name=\"\"> \n",
+                           pRunSummary->nTestsFailed,
+                           pRunSummary->nTestsRun);
     } else {
-      fprintf(f_pTestResultFile,
-              "<?xml version=\"1.0\" ?> \n"
-              "<?xml-stylesheet type=\"text/xsl\" href=\"CUnit-Run.xsl\" ?> \n"
-              "<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM \"CUnit-Run.dtd\"> \n"
-              "<CUNIT_TEST_RUN_REPORT> \n"
-              "  <CUNIT_HEADER/> \n");
+      UT_xml_writer_printf(f_pResultWriter,
+                           "<?xml version=\"1.0\" ?> \n"
+                           "<?xml-stylesheet type=\"text/xsl\" href=\"CUnit-Run.xsl\" ?> \n"
+                           "<!DOCTYPE CUNIT_TEST_RUN_REPORT SYSTEM \"CUnit-Run.dtd\"> \n"
+                           "<CUNIT_TEST_RUN_REPORT> \n"
+                           "  <CUNIT_HEADER/> \n");
     }
+    UT_xml_writer_flush(f_pResultWriter);
   }
 
   return CU_get_error();
@@ -252,71 +404,77 @@ static CU_ErrorCode initialize_result_file(const char* szFilename)
 /*------------------------------------------------------------------------*/
 /** Handler function called at start of each test.
  *  The test result file must have been opened before this
- *  function is called (i.e. f_pTestResultFile non-NULL).
+ *  function is called (i.e. f_pResultWriter non-NULL).
  *  @param pTest  The test being run (non-NULL).
  *  @param pSuite The suite containing the test (non-NULL).
  */
 static void automated_test_start_message_handler(const CU_pTest pTest, const CU_pSuite pSuite)
 {
-	char *szTempName = NULL;
-	size_t szTempName_len = 0;
+  CU_BOOL bNewSuite = CU_FALSE;
 
   CU_UNREFERENCED_PARAMETER(pTest);   /* not currently used */
 
   assert(NULL != pTest);
   assert(NULL != pSuite);
   assert(NULL != pSuite->pName);
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   /* Comparing the Addresses rather than the Group Names. */
   UT_LOG( "\n" );
   if ((NULL == f_pRunningSuite) || (f_pRunningSuite != pSuite)) 
   {
     UT_LOG( UT_LOG_ASCII_BLUE"Running Suite : "UT_LOG_ASCII_CYAN"%s"UT_LOG_ASCII_NC, pSuite->pName);
-    f_pRunningSuite = pSuite;
+    bNewSuite = CU_TRUE;
   }
   UT_LOG( UT_LOG_ASCII_GREEN"     Running Test : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
 
   /* write suite close/open tags if this is the 1st test for this szSuite */
-  if ((NULL == f_pRunningSuite) || (f_pRunningSuite != pSuite)) {
+  if (CU_TRUE == bNewSuite) {
     if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
       if (bJUnitXmlOutput == CU_TRUE) {
-        fprintf(f_pTestResultFile,
-                "    </testsuite>\n");
+        automated_close_junit_suite();
       }
       else {
-        fprintf(f_pTestResultFile,
-                "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-                "    </CUNIT_RUN_SUITE> \n");
+        UT_xml_writer_printf(f_pResultWriter,
+                             "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+                             "    </CUNIT_RUN_SUITE> \n");
       }
     }
 
-  /* translate suite name that may contain XML control characters */
-  szTempName = (char *)CU_MALLOC((szTempName_len = CU_translated_strlen(pSuite->pName) + 1));
-  CU_translate_special_characters(pSuite->pName, szTempName, szTempName_len);
-
+    /* suite name may contain XML control characters, it is escaped as it is written */
     if (bJUnitXmlOutput == CU_TRUE) {
-      fprintf(f_pTestResultFile,
-              "  <testsuite errors=\"%d\" failures=\"%d\" tests=\"%d\" name=\"%s\"> \n",
-              0 , /* Errors */
-              pSuite->uiNumberOfTestsFailed, /* Failures */
-              pSuite->uiNumberOfTests, /* Tests */
-              (NULL != szTempName) ? szTempName : ""); /* Name */
+      UT_xml_writer_printf(f_pResultWriter,
+                           "  <testsuite errors=\"%d\" failures=\"%d\" tests=\"%d\" name=\"",
+                           0 , /* Errors */
+                           pSuite->uiNumberOfTestsFailed, /* Failures */
+                           pSuite->uiNumberOfTests); /* Tests */
+      UT_xml_writer_escaped(f_pResultWriter, pSuite->pName); /* Name */
+      UT_xml_writer_printf(f_pResultWriter, "\" ");
+      /* The suite total is only known when it closes, reserve room to write it then */
+      f_lSuiteTimeOffset = UT_xml_writer_tell(f_pResultWriter);
+      UT_xml_writer_printf(f_pResultWriter, "%-*s> \n", SUITE_TIME_FIELD_WIDTH, "time=\"0.000000\"");
+      memset(&f_suiteTotal, 0, sizeof(f_suiteTotal));
     } else {
-      fprintf(f_pTestResultFile,
-              "    <CUNIT_RUN_SUITE> \n"
-              "      <CUNIT_RUN_SUITE_SUCCESS> \n"
-              "        <SUITE_NAME> %s </SUITE_NAME> \n",
-              (NULL != szTempName ? szTempName : ""));
+      UT_xml_writer_printf(f_pResultWriter,
+                           "    <CUNIT_RUN_SUITE> \n"
+                           "      <CUNIT_RUN_SUITE_SUCCESS> \n"
+                           "        <SUITE_NAME> ");
+      UT_xml_writer_escaped(f_pResultWriter, pSuite->pName);
+      UT_xml_writer_printf(f_pResultWriter, " </SUITE_NAME> \n");
     }
 
     f_bWriting_CUNIT_RUN_SUITE = CU_TRUE;
     f_pRunningSuite = pSuite;
-  }
 
-  if (NULL != szTempName) {
-    CU_FREE(szTempName);
+    /* The suite header is on disk before its first test runs */
+    UT_xml_writer_flush(f_pResultWriter);
   }
+
+  f_nTestProperties = 0;
+  UT_cunit_test_start(pTest, pSuite);
+
+  /* Last, so the handler's own output is not charged to the test */
+  automated_timing_snapshot(&f_testStart);
 }
 
 /*------------------------------------------------------------------------*/
@@ -329,11 +487,17 @@ static void automated_test_complete_message_handler(const CU_pTest pTest,
                                                     const CU_pSuite pSuite,
                                                     const CU_pFailureRecord pFailure)
 {
-  char *szTemp = NULL;
-  size_t szTemp_len = 0;
-  size_t cur_len = 0;
   CU_pFailureRecord pTempFailure = pFailure;
-  const char *pPackageName = UT_automated_package_name_get();
+  automated_timing_t elapsed;
+
+  automated_timing_snapshot(&elapsed);
+  UT_cunit_test_body_end(pTest, pSuite);
+  elapsed.wall -= f_testStart.wall;
+  elapsed.user -= f_testStart.user;
+  elapsed.system -= f_testStart.system;
+  f_suiteTotal.wall += elapsed.wall;
+  f_suiteTotal.user += elapsed.user;
+  f_suiteTotal.system += elapsed.system;
 
   CU_UNREFERENCED_PARAMETER(pSuite);  /* pSuite is not used except in assertion */
 
@@ -341,111 +505,98 @@ static void automated_test_complete_message_handler(const CU_pTest pTest,
   assert(NULL != pTest->pName);
   assert(NULL != pSuite);
   assert(NULL != pSuite->pName);
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   /* Comparing the Addresses rather than the Group Names. */
   UT_LOG( UT_LOG_ASCII_GREEN"     Test Complete : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
 
+  /* xml entities in strCondition are converted as it is written */
   if (NULL != pTempFailure) {
 
-    if(NULL != pTempFailure) {
-      if (bJUnitXmlOutput == CU_TRUE) {
-        assert((NULL != pTempFailure->pSuite) && (pTempFailure->pSuite == pSuite));
-        assert((NULL != pTempFailure->pTest) && (pTempFailure->pTest == pTest));
-
-        szTemp_len = CU_translated_strlen(pTempFailure->strCondition) + 1;
-        szTemp = (char *)CU_MALLOC( szTemp_len );
-        szTemp[0] = '\0';
-        if (NULL != pTempFailure->strCondition) {
-          CU_translate_special_characters(pTempFailure->strCondition, szTemp, szTemp_len);
-        }
-        else {
-          szTemp[0] = '\0';
-        }
-
-        fprintf(f_pTestResultFile, "        <testcase classname=\"%s.%s\" name=\"%s\" time=\"0\">\n",
-                pPackageName,
-                pSuite->pName,
-                (NULL != pTest->pName) ? pTest->pName : "");
-        fprintf(f_pTestResultFile, "            <failure message=\"%s\" type=\"Failure\">\n", szTemp);
-      } /* if */
-    }
+    if (bJUnitXmlOutput == CU_TRUE) {
+      assert((NULL != pTempFailure->pSuite) && (pTempFailure->pSuite == pSuite));
+      assert((NULL != pTempFailure->pTest) && (pTempFailure->pTest == pTest));
+
+      automated_write_testcase(pTest, pSuite, &elapsed);
+      UT_xml_writer_printf(f_pResultWriter, "            <failure message=\"");
+      UT_xml_writer_escaped(f_pResultWriter, pTempFailure->strCondition);
+      UT_xml_writer_printf(f_pResultWriter, "\" type=\"Failure\">\n");
+    } /* if */
 
     while (NULL != pTempFailure) {
 
       assert((NULL != pTempFailure->pSuite) && (pTempFailure->pSuite == pSuite));
       assert((NULL != pTempFailure->pTest) && (pTempFailure->pTest == pTest));
 
-      /* expand temporary char buffer if need more room */
-      if (NULL != pTempFailure->strCondition) {
-        cur_len = CU_translated_strlen(pTempFailure->strCondition) + 1;
-      }
-      else {
-        cur_len = 1;
-      }
-      if (cur_len > szTemp_len) {
-        szTemp_len = cur_len;
-        if (NULL != szTemp) {
-          CU_FREE(szTemp);
-        }
-        szTemp = (char *)CU_MALLOC(szTemp_len);
-      }
-
-      /* convert xml entities in strCondition (if present) */
-      if (NULL != pTempFailure->strCondition) {
-        CU_translate_special_characters(pTempFailure->strCondition, szTemp, szTemp_len);
-      }
-      else {
-        szTemp[0] = '\0';
-      }
-
       if (bJUnitXmlOutput == CU_TRUE) {
-        fprintf(f_pTestResultFile, "                     Condition: %s\n", szTemp);
-        fprintf(f_pTestResultFile, "                     File     : %s\n", (NULL != pTempFailure->strFileName) ? pTempFailure->strFileName : "");
-        fprintf(f_pTestResultFile, "                     Line     : %d\n", pTempFailure->uiLineNumber);
+        UT_xml_writer_printf(f_pResultWriter, "                     Condition: ");
+        UT_xml_writer_escaped(f_pResultWriter, pTempFailure->strCondition);
+        UT_xml_writer_printf(f_pResultWriter, "\n");
+        UT_xml_writer_printf(f_pResultWriter, "                     File     : %s\n", (NULL != pTempFailure->strFileName) ? pTempFailure->strFileName : "");
+        UT_xml_writer_printf(f_pResultWriter, "                     Line     : %d\n", pTempFailure->uiLineNumber);
       } else {
-        fprintf(f_pTestResultFile,
-              "        <CUNIT_RUN_TEST_RECORD> \n"
-              "          <CUNIT_RUN_TEST_FAILURE> \n"
-              "            <TEST_NAME> %s </TEST_NAME> \n"
-              "            <FILE_NAME> %s </FILE_NAME> \n"
-              "            <LINE_NUMBER> %u </LINE_NUMBER> \n"
-              "            <CONDITION> %s </CONDITION> \n"
-              "          </CUNIT_RUN_TEST_FAILURE> \n"
-              "        </CUNIT_RUN_TEST_RECORD> \n",
-              pTest->pName,
-              (NULL != pTempFailure->strFileName) ? pTempFailure->strFileName : "",
-              pTempFailure->uiLineNumber,
-              szTemp);
+        UT_xml_writer_printf(f_pResultWriter,
+                             "        <CUNIT_RUN_TEST_RECORD> \n"
+                             "          <CUNIT_RUN_TEST_FAILURE> \n"
+                             "            <TEST_NAME> %s </TEST_NAME> \n"
+                             "            <FILE_NAME> %s </FILE_NAME> \n"
+                             "            <LINE_NUMBER> %u </LINE_NUMBER> \n"
+                             "            <CONDITION> ",
+                             pTest->pName,
+                             (NULL != pTempFailure->strFileName) ? pTempFailure->strFileName : "",
+                             pTempFailure->uiLineNumber);
+        UT_xml_writer_escaped(f_pResultWriter, pTempFailure->strCondition);
+        UT_xml_writer_printf(f_pResultWriter,
+                             " </CONDITION> \n"
+                             "          </CUNIT_RUN_TEST_FAILURE> \n"
+                             "        </CUNIT_RUN_TEST_RECORD> \n");
       } /* if */
       pTempFailure = pTempFailure->pNext;
     } /* while */
 
     if (bJUnitXmlOutput == CU_TRUE) {
-      fprintf(f_pTestResultFile, "            </failure>\n");
-      fprintf(f_pTestResultFile, "        </testcase>\n");
+      UT_xml_writer_printf(f_pResultWriter, "            </failure>\n");
+      UT_xml_writer_printf(f_pResultWriter, "        </testcase>\n");
     } /* if */
   }
   else {
     if (bJUnitXmlOutput == CU_TRUE) {
-      fprintf(f_pTestResultFile,  "        <testcase classname=\"%s.%s\" name=\"%s\" time=\"0\"/>\n",
-              pPackageName,
-              pSuite->pName,
-              (NULL != pTest->pName) ? pTest->pName : "");
+      automated_write_testcase(pTest, pSuite, &elapsed);
+      UT_xml_writer_printf(f_pResultWriter, "        </testcase>\n");
     } else {
-      fprintf(f_pTestResultFile,
-              "        <CUNIT_RUN_TEST_RECORD> \n"
-              "          <CUNIT_RUN_TEST_SUCCESS> \n"
-              "            <TEST_NAME> %s </TEST_NAME> \n"
-              "          </CUNIT_RUN_TEST_SUCCESS> \n"
-              "        </CUNIT_RUN_TEST_RECORD> \n",
-              pTest->pName);
+      UT_xml_writer_printf(f_pResultWriter,
+                           "        <CUNIT_RUN_TEST_RECORD> \n"
+                           "          <CUNIT_RUN_TEST_SUCCESS> \n"
+                           "            <TEST_NAME> %s </TEST_NAME> \n"
+                           "          </CUNIT_RUN_TEST_SUCCESS> \n"
+                           "        </CUNIT_RUN_TEST_RECORD> \n",
+                           pTest->pName);
     }
   }
 
-  if (NULL != szTemp) {
-    CU_FREE(szTemp);
-  }
+  /* One write per test, a crash in a later test keeps everything before it */
+  UT_xml_writer_flush(f_pResultWriter);
+  UT_cunit_test_complete(pTest, pSuite, pFailure);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at the start of each suite, active or not.
+ *  @param pSuite The suite being started.
+ */
+static void automated_suite_start_message_handler(const CU_pSuite pSuite)
+{
+  UT_cunit_suite_start(pSuite);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each suite.
+ *  @param pSuite   The suite that completed.
+ *  @param pFailure Pointer to the 1st failure record for this suite.
+ */
+static void automated_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+  UT_cunit_suite_complete(pSuite);
 }
 
 /*------------------------------------------------------------------------*/
@@ -458,71 +609,76 @@ static void automated_all_tests_complete_message_handler(const CU_pFailureRecord
   CU_pRunSummary pRunSummary = CU_get_run_summary();
 
   CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+  UT_trace_suiteEnd();
 
   assert(NULL != pRegistry);
   assert(NULL != pRunSummary);
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   if ((NULL != f_pRunningSuite) && (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE)) {
     if (bJUnitXmlOutput == CU_FALSE) {
-      fprintf(f_pTestResultFile,
-              "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-              "    </CUNIT_RUN_SUITE> \n");
+      UT_xml_writer_printf(f_pResultWriter,
+                           "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+                           "    </CUNIT_RUN_SUITE> \n");
+    }
+    else {
+      automated_close_junit_suite();
     }
+    f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
   }
 
   if (bJUnitXmlOutput == CU_FALSE) {
-    fprintf(f_pTestResultFile,
-            "  </CUNIT_RESULT_LISTING>\n"
-            "  <CUNIT_RUN_SUMMARY> \n");
-
-    fprintf(f_pTestResultFile,
-            "    <CUNIT_RUN_SUMMARY_RECORD> \n"
-            "      <TYPE> %s </TYPE> \n"
-            "      <TOTAL> %u </TOTAL> \n"
-            "      <RUN> %u </RUN> \n"
-            "      <SUCCEEDED> - NA - </SUCCEEDED> \n"
-            "      <FAILED> %u </FAILED> \n"
-            "      <INACTIVE> %u </INACTIVE> \n"
-            "    </CUNIT_RUN_SUMMARY_RECORD> \n",
-            _("Suites"),
-            pRegistry->uiNumberOfSuites,
-            pRunSummary->nSuitesRun,
-            pRunSummary->nSuitesFailed,
-            pRunSummary->nSuitesInactive);
-
-    fprintf(f_pTestResultFile,
-            "    <CUNIT_RUN_SUMMARY_RECORD> \n"
-            "      <TYPE> %s </TYPE> \n"
-            "      <TOTAL> %u </TOTAL> \n"
-            "      <RUN> %u </RUN> \n"
-            "      <SUCCEEDED> %u </SUCCEEDED> \n"
-            "      <FAILED> %u </FAILED> \n"
-            "      <INACTIVE> %u </INACTIVE> \n"
-            "    </CUNIT_RUN_SUMMARY_RECORD> \n",
-            _("Test Cases"),
-            pRegistry->uiNumberOfTests,
-            pRunSummary->nTestsRun,
-            pRunSummary->nTestsRun - pRunSummary->nTestsFailed,
-            pRunSummary->nTestsFailed,
-            pRunSummary->nTestsInactive);
-
-    fprintf(f_pTestResultFile,
-            "    <CUNIT_RUN_SUMMARY_RECORD> \n"
-            "      <TYPE> %s </TYPE> \n"
-            "      <TOTAL> %u </TOTAL> \n"
-            "      <RUN> %u </RUN> \n"
-            "      <SUCCEEDED> %u </SUCCEEDED> \n"
-            "      <FAILED> %u </FAILED> \n"
-            "      <INACTIVE> %s </INACTIVE> \n"
-            "    </CUNIT_RUN_SUMMARY_RECORD> \n"
-            "  </CUNIT_RUN_SUMMARY> \n",
-            _("Assertions"),
-            pRunSummary->nAsserts,
-            pRunSummary->nAsserts,
-            pRunSummary->nAsserts - pRunSummary->nAssertsFailed,
-            pRunSummary->nAssertsFailed,
-            _("n/a"));
+    UT_xml_writer_printf(f_pResultWriter,
+                         "  </CUNIT_RESULT_LISTING>\n"
+                         "  <CUNIT_RUN_SUMMARY> \n");
+
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+                         "      <TYPE> %s </TYPE> \n"
+                         "      <TOTAL> %u </TOTAL> \n"
+                         "      <RUN> %u </RUN> \n"
+                         "      <SUCCEEDED> - NA - </SUCCEEDED> \n"
+                         "      <FAILED> %u </FAILED> \n"
+                         "      <INACTIVE> %u </INACTIVE> \n"
+                         "    </CUNIT_RUN_SUMMARY_RECORD> \n",
+                         _("Suites"),
+                         pRegistry->uiNumberOfSuites,
+                         pRunSummary->nSuitesRun,
+                         pRunSummary->nSuitesFailed,
+                         pRunSummary->nSuitesInactive);
+
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+                         "      <TYPE> %s </TYPE> \n"
+                         "      <TOTAL> %u </TOTAL> \n"
+                         "      <RUN> %u </RUN> \n"
+                         "      <SUCCEEDED> %u </SUCCEEDED> \n"
+                         "      <FAILED> %u </FAILED> \n"
+                         "      <INACTIVE> %u </INACTIVE> \n"
+                         "    </CUNIT_RUN_SUMMARY_RECORD> \n",
+                         _("Test Cases"),
+                         pRegistry->uiNumberOfTests,
+                         pRunSummary->nTestsRun,
+                         pRunSummary->nTestsRun - pRunSummary->nTestsFailed,
+                         pRunSummary->nTestsFailed,
+                         pRunSummary->nTestsInactive);
+
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <CUNIT_RUN_SUMMARY_RECORD> \n"
+                         "      <TYPE> %s </TYPE> \n"
+                         "      <TOTAL> %u </TOTAL> \n"
+                         "      <RUN> %u </RUN> \n"
+                         "      <SUCCEEDED> %u </SUCCEEDED> \n"
+                         "      <FAILED> %u </FAILED> \n"
+                         "      <INACTIVE> %s </INACTIVE> \n"
+                         "    </CUNIT_RUN_SUMMARY_RECORD> \n"
+                         "  </CUNIT_RUN_SUMMARY> \n",
+                         _("Assertions"),
+                         pRunSummary->nAsserts,
+                         pRunSummary->nAsserts,
+                         pRunSummary->nAsserts - pRunSummary->nAssertsFailed,
+                         pRunSummary->nAssertsFailed,
+                         _("n/a"));
     }
 }
 
@@ -534,31 +690,30 @@ static void automated_suite_init_failure_message_handler(const CU_pSuite pSuite)
 {
   assert(NULL != pSuite);
   assert(NULL != pSuite->pName);
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
     if (bJUnitXmlOutput == CU_TRUE) {
       f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
-      fprintf(f_pTestResultFile,
-              "    </testsuite>\n");
+      automated_close_junit_suite();
     } else {
-      fprintf(f_pTestResultFile,
-              "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-              "    </CUNIT_RUN_SUITE> \n");
+      UT_xml_writer_printf(f_pResultWriter,
+                           "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+                           "    </CUNIT_RUN_SUITE> \n");
       f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
     }
   }
 
   if (bJUnitXmlOutput == CU_FALSE) {
-    fprintf(f_pTestResultFile,
-            "    <CUNIT_RUN_SUITE> \n"
-            "      <CUNIT_RUN_SUITE_FAILURE> \n"
-            "        <SUITE_NAME> %s </SUITE_NAME> \n"
-            "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
-            "      </CUNIT_RUN_SUITE_FAILURE> \n"
-            "    </CUNIT_RUN_SUITE>  \n",
-            pSuite->pName,
-            _("Suite Initialization Failed"));
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <CUNIT_RUN_SUITE> \n"
+                         "      <CUNIT_RUN_SUITE_FAILURE> \n"
+                         "        <SUITE_NAME> %s </SUITE_NAME> \n"
+                         "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
+                         "      </CUNIT_RUN_SUITE_FAILURE> \n"
+                         "    </CUNIT_RUN_SUITE>  \n",
+                         pSuite->pName,
+                         _("Suite Initialization Failed"));
   }
 }
 
@@ -570,45 +725,125 @@ static void automated_suite_cleanup_failure_message_handler(const CU_pSuite pSui
 {
   assert(NULL != pSuite);
   assert(NULL != pSuite->pName);
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   if (CU_TRUE == f_bWriting_CUNIT_RUN_SUITE) {
     if (bJUnitXmlOutput == CU_TRUE) {
       f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
-      fprintf(f_pTestResultFile,
-              "    </testsuite>\n");
+      automated_close_junit_suite();
     } else {
-      fprintf(f_pTestResultFile,
-              "      </CUNIT_RUN_SUITE_SUCCESS> \n"
-              "    </CUNIT_RUN_SUITE> \n");
+      UT_xml_writer_printf(f_pResultWriter,
+                           "      </CUNIT_RUN_SUITE_SUCCESS> \n"
+                           "    </CUNIT_RUN_SUITE> \n");
       f_bWriting_CUNIT_RUN_SUITE = CU_FALSE;
     }
   }
 
   if (bJUnitXmlOutput == CU_TRUE) {
-    fprintf(f_pTestResultFile,
-            "    <testsuite name=\"Suite Cleanup\"> \n"
-            "        <testcase name=\"%s\" result=\"failure\"> \n"
-            "            <error> \"Cleanup of suite failed.\" </error> \n"
-            "          <variation name=\"error\"> \n"
-            "            <severity>fail</severity> \n"
-            "            <description> \"Cleanup of suite failed.\" </description> \n"
-            "            <resource> SuiteCleanup </resource> \n"
-            "          </variation> \n"
-            "       </testcase> \n"
-            "    </testsuite>\n",
-            (NULL != pSuite->pName) ? pSuite->pName : "");
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <testsuite name=\"Suite Cleanup\"> \n"
+                         "        <testcase name=\"%s\" result=\"failure\"> \n"
+                         "            <error> \"Cleanup of suite failed.\" </error> \n"
+                         "          <variation name=\"error\"> \n"
+                         "            <severity>fail</severity> \n"
+                         "            <description> \"Cleanup of suite failed.\" </description> \n"
+                         "            <resource> SuiteCleanup </resource> \n"
+                         "          </variation> \n"
+                         "       </testcase> \n"
+                         "    </testsuite>\n",
+                         (NULL != pSuite->pName) ? pSuite->pName : "");
   } else {
-    fprintf(f_pTestResultFile,
-            "    <CUNIT_RUN_SUITE> \n"
-            "      <CUNIT_RUN_SUITE_FAILURE> \n"
-            "        <SUITE_NAME> %s </SUITE_NAME> \n"
-            "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
-            "      </CUNIT_RUN_SUITE_FAILURE> \n"
-            "    </CUNIT_RUN_SUITE>  \n",
-            pSuite->pName,
-            _("Suite Cleanup Failed"));
+    UT_xml_writer_printf(f_pResultWriter,
+                         "    <CUNIT_RUN_SUITE> \n"
+                         "      <CUNIT_RUN_SUITE_FAILURE> \n"
+                         "        <SUITE_NAME> %s </SUITE_NAME> \n"
+                         "        <FAILURE_REASON> %s </FAILURE_REASON> \n"
+                         "      </CUNIT_RUN_SUITE_FAILURE> \n"
+                         "    </CUNIT_RUN_SUITE>  \n",
+                         pSuite->pName,
+                         _("Suite Cleanup Failed"));
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Takes a wall clock and process CPU time snapshot.
+ *  @param pTiming Snapshot to fill in (non-NULL).
+ */
+static void automated_timing_snapshot(automated_timing_t *pTiming)
+{
+  struct timespec now;
+  struct rusage usage;
+
+  memset(pTiming, 0, sizeof(*pTiming));
+
+  if (0 == clock_gettime(CLOCK_MONOTONIC, &now)) {
+    pTiming->wall = (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+  }
+  if (0 == getrusage(RUSAGE_SELF, &usage)) {
+    pTiming->user = (double)usage.ru_utime.tv_sec + ((double)usage.ru_utime.tv_usec / 1e6);
+    pTiming->system = (double)usage.ru_stime.tv_sec + ((double)usage.ru_stime.tv_usec / 1e6);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+/** Opens the junit testcase of a test, the suite and test names escaped, and writes its timing.
+ *  @param pTest    The test (non-NULL).
+ *  @param pSuite   The suite of the test (non-NULL).
+ *  @param pElapsed Time taken by the test (non-NULL).
+ */
+static void automated_write_testcase(const CU_pTest pTest, const CU_pSuite pSuite, const automated_timing_t *pElapsed)
+{
+  UT_xml_writer_printf(f_pResultWriter, "        <testcase classname=\"%s.", UT_automated_package_name_get());
+  UT_xml_writer_escaped(f_pResultWriter, pSuite->pName);
+  UT_xml_writer_printf(f_pResultWriter, "\" name=\"");
+  UT_xml_writer_escaped(f_pResultWriter, (NULL != pTest->pName) ? pTest->pName : "");
+  UT_xml_writer_printf(f_pResultWriter, "\" time=\"%.6f\">\n", pElapsed->wall);
+  automated_write_timing_properties(pElapsed);
+}
+
+/*------------------------------------------------------------------------*/
+/** Writes the timing of a test, and any properties it added, as testcase properties.
+ *  @param pElapsed Time taken by the test (non-NULL).
+ */
+static void automated_write_timing_properties(const automated_timing_t *pElapsed)
+{
+  int i;
+
+  UT_xml_writer_printf(f_pResultWriter,
+                       "            <properties>\n"
+                       "                <property name=\"wall_time\" value=\"%.6f\"/>\n"
+                       "                <property name=\"user_cpu_time\" value=\"%.6f\"/>\n"
+                       "                <property name=\"system_cpu_time\" value=\"%.6f\"/>\n",
+                       pElapsed->wall,
+                       pElapsed->user,
+                       pElapsed->system);
+  for (i = 0; i < f_nTestProperties; i++) {
+    UT_xml_writer_printf(f_pResultWriter,
+                         "                <property name=\"%s\" value=\"%s\"/>\n",
+                         f_testProperties[i].szName,
+                         f_testProperties[i].szValue);
   }
+  UT_xml_writer_printf(f_pResultWriter,
+                       "            </properties>\n");
+}
+
+/*------------------------------------------------------------------------*/
+/** Closes the open junit testsuite, filling in its total time.
+ */
+static void automated_close_junit_suite(void)
+{
+  char szTime[SUITE_TIME_FIELD_WIDTH + 1];
+  char szField[SUITE_TIME_FIELD_WIDTH + 1];
+
+  if (f_lSuiteTimeOffset >= 0) {
+    snprintf(szTime, sizeof(szTime), "time=\"%.6f\"", f_suiteTotal.wall);
+    snprintf(szField, sizeof(szField), "%-*s", SUITE_TIME_FIELD_WIDTH, szTime);
+    UT_xml_writer_patch(f_pResultWriter, f_lSuiteTimeOffset, szField, SUITE_TIME_FIELD_WIDTH);
+    f_lSuiteTimeOffset = -1;
+  }
+
+  UT_xml_writer_printf(f_pResultWriter, "    </testsuite>\n");
+  UT_xml_writer_sync(f_pResultWriter);
 }
 
 /*------------------------------------------------------------------------*/
@@ -619,26 +854,33 @@ static CU_ErrorCode uninitialize_result_file(void)
 {
   char* szTime;
   time_t tTime = 0;
+  int i;
 
-  assert(NULL != f_pTestResultFile);
+  assert(NULL != f_pResultWriter);
 
   CU_set_error(CUE_SUCCESS);
 
+  /* Suites skipped by the result cache keep their previous results */
+  for (i = 0; i < f_nSplicedBlocks; i++) {
+    UT_xml_writer_write(f_pResultWriter, f_ppSplicedBlocks[i], strlen(f_ppSplicedBlocks[i]));
+  }
+
   time(&tTime);
   szTime = ctime(&tTime);
   if (szTime[strlen(szTime)-1] == '\n') 
   {
     szTime[strlen(szTime)-1] = '\0';
   }
-  fprintf(f_pTestResultFile,
-          "  <ut-core %s" UT_VERSION "\" time=\"%s\">\n  </ut-core>\n",
-          _("version=\""),
-          (NULL != szTime) ? szTime : ""
-          );
+  UT_xml_writer_printf(f_pResultWriter,
+                       "  <ut-core %s" UT_VERSION "\" time=\"%s\">\n  </ut-core>\n",
+                       _("version=\""),
+                       (NULL != szTime) ? szTime : ""
+                       );
 
-  if (0 != fclose(f_pTestResultFile)) {
+  if (0 != UT_xml_writer_close(f_pResultWriter)) {
     CU_set_error(CUE_FCLOSE_FAILED);
   }
+  f_pResultWriter = NULL;
 
   return CU_get_error();
 }
@@ -52,6 +52,9 @@
 #include "Basic.h"
 #include "CUnit_intl.h"
 
+#include "ut_cunit_internal.h"
+#include "ut_trace.h"
+
 #include <ut_log.h>
 
 /*=================================================================
@@ -72,6 +75,8 @@ static CU_ErrorCode basic_run_single_test(CU_pSuite pSuite, CU_pTest pTest);
 
 static void basic_test_start_message_handler(const CU_pTest pTest, const CU_pSuite pSuite);
 static void basic_test_complete_message_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailureList);
+static void basic_suite_start_message_handler(const CU_pSuite pSuite);
+static void basic_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
 static void basic_all_tests_complete_message_handler(const CU_pFailureRecord pFailure);
 static void basic_suite_init_failure_message_handler(const CU_pSuite pSuite);
 static void basic_suite_cleanup_failure_message_handler(const CU_pSuite pSuite);
@@ -172,8 +177,10 @@ static CU_ErrorCode basic_initialize(void)
                     _("http://cunit.sourceforge.net/"));
 #endif
 
+  CU_set_suite_start_handler(basic_suite_start_message_handler);
   CU_set_test_start_handler(basic_test_start_message_handler);
   CU_set_test_complete_handler(basic_test_complete_message_handler);
+  CU_set_suite_complete_handler(basic_suite_complete_message_handler);
   CU_set_all_test_complete_handler(basic_all_tests_complete_message_handler);
   CU_set_suite_init_failure_handler(basic_suite_init_failure_message_handler);
   CU_set_suite_cleanup_failure_handler(basic_suite_cleanup_failure_message_handler);
@@ -251,6 +258,7 @@ static void basic_test_start_message_handler(const CU_pTest pTest, const CU_pSui
     f_pRunningSuite = pSuite;
   }
   UT_LOG( UT_LOG_ASCII_GREEN"     Running Test : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
+  UT_cunit_test_start(pTest, pSuite);
 }
 
 /*------------------------------------------------------------------------*/
@@ -269,6 +277,8 @@ static void basic_test_complete_message_handler(const CU_pTest pTest,
   assert(NULL != pSuite);
   assert(NULL != pTest);
 
+  UT_cunit_test_body_end(pTest, pSuite);
+
   if (NULL == pFailure) {
     if (CU_BRM_VERBOSE == f_run_mode) {
       UT_LOG( _(UT_LOG_ASCII_GREEN"passed"UT_LOG_ASCII_NC));
@@ -299,7 +309,27 @@ static void basic_test_complete_message_handler(const CU_pTest pTest,
 
   /* Comparing the Addresses rather than the Group Names. */
   UT_LOG( UT_LOG_ASCII_GREEN"     Test Complete : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
+  UT_cunit_test_complete(pTest, pSuite, pFailureList);
+}
 
+/*------------------------------------------------------------------------*/
+/** Handler function called at the start of each suite, active or not.
+ *  @param pSuite The suite being started.
+ */
+static void basic_suite_start_message_handler(const CU_pSuite pSuite)
+{
+  UT_cunit_suite_start(pSuite);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each suite.
+ *  @param pSuite   The suite that completed.
+ *  @param pFailure Pointer to the 1st failure record for this suite.
+ */
+static void basic_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+  UT_cunit_suite_complete(pSuite);
 }
 
 /*------------------------------------------------------------------------*/
@@ -309,6 +339,7 @@ static void basic_test_complete_message_handler(const CU_pTest pTest,
 static void basic_all_tests_complete_message_handler(const CU_pFailureRecord pFailure)
 {
   CU_UNREFERENCED_PARAMETER(pFailure); /* not used in basic interface */
+  UT_trace_suiteEnd();
   printf("\n\n");
   CU_print_run_results(stdout);
   printf("\n");
@@ -67,6 +67,7 @@
 #include "CUnit_intl.h"
 
 #include "ut_cunit_internal.h"
+#include "ut_trace.h"
 #include <ut_log.h>
 
 /** Console interface status flag. */
@@ -102,6 +103,8 @@ static CU_ErrorCode console_run_single_test(CU_pSuite pSuite, CU_pTest pTest);
 
 static void console_test_start_message_handler(const CU_pTest pTest, const CU_pSuite pSuite);
 static void console_test_complete_message_handler(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+static void console_suite_start_message_handler(const CU_pSuite pSuite);
+static void console_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
 static void console_all_tests_complete_message_handler(const CU_pFailureRecord pFailure);
 static void console_suite_init_failure_message_handler(const CU_pSuite pSuite);
 static void console_suite_cleanup_failure_message_handler(const CU_pSuite pSuite);
@@ -135,8 +138,10 @@ void UT_console_run_tests(void)
     f_yes_width = strlen(_("Yes"));
     f_no_width  = strlen(_("No"));
 
+    CU_set_suite_start_handler(console_suite_start_message_handler);
     CU_set_test_start_handler(console_test_start_message_handler);
     CU_set_test_complete_handler(console_test_complete_message_handler);
+    CU_set_suite_complete_handler(console_suite_complete_message_handler);
     CU_set_all_test_complete_handler(console_all_tests_complete_message_handler);
     CU_set_suite_init_failure_handler(console_suite_init_failure_message_handler);
     CU_set_suite_cleanup_failure_handler(console_suite_cleanup_failure_message_handler);
@@ -637,6 +642,7 @@ static void console_test_start_message_handler(const CU_pTest pTest, const CU_pS
     f_pRunningSuite = pSuite;
   }
   UT_LOG( UT_LOG_ASCII_GREEN"     Running Test : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
+  UT_cunit_test_start(pTest, pSuite);
 }
 
 /*------------------------------------------------------------------------*/
@@ -657,8 +663,31 @@ static void console_test_complete_message_handler(const CU_pTest pTest,
   CU_UNREFERENCED_PARAMETER(pSuite);
   CU_UNREFERENCED_PARAMETER(pFailure);
 
+  UT_cunit_test_body_end(pTest, pSuite);
+
   /* Comparing the Addresses rather than the Group Names. */
   UT_LOG( UT_LOG_ASCII_GREEN"     Test Complete : "UT_LOG_ASCII_CYAN"\'%s\'"UT_LOG_ASCII_NC, pTest->pName);
+  UT_cunit_test_complete(pTest, pSuite, pFailure);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at the start of each suite, active or not.
+ *  @param pSuite The suite being started.
+ */
+static void console_suite_start_message_handler(const CU_pSuite pSuite)
+{
+  UT_cunit_suite_start(pSuite);
+}
+
+/*------------------------------------------------------------------------*/
+/** Handler function called at completion of each suite.
+ *  @param pSuite   The suite that completed.
+ *  @param pFailure Pointer to the 1st failure record for this suite.
+ */
+static void console_suite_complete_message_handler(const CU_pSuite pSuite, const CU_pFailureRecord pFailure)
+{
+  CU_UNREFERENCED_PARAMETER(pFailure);  /* not used */
+  UT_cunit_suite_complete(pSuite);
 }
 
 /*------------------------------------------------------------------------*/
@@ -668,6 +697,7 @@ static void console_test_complete_message_handler(const CU_pTest pTest,
 static void console_all_tests_complete_message_handler(const CU_pFailureRecord pFailure)
 {
   CU_UNREFERENCED_PARAMETER(pFailure); /* not used in console interface */
+  UT_trace_suiteEnd();
     printf("\n\n");
   CU_print_run_results(stdout);
   printf("\n");
@@ -25,6 +25,10 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <assert.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 /* CUnit functions */
 #include <CUnit.h>
@@ -34,31 +38,144 @@
 #include <MyMem.h>
 
 #include <ut.h>
+#include <ut_kvp_profile.h>
 #include "ut_internal.h"
 #include "ut_cunit_internal.h"
+#include "ut_xml_writer.h"
+#include "ut_watchdog.h"
+#include "ut_isolation.h"
+#include "ut_result_cache.h"
+#include "ut_log_async.h"
+#include "ut_trace.h"
+#include "ut_stress.h"
+#include "ut_impact.h"
+#include "ut_coverage.h"
+#include "ut_perf.h"
+#include "ut_memory.h"
+#include "ut_fixture.h"
 
+#define UT_GROUP_LIST_INITIAL_CAPACITY (128)   /*!< Initial suite capacity of the group list, doubled as required */
+
+/** A registered suite, chained to the next suite of its group and of its name hash bucket */
 typedef struct
 {
     CU_pSuite pSuite;
     UT_groupID_t groupId;
+    unsigned int paramTests;    /*!< Parameterized cases of the suite, dealt to the workers one by one */
+    UT_InitialiseFunction_t pInitFunction;  /*!< Run by suiteInit() when the suite has an active test */
+    UT_CleanupFunction_t pCleanupFunction;  /*!< Run by suiteCleanup() when pInitFunction was */
+    bool bInitSkipped;                      /*!< No test of the suite was active as it started */
+    bool bSkipped;      /*!< Deactivated by the run itself, see skipSuite(), not a failure while inactive */
+    int nextInGroup;    /*!< Index of the next suite with the same group ID, -1 for none */
+    int nextInBucket;   /*!< Index of the next suite in the same name hash bucket, -1 for none */
 } UT_test_group_t;
 
+/**
+ * Registered suites in registration order, indexed by group ID and by suite name
+ *
+ * The groups and the name hash buckets share one arena allocation, which is doubled
+ * when full and released with a single free().
+ */
 typedef struct
 {
-    UT_test_group_t *groups[MAX_GROUPS];
+    UT_test_group_t *groups;        /*!< Suites in registration order */
+    int *buckets;                   /*!< Name hash buckets, one per suite of capacity, -1 for empty */
     int count;
+    int capacity;                   /*!< Always a power of 2 */
+    int groupHead[UT_TESTS_MAX];    /*!< First suite of each group ID, -1 for none */
+    int groupTail[UT_TESTS_MAX];    /*!< Last suite of each group ID, -1 for none */
 } UT_group_list_t;
 
 UT_group_list_t group_list = {.count = 0};
 
+#define UT_DURATION_CONDITION_SIZE (256)   /*!< Size of a duration assertion failure condition */
+#define UT_TIMEOUT_CONDITION_SIZE (128)    /*!< Size of a timeout failure condition */
+#define UT_PARAM_TEST_TITLE_SIZE (256)     /*!< Size of a parameterized test case name */
+#define UT_RUN_OPTIONS_SIZE (512)          /*!< Size of the run options hashed into the result cache key */
+
+/** Binds a registered test to the function its trampoline calls */
+typedef struct UT_test_binding
+{
+    CU_pTest pTest;
+    UT_TestFunction_t pFunction;
+    struct UT_test_binding *pNext;
+} UT_test_binding_t;
+
+/** Binds a parameterized test case to its function and profile list element */
+typedef struct UT_param_binding
+{
+    CU_pTest pTest;
+    UT_ParamTestFunction_t pFunction;
+    uint32_t index;
+    char *pKey;     /*!< Key of the element, stored after the binding */
+    struct UT_param_binding *pNext;
+} UT_param_binding_t;
+
+/** Tests of the worker shares that were lost, written to the results as failed */
+typedef struct
+{
+    const char **ppSuites;  /*!< Suite name of each test, shared by the tests of a suite */
+    const char **ppTests;
+    int count;
+} UT_lost_tests_t;
+
+static UT_test_binding_t *gpBindings = NULL;   /*!< Bindings of the trampoline registered tests */
+static UT_param_binding_t *gpParamBindings = NULL;  /*!< Bindings of the parameterized cases, in registration order */
+static UT_param_binding_t *gpParamTail = NULL;
+static UT_param_binding_t *gpParamCursor = NULL;    /*!< Binding found last, the next lookup starts from it */
+static UT_test_binding_t *gpTimeoutBindings = NULL;  /*!< Original functions of the timed tests, sorted by test */
+static int gTimeoutBindingCount = 0;
+
 /** Pointer to the currently running suite. */
 static int gRegisterFailed;     /*!< Global Registration failed counter */
 static TestMode_t  gTestMode;
 static groupFlag_t gGroupFlag;
+static int gParallelJobs = 1;   /*!< Number of worker processes used by UT_run_tests() */
+static int gShardIndex = 0;     /*!< Index of this shard, 0 based */
+static int gShardCount = 1;     /*!< Total number of shards, 1 disables sharding */
+static unsigned int gTestTimeout = 0;   /*!< Per test timeout in seconds, 0 disables */
+static unsigned int gSuiteTimeout = 0;  /*!< Per suite timeout in seconds, 0 disables */
+static UT_isolation_t gIsolation = UT_ISOLATION_NONE;  /*!< Process isolation of the test bodies */
+static unsigned int gTraceAssertsAtStart = 0; /*!< Run assertion count when the traced test started */
+static uint64_t gStressTestStartNs = 0;     /*!< Start of the running test, for the stress records */
+static CU_pSuite gpTimedSuite = NULL;   /*!< Suite the suite timeout is running for */
+static uint64_t gSuiteStartNs = 0;      /*!< Start of the first test of gpTimedSuite */
+static char *gpResultCacheFile = NULL;  /*!< Result cache file, NULL when the cache is not enabled */
+static char *gpResultCacheProfile = NULL;   /*!< Comma separated profile files hashed into the result cache key */
+static bool gbUseCachedResults = true;  /*!< false to run every suite, the cache is still refreshed */
+static const char **gppCachedBlocks = NULL;     /*!< Cached results of the skipped suites */
+static int gCachedBlockCount = 0;
+static bool gbFailOnInactiveLifted = false;  /*!< Fail on inactive is lifted for the skipped suite being run */
+static CU_BOOL gFailOnInactive = CU_TRUE;   /*!< Fail on inactive setting to restore once it is done */
 
 static int internalInit( void );
 static int internalClean( void );
+static int suiteInit( void );
+static int suiteCleanup( void );
 static void releaseGroups( void );
+static bool growGroups( void );
+static unsigned int hashSuiteName( const char *pTitle );
+static UT_test_group_t *findGroup( const char *pTitle );
+static UT_test_group_t *findSuiteGroup( CU_pSuite pSuite );
+static void skipSuite( UT_test_group_t *pGroup );
+static void restoreFailOnInactive( void );
+static void releaseBindings( void );
+static void benchmarkTrampoline( void );
+static void paramTrampoline( void );
+static UT_param_binding_t *findParamBinding( CU_pTest pTest );
+static void run_tests_in_process( TestMode_t mode );
+static void run_tests_parallel( TestMode_t mode );
+static void apply_impact( void );
+static void apply_shard( void );
+static void apply_timeouts( void );
+static void apply_leak_budget( void );
+static void apply_result_cache( void );
+static void describeRunOptions( char *pOptions, size_t size );
+static void release_result_cache( void );
+static void timeoutTrampoline( void );
+static void memoryTrampoline( void );
+static void apply_isolation( void );
+static void isolationTrampoline( void );
 
 /**
  * @brief Startup the system
@@ -99,6 +216,57 @@ static TestMode_t get_test_mode( void )
     return gTestMode;
 }
 
+void UT_set_parallel_jobs(int jobs)
+{
+    if ((jobs < 1) || (jobs > UT_MAX_PARALLEL_JOBS))
+    {
+        UT_LOG_ERROR("Invalid parallel job count [%d]\n", jobs);
+        return;
+    }
+    gParallelJobs = jobs;
+}
+
+void UT_set_shard(int shardIndex, int shardCount)
+{
+    gShardIndex = shardIndex;
+    gShardCount = shardCount;
+}
+
+void UT_set_shard_history(const char *pReports)
+{
+    /* CUnit shards are balanced by test count, the history is not used */
+    UT_LOG_WARNING("Shard history [%s] is not used by the CUnit runner\n", pReports);
+}
+
+void UT_set_results_fsync(bool enable)
+{
+    UT_xml_writer_set_fsync(enable);
+}
+
+void UT_set_result_cache(const char *pCacheFile, const char *pProfileFiles, bool bUseCached)
+{
+    free( gpResultCacheFile );
+    free( gpResultCacheProfile );
+    gpResultCacheFile = (pCacheFile != NULL) ? strdup( pCacheFile ) : NULL;
+    gpResultCacheProfile = (pProfileFiles != NULL) ? strdup( pProfileFiles ) : NULL;
+    gbUseCachedResults = bUseCached;
+}
+
+void UT_set_test_timeout(unsigned int seconds)
+{
+    gTestTimeout = seconds;
+}
+
+void UT_set_suite_timeout(unsigned int seconds)
+{
+    gSuiteTimeout = seconds;
+}
+
+void UT_set_isolation(UT_isolation_t isolation)
+{
+    gIsolation = isolation;
+}
+
 void UT_Manage_Suite_Activation(int groupID, bool enable_disable)
 {
     if(gGroupFlag.group_flag_count > MAX_OPTIONS)
@@ -123,6 +291,7 @@ void UT_Manage_Suite_Activation(int groupID, bool enable_disable)
 UT_status_t UT_run_tests( void )
 {
     CU_ErrorCode error;
+    bool bInProcess;
     
     /* If any registration failed then stop here */
     if ( gRegisterFailed != 0 )
@@ -144,32 +313,90 @@ UT_status_t UT_run_tests( void )
         }
     }
 
-    UT_LOG( UT_LOG_ASCII_GREEN"---- start of test run ----"UT_LOG_ASCII_NC );
-    switch( get_test_mode() )
+    if ( UT_impact_selecting() )
     {
-        case UT_MODE_BASIC:
+        apply_impact();
+    }
+
+    if ( gShardCount > 1 )
+    {
+        apply_shard();
+    }
+
+    if ( gpResultCacheFile != NULL )
+    {
+        apply_result_cache();
+    }
+
+    bInProcess = UT_impact_recording() || UT_coverage_enabled() || UT_perf_enabled() || UT_memory_enabled();
+    if ( (gIsolation != UT_ISOLATION_NONE) && bInProcess )
+    {
+        UT_LOG_WARNING("--isolate is ignored, the test bodies run in process for%s%s%s%s",
+                       UT_impact_recording() ? " --impact-record" : "", UT_coverage_enabled() ? " --coverage-dir" : "",
+                       UT_perf_enabled() ? " --perf" : "", UT_memory_enabled() ? " --memory" : "");
+        gIsolation = UT_ISOLATION_NONE;
+    }
+
+    /* With --isolate a hung body is killed with its worker, the run carries on with the next test */
+    if ( gIsolation != UT_ISOLATION_NONE )
+    {
+        apply_isolation();
+        if ( (gTestTimeout > 0) || (gSuiteTimeout > 0) )
         {
-            /* Run all tests using the Basic interface */
-            UT_basic_run_tests();
+            UT_LOG( "Timeouts: test [%u]s suite [%u]s (0 is none)", gTestTimeout, gSuiteTimeout );
         }
-        break;
+    }
+    else if ( (gTestTimeout > 0) || (gSuiteTimeout > 0) )
+    {
+        UT_LOG_WARNING("The test bodies run in process, a test that overruns its timeout fails once it returns and a hung test stalls the run%s",
+                       bInProcess ? "" : ", use --isolate to kill a hung test and carry on");
+        apply_timeouts();
+    }
+    else if ( UT_memory_budget_set() )
+    {
+        apply_leak_budget();
+    }
 
-        case UT_MODE_CONSOLE:
+    UT_LOG( UT_LOG_ASCII_GREEN"---- start of test run ----"UT_LOG_ASCII_NC );
+    if ( (gParallelJobs > 1) && (get_test_mode() == UT_MODE_CONSOLE) )
+    {
+        UT_LOG_WARNING("Parallel jobs are not supported in Console Mode, running serially");
+    }
+    if ( UT_stress_enabled() && (get_test_mode() == UT_MODE_CONSOLE) )
+    {
+        UT_LOG_WARNING("Stress runs are not supported in Console Mode, running once");
+        UT_stress_configure( 0, 0, false );
+    }
+
+    /* Each stress iteration is a whole run, the results file is left with the last one */
+    UT_stress_begin();
+    do
+    {
+        if ( (gParallelJobs > 1) && (get_test_mode() != UT_MODE_CONSOLE) )
         {
-            UT_console_run_tests();
+            run_tests_parallel( get_test_mode() );
         }
-        break;
-
-        case UT_MODE_AUTOMATED:
+        else
         {
-            UT_automated_enable_junit_xml( CU_TRUE );
-            UT_automated_run_tests();
+            run_tests_in_process( get_test_mode() );
         }
-        break;
+    } while ( UT_stress_next() );
+    UT_stress_end();
+    UT_perf_summary();
+    UT_memory_summary();
+    UT_fixture_run_end();
+
+    UT_isolation_stop();
+
+    if ( (gpResultCacheFile != NULL) && (get_test_mode() == UT_MODE_AUTOMATED) )
+    {
+        UT_result_cache_store( UT_automated_results_filename_get() );
     }
 
     CU_cleanup_registry();
     releaseGroups();
+    releaseBindings();
+    release_result_cache();
     error = CU_get_error();
 
     /* #BUG: There's a bug here to be investigated, the suites are not counting as failed when tests fail.*/
@@ -214,29 +441,53 @@ UT_test_suite_t *UT_add_suite_withGroupID( const char *pTitle, UT_InitialiseFunc
         return NULL;
     }
 
-    if (group_list.count >= MAX_GROUPS)
+    /* CUnit accepts a repeated name, lookups by name find the first suite registered with it */
+    if ( findGroup( pTitle ) != NULL )
+    {
+        UT_LOG_WARNING("Suite [%s] is already registered\n", pTitle);
+    }
+
+    if ( (group_list.count >= group_list.capacity) && (growGroups() == false) )
     {
         gRegisterFailed++;
         return NULL;
     }
 
-    pSuite = CU_add_suite(pTitle, (CU_InitializeFunc)pInitFunction, (CU_CleanupFunc)pCleanupFunction);
+    pSuite = CU_add_suite(pTitle, (CU_InitializeFunc)&suiteInit, (CU_CleanupFunc)&suiteCleanup);
 
     if ( pSuite == NULL )
     {
         gRegisterFailed++;
-    }
-
-    UT_test_group_t* newGroup = (UT_test_group_t*)malloc(sizeof(UT_test_group_t));
-    if (newGroup == NULL) {
-        gRegisterFailed++;
         return NULL;
     }
 
+    int index = group_list.count++;
+    UT_test_group_t *newGroup = &group_list.groups[index];
+    int *pBucket = &group_list.buckets[hashSuiteName( pSuite->pName ) & (group_list.capacity - 1)];
+
     newGroup->pSuite = pSuite;
     newGroup->groupId = groupId;
+    newGroup->paramTests = 0;
+    newGroup->pInitFunction = pInitFunction;
+    newGroup->pCleanupFunction = pCleanupFunction;
+    newGroup->bInitSkipped = false;
+    newGroup->bSkipped = false;
+    newGroup->nextInGroup = -1;
+    newGroup->nextInBucket = *pBucket;
+    *pBucket = index;
 
-    group_list.groups[group_list.count++]=newGroup;
+    if ( ((unsigned int)groupId) < UT_TESTS_MAX )
+    {
+        if ( group_list.groupTail[groupId] < 0 )
+        {
+            group_list.groupHead[groupId] = index;
+        }
+        else
+        {
+            group_list.groups[group_list.groupTail[groupId]].nextInGroup = index;
+        }
+        group_list.groupTail[groupId] = index;
+    }
 
     return (UT_test_suite_t *)pSuite;
 
@@ -249,12 +500,14 @@ void UT_toggle_suite_activation_based_on_groupID(UT_groupID_t groupId, bool enab
         return;
     }
 
-    for (int i = 0; i < group_list.count; ++i)
+    if (group_list.count == 0)
     {
-        if (group_list.groups[i]->groupId == groupId)
-        {
-            CU_set_suite_active(group_list.groups[i]->pSuite, (CU_BOOL)enable_disable);
-        }
+        return;
+    }
+
+    for (int i = group_list.groupHead[groupId]; i >= 0; i = group_list.groups[i].nextInGroup)
+    {
+        CU_set_suite_active(group_list.groups[i].pSuite, (CU_BOOL)enable_disable);
     }
 }
 
@@ -262,7 +515,7 @@ void UT_toggle_all_suites(bool enable_disable)
 {
     for (int i = 0; i < group_list.count; ++i)
     {
-        CU_set_suite_active(group_list.groups[i]->pSuite, (CU_BOOL) enable_disable);
+        CU_set_suite_active(group_list.groups[i].pSuite, (CU_BOOL) enable_disable);
     }
 }
 
@@ -281,6 +534,228 @@ UT_test_t *UT_add_test(UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunct
     return (UT_test_t *)pTest;
 }
 
+UT_test_t *UT_add_benchmark(UT_test_suite_t *pSuite, const char *pTitle, UT_TestFunction_t pFunction)
+{
+    UT_test_binding_t *pBinding;
+    UT_test_t *pTest;
+
+    pBinding = (UT_test_binding_t *)malloc(sizeof(UT_test_binding_t));
+    if ( pBinding == NULL )
+    {
+        gRegisterFailed++;
+        return NULL;
+    }
+
+    pTest = UT_add_test(pSuite, pTitle, &benchmarkTrampoline);
+    if ( pTest == NULL )
+    {
+        free(pBinding);
+        return NULL;
+    }
+
+    pBinding->pTest = (CU_pTest)pTest;
+    pBinding->pFunction = pFunction;
+    pBinding->pNext = gpBindings;
+    gpBindings = pBinding;
+
+    return pTest;
+}
+
+uint32_t UT_add_param_tests(UT_test_suite_t *pSuite, const char *pTitle, UT_ParamTestFunction_t pFunction, const char *pListKey)
+{
+    char title[UT_PARAM_TEST_TITLE_SIZE];
+    UT_test_group_t *pGroup;
+    uint32_t count;
+    uint32_t added = 0;
+
+    if ( (pSuite == NULL) || (pTitle == NULL) || (pFunction == NULL) || (pListKey == NULL) )
+    {
+        gRegisterFailed++;
+        return 0;
+    }
+
+    count = ut_kvp_profile_getListCount( pListKey );
+    if ( count == 0 )
+    {
+        UT_LOG_WARNING("Profile list [%s] is empty or not in the profile, no [%s] tests added\n", pListKey, pTitle);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        size_t keySize = strlen( pListKey ) + 12;
+        UT_param_binding_t *pBinding;
+        UT_test_t *pTest;
+
+        pBinding = (UT_param_binding_t *)malloc( sizeof(UT_param_binding_t) + keySize );
+        if ( pBinding == NULL )
+        {
+            gRegisterFailed++;
+            break;
+        }
+
+        snprintf( title, sizeof(title), "%s[%u]", pTitle, i );
+        pTest = UT_add_test( pSuite, title, &paramTrampoline );
+        if ( pTest == NULL )
+        {
+            free( pBinding );
+            break;
+        }
+
+        pBinding->pTest = (CU_pTest)pTest;
+        pBinding->pFunction = pFunction;
+        pBinding->index = i;
+        pBinding->pKey = (char *)(pBinding + 1);
+        snprintf( pBinding->pKey, keySize, "%s/%u", pListKey, i );
+        pBinding->pNext = NULL;
+        if ( gpParamTail != NULL )
+        {
+            gpParamTail->pNext = pBinding;
+        }
+        else
+        {
+            gpParamBindings = pBinding;
+        }
+        gpParamTail = pBinding;
+        added++;
+    }
+
+    pGroup = findSuiteGroup( (CU_pSuite)pSuite );
+    if ( pGroup != NULL )
+    {
+        pGroup->paramTests += added;
+    }
+    return added;
+}
+
+void UT_assert_duration(double elapsedMs, double budgetMs, const char *pStatement, unsigned int line, const char *pFile, CU_BOOL bFatal)
+{
+    char condition[UT_DURATION_CONDITION_SIZE];
+
+    /* CUnit copies the condition into the failure record, so the measurement can be formatted into it */
+    snprintf( condition, sizeof(condition), "%s took %.3fms, budget %.3fms", pStatement, elapsedMs, budgetMs );
+    CU_assertImplementation( (CU_BOOL)(elapsedMs < budgetMs), line, condition, pFile, "", bFatal );
+}
+
+void UT_cunit_test_start( const CU_pTest pTest, const CU_pSuite pSuite )
+{
+    CU_pRunSummary pRunSummary = CU_get_run_summary();
+
+    gStressTestStartNs = UT_get_monotonic_ns();
+    if ( UT_trace_enabled() )
+    {
+        gTraceAssertsAtStart = (pRunSummary != NULL) ? pRunSummary->nAsserts : 0;
+        UT_trace_testStart( pSuite->pName, pTest->pName );
+    }
+
+    /* Last, so the counters only see the test */
+    UT_memory_test_start();
+    UT_perf_test_start();
+}
+
+void UT_cunit_test_body_end( const CU_pTest pTest, const CU_pSuite pSuite )
+{
+    char value[32];
+    UT_perf_sample_t sample;
+    UT_memory_sample_t memory;
+
+    /* A fatal assertion leaves the body past the timeout trampoline's disarm */
+    UT_watchdog_disarm();
+
+    /* Both read before the properties are added, the perf counters first as they were started last */
+    bool bPerf = UT_perf_test_end( pSuite->pName, pTest->pName, &sample );
+    bool bMemory = UT_memory_test_end( pSuite->pName, pTest->pName, &memory );
+
+    for (int i = 0; bPerf && (i < UT_PERF_COUNTERS); i++)
+    {
+        if ( sample.bValid[i] )
+        {
+            snprintf( value, sizeof(value), "%llu", (unsigned long long)sample.value[i] );
+            UT_automated_add_property( UT_perf_counter_name( (UT_perf_counter_t)i ), value );
+        }
+    }
+    if ( bMemory && memory.bNetValid )
+    {
+        snprintf( value, sizeof(value), "%lld", (long long)memory.netBytes );
+        UT_automated_add_property( "memory_net_bytes", value );
+    }
+    if ( bMemory && memory.bPeakValid )
+    {
+        snprintf( value, sizeof(value), "%lld", (long long)memory.peakBytes );
+        UT_automated_add_property( "memory_peak_bytes", value );
+    }
+}
+
+void UT_cunit_test_complete( const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure )
+{
+    CU_pRunSummary pRunSummary = CU_get_run_summary();
+    unsigned int asserts;
+    unsigned int failed = 0;
+
+    UT_impact_test_end( pSuite->pName, pTest->pName );
+    UT_coverage_test_end( pSuite->pName, pTest->pName );
+    if ( UT_stress_enabled() )
+    {
+        UT_stress_record( pSuite->pName, pTest->pName, (pFailure == NULL), UT_get_monotonic_ns() - gStressTestStartNs );
+    }
+    if ( UT_trace_enabled() == false )
+    {
+        return;
+    }
+
+    /* CUnit only keeps the failed assertions, the passed ones are counted in test_end */
+    for (CU_pFailureRecord pRecord = pFailure; pRecord != NULL; pRecord = pRecord->pNext)
+    {
+        UT_trace_assert( pRecord->strFileName, pRecord->uiLineNumber, pRecord->strCondition, false, false );
+        failed++;
+    }
+    asserts = (pRunSummary != NULL) ? (pRunSummary->nAsserts - gTraceAssertsAtStart) : failed;
+    UT_trace_testEnd( (failed > 0) ? "failed" : "passed", (asserts > failed) ? asserts : failed, failed );
+}
+
+void UT_cunit_suite_start( const CU_pSuite pSuite )
+{
+    UT_test_group_t *pGroup = findSuiteGroup( pSuite );
+
+    /* CUnit only has a run wide fail on inactive setting, it is lifted while a suite the run skipped goes by */
+    restoreFailOnInactive();
+    if ( (pGroup != NULL) && pGroup->bSkipped && (pSuite->fActive == CU_FALSE) )
+    {
+        gFailOnInactive = CU_get_fail_on_inactive();
+        gbFailOnInactiveLifted = true;
+        CU_set_fail_on_inactive( CU_FALSE );
+    }
+}
+
+void UT_cunit_suite_complete( const CU_pSuite pSuite )
+{
+    CU_UNREFERENCED_PARAMETER( pSuite );
+
+    restoreFailOnInactive();
+    /* The suite_start is written by the first test that runs, a suite without one writes neither */
+    UT_trace_suiteEnd();
+}
+
+static void restoreFailOnInactive( void )
+{
+    if ( gbFailOnInactiveLifted )
+    {
+        CU_set_fail_on_inactive( gFailOnInactive );
+        gbFailOnInactiveLifted = false;
+    }
+}
+
+/**
+ * @brief Deactivates a suite the run itself leaves out, for the impact map, another shard or worker, or its cached pass
+ *
+ * Unlike a suite deactivated with its group, it is not recorded as a failure when CUnit fails inactive suites.
+ */
+static void skipSuite( UT_test_group_t *pGroup )
+{
+    CU_set_suite_active( pGroup->pSuite, CU_FALSE );
+    pGroup->bSkipped = true;
+}
+
 const char *UT_getTestSuiteTitle( UT_test_suite_t *pSuite )
 {
     CU_pTest pTest;
@@ -300,13 +775,1263 @@ static int internalClean( void )
     return 0;
 }
 
-static void releaseGroups( void )
+/**
+ * @brief Initialisation of every suite, runs the suite's own unless none of its tests is active
+ *
+ * CUnit sets the current suite before calling it. A suite left with no active test, e.g. by
+ * the -j dealing of its parameterized cases, skips its set up and clean up.
+ */
+static int suiteInit( void )
+{
+    CU_pSuite pSuite = CU_get_current_suite();
+    UT_test_group_t *pGroup = findSuiteGroup( pSuite );
+    bool bActive = false;
+
+    if ( pGroup == NULL )
+    {
+        return 0;
+    }
+    for (CU_pTest pTest = pSuite->pTest; (pTest != NULL) && (bActive == false); pTest = pTest->pNext)
+    {
+        bActive = (pTest->fActive == CU_TRUE);
+    }
+
+    pGroup->bInitSkipped = (bActive == false);
+    if ( pGroup->bInitSkipped )
+    {
+        UT_LOG( "Suite [%s] has no active test, skipping its set up", pSuite->pName );
+        return 0;
+    }
+    return pGroup->pInitFunction();
+}
+
+/**
+ * @brief Clean up of every suite, tears down the suite's fixtures then runs the suite's own if it was set up
+ */
+static int suiteCleanup( void )
+{
+    CU_pSuite pSuite = CU_get_current_suite();
+    UT_test_group_t *pGroup = findSuiteGroup( pSuite );
+    int result = 0;
+
+    if ( pGroup == NULL )
+    {
+        return 0;
+    }
+
+    /* Set up after the suite, so torn down before it */
+    UT_fixture_suite_end( pSuite->pName );
+    if ( pGroup->bInitSkipped == false )
+    {
+        result = pGroup->pCleanupFunction();
+    }
+    pGroup->bInitSkipped = false;
+    return result;
+}
+
+/**
+ * @brief Orders suite indices heaviest first, by test count then registration order
+ */
+static int compareSuiteWeight( const void *a, const void *b )
+{
+    int lhs = *(const int *)a;
+    int rhs = *(const int *)b;
+    unsigned int lhsTests = group_list.groups[lhs].pSuite->uiNumberOfTests;
+    unsigned int rhsTests = group_list.groups[rhs].pSuite->uiNumberOfTests;
+
+    if ( lhsTests != rhsTests )
+    {
+        return (lhsTests > rhsTests) ? -1 : 1;
+    }
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * @brief Deactivates the suites that did not enter any of the changed functions, see ut_impact.h
+ *
+ * Applied before the shard, so the shards split the selected suites between them.
+ */
+static void apply_impact( void )
 {
+    int skipped = 0;
+    int active = 0;
+
     for (int i = 0; i < group_list.count; ++i)
     {
-        free(group_list.groups[i]);
+        CU_pSuite pSuite = group_list.groups[i].pSuite;
+
+        if ( pSuite->fActive == CU_FALSE )
+        {
+            continue;
+        }
+        active++;
+        if ( UT_impact_suite_selected( pSuite->pName ) == false )
+        {
+            skipSuite( &group_list.groups[i] );
+            skipped++;
+        }
     }
-    group_list.count = 0;
+    UT_LOG( "Impact: running [%d] of [%d] active suites", active - skipped, active );
+}
+
+/**
+ * @brief Deactivates the suites not owned by this shard
+ *
+ * Active suites are weighted by their test count and handed out heaviest first
+ * to the least loaded shard, ties are broken by registration order so every
+ * shard agrees on the split. In Automated Mode the results file is renamed after
+ * the shard index.
+ */
+static void apply_shard( void )
+{
+    unsigned int load[UT_MAX_SHARDS];
+    int *order;
+    int ownSuites = 0;
+    int activeSuites = 0;
+
+    memset( load, 0, sizeof(load) );
+
+    order = (int *)malloc( (group_list.count + 1) * sizeof(int) );
+    if ( order == NULL )
+    {
+        UT_LOG_ERROR("Failed to allocate the shard order, running all suites\n");
+        return;
+    }
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        if ( group_list.groups[i].pSuite->fActive == CU_TRUE )
+        {
+            order[activeSuites++] = i;
+        }
+    }
+    qsort( order, activeSuites, sizeof(int), compareSuiteWeight );
+
+    for (int n = 0; n < activeSuites; n++)
+    {
+        CU_pSuite pSuite = group_list.groups[order[n]].pSuite;
+        int shard = 0;
+
+        for (int k = 1; k < gShardCount; k++)
+        {
+            if ( load[k] < load[shard] )
+            {
+                shard = k;
+            }
+        }
+
+        load[shard] += pSuite->uiNumberOfTests;
+        if ( shard == gShardIndex )
+        {
+            ownSuites++;
+        }
+        else
+        {
+            skipSuite( &group_list.groups[order[n]] );
+        }
+    }
+    free( order );
+
+    if ( get_test_mode() == UT_MODE_AUTOMATED )
+    {
+        const char *pResults = UT_automated_results_filename_get();
+        size_t length = strlen( pResults );
+        char *pShardResults;
+
+        if ( (length > 4) && (strcmp( &pResults[length - 4], ".xml" ) == 0) )
+        {
+            length -= 4;
+        }
+        pShardResults = (char *)malloc( length + 32 );
+        if ( pShardResults != NULL )
+        {
+            snprintf( pShardResults, length + 32, "%.*s-shard%d.xml", (int)length, pResults, gShardIndex );
+            UT_automated_results_filename_set( pShardResults );
+            free( pShardResults );
+        }
+    }
+
+    UT_LOG( "Shard [%d/%d]: running [%d] of [%d] suites", gShardIndex, gShardCount, ownSuites, activeSuites );
+}
+
+/**
+ * @brief Checks whether the suites of a group are kept out of the worker pool
+ *
+ * Module control and human interaction suites run one at a time in the parent, after the workers.
+ */
+static bool isSerialGroup( UT_groupID_t groupId )
+{
+    return (groupId == UT_TESTS_L4) || (groupId == UT_TESTS_HUMAN_L2) || (groupId == UT_TESTS_HUMAN_L3) || (groupId == UT_TESTS_HUMAN_L4);
+}
+
+/**
+ * @brief Gets the number of worker slots a suite is dealt in, see dealSuite()
+ */
+static unsigned int dealtSlots( int index )
+{
+    unsigned int paramTests = group_list.groups[index].paramTests;
+
+    if ( (paramTests > 0) && (group_list.groups[index].pSuite->uiNumberOfTests == paramTests) )
+    {
+        return paramTests;
+    }
+    return paramTests + 1;
+}
+
+/**
+ * @brief Deals an active suite to the workers
+ *
+ * The suite takes the next slot, then each of its parameterized cases takes a slot of its own.
+ * A suite made only of parameterized cases takes no slot itself. The parent and every worker
+ * deal in the same order, so they agree on the split.
+ *
+ * @param index - index of the suite in the group list
+ * @param pOwned - CU_TRUE for each worker whose share is dealt
+ * @param jobs - total number of workers
+ * @param pSlot - next slot, advanced past the suite and its cases
+ * @param bApply - CU_TRUE to activate the share's cases of the suite and deactivate the others
+ * @param pLost - if not NULL, the active tests of the suite in the share are added to it
+ * @return CU_BOOL - CU_TRUE if the share holds the suite or any of its cases
+ */
+static CU_BOOL dealSuite( int index, const CU_BOOL *pOwned, int jobs, int *pSlot, CU_BOOL bApply, UT_lost_tests_t *pLost )
+{
+    CU_pSuite pSuite = group_list.groups[index].pSuite;
+    unsigned int paramTests = group_list.groups[index].paramTests;
+    CU_BOOL ownsSuite = CU_FALSE;
+    CU_BOOL ownsAny;
+
+    if ( dealtSlots( index ) > paramTests )
+    {
+        ownsSuite = pOwned[*pSlot % jobs];
+        (*pSlot)++;
+    }
+    ownsAny = ownsSuite;
+
+    if ( (paramTests == 0) && (pLost == NULL) )
+    {
+        return ownsAny;
+    }
+
+    for (CU_pTest pTest = pSuite->pTest; pTest != NULL; pTest = pTest->pNext)
+    {
+        CU_BOOL owned = ownsSuite;
+
+        if ( (paramTests > 0) && (findParamBinding( pTest ) != NULL) )
+        {
+            owned = pOwned[*pSlot % jobs];
+            (*pSlot)++;
+        }
+        if ( bApply == CU_TRUE )
+        {
+            CU_set_test_active( pTest, owned );
+        }
+        if ( (pLost != NULL) && (owned == CU_TRUE) && (pTest->fActive == CU_TRUE) )
+        {
+            pLost->ppSuites[pLost->count] = pSuite->pName;
+            pLost->ppTests[pLost->count++] = pTest->pName;
+        }
+        ownsAny = (owned == CU_TRUE) ? CU_TRUE : ownsAny;
+    }
+    return ownsAny;
+}
+
+/**
+ * @brief Activates the suites and cases of a share of the run and deactivates the others
+ *
+ * @param pActive - activation state of each group before partitioning
+ * @param pOwned - CU_TRUE for each worker whose share is run
+ * @param jobs - total number of workers
+ * @param bSerial - CU_TRUE to run the suites kept out of the workers, see isSerialGroup()
+ * @return int - number of suites in the share
+ */
+static int applyShare( const CU_BOOL *pActive, const CU_BOOL *pOwned, int jobs, CU_BOOL bSerial )
+{
+    int slot = 0;
+    int count = 0;
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        CU_BOOL owned = CU_FALSE;
+
+        if ( pActive[i] == CU_TRUE )
+        {
+            owned = isSerialGroup( group_list.groups[i].groupId ) ? bSerial : dealSuite( i, pOwned, jobs, &slot, CU_TRUE, NULL );
+        }
+        /* The suites inactive before the run was shared are counted once, by run_pool() */
+        if ( owned == CU_TRUE )
+        {
+            CU_set_suite_active( group_list.groups[i].pSuite, CU_TRUE );
+            group_list.groups[i].bSkipped = false;
+            count++;
+        }
+        else
+        {
+            skipSuite( &group_list.groups[i] );
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Runs the active suites through the Basic, Console or Automated path of this process
+ */
+static void run_tests_in_process( TestMode_t mode )
+{
+    switch( mode )
+    {
+        case UT_MODE_BASIC:
+        {
+            /* Run all tests using the Basic interface */
+            UT_basic_run_tests();
+        }
+        break;
+
+        case UT_MODE_CONSOLE:
+        {
+            UT_console_run_tests();
+        }
+        break;
+
+        case UT_MODE_AUTOMATED:
+        {
+            UT_automated_enable_junit_xml( CU_TRUE );
+            UT_automated_run_tests();
+        }
+        break;
+    }
+    /* CUnit need not report the end of an inactive suite */
+    restoreFailOnInactive();
+}
+
+/**
+ * @brief Runs the share of the suites made active by applyShare()
+ *
+ * @param mode - test mode to run the share in
+ * @param pResultsFile - results file of the share, only used in Automated Mode
+ */
+static void run_share( TestMode_t mode, const char *pResultsFile )
+{
+    /* The cached results are spliced into the merged file by the parent */
+    UT_automated_set_spliced_results( NULL, 0 );
+
+    if ( mode == UT_MODE_AUTOMATED )
+    {
+        UT_automated_results_filename_set( pResultsFile );
+    }
+    run_tests_in_process( mode );
+}
+
+/**
+ * @brief Builds the results filename of a worker, or of the parent, from the results file of the run
+ *
+ * @param pResults - results file of the run
+ * @param worker - index of the worker, -1 for the parent
+ * @return char* - the filename, freed by the caller, NULL if it could not be allocated
+ */
+static char *shareResultsFilename( const char *pResults, int worker )
+{
+    size_t length = strlen( pResults );
+    char *pFilename;
+
+    if ( (length > 4) && (strcmp( &pResults[length - 4], ".xml" ) == 0) )
+    {
+        length -= 4;
+    }
+    pFilename = (char *)malloc( length + 32 );
+    if ( pFilename == NULL )
+    {
+        return NULL;
+    }
+    if ( worker < 0 )
+    {
+        snprintf( pFilename, length + 32, "%.*s-parent.xml", (int)length, pResults );
+    }
+    else
+    {
+        snprintf( pFilename, length + 32, "%.*s-worker%d.xml", (int)length, pResults, worker );
+    }
+    return pFilename;
+}
+
+/**
+ * @brief Adds a run summary to the total of the parallel run
+ */
+static void addRunSummary( CU_pRunSummary pTotal, const CU_RunSummary *pSummary )
+{
+    pTotal->nSuitesRun += pSummary->nSuitesRun;
+    pTotal->nSuitesFailed += pSummary->nSuitesFailed;
+    pTotal->nTestsRun += pSummary->nTestsRun;
+    pTotal->nTestsFailed += pSummary->nTestsFailed;
+    pTotal->nTestsInactive += pSummary->nTestsInactive;
+    pTotal->nAsserts += pSummary->nAsserts;
+    pTotal->nAssertsFailed += pSummary->nAssertsFailed;
+    pTotal->nFailureRecords += pSummary->nFailureRecords;
+}
+
+/**
+ * @brief Runs a worker's share of the suites and reports its run summary
+ *
+ * Called in the forked child, the suites not owned by this worker are deactivated
+ * so the normal Basic / Automated paths only run this worker's share.
+ *
+ * @param worker - index of this worker
+ * @param jobs - total number of workers
+ * @param pActive - activation state of each group before partitioning
+ * @param mode - test mode to run the share in
+ * @param pResultsFile - results file for this worker, only used in Automated Mode
+ * @param fd - pipe used to return the run summary to the parent
+ */
+static void run_worker( int worker, int jobs, const CU_BOOL *pActive, TestMode_t mode, const char *pResultsFile, int fd )
+{
+    CU_BOOL owned[UT_MAX_PARALLEL_JOBS] = { CU_FALSE };
+    CU_RunSummary summary;
+    ssize_t written;
+
+    owned[worker] = CU_TRUE;
+    applyShare( pActive, owned, jobs, CU_FALSE );
+    run_share( mode, pResultsFile );
+
+    summary = *CU_get_run_summary();
+    written = write( fd, &summary, sizeof(summary) );
+    if ( written != (ssize_t)sizeof(summary) )
+    {
+        UT_LOG_ERROR("Worker [%d] failed to report its run summary\n", worker);
+    }
+    close( fd );
+}
+
+/**
+ * @brief Runs the active suites across the worker pool, see run_tests_parallel()
+ *
+ * @param mode - test mode, Basic or Automated
+ * @param pActive - activation state of each group
+ * @param pLost - filled with the tests of the workers that died
+ * @param pResultsFiles - filled with the results file of each worker, then of the parent, Automated Mode only
+ * @param pResults - results file of the run, Automated Mode only
+ * @return bool - false if no worker could be started, nothing was run
+ */
+static bool run_pool( TestMode_t mode, const CU_BOOL *pActive, UT_lost_tests_t *pLost, char **pResultsFiles, const char *pResults )
+{
+    CU_BOOL owned[UT_MAX_PARALLEL_JOBS];
+    pid_t pids[UT_MAX_PARALLEL_JOBS];
+    int fds[UT_MAX_PARALLEL_JOBS];
+    CU_RunSummary total;
+    int activeCount = 0;
+    int activeSlots = 0;
+    int inactiveFailures = 0;   /* Suites inactive before the pool and not skipped by the run, see skipSuite() */
+    int parentSuites;
+    int jobs;
+    int started = 0;
+
+    memset( &total, 0, sizeof(total) );
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        if ( pActive[i] == CU_TRUE )
+        {
+            activeCount++;
+            activeSlots += isSerialGroup( group_list.groups[i].groupId ) ? 0 : dealtSlots( i );
+        }
+        else if ( group_list.groups[i].bSkipped == false )
+        {
+            inactiveFailures++;
+        }
+    }
+
+    jobs = (gParallelJobs < activeSlots) ? gParallelJobs : activeSlots;
+    if ( jobs < 1 )
+    {
+        UT_LOG( "No active suite can run in a worker, running serially" );
+        return false;
+    }
+    UT_LOG( UT_LOG_ASCII_GREEN"Running [%d] suites across [%d] workers"UT_LOG_ASCII_NC, activeCount, jobs );
+
+    /* Don't let the children flush a copy of anything still buffered */
+    fflush( NULL );
+
+    for (int worker = 0; worker < jobs; worker++)
+    {
+        int pipeFd[2];
+
+        pids[worker] = -1;
+        if ( mode == UT_MODE_AUTOMATED )
+        {
+            pResultsFiles[worker] = shareResultsFilename( pResults, worker );
+            if ( pResultsFiles[worker] == NULL )
+            {
+                UT_LOG_ERROR("Failed to allocate worker [%d] results filename, its suites run after the workers\n", worker);
+                continue;
+            }
+        }
+
+        if ( pipe( pipeFd ) != 0 )
+        {
+            UT_LOG_ERROR("pipe() failed for worker [%d]: %s, its suites run after the workers\n", worker, strerror(errno));
+            free( pResultsFiles[worker] );
+            pResultsFiles[worker] = NULL;
+            continue;
+        }
+
+        pids[worker] = fork();
+        if ( pids[worker] < 0 )
+        {
+            UT_LOG_ERROR("fork() failed for worker [%d]: %s, its suites run after the workers\n", worker, strerror(errno));
+            close( pipeFd[0] );
+            close( pipeFd[1] );
+            free( pResultsFiles[worker] );
+            pResultsFiles[worker] = NULL;
+            continue;
+        }
+
+        if ( pids[worker] == 0 )
+        {
+            close( pipeFd[0] );
+            for (int i = 0; i < worker; i++)
+            {
+                if ( pids[i] > 0 )
+                {
+                    close( fds[i] );
+                }
+            }
+            run_worker( worker, jobs, pActive, mode, pResultsFiles[worker], pipeFd[1] );
+            UT_perf_summary();
+            UT_memory_summary();
+            UT_fixture_run_end();
+            UT_isolation_stop();
+            UT_log_async_flush();
+            fflush( NULL );
+            _exit( 0 );
+        }
+
+        close( pipeFd[1] );
+        fds[worker] = pipeFd[0];
+        started++;
+    }
+
+    if ( started == 0 )
+    {
+        UT_LOG_ERROR("No worker could be started, running serially\n");
+        return false;
+    }
+
+    for (int worker = 0; worker < jobs; worker++)
+    {
+        CU_RunSummary summary;
+        int status = 0;
+        ssize_t length;
+
+        owned[worker] = (pids[worker] < 0) ? CU_TRUE : CU_FALSE;
+        if ( pids[worker] < 0 )
+        {
+            continue;
+        }
+
+        do
+        {
+            length = read( fds[worker], &summary, sizeof(summary) );
+        } while ( (length < 0) && (errno == EINTR) );
+        close( fds[worker] );
+
+        while ( (waitpid( pids[worker], &status, 0 ) < 0) && (errno == EINTR) )
+        {
+        }
+
+        if ( length != (ssize_t)sizeof(summary) )
+        {
+            CU_BOOL workerOwned[UT_MAX_PARALLEL_JOBS] = { CU_FALSE };
+
+            /* The worker died before reporting, each test of its share is counted as failed */
+            UT_LOG_ERROR("Worker [%d] terminated abnormally (status 0x%x)\n", worker, status);
+            workerOwned[worker] = CU_TRUE;
+            for (int i = 0, slot = 0; i < group_list.count; ++i)
+            {
+                int before = pLost->count;
+
+                if ( (pActive[i] == CU_TRUE) && (isSerialGroup( group_list.groups[i].groupId ) == false) &&
+                     (dealSuite( i, workerOwned, jobs, &slot, CU_FALSE, pLost ) == CU_TRUE) && (pLost->count > before) )
+                {
+                    total.nSuitesFailed++;
+                    total.nTestsRun += pLost->count - before;
+                    total.nTestsFailed += pLost->count - before;
+                    total.nFailureRecords += pLost->count - before;
+                }
+            }
+
+            /* Its partial results would contradict the summary, the lost tests are written in their place */
+            if ( pResultsFiles[worker] != NULL )
+            {
+                remove( pResultsFiles[worker] );
+                free( pResultsFiles[worker] );
+                pResultsFiles[worker] = NULL;
+            }
+            continue;
+        }
+
+        addRunSummary( &total, &summary );
+        if ( summary.ElapsedTime > total.ElapsedTime )
+        {
+            total.ElapsedTime = summary.ElapsedTime;
+        }
+    }
+
+    /* The suites kept out of the pool and the share of any worker not started */
+    parentSuites = applyShare( pActive, owned, jobs, CU_TRUE );
+    if ( parentSuites > 0 )
+    {
+        UT_LOG( UT_LOG_ASCII_GREEN"Running [%d] suites in process after the workers"UT_LOG_ASCII_NC, parentSuites );
+        run_share( mode, pResultsFiles[UT_MAX_PARALLEL_JOBS] );
+        addRunSummary( &total, CU_get_run_summary() );
+        total.ElapsedTime += CU_get_run_summary()->ElapsedTime;
+        UT_automated_set_spliced_results( gppCachedBlocks, gCachedBlockCount );
+    }
+    total.nSuitesInactive = group_list.count - activeCount;
+    if ( CU_get_fail_on_inactive() == CU_TRUE )
+    {
+        total.nFailureRecords += inactiveFailures;
+    }
+
+    if ( mode == UT_MODE_AUTOMATED )
+    {
+        UT_automated_results_filename_set( pResults );
+        UT_automated_enable_junit_xml( CU_TRUE );
+        UT_automated_merge_results( (const char **)pResultsFiles, UT_MAX_PARALLEL_JOBS + 1, pLost->ppSuites, pLost->ppTests, pLost->count,
+                                    "Worker terminated abnormally before reporting its results", &total );
+    }
+
+    UT_LOG( "\n" );
+    UT_LOG( UT_LOG_ASCII_GREEN"Parallel Run Summary"UT_LOG_ASCII_NC" : workers [%d] suites in process [%d]", started, parentSuites );
+    UT_LOG( "  suites  : run [%u] failed [%u] inactive [%u]", total.nSuitesRun, total.nSuitesFailed, total.nSuitesInactive );
+    UT_LOG( "  tests   : run [%u] failed [%u] inactive [%u]", total.nTestsRun, total.nTestsFailed, total.nTestsInactive );
+    UT_LOG( "  asserts : run [%u] failed [%u]", total.nAsserts, total.nAssertsFailed );
+    return true;
+}
+
+/**
+ * @brief Runs the active suites across gParallelJobs forked worker processes
+ *
+ * Active suites are dealt round robin to the workers, each worker runs its share
+ * through the Basic or Automated path and returns its run summary over a pipe.
+ * The suites kept out of the pool, see isSerialGroup(), and the share of any worker
+ * that could not be started run in this process once the workers have finished.
+ * In Automated Mode each share is written to its own results file, which are merged
+ * into the single results file at the end, the tests of a worker that died are written
+ * as failed. Should no worker start, the suites run serially.
+ *
+ * @param mode - test mode, Basic or Automated
+ */
+static void run_tests_parallel( TestMode_t mode )
+{
+    CU_BOOL *active;
+    bool *skipped;
+    CU_BOOL *testActive;
+    char *resultsFiles[UT_MAX_PARALLEL_JOBS + 1];   /* One per worker, then the parent's */
+    char *pResults = NULL;
+    UT_lost_tests_t lost = { NULL, NULL, 0 };
+    int testCount = 0;
+
+    memset( resultsFiles, 0, sizeof(resultsFiles) );
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        testCount += group_list.groups[i].pSuite->uiNumberOfTests;
+    }
+    active = (CU_BOOL *)malloc( (group_list.count + 1) * sizeof(CU_BOOL) );
+    skipped = (bool *)malloc( (group_list.count + 1) * sizeof(bool) );
+    testActive = (CU_BOOL *)malloc( (testCount + 1) * sizeof(CU_BOOL) );
+    lost.ppSuites = (const char **)malloc( (testCount + 1) * sizeof(const char *) );
+    lost.ppTests = (const char **)malloc( (testCount + 1) * sizeof(const char *) );
+    if ( mode == UT_MODE_AUTOMATED )
+    {
+        pResults = strdup( UT_automated_results_filename_get() );
+        resultsFiles[UT_MAX_PARALLEL_JOBS] = (pResults != NULL) ? shareResultsFilename( pResults, -1 ) : NULL;
+    }
+
+    if ( (active == NULL) || (skipped == NULL) || (testActive == NULL) || (lost.ppSuites == NULL) || (lost.ppTests == NULL) ||
+         ((mode == UT_MODE_AUTOMATED) && (resultsFiles[UT_MAX_PARALLEL_JOBS] == NULL)) )
+    {
+        UT_LOG_ERROR("Failed to allocate the worker partition, running serially\n");
+        run_tests_in_process( mode );
+    }
+    else
+    {
+        for (int i = 0, test = 0; i < group_list.count; ++i)
+        {
+            active[i] = group_list.groups[i].pSuite->fActive;
+            skipped[i] = group_list.groups[i].bSkipped;
+            for (CU_pTest pTest = group_list.groups[i].pSuite->pTest; pTest != NULL; pTest = pTest->pNext)
+            {
+                testActive[test++] = pTest->fActive;
+            }
+        }
+
+        if ( run_pool( mode, active, &lost, resultsFiles, pResults ) == false )
+        {
+            run_tests_in_process( mode );
+        }
+
+        /* Leave the registry as it was for the next stress iteration */
+        for (int i = 0, test = 0; i < group_list.count; ++i)
+        {
+            CU_set_suite_active( group_list.groups[i].pSuite, active[i] );
+            group_list.groups[i].bSkipped = skipped[i];
+            for (CU_pTest pTest = group_list.groups[i].pSuite->pTest; pTest != NULL; pTest = pTest->pNext)
+            {
+                CU_set_test_active( pTest, testActive[test++] );
+            }
+        }
+    }
+
+    for (int i = 0; i <= UT_MAX_PARALLEL_JOBS; i++)
+    {
+        if ( resultsFiles[i] != NULL )
+        {
+            remove( resultsFiles[i] );
+            free( resultsFiles[i] );
+        }
+    }
+    free( pResults );
+    free( lost.ppSuites );
+    free( lost.ppTests );
+    free( testActive );
+    free( skipped );
+    free( active );
+}
+
+/**
+ * @brief Finds the function bound to a trampoline registered test
+ *
+ * @param pTest - the test
+ * @return UT_TestFunction_t - the bound function, NULL if none
+ */
+static UT_TestFunction_t findBinding( CU_pTest pTest )
+{
+    for (UT_test_binding_t *pBinding = gpBindings; pBinding != NULL; pBinding = pBinding->pNext)
+    {
+        if ( pBinding->pTest == pTest )
+        {
+            return pBinding->pFunction;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test function of every benchmark, runs the function bound to the current test
+ *
+ * The statistics go to the log and, in Automated Mode, to the testcase properties.
+ */
+static void benchmarkTrampoline( void )
+{
+    CU_pTest pTest = CU_get_current_test();
+    UT_TestFunction_t pFunction = findBinding( pTest );
+    UT_benchmark_stats_t stats;
+    char value[32];
+
+    if ( pFunction == NULL )
+    {
+        UT_FAIL("Benchmark function not found");
+        return;
+    }
+
+    UT_benchmark_run( pFunction, &stats );
+    UT_benchmark_log( pTest->pName, &stats );
+
+    snprintf( value, sizeof(value), "%llu", (unsigned long long)stats.iterations );
+    UT_automated_add_property( "benchmark_iterations", value );
+    snprintf( value, sizeof(value), "%u", stats.samples );
+    UT_automated_add_property( "benchmark_samples", value );
+    snprintf( value, sizeof(value), "%.1f", stats.min );
+    UT_automated_add_property( "benchmark_min_ns", value );
+    snprintf( value, sizeof(value), "%.1f", stats.median );
+    UT_automated_add_property( "benchmark_median_ns", value );
+    snprintf( value, sizeof(value), "%.1f", stats.p99 );
+    UT_automated_add_property( "benchmark_p99_ns", value );
+    snprintf( value, sizeof(value), "%.1f", stats.mean );
+    UT_automated_add_property( "benchmark_mean_ns", value );
+    snprintf( value, sizeof(value), "%.1f", stats.stddev );
+    UT_automated_add_property( "benchmark_stddev_ns", value );
+}
+
+/**
+ * @brief Finds the binding of a parameterized case
+ *
+ * Cases are looked up in registration order, so the search starts from the case found last.
+ *
+ * @param pTest - the test
+ * @return UT_param_binding_t* - the binding, NULL if the test is not a parameterized case
+ */
+static UT_param_binding_t *findParamBinding( CU_pTest pTest )
+{
+    UT_param_binding_t *pStart = (gpParamCursor != NULL) ? gpParamCursor : gpParamBindings;
+    UT_param_binding_t *pBinding;
+
+    for (pBinding = pStart; pBinding != NULL; pBinding = pBinding->pNext)
+    {
+        if ( pBinding->pTest == pTest )
+        {
+            gpParamCursor = pBinding;
+            return pBinding;
+        }
+    }
+    for (pBinding = gpParamBindings; pBinding != pStart; pBinding = pBinding->pNext)
+    {
+        if ( pBinding->pTest == pTest )
+        {
+            gpParamCursor = pBinding;
+            return pBinding;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test function of every parameterized case, calls its function with the list element
+ */
+static void paramTrampoline( void )
+{
+    UT_param_binding_t *pBinding = findParamBinding( CU_get_current_test() );
+
+    if ( pBinding == NULL )
+    {
+        UT_FAIL("Parameterized test function not found");
+        return;
+    }
+    pBinding->pFunction( pBinding->pKey, pBinding->index );
+}
+
+/**
+ * @brief Skips the active suites that passed in a previous run of the same binary, libraries and profile
+ *
+ * Only used in Automated Mode, the cached results are spliced into the results file in place of the skipped suites.
+ */
+static void apply_result_cache( void )
+{
+    char options[UT_RUN_OPTIONS_SIZE];
+    int skipped = 0;
+
+    if ( get_test_mode() != UT_MODE_AUTOMATED )
+    {
+        UT_LOG_WARNING("The result cache is only used in Automated Mode, running all suites\n");
+        return;
+    }
+
+    describeRunOptions( options, sizeof(options) );
+    if ( UT_result_cache_open( gpResultCacheFile, gpResultCacheProfile, options, gbUseCachedResults ) == 0 )
+    {
+        return;
+    }
+
+    gppCachedBlocks = (const char **)calloc( group_list.count + 1, sizeof(const char *) );
+    if ( gppCachedBlocks == NULL )
+    {
+        UT_LOG_ERROR("Failed to allocate the cached results, running all suites\n");
+        return;
+    }
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        CU_pSuite pSuite = group_list.groups[i].pSuite;
+        const char *pBlock;
+
+        if ( pSuite->fActive == CU_FALSE )
+        {
+            continue;
+        }
+        pBlock = UT_result_cache_lookup( pSuite->pName );
+        if ( pBlock != NULL )
+        {
+            skipSuite( &group_list.groups[i] );
+            gppCachedBlocks[gCachedBlockCount++] = pBlock;
+            skipped++;
+        }
+    }
+    UT_automated_set_spliced_results( gppCachedBlocks, gCachedBlockCount );
+    UT_LOG( "Result cache: skipping [%d] unchanged passing suites", skipped );
+}
+
+/**
+ * @brief Describes the options of this run that can change a suite's result, for the result cache key
+ *
+ * The group toggles are listed in the order given, as a later one overrides an earlier one.
+ */
+static void describeRunOptions( char *pOptions, size_t size )
+{
+    size_t used;
+
+    used = (size_t)snprintf( pOptions, size, "test-timeout=%u suite-timeout=%u isolate=%d memory=%d leak-budget=%lld perf=%d stress=%d groups=",
+                             gTestTimeout, gSuiteTimeout, (int)gIsolation, UT_memory_enabled() ? 1 : 0,
+                             (long long)UT_memory_leak_budget(), UT_perf_enabled() ? 1 : 0, UT_stress_enabled() ? 1 : 0 );
+    for (int i = 0; (i < gGroupFlag.group_flag_count) && (used < size); i++)
+    {
+        used += (size_t)snprintf( &pOptions[used], size - used, "%c%d", gGroupFlag.switch_value[i] ? '+' : '-',
+                                  gGroupFlag.group_value[i] );
+    }
+}
+
+static void release_result_cache( void )
+{
+    UT_automated_set_spliced_results( NULL, 0 );
+    free( gppCachedBlocks );
+    gppCachedBlocks = NULL;
+    gCachedBlockCount = 0;
+    UT_result_cache_close();
+}
+
+static int compareBinding( const void *a, const void *b )
+{
+    uintptr_t lhs = (uintptr_t)((const UT_test_binding_t *)a)->pTest;
+    uintptr_t rhs = (uintptr_t)((const UT_test_binding_t *)b)->pTest;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * @brief Wraps every registered test in a trampoline
+ *
+ * The original test functions are kept sorted by test, so the trampoline finds them with a binary search.
+ *
+ * @return bool - false if the bindings could not be allocated, the tests are left as they were
+ */
+static bool wrap_tests( CU_TestFunc trampoline )
+{
+    CU_pTestRegistry pRegistry = CU_get_registry();
+    int count = 0;
+
+    for (CU_pSuite pSuite = pRegistry->pSuite; pSuite != NULL; pSuite = pSuite->pNext)
+    {
+        count += pSuite->uiNumberOfTests;
+    }
+
+    gpTimeoutBindings = (UT_test_binding_t *)calloc( count + 1, sizeof(UT_test_binding_t) );
+    if ( gpTimeoutBindings == NULL )
+    {
+        return false;
+    }
+
+    for (CU_pSuite pSuite = pRegistry->pSuite; pSuite != NULL; pSuite = pSuite->pNext)
+    {
+        for (CU_pTest pTest = pSuite->pTest; pTest != NULL; pTest = pTest->pNext)
+        {
+            gpTimeoutBindings[gTimeoutBindingCount].pTest = pTest;
+            gpTimeoutBindings[gTimeoutBindingCount].pFunction = (UT_TestFunction_t)pTest->pTestFunc;
+            gTimeoutBindingCount++;
+            pTest->pTestFunc = trampoline;
+        }
+    }
+    qsort( gpTimeoutBindings, gTimeoutBindingCount, sizeof(UT_test_binding_t), compareBinding );
+    return true;
+}
+
+static void apply_timeouts( void )
+{
+    if ( wrap_tests( (CU_TestFunc)&timeoutTrampoline ) == false )
+    {
+        UT_LOG_ERROR("Failed to allocate the test timeouts, running without them\n");
+        return;
+    }
+    UT_LOG( "Timeouts: test [%u]s suite [%u]s (0 is none)", gTestTimeout, gSuiteTimeout );
+}
+
+static void apply_leak_budget( void )
+{
+    if ( wrap_tests( (CU_TestFunc)&memoryTrampoline ) == false )
+    {
+        UT_LOG_ERROR("Failed to allocate the leak budget checks, running without them\n");
+    }
+}
+
+static void apply_isolation( void )
+{
+    if ( wrap_tests( (CU_TestFunc)&isolationTrampoline ) == false )
+    {
+        UT_LOG_ERROR("Failed to allocate the test isolation, running in process\n");
+        return;
+    }
+    UT_LOG( "Isolation: a worker process per [%s]", (gIsolation == UT_ISOLATION_TEST) ? "test" : "suite" );
+}
+
+/**
+ * @brief Finds the original function of the running test, and the deadline it has to finish by
+ *
+ * The deadline is whichever of the test and suite deadlines is first. Once a suite has
+ * overrun, its remaining tests fail as they start.
+ *
+ * @param pDeadline - set to the deadline, UINT64_MAX when there is none
+ * @param pCondition - set to the failure condition should the deadline pass
+ * @return UT_TestFunction_t - the test function, NULL if the test has failed already
+ */
+static UT_TestFunction_t start_wrapped_test( uint64_t now, uint64_t *pDeadline, char *pCondition, size_t conditionSize )
+{
+    CU_pTest pTest = CU_get_current_test();
+    CU_pSuite pSuite = CU_get_current_suite();
+    UT_test_binding_t key = { pTest, NULL, NULL };
+    UT_test_binding_t *pBinding;
+    uint64_t testDeadline = UINT64_MAX;
+    uint64_t suiteDeadline = UINT64_MAX;
+
+    pBinding = (UT_test_binding_t *)bsearch( &key, gpTimeoutBindings, gTimeoutBindingCount, sizeof(UT_test_binding_t), compareBinding );
+    if ( (pBinding == NULL) || (pBinding->pFunction == NULL) )
+    {
+        UT_FAIL("Test function not found");
+        return NULL;
+    }
+
+    if ( pSuite != gpTimedSuite )
+    {
+        gpTimedSuite = pSuite;
+        gSuiteStartNs = now;
+    }
+    if ( gTestTimeout > 0 )
+    {
+        testDeadline = now + (gTestTimeout * 1000000000ull);
+    }
+    if ( gSuiteTimeout > 0 )
+    {
+        suiteDeadline = gSuiteStartNs + (gSuiteTimeout * 1000000000ull);
+    }
+
+    if ( suiteDeadline <= now )
+    {
+        snprintf( pCondition, conditionSize, "Suite timeout of %us exceeded", gSuiteTimeout );
+        CU_assertImplementation( CU_FALSE, 0, pCondition, "watchdog", "", CU_TRUE );
+        return NULL;
+    }
+
+    if ( testDeadline <= suiteDeadline )
+    {
+        snprintf( pCondition, conditionSize, "Test timeout of %us exceeded by [%s]", gTestTimeout, pTest->pName );
+    }
+    else
+    {
+        snprintf( pCondition, conditionSize, "Suite timeout of %us exceeded by [%s]", gSuiteTimeout, pTest->pName );
+    }
+    *pDeadline = (testDeadline < suiteDeadline) ? testDeadline : suiteDeadline;
+    return pBinding->pFunction;
+}
+
+/**
+ * @brief Fails the running test if it has left more allocated than the leak budget
+ *
+ * Called from the trampolines, as CUnit has counted the failed tests by the time the complete handler runs.
+ */
+static void check_leak_budget( void )
+{
+    char condition[UT_TIMEOUT_CONDITION_SIZE];
+
+    if ( UT_memory_over_budget( condition, sizeof(condition) ) )
+    {
+        CU_assertImplementation( CU_FALSE, 0, condition, "leak budget", "", CU_FALSE );
+    }
+}
+
+/**
+ * @brief Test function of every test when timeouts are set and the bodies run in process, runs the original under the watchdog
+ */
+static void timeoutTrampoline( void )
+{
+    char condition[UT_TIMEOUT_CONDITION_SIZE];
+    uint64_t now = UT_get_monotonic_ns();
+    uint64_t deadline;
+    UT_TestFunction_t pFunction;
+    bool armed;
+
+    pFunction = start_wrapped_test( now, &deadline, condition, sizeof(condition) );
+    if ( pFunction == NULL )
+    {
+        return;
+    }
+
+    /* The watchdog reports the overrun as it happens, the failure is recorded once the body returns */
+    armed = ( UT_watchdog_arm( deadline - now, condition ) == 0 );
+    pFunction();
+    if ( (armed && UT_watchdog_disarm()) || (UT_get_monotonic_ns() > deadline) )
+    {
+        CU_assertImplementation( CU_FALSE, 0, condition, "watchdog", "", CU_FALSE );
+    }
+    check_leak_budget();
+}
+
+/**
+ * @brief Test function of every test when only a leak budget is set
+ */
+static void memoryTrampoline( void )
+{
+    char condition[UT_TIMEOUT_CONDITION_SIZE];
+    uint64_t deadline;
+    UT_TestFunction_t pFunction;
+
+    pFunction = start_wrapped_test( UT_get_monotonic_ns(), &deadline, condition, sizeof(condition) );
+    if ( pFunction == NULL )
+    {
+        return;
+    }
+    pFunction();
+    check_leak_budget();
+}
+
+/**
+ * @brief Test function of every test when isolation is set, runs the original in a worker process
+ *
+ * The timeouts are enforced here rather than by the watchdog, the worker is killed once the deadline passes.
+ */
+static void isolationTrampoline( void )
+{
+    char condition[UT_TIMEOUT_CONDITION_SIZE];
+    uint64_t now = UT_get_monotonic_ns();
+    uint64_t deadline;
+    UT_TestFunction_t pFunction;
+
+    pFunction = start_wrapped_test( now, &deadline, condition, sizeof(condition) );
+    if ( pFunction == NULL )
+    {
+        return;
+    }
+    UT_isolation_run( gIsolation, CU_get_current_test(), CU_get_current_suite(), pFunction, (deadline == UINT64_MAX) ? 0 : deadline - now, condition );
+}
+
+static void releaseBindings( void )
+{
+    free( gpTimeoutBindings );
+    gpTimeoutBindings = NULL;
+    gTimeoutBindingCount = 0;
+
+    while ( gpBindings != NULL )
+    {
+        UT_test_binding_t *pNext = gpBindings->pNext;
+
+        free( gpBindings );
+        gpBindings = pNext;
+    }
+
+    while ( gpParamBindings != NULL )
+    {
+        UT_param_binding_t *pNext = gpParamBindings->pNext;
+
+        free( gpParamBindings );
+        gpParamBindings = pNext;
+    }
+    gpParamTail = NULL;
+    gpParamCursor = NULL;
+}
+
+/**
+ * @brief Hashes a suite name, FNV-1a
+ *
+ * @param pTitle - suite name
+ * @return unsigned int - hash of the name
+ */
+static unsigned int hashSuiteName( const char *pTitle )
+{
+    unsigned int hash = 2166136261u;
+
+    while ( *pTitle != '\0' )
+    {
+        hash ^= (unsigned char)*pTitle++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Finds a registered suite by name
+ *
+ * A bucket chains its suites most recently registered first, so the last match is the first
+ * suite registered with the name.
+ *
+ * @param pTitle - suite name
+ * @return UT_test_group_t* - the suite, NULL if not registered
+ */
+static UT_test_group_t *findGroup( const char *pTitle )
+{
+    UT_test_group_t *pFound = NULL;
+
+    if ( (pTitle == NULL) || (group_list.count == 0) )
+    {
+        return NULL;
+    }
+
+    for (int i = group_list.buckets[hashSuiteName( pTitle ) & (group_list.capacity - 1)]; i >= 0; i = group_list.groups[i].nextInBucket)
+    {
+        if ( strcmp( group_list.groups[i].pSuite->pName, pTitle ) == 0 )
+        {
+            pFound = &group_list.groups[i];
+        }
+    }
+    return pFound;
+}
+
+/**
+ * @brief Finds the group of a registered suite, suites sharing a name each have their own
+ *
+ * @param pSuite - the suite
+ * @return UT_test_group_t* - its group, NULL if not registered through UT_add_suite()
+ */
+static UT_test_group_t *findSuiteGroup( CU_pSuite pSuite )
+{
+    if ( (pSuite == NULL) || (group_list.count == 0) )
+    {
+        return NULL;
+    }
+
+    for (int i = group_list.buckets[hashSuiteName( pSuite->pName ) & (group_list.capacity - 1)]; i >= 0; i = group_list.groups[i].nextInBucket)
+    {
+        if ( group_list.groups[i].pSuite == pSuite )
+        {
+            return &group_list.groups[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Doubles the capacity of the group list
+ *
+ * The groups are moved to a new arena and the name hash buckets rebuilt, the group ID chains
+ * are indices so they carry over unchanged.
+ *
+ * @return bool - true on success, false if the arena could not be allocated
+ */
+static bool growGroups( void )
+{
+    int capacity = (group_list.capacity == 0) ? UT_GROUP_LIST_INITIAL_CAPACITY : (group_list.capacity * 2);
+    UT_test_group_t *groups;
+    int *buckets;
+
+    groups = (UT_test_group_t *)malloc( capacity * (sizeof(UT_test_group_t) + sizeof(int)) );
+    if ( groups == NULL )
+    {
+        UT_LOG_ERROR("Failed to grow the suite list to [%d] suites\n", capacity);
+        return false;
+    }
+    buckets = (int *)&groups[capacity];
+    memset( buckets, 0xff, capacity * sizeof(int) );
+
+    if ( group_list.capacity == 0 )
+    {
+        memset( group_list.groupHead, 0xff, sizeof(group_list.groupHead) );
+        memset( group_list.groupTail, 0xff, sizeof(group_list.groupTail) );
+    }
+
+    for (int i = 0; i < group_list.count; ++i)
+    {
+        int *pBucket = &buckets[hashSuiteName( group_list.groups[i].pSuite->pName ) & (capacity - 1)];
+
+        groups[i] = group_list.groups[i];
+        groups[i].nextInBucket = *pBucket;
+        *pBucket = i;
+    }
+
+    free( group_list.groups );
+    group_list.groups = groups;
+    group_list.buckets = buckets;
+    group_list.capacity = capacity;
+    return true;
+}
+
+static void releaseGroups( void )
+{
+    free( group_list.groups );
+    memset( &group_list, 0, sizeof(group_list) );
 }
 
 
@@ -59,5 +59,25 @@ extern const char *UT_automated_package_name_get();
 extern void UT_automated_package_name_set(const char *pName);
 extern void UT_automated_enable_junit_xml(CU_BOOL bFlag);
 
+extern const char *UT_automated_results_filename_get(void);
+extern void UT_automated_results_filename_set(const char *szFilename);
+extern void UT_automated_add_property(const char *szName, const char *szValue);
+/* NULL entries of ppFilenames are skipped, each of ppLostTests is written as a failed testcase of the
+ * suite in ppLostSuites at the same index, the tests of a suite are consecutive and share its name pointer */
+extern CU_ErrorCode UT_automated_merge_results(const char **ppFilenames, int count,
+                                               const char **ppLostSuites, const char **ppLostTests, int lostCount,
+                                               const char *szLostReason, CU_pRunSummary pRunSummary);
+extern void UT_automated_set_spliced_results(const char **ppBlocks, int count);
+
+/* Feed the --trace file and the stress records from the test start and complete handlers of every mode */
+extern void UT_cunit_test_start(const CU_pTest pTest, const CU_pSuite pSuite);
+/* First thing in the complete handlers, ahead of the test properties being written */
+extern void UT_cunit_test_body_end(const CU_pTest pTest, const CU_pSuite pSuite);
+extern void UT_cunit_test_complete(const CU_pTest pTest, const CU_pSuite pSuite, const CU_pFailureRecord pFailure);
+/* From the suite start handlers of every mode, called for inactive suites too, see skipSuite() */
+extern void UT_cunit_suite_start(const CU_pSuite pSuite);
+/* Ends the suite in the --trace file, the all tests complete handlers still end it for a single test run */
+extern void UT_cunit_suite_complete(const CU_pSuite pSuite);
+
 #endif  /*  __UT_CUNIT_INTERNAL_H  */
 /** @} */
\ No newline at end of file
@@ -0,0 +1,611 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* pipe2() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* stdlib */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#define UT_ISOLATION_BACKTRACE
+#endif
+
+#include <CUnit.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_isolation.h"
+#include "ut_log_async.h"
+#include "ut_fixture.h"
+
+#define UT_ISOLATION_MAX_FRAMES     (32)        /*!< Frames written in a crash backtrace */
+#define UT_ISOLATION_MAX_RETIRED    (64)        /*!< Exited workers waiting to be reaped */
+#define UT_ISOLATION_CRASH_WAIT_MS  (1000)      /*!< Time a crashed worker has to finish its backtrace */
+#define UT_ISOLATION_CONDITION_SIZE (4096)      /*!< Size of a crash failure condition */
+
+#define UT_ISOLATION_RESULT 'R'     /*!< Result message, counts then the failure records */
+#define UT_ISOLATION_CRASH  'C'     /*!< Crash message, backtrace text up to the end of the pipe */
+
+/** A forked worker, it reads tests from commandFd and writes their results to resultFd */
+typedef struct
+{
+    pid_t pid;              /*!< -1 when there is no worker */
+    int commandFd;
+    int resultFd;
+    CU_pSuite pSuite;       /*!< Suite the worker was forked in, after its set up */
+} UT_isolation_worker_t;
+
+/** A test handed to a worker, the pointers are valid in the worker as it is a copy of the parent */
+typedef struct
+{
+    CU_pTest pTest;
+    UT_TestFunction_t pFunction;
+} UT_isolation_command_t;
+
+/** Header of a result message, followed by failures records */
+typedef struct
+{
+    uint32_t asserts;
+    uint32_t failures;
+} UT_isolation_result_t;
+
+/** Header of a failure record, followed by the file and condition, without terminators */
+typedef struct
+{
+    uint32_t line;
+    uint32_t fileLength;
+    uint32_t conditionLength;
+} UT_isolation_failure_t;
+
+static UT_isolation_worker_t gCurrent = { -1, -1, -1, NULL };
+static UT_isolation_worker_t gSpare = { -1, -1, -1, NULL };
+static pid_t gRetired[UT_ISOLATION_MAX_RETIRED];
+static int gRetiredCount = 0;
+
+/* Worker side */
+static int gWorkerResultFd = -1;
+static char gAlternateStack[64 * 1024];     /*!< The crash handler runs here, a stack overflow leaves no stack */
+
+static uint64_t now_ms( void )
+{
+    return UT_get_monotonic_ns() / 1000000ull;
+}
+
+static bool write_all( int fd, const void *pData, size_t length )
+{
+    const char *pBytes = (const char *)pData;
+
+    while ( length > 0 )
+    {
+        ssize_t written = write( fd, pBytes, length );
+
+        if ( written < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            return false;
+        }
+        pBytes += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads exactly length bytes before the deadline
+ *
+ * @param deadlineMs - monotonic deadline in milliseconds, 0 for none
+ * @return int - 1 on success, 0 if the pipe ended, -1 on timeout
+ */
+static int read_all( int fd, void *pData, size_t length, uint64_t deadlineMs )
+{
+    char *pBytes = (char *)pData;
+
+    while ( length > 0 )
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int timeout = -1;
+        ssize_t got;
+
+        if ( deadlineMs != 0 )
+        {
+            uint64_t now = now_ms();
+
+            timeout = (now >= deadlineMs) ? 0 : (int)(deadlineMs - now);
+        }
+        if ( poll( &pfd, 1, timeout ) == 0 )
+        {
+            return -1;
+        }
+
+        got = read( fd, pBytes, length );
+        if ( got < 0 )
+        {
+            if ( (errno == EINTR) || (errno == EAGAIN) )
+            {
+                continue;
+            }
+            return 0;
+        }
+        if ( got == 0 )
+        {
+            return 0;
+        }
+        pBytes += got;
+        length -= (size_t)got;
+    }
+    return 1;
+}
+
+/**
+ * @brief Writes the crash and its backtrace to the parent, then lets the signal take the worker down
+ */
+static void worker_crash_handler( int sig )
+{
+    char marker = UT_ISOLATION_CRASH;
+
+    write_all( gWorkerResultFd, &marker, 1 );
+#ifdef UT_ISOLATION_BACKTRACE
+    {
+        void *frames[UT_ISOLATION_MAX_FRAMES];
+        int count = backtrace( frames, UT_ISOLATION_MAX_FRAMES );
+
+        backtrace_symbols_fd( frames, count, gWorkerResultFd );
+    }
+#endif
+    close( gWorkerResultFd );
+    raise( sig );
+}
+
+static void worker_install_crash_handlers( void )
+{
+    static const int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGSYS };
+    struct sigaction action;
+    stack_t stack;
+
+#ifdef UT_ISOLATION_BACKTRACE
+    {
+        /* The first backtrace() loads the unwinder, which is not safe from a signal handler */
+        void *frame;
+
+        backtrace( &frame, 1 );
+    }
+#endif
+
+    stack.ss_sp = gAlternateStack;
+    stack.ss_size = sizeof(gAlternateStack);
+    stack.ss_flags = 0;
+    sigaltstack( &stack, NULL );
+
+    memset( &action, 0, sizeof(action) );
+    action.sa_handler = worker_crash_handler;
+    action.sa_flags = SA_ONSTACK | SA_RESETHAND | SA_NODEFER;
+    sigemptyset( &action.sa_mask );
+    for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++)
+    {
+        sigaction( signals[i], &action, NULL );
+    }
+}
+
+/**
+ * @brief Runs one test body, with the worker's own jump buffer, and sends its results
+ *
+ * A fatal assertion jumps back here instead of into the parent's copy of the CUnit run loop.
+ */
+static bool worker_run( const UT_isolation_command_t *pCommand )
+{
+    CU_pRunSummary pRunSummary = CU_get_run_summary();
+    unsigned int assertsBefore = pRunSummary->nAsserts;
+    unsigned int recordsBefore = CU_get_number_of_failure_records();
+    UT_isolation_result_t result;
+    CU_pFailureRecord pRecord;
+    jmp_buf jumpBuffer;
+    char marker = UT_ISOLATION_RESULT;
+    bool bSent;
+
+    /* A spare was forked during an earlier test, which is still CUnit's current test in this copy */
+    CU_pTest pCurrent = CU_get_current_test();
+
+    if ( pCurrent == NULL )
+    {
+        pCurrent = pCommand->pTest;
+    }
+    pCurrent->pJumpBuf = &jumpBuffer;
+    if ( setjmp( jumpBuffer ) == 0 )
+    {
+        pCommand->pFunction();
+    }
+    pCurrent->pJumpBuf = NULL;
+
+    /* The test's output is out before its result, so the parent's next lines follow it */
+    UT_log_async_flush();
+    fflush( NULL );
+
+    pRecord = CU_get_failure_list();
+    for (unsigned int i = 0; (i < recordsBefore) && (pRecord != NULL); i++)
+    {
+        pRecord = pRecord->pNext;
+    }
+    result.asserts = pRunSummary->nAsserts - assertsBefore;
+    result.failures = CU_get_number_of_failure_records() - recordsBefore;
+
+    bSent = write_all( gWorkerResultFd, &marker, 1 ) && write_all( gWorkerResultFd, &result, sizeof(result) );
+    for (; bSent && (pRecord != NULL); pRecord = pRecord->pNext)
+    {
+        const char *pFile = (pRecord->strFileName != NULL) ? pRecord->strFileName : "";
+        const char *pCondition = (pRecord->strCondition != NULL) ? pRecord->strCondition : "";
+        UT_isolation_failure_t failure = { pRecord->uiLineNumber, (uint32_t)strlen( pFile ), (uint32_t)strlen( pCondition ) };
+
+        bSent = write_all( gWorkerResultFd, &failure, sizeof(failure) ) &&
+                write_all( gWorkerResultFd, pFile, failure.fileLength ) &&
+                write_all( gWorkerResultFd, pCondition, failure.conditionLength );
+    }
+    return bSent;
+}
+
+/**
+ * @brief Body of a worker, runs the tests it is sent until the parent closes the command pipe
+ */
+static void worker_main( UT_isolation_t isolation, int commandFd )
+{
+    UT_isolation_command_t command;
+
+    worker_install_crash_handlers();
+    while ( read_all( commandFd, &command, sizeof(command), 0 ) == 1 )
+    {
+        if ( (worker_run( &command ) == false) || (isolation == UT_ISOLATION_TEST) )
+        {
+            break;
+        }
+    }
+    UT_fixture_run_end();
+    UT_log_async_flush();
+    fflush( NULL );
+    _exit( 0 );
+}
+
+static void close_worker_fds( UT_isolation_worker_t *pWorker )
+{
+    if ( pWorker->commandFd >= 0 )
+    {
+        close( pWorker->commandFd );
+    }
+    if ( pWorker->resultFd >= 0 )
+    {
+        close( pWorker->resultFd );
+    }
+    pWorker->pid = -1;
+    pWorker->commandFd = -1;
+    pWorker->resultFd = -1;
+    pWorker->pSuite = NULL;
+}
+
+/**
+ * @brief Reaps the retired workers, waiting for them when bWait is set
+ */
+static void reap_retired( bool bWait )
+{
+    int kept = 0;
+
+    for (int i = 0; i < gRetiredCount; i++)
+    {
+        if ( waitpid( gRetired[i], NULL, bWait ? 0 : WNOHANG ) == 0 )
+        {
+            gRetired[kept++] = gRetired[i];
+        }
+    }
+    gRetiredCount = kept;
+}
+
+/**
+ * @brief Closes a worker's pipes, the worker exits once it reads the end of its commands
+ */
+static void retire_worker( UT_isolation_worker_t *pWorker )
+{
+    if ( pWorker->pid < 0 )
+    {
+        return;
+    }
+    if ( gRetiredCount == UT_ISOLATION_MAX_RETIRED )
+    {
+        waitpid( gRetired[0], NULL, 0 );
+        memmove( &gRetired[0], &gRetired[1], (UT_ISOLATION_MAX_RETIRED - 1) * sizeof(pid_t) );
+        gRetiredCount--;
+    }
+    gRetired[gRetiredCount++] = pWorker->pid;
+    close_worker_fds( pWorker );
+}
+
+/**
+ * @brief Forks a worker for a suite, the worker waits for its first test
+ *
+ * @return bool - true if the worker was started
+ */
+static bool spawn_worker( UT_isolation_worker_t *pWorker, UT_isolation_t isolation, CU_pSuite pSuite )
+{
+    static bool bPipeIgnored = false;
+    int commandPipe[2];
+    int resultPipe[2];
+    pid_t pid;
+
+    /* A worker that died leaves a broken command pipe, which is reported as a crash rather than a SIGPIPE */
+    if ( bPipeIgnored == false )
+    {
+        signal( SIGPIPE, SIG_IGN );
+        bPipeIgnored = true;
+    }
+
+    if ( pipe2( commandPipe, O_CLOEXEC ) != 0 )
+    {
+        return false;
+    }
+    if ( pipe2( resultPipe, O_CLOEXEC ) != 0 )
+    {
+        close( commandPipe[0] );
+        close( commandPipe[1] );
+        return false;
+    }
+
+    /* Buffered output would otherwise be written by the parent and again by the worker */
+    UT_log_async_flush();
+    fflush( NULL );
+
+    pid = fork();
+    if ( pid < 0 )
+    {
+        close( commandPipe[0] );
+        close( commandPipe[1] );
+        close( resultPipe[0] );
+        close( resultPipe[1] );
+        return false;
+    }
+
+    if ( pid == 0 )
+    {
+        close( commandPipe[1] );
+        close( resultPipe[0] );
+        close_worker_fds( &gCurrent );
+        close_worker_fds( &gSpare );
+        signal( SIGPIPE, SIG_DFL );
+        gWorkerResultFd = resultPipe[1];
+        worker_main( isolation, commandPipe[0] );
+    }
+
+    close( commandPipe[0] );
+    close( resultPipe[1] );
+    pWorker->pid = pid;
+    pWorker->commandFd = commandPipe[1];
+    pWorker->resultFd = resultPipe[0];
+    pWorker->pSuite = pSuite;
+    return true;
+}
+
+/**
+ * @brief Records how a worker ended, it has sent a crash marker, closed its pipe or was killed
+ */
+static void record_worker_death( UT_isolation_worker_t *pWorker, CU_pTest pTest, bool bCrashMarker )
+{
+    char condition[UT_ISOLATION_CONDITION_SIZE];
+    char backtraceText[UT_ISOLATION_CONDITION_SIZE];
+    size_t backtraceLength = 0;
+    uint64_t deadline = now_ms() + UT_ISOLATION_CRASH_WAIT_MS;
+    size_t length;
+    int status = 0;
+
+    /* Give a crashing worker the time to write its backtrace, it ends at the end of the pipe */
+    while ( bCrashMarker && (backtraceLength < sizeof(backtraceText) - 1) )
+    {
+        if ( read_all( pWorker->resultFd, &backtraceText[backtraceLength], 1, deadline ) != 1 )
+        {
+            break;
+        }
+        backtraceLength++;
+    }
+    backtraceText[backtraceLength] = '\0';
+
+    if ( waitpid( pWorker->pid, &status, WNOHANG ) == 0 )
+    {
+        kill( pWorker->pid, SIGKILL );
+        waitpid( pWorker->pid, &status, 0 );
+    }
+
+    length = (size_t)snprintf( condition, sizeof(condition), "%s: [%s]", bCrashMarker ? "Test crashed" : "Test ended its worker", pTest->pName );
+    if ( WIFSIGNALED( status ) )
+    {
+        length += (size_t)snprintf( &condition[length], sizeof(condition) - length, " signal %d (%s)", WTERMSIG( status ), strsignal( WTERMSIG( status ) ) );
+    }
+    else if ( WIFEXITED( status ) )
+    {
+        length += (size_t)snprintf( &condition[length], sizeof(condition) - length, " exited with code %d", WEXITSTATUS( status ) );
+    }
+    if ( (backtraceLength > 0) && (length < sizeof(condition)) )
+    {
+        snprintf( &condition[length], sizeof(condition) - length, "\n%s", backtraceText );
+    }
+
+    UT_LOG_ERROR( "%s\n", condition );
+    CU_assertImplementation( CU_FALSE, 0, condition, "isolation", "", CU_FALSE );
+    close_worker_fds( pWorker );
+}
+
+/**
+ * @brief Reads the results of a test and replays them into CUnit
+ *
+ * @return int - 1 if the worker sent its results, 0 if it ended, -1 if the deadline passed
+ */
+static int collect_result( UT_isolation_worker_t *pWorker, uint64_t deadlineMs, bool *pbCrashMarker )
+{
+    UT_isolation_result_t result;
+    char marker;
+    int status;
+
+    *pbCrashMarker = false;
+    status = read_all( pWorker->resultFd, &marker, 1, deadlineMs );
+    if ( status != 1 )
+    {
+        return status;
+    }
+    if ( marker != UT_ISOLATION_RESULT )
+    {
+        *pbCrashMarker = ( marker == UT_ISOLATION_CRASH );
+        return 0;
+    }
+
+    status = read_all( pWorker->resultFd, &result, sizeof(result), deadlineMs );
+    if ( status != 1 )
+    {
+        return status;
+    }
+
+    for (uint32_t i = result.failures; i < result.asserts; i++)
+    {
+        CU_assertImplementation( CU_TRUE, 0, "", "", "", CU_FALSE );
+    }
+    for (uint32_t i = 0; i < result.failures; i++)
+    {
+        UT_isolation_failure_t failure;
+        char *pText;
+
+        status = read_all( pWorker->resultFd, &failure, sizeof(failure), deadlineMs );
+        if ( status != 1 )
+        {
+            return status;
+        }
+
+        pText = (char *)malloc( (size_t)failure.fileLength + failure.conditionLength + 2 );
+        if ( pText == NULL )
+        {
+            UT_LOG_ERROR( "Failed to allocate a failure record of the worker, its remaining results are lost\n" );
+            return 0;
+        }
+        status = read_all( pWorker->resultFd, pText, (size_t)failure.fileLength + failure.conditionLength, deadlineMs );
+        if ( status == 1 )
+        {
+            /* The file and condition arrive back to back, split them into two strings */
+            memmove( &pText[failure.fileLength + 1], &pText[failure.fileLength], failure.conditionLength );
+            pText[failure.fileLength] = '\0';
+            pText[failure.fileLength + 1 + failure.conditionLength] = '\0';
+            CU_assertImplementation( CU_FALSE, failure.line, &pText[failure.fileLength + 1], pText, "", CU_FALSE );
+        }
+        free( pText );
+        if ( status != 1 )
+        {
+            return status;
+        }
+    }
+    return 1;
+}
+
+void UT_isolation_run(UT_isolation_t isolation, CU_pTest pTest, CU_pSuite pSuite, UT_TestFunction_t pFunction, uint64_t timeoutNs, const char *pTimeoutReason)
+{
+    UT_isolation_command_t command = { pTest, pFunction };
+    uint64_t deadlineMs = 0;
+    bool bCrashMarker = false;
+    int status;
+
+    reap_retired( false );
+
+    if ( (gCurrent.pid >= 0) && (gCurrent.pSuite != pSuite) )
+    {
+        retire_worker( &gCurrent );
+    }
+    if ( (gSpare.pid >= 0) && (gSpare.pSuite != pSuite) )
+    {
+        retire_worker( &gSpare );
+    }
+
+    if ( gCurrent.pid < 0 )
+    {
+        if ( gSpare.pid >= 0 )
+        {
+            gCurrent = gSpare;
+            gSpare.pid = -1;
+            gSpare.commandFd = -1;
+            gSpare.resultFd = -1;
+            gSpare.pSuite = NULL;
+        }
+        else if ( spawn_worker( &gCurrent, isolation, pSuite ) == false )
+        {
+            UT_LOG_WARNING( "Failed to fork a worker for [%s]: %s, running it in process\n", pTest->pName, strerror( errno ) );
+            pFunction();
+            return;
+        }
+    }
+
+    if ( timeoutNs > 0 )
+    {
+        deadlineMs = now_ms() + (timeoutNs + 999999ull) / 1000000ull;
+    }
+
+    if ( write_all( gCurrent.commandFd, &command, sizeof(command) ) )
+    {
+        /* The next worker is forked while this test runs */
+        if ( (isolation == UT_ISOLATION_TEST) && (gSpare.pid < 0) )
+        {
+            spawn_worker( &gSpare, isolation, pSuite );
+        }
+        status = collect_result( &gCurrent, deadlineMs, &bCrashMarker );
+    }
+    else
+    {
+        status = 0;
+    }
+
+    if ( status < 0 )
+    {
+        UT_LOG_ERROR( "%s\n", pTimeoutReason );
+        kill( gCurrent.pid, SIGKILL );
+        waitpid( gCurrent.pid, NULL, 0 );
+        close_worker_fds( &gCurrent );
+        CU_assertImplementation( CU_FALSE, 0, pTimeoutReason, "watchdog", "", CU_FALSE );
+    }
+    else if ( status == 0 )
+    {
+        record_worker_death( &gCurrent, pTest, bCrashMarker );
+    }
+    else if ( isolation == UT_ISOLATION_TEST )
+    {
+        retire_worker( &gCurrent );
+    }
+}
+
+void UT_isolation_stop(void)
+{
+    retire_worker( &gCurrent );
+    retire_worker( &gSpare );
+    reap_retired( true );
+}
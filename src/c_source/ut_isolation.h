@@ -0,0 +1,66 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT_CUNIT
+ * @{
+ */
+
+/** @brief Process isolated tests
+ *
+ * Test bodies run in forked worker processes while CUnit, its handlers and the results file stay in
+ * the parent. A worker runs the body under its own jump buffer and sends the assertion count and the
+ * failure records back over a pipe, which the parent replays into CUnit. A worker that dies with a
+ * signal or exits, or misses the timeout, is recorded as a failure of the test it was running,
+ * with the signal, the exit code and, where the C library has backtrace(), the stack of the crash.
+ *
+ * Workers are forked ahead of need (a zygote): with UT_ISOLATION_TEST a spare is forked while each test
+ * runs, once the suite is set up, so handing the next test out costs a pipe write rather than a fork.
+ */
+
+#ifndef __UT_ISOLATION_H
+#define __UT_ISOLATION_H
+
+#include <stdint.h>
+#include <CUnit.h>
+
+#include <ut.h>
+#include "ut_internal.h"
+
+/**
+ * @brief Runs a test body in a worker process and records its results against the running test
+ *
+ * Called from the test function CUnit runs, in the parent. Falls back to running the body in
+ * process if a worker cannot be forked.
+ *
+ * @param isolation - UT_ISOLATION_TEST for a fresh worker per test, UT_ISOLATION_SUITE to keep one per suite
+ * @param pTest - the running test
+ * @param pSuite - the suite of the running test
+ * @param pFunction - the test body
+ * @param timeoutNs - time the body may run before its worker is killed, 0 for no limit
+ * @param pTimeoutReason - failure condition recorded on timeout
+ */
+extern void UT_isolation_run(UT_isolation_t isolation, CU_pTest pTest, CU_pSuite pSuite, UT_TestFunction_t pFunction, uint64_t timeoutNs, const char *pTimeoutReason);
+
+/**
+ * @brief Stops every worker and reaps them, called once the tests have run
+ */
+extern void UT_isolation_stop(void);
+
+#endif  /*  __UT_ISOLATION_H  */
+/** @} */
@@ -0,0 +1,499 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* dl_iterate_phdr() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* stdlib */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <link.h>
+
+#include <ut_log.h>
+#include "ut_result_cache.h"
+
+#define UT_RESULT_CACHE_MAGIC       "ut-core-result-cache 1"   /*!< First line of the cache file, followed by the key */
+#define UT_RESULT_CACHE_READ_SIZE   (64 * 1024)                /*!< Read size used when hashing files */
+#define UT_RESULT_CACHE_SUITE_START "  <testsuite "
+#define UT_RESULT_CACHE_SUITE_END   "    </testsuite>\n"
+#define UT_RESULT_CACHE_CLEANUP     "    <testsuite name=\"Suite Cleanup\">"
+
+#define FNV_OFFSET_BASIS (0xcbf29ce484222325ull)
+#define FNV_PRIME        (0x100000001b3ull)
+
+typedef struct
+{
+    char *pName;        /*!< Suite name, XML escaped as in the results file */
+    char *pBlock;       /*!< The complete testsuite block */
+} UT_cached_suite_t;
+
+static struct
+{
+    uint64_t key;
+    bool bUseCached;
+    char *pCacheFile;
+    UT_cached_suite_t *pSuites;
+    int count;
+    int capacity;
+} gCache;
+
+static uint64_t hashBytes( uint64_t hash, const void *pData, size_t length )
+{
+    const unsigned char *pByte = (const unsigned char *)pData;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= pByte[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hashes the contents of a file, or only its name if it cannot be read
+ */
+static uint64_t hashFile( uint64_t hash, const char *pFilename )
+{
+    char *pBuffer;
+    ssize_t length;
+    int fd;
+
+    hash = hashBytes( hash, pFilename, strlen(pFilename) + 1 );
+
+    fd = open( pFilename, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return hash;
+    }
+    pBuffer = (char *)malloc( UT_RESULT_CACHE_READ_SIZE );
+    if ( pBuffer != NULL )
+    {
+        while ( (length = read( fd, pBuffer, UT_RESULT_CACHE_READ_SIZE )) > 0 )
+        {
+            hash = hashBytes( hash, pBuffer, (size_t)length );
+        }
+        free( pBuffer );
+    }
+    close( fd );
+    return hash;
+}
+
+static int hashLoadedObject( struct dl_phdr_info *pInfo, size_t size, void *pData )
+{
+    (void)size;
+
+    /* The main program has no name, it is hashed through /proc/self/exe */
+    if ( (pInfo->dlpi_name != NULL) && (pInfo->dlpi_name[0] != '\0') )
+    {
+        *(uint64_t *)pData = hashFile( *(uint64_t *)pData, pInfo->dlpi_name );
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads a whole file into a NUL terminated buffer
+ *
+ * @return char* - the contents, to be freed by the caller, NULL on failure
+ */
+static char *readFile( const char *pFilename )
+{
+    char *pData = NULL;
+    long length;
+    FILE *pFile = fopen( pFilename, "r" );
+
+    if ( pFile == NULL )
+    {
+        return NULL;
+    }
+    if ( (fseek( pFile, 0, SEEK_END ) == 0) && ((length = ftell( pFile )) >= 0) && (fseek( pFile, 0, SEEK_SET ) == 0) )
+    {
+        pData = (char *)malloc( (size_t)length + 1 );
+        if ( (pData != NULL) && (fread( pData, 1, (size_t)length, pFile ) != (size_t)length) )
+        {
+            free( pData );
+            pData = NULL;
+        }
+        else if ( pData != NULL )
+        {
+            pData[length] = '\0';
+        }
+    }
+    fclose( pFile );
+    return pData;
+}
+
+static char *copyString( const char *pStart, size_t length )
+{
+    char *pCopy = (char *)malloc( length + 1 );
+
+    if ( pCopy != NULL )
+    {
+        memcpy( pCopy, pStart, length );
+        pCopy[length] = '\0';
+    }
+    return pCopy;
+}
+
+/**
+ * @brief Copies the name attribute of the element starting at pElement
+ *
+ * @return char* - the name, still escaped, NULL if not found
+ */
+static char *getNameAttribute( const char *pElement )
+{
+    const char *pLineEnd = strchr( pElement, '\n' );
+    const char *pName = strstr( pElement, " name=\"" );
+    const char *pEnd;
+
+    if ( (pName == NULL) || ((pLineEnd != NULL) && (pName > pLineEnd)) )
+    {
+        return NULL;
+    }
+    pName += strlen(" name=\"");
+    pEnd = strchr( pName, '"' );
+    if ( pEnd == NULL )
+    {
+        return NULL;
+    }
+    return copyString( pName, (size_t)(pEnd - pName) );
+}
+
+/**
+ * @brief Finds the next testsuite block
+ *
+ * @param pData - where to start looking
+ * @param ppEnd - set to the end of the block
+ * @return const char* - start of the block, NULL when there are no more
+ */
+static const char *nextSuiteBlock( const char *pData, const char **ppEnd )
+{
+    const char *pStart = pData;
+    const char *pEnd;
+
+    while ( (pStart = strstr( pStart, UT_RESULT_CACHE_SUITE_START )) != NULL )
+    {
+        if ( (pStart == pData) || (pStart[-1] == '\n') )
+        {
+            break;
+        }
+        pStart++;
+    }
+    if ( pStart == NULL )
+    {
+        return NULL;
+    }
+    pEnd = strstr( pStart, UT_RESULT_CACHE_SUITE_END );
+    if ( pEnd == NULL )
+    {
+        return NULL;
+    }
+    *ppEnd = pEnd + strlen(UT_RESULT_CACHE_SUITE_END);
+    return pStart;
+}
+
+static bool containsBefore( const char *pStart, const char *pEnd, const char *pNeedle )
+{
+    const char *pFound = strstr( pStart, pNeedle );
+
+    return (pFound != NULL) && (pFound < pEnd);
+}
+
+/**
+ * @brief Counts the testsuite blocks of a suite
+ *
+ * A suite whose parameterized cases were split across workers has a block per worker.
+ */
+static int countSuiteBlocks( const char *pData, const char *pName )
+{
+    const char *pBlock;
+    const char *pEnd;
+    int count = 0;
+
+    for (pBlock = pData; (pBlock = nextSuiteBlock( pBlock, &pEnd )) != NULL; pBlock = pEnd)
+    {
+        char *pBlockName = getNameAttribute( pBlock );
+
+        if ( (pBlockName != NULL) && (strcmp( pBlockName, pName ) == 0) )
+        {
+            count++;
+        }
+        free( pBlockName );
+    }
+    return count;
+}
+
+static void addSuite( char *pName, char *pBlock )
+{
+    if ( gCache.count == gCache.capacity )
+    {
+        int capacity = (gCache.capacity == 0) ? 64 : gCache.capacity * 2;
+        UT_cached_suite_t *pSuites = (UT_cached_suite_t *)realloc( gCache.pSuites, capacity * sizeof(UT_cached_suite_t) );
+
+        if ( pSuites == NULL )
+        {
+            free( pName );
+            free( pBlock );
+            return;
+        }
+        gCache.pSuites = pSuites;
+        gCache.capacity = capacity;
+    }
+    gCache.pSuites[gCache.count].pName = pName;
+    gCache.pSuites[gCache.count].pBlock = pBlock;
+    gCache.count++;
+}
+
+/**
+ * @brief Escapes a suite name the way the results file does
+ *
+ * @return bool - false if the escaped name did not fit and was truncated
+ */
+static bool escapeName( const char *pName, char *pEscaped, size_t size )
+{
+    size_t used = 0;
+
+    for (; (*pName != '\0') && (used + 7 < size); pName++)
+    {
+        const char *pEntity = NULL;
+
+        switch ( *pName )
+        {
+            case '&': pEntity = "&amp;"; break;
+            case '>': pEntity = "&gt;"; break;
+            case '<': pEntity = "&lt;"; break;
+            case '"': pEntity = "&quot;"; break;
+            default: pEscaped[used++] = *pName; break;
+        }
+        if ( pEntity != NULL )
+        {
+            memcpy( &pEscaped[used], pEntity, strlen(pEntity) );
+            used += strlen(pEntity);
+        }
+    }
+    pEscaped[used] = '\0';
+    return (*pName == '\0');
+}
+
+int UT_result_cache_open( const char *pCacheFile, const char *pProfileFiles, const char *pOptions, bool bUseCached )
+{
+    char expected[64];
+    char *pData;
+    const char *pBlock;
+    const char *pEnd;
+
+    UT_result_cache_close();
+    gCache.bUseCached = bUseCached;
+    gCache.pCacheFile = copyString( pCacheFile, strlen(pCacheFile) );
+
+    gCache.key = hashFile( FNV_OFFSET_BASIS, "/proc/self/exe" );
+    dl_iterate_phdr( hashLoadedObject, &gCache.key );
+    /* Every profile layer can change a result, not only the last one opened */
+    for (const char *pProfile = pProfileFiles; (pProfile != NULL) && (*pProfile != '\0'); )
+    {
+        const char *pComma = strchr( pProfile, ',' );
+        size_t length = (pComma != NULL) ? (size_t)(pComma - pProfile) : strlen( pProfile );
+        char *pFilename = copyString( pProfile, length );
+
+        if ( pFilename != NULL )
+        {
+            gCache.key = hashFile( gCache.key, pFilename );
+            free( pFilename );
+        }
+        pProfile += length + ((pComma != NULL) ? 1 : 0);
+    }
+    /* A suite that passed may not with a timeout, a leak budget or another group enabled */
+    if ( pOptions != NULL )
+    {
+        gCache.key = hashBytes( gCache.key, pOptions, strlen(pOptions) + 1 );
+    }
+
+    if ( bUseCached == false )
+    {
+        UT_LOG( "Result cache: [%s] not used for this run", pCacheFile );
+        return 0;
+    }
+
+    pData = readFile( pCacheFile );
+    if ( pData == NULL )
+    {
+        UT_LOG( "Result cache: [%s] empty", pCacheFile );
+        return 0;
+    }
+
+    snprintf( expected, sizeof(expected), UT_RESULT_CACHE_MAGIC " %016llx\n", (unsigned long long)gCache.key );
+    if ( strncmp( pData, expected, strlen(expected) ) != 0 )
+    {
+        UT_LOG( "Result cache: [%s] is for a different binary, libraries, profile or options", pCacheFile );
+        free( pData );
+        return 0;
+    }
+
+    for (pBlock = pData + strlen(expected); (pBlock = nextSuiteBlock( pBlock, &pEnd )) != NULL; pBlock = pEnd)
+    {
+        char *pName = getNameAttribute( pBlock );
+
+        if ( pName != NULL )
+        {
+            addSuite( pName, copyString( pBlock, (size_t)(pEnd - pBlock) ) );
+        }
+    }
+    free( pData );
+
+    UT_LOG( "Result cache: [%s] [%d] passing suites", pCacheFile, gCache.count );
+    return gCache.count;
+}
+
+const char *UT_result_cache_lookup( const char *pSuiteName )
+{
+    char escaped[1024];
+
+    if ( (gCache.bUseCached == false) || (pSuiteName == NULL) )
+    {
+        return NULL;
+    }
+    if ( escapeName( pSuiteName, escaped, sizeof(escaped) ) == false )
+    {
+        UT_LOG_WARNING( "Result cache: suite name [%.64s...] is too long to look up, running it", pSuiteName );
+        return NULL;
+    }
+    for (int i = 0; i < gCache.count; i++)
+    {
+        if ( (gCache.pSuites[i].pBlock != NULL) && (strcmp( gCache.pSuites[i].pName, escaped ) == 0) )
+        {
+            return gCache.pSuites[i].pBlock;
+        }
+    }
+    return NULL;
+}
+
+int UT_result_cache_store( const char *pResultsFile )
+{
+    char *pData;
+    char *pTempFile;
+    const char *pBlock;
+    const char *pEnd;
+    size_t length;
+    FILE *pFile;
+    int stored = 0;
+    int result = 0;
+
+    if ( gCache.pCacheFile == NULL )
+    {
+        return -1;
+    }
+
+    pData = readFile( pResultsFile );
+    if ( pData == NULL )
+    {
+        UT_LOG_ERROR( "Result cache: failed to read [%s]", pResultsFile );
+        return -1;
+    }
+
+    length = strlen( gCache.pCacheFile ) + 8;
+    pTempFile = (char *)malloc( length );
+    if ( pTempFile == NULL )
+    {
+        free( pData );
+        return -1;
+    }
+    snprintf( pTempFile, length, "%s.tmp", gCache.pCacheFile );
+
+    pFile = fopen( pTempFile, "w" );
+    if ( pFile == NULL )
+    {
+        UT_LOG_ERROR( "Result cache: failed to create [%s]", pTempFile );
+        free( pTempFile );
+        free( pData );
+        return -1;
+    }
+
+    fprintf( pFile, UT_RESULT_CACHE_MAGIC " %016llx\n", (unsigned long long)gCache.key );
+    for (pBlock = pData; (pBlock = nextSuiteBlock( pBlock, &pEnd )) != NULL; pBlock = pEnd)
+    {
+        char *pName;
+        bool bPassed = !containsBefore( pBlock, pEnd, "<failure" ) && !containsBefore( pBlock, pEnd, "<error" );
+
+        /* A suite whose cleanup failed is reported in a separate block after its own */
+        pName = getNameAttribute( pBlock );
+        if ( (pName != NULL) && bPassed )
+        {
+            char cleanup[1200];
+            const char *pCleanup;
+
+            snprintf( cleanup, sizeof(cleanup), UT_RESULT_CACHE_CLEANUP " \n        <testcase name=\"%s\"", pName );
+            pCleanup = strstr( pEnd, cleanup );
+            bPassed = (pCleanup == NULL);
+        }
+        /* Only one block of a suite is spliced back, so a suite split across workers is not cached */
+        if ( bPassed && (pName != NULL) )
+        {
+            bPassed = (countSuiteBlocks( pData, pName ) == 1);
+        }
+        if ( bPassed && (pName != NULL) )
+        {
+            if ( fwrite( pBlock, 1, (size_t)(pEnd - pBlock), pFile ) != (size_t)(pEnd - pBlock) )
+            {
+                result = -1;
+            }
+            stored++;
+        }
+        free( pName );
+    }
+
+    if ( fclose( pFile ) != 0 )
+    {
+        result = -1;
+    }
+    if ( (result == 0) && (rename( pTempFile, gCache.pCacheFile ) != 0) )
+    {
+        result = -1;
+    }
+    if ( result != 0 )
+    {
+        UT_LOG_ERROR( "Result cache: failed to write [%s]", gCache.pCacheFile );
+        remove( pTempFile );
+    }
+    else
+    {
+        UT_LOG( "Result cache: [%s] updated with [%d] passing suites", gCache.pCacheFile, stored );
+    }
+
+    free( pTempFile );
+    free( pData );
+    return result;
+}
+
+void UT_result_cache_close( void )
+{
+    for (int i = 0; i < gCache.count; i++)
+    {
+        free( gCache.pSuites[i].pName );
+        free( gCache.pSuites[i].pBlock );
+    }
+    free( gCache.pSuites );
+    free( gCache.pCacheFile );
+    memset( &gCache, 0, sizeof(gCache) );
+}
@@ -0,0 +1,71 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT_CUNIT
+ * @{
+ */
+
+/** @brief Persistent cache of passing suite results
+ *
+ * The cache holds the JUnit testsuite blocks of the suites that passed, keyed on a hash of the
+ * test binary, every loaded shared object, the profile and the run options. While the key is
+ * unchanged those suites are skipped and their previous blocks are spliced into the results
+ * file instead.
+ */
+
+#ifndef __UT_RESULT_CACHE_H
+#define __UT_RESULT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Computes the cache key and loads the cache file when the key matches
+ *
+ * @param pCacheFile - cache file, need not exist
+ * @param pProfileFiles - comma separated profile files hashed into the key, or NULL
+ * @param pOptions - the run options that can change a result, hashed into the key, or NULL
+ * @param bUseCached - false to ignore the cached results, the cache is still refreshed after the run
+ * @return int - number of cached suites loaded
+ */
+extern int UT_result_cache_open(const char *pCacheFile, const char *pProfileFiles, const char *pOptions, bool bUseCached);
+
+/**
+ * @brief Looks up a suite in the cache
+ *
+ * @param pSuiteName - suite name, as registered
+ * @return const char* - the cached testsuite block, NULL if the suite has to run
+ */
+extern const char *UT_result_cache_lookup(const char *pSuiteName);
+
+/**
+ * @brief Replaces the cache with the passing suites of a results file
+ *
+ * @param pResultsFile - JUnit results file of the completed run, including any spliced blocks
+ * @return int - 0 on success, -1 on failure
+ */
+extern int UT_result_cache_store(const char *pResultsFile);
+
+/**
+ * @brief Releases the loaded cache
+ */
+extern void UT_result_cache_close(void);
+
+#endif  /*  __UT_RESULT_CACHE_H  */
+/** @} */
@@ -0,0 +1,160 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* stdlib */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <CUnit.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_watchdog.h"
+
+#define UT_WATCHDOG_REASON_SIZE (128)
+
+static struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool bStarted;
+    bool bAtFork;                       /*!< Fork handler registered */
+    bool bOverrun;                      /*!< The armed deadline has passed */
+    uint64_t deadlineNs;                /*!< Monotonic deadline, 0 when disarmed */
+    char reason[UT_WATCHDOG_REASON_SIZE];
+} gWatchdog = { PTHREAD_MUTEX_INITIALIZER };
+
+/**
+ * @brief Watchdog thread, reports the overrun once the deadline passes
+ *
+ * The test is not interrupted, the trampoline records the failure once the body returns.
+ */
+static void *watchdog_thread( void *pArg )
+{
+    (void)pArg;
+
+    pthread_mutex_lock( &gWatchdog.mutex );
+    for (;;)
+    {
+        if ( gWatchdog.deadlineNs == 0 )
+        {
+            pthread_cond_wait( &gWatchdog.cond, &gWatchdog.mutex );
+        }
+        else if ( UT_get_monotonic_ns() < gWatchdog.deadlineNs )
+        {
+            struct timespec until;
+
+            until.tv_sec = (time_t)(gWatchdog.deadlineNs / 1000000000ull);
+            until.tv_nsec = (long)(gWatchdog.deadlineNs % 1000000000ull);
+            pthread_cond_timedwait( &gWatchdog.cond, &gWatchdog.mutex, &until );
+        }
+        else
+        {
+            UT_LOG_ERROR( "Watchdog: %s, the test is still running", gWatchdog.reason );
+            gWatchdog.bOverrun = true;
+            gWatchdog.deadlineNs = 0;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief A forked child has no watchdog thread, it is started again on the next arm
+ */
+static void watchdog_atfork_child( void )
+{
+    pthread_mutex_init( &gWatchdog.mutex, NULL );
+    gWatchdog.bStarted = false;
+    gWatchdog.bOverrun = false;
+    gWatchdog.deadlineNs = 0;
+}
+
+/**
+ * @brief Starts the watchdog thread, once
+ *
+ * @return int - 0 on success, -1 on failure
+ */
+static int watchdog_start( void )
+{
+    pthread_condattr_t attr;
+
+    if ( gWatchdog.bStarted == true )
+    {
+        return 0;
+    }
+
+    pthread_condattr_init( &attr );
+    pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+    pthread_cond_init( &gWatchdog.cond, &attr );
+    pthread_condattr_destroy( &attr );
+
+    if ( pthread_create( &gWatchdog.thread, NULL, watchdog_thread, NULL ) != 0 )
+    {
+        pthread_cond_destroy( &gWatchdog.cond );
+        return -1;
+    }
+    pthread_detach( gWatchdog.thread );
+    if ( gWatchdog.bAtFork == false )
+    {
+        pthread_atfork( NULL, NULL, watchdog_atfork_child );
+        gWatchdog.bAtFork = true;
+    }
+    gWatchdog.bStarted = true;
+    return 0;
+}
+
+int UT_watchdog_arm( uint64_t timeoutNs, const char *pReason )
+{
+    if ( watchdog_start() != 0 )
+    {
+        UT_LOG_ERROR( "Watchdog failed to start, overruns are only found once the test returns" );
+        return -1;
+    }
+
+    pthread_mutex_lock( &gWatchdog.mutex );
+    snprintf( gWatchdog.reason, sizeof(gWatchdog.reason), "%s", pReason );
+    gWatchdog.bOverrun = false;
+    gWatchdog.deadlineNs = UT_get_monotonic_ns() + ((timeoutNs > 0) ? timeoutNs : 1);
+    pthread_cond_signal( &gWatchdog.cond );
+    pthread_mutex_unlock( &gWatchdog.mutex );
+    return 0;
+}
+
+bool UT_watchdog_disarm( void )
+{
+    bool bOverrun;
+
+    if ( gWatchdog.bStarted == false )
+    {
+        return false;
+    }
+
+    pthread_mutex_lock( &gWatchdog.mutex );
+    bOverrun = gWatchdog.bOverrun;
+    gWatchdog.bOverrun = false;
+    gWatchdog.deadlineNs = 0;
+    pthread_cond_signal( &gWatchdog.cond );
+    pthread_mutex_unlock( &gWatchdog.mutex );
+    return bOverrun;
+}
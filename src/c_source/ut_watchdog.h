@@ -0,0 +1,55 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT_CUNIT
+ * @{
+ */
+
+/** @brief Watchdog for tests run in process
+ *
+ * The timeouts are normally enforced by running the test bodies in a worker process, which is
+ * killed on overrun, see ut_isolation.h. When the bodies must run in process the watchdog thread
+ * only reports the overrun as the deadline passes, the test is not interrupted. The trampoline
+ * records the failure once the body returns, a body that never returns stalls the run.
+ */
+
+#ifndef __UT_WATCHDOG_H
+#define __UT_WATCHDOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Arms the watchdog for the running test, replacing any earlier deadline
+ *
+ * @param timeoutNs - time allowed from now, in nanoseconds
+ * @param pReason - reported on overrun, copied
+ * @return int - 0 on success, -1 if the watchdog thread could not be started
+ */
+extern int UT_watchdog_arm(uint64_t timeoutNs, const char *pReason);
+
+/**
+ * @brief Disarms the watchdog
+ *
+ * @return bool - true if the deadline passed while it was armed
+ */
+extern bool UT_watchdog_disarm(void);
+
+#endif  /*  __UT_WATCHDOG_H  */
+/** @} */
@@ -0,0 +1,285 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* stdlib */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ut_xml_writer.h"
+
+#define UT_XML_WRITER_BLOCK_SIZE (64 * 1024)   /*!< Initial block size, grows for larger single writes */
+
+struct UT_xml_writer
+{
+    int fd;             /*!< Results file */
+    char *pBlock;       /*!< Pending output */
+    size_t used;        /*!< Bytes pending in pBlock */
+    size_t size;        /*!< Allocated size of pBlock */
+    long flushed;       /*!< Bytes already written to the file */
+    bool bError;        /*!< Set on any allocation, write or sync failure */
+};
+
+static bool gbFsync = false;    /*!< fsync() at each UT_xml_writer_sync() */
+
+/**
+ * @brief Makes room for at least length more bytes in the block
+ *
+ * The block is flushed first, and only grown when a single write is larger than the block.
+ *
+ * @return bool - true if the room is available
+ */
+static bool reserve( UT_xml_writer_t *pWriter, size_t length )
+{
+    char *pBlock;
+    size_t size;
+
+    if ( (pWriter->size - pWriter->used) >= length )
+    {
+        return true;
+    }
+
+    UT_xml_writer_flush( pWriter );
+    if ( (pWriter->size - pWriter->used) >= length )
+    {
+        return true;
+    }
+
+    size = pWriter->size;
+    while ( (size - pWriter->used) < length )
+    {
+        size *= 2;
+    }
+    pBlock = (char *)realloc( pWriter->pBlock, size );
+    if ( pBlock == NULL )
+    {
+        pWriter->bError = true;
+        return false;
+    }
+    pWriter->pBlock = pBlock;
+    pWriter->size = size;
+    return true;
+}
+
+/**
+ * @brief Writes all of a buffer, retrying on short writes and interrupts
+ *
+ * @return int - 0 on success, -1 on failure
+ */
+static int write_all( int fd, const char *pData, size_t length )
+{
+    while ( length > 0 )
+    {
+        ssize_t written = write( fd, pData, length );
+
+        if ( written < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            return -1;
+        }
+        pData += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+UT_xml_writer_t *UT_xml_writer_open( const char *pFilename )
+{
+    UT_xml_writer_t *pWriter;
+
+    pWriter = (UT_xml_writer_t *)calloc( 1, sizeof(UT_xml_writer_t) );
+    if ( pWriter == NULL )
+    {
+        return NULL;
+    }
+
+    pWriter->pBlock = (char *)malloc( UT_XML_WRITER_BLOCK_SIZE );
+    pWriter->size = UT_XML_WRITER_BLOCK_SIZE;
+    pWriter->fd = open( pFilename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+    if ( (pWriter->pBlock == NULL) || (pWriter->fd < 0) )
+    {
+        if ( pWriter->fd >= 0 )
+        {
+            close( pWriter->fd );
+        }
+        free( pWriter->pBlock );
+        free( pWriter );
+        return NULL;
+    }
+
+    return pWriter;
+}
+
+int UT_xml_writer_close( UT_xml_writer_t *pWriter )
+{
+    int result;
+
+    UT_xml_writer_flush( pWriter );
+    if ( close( pWriter->fd ) != 0 )
+    {
+        pWriter->bError = true;
+    }
+
+    result = pWriter->bError ? -1 : 0;
+    free( pWriter->pBlock );
+    free( pWriter );
+    return result;
+}
+
+void UT_xml_writer_printf( UT_xml_writer_t *pWriter, const char *pFormat, ... )
+{
+    va_list args;
+    int length;
+
+    va_start( args, pFormat );
+    length = vsnprintf( &pWriter->pBlock[pWriter->used], pWriter->size - pWriter->used, pFormat, args );
+    va_end( args );
+
+    if ( length < 0 )
+    {
+        pWriter->bError = true;
+        return;
+    }
+
+    /* Didn't fit, make room and format again */
+    if ( (size_t)length >= (pWriter->size - pWriter->used) )
+    {
+        if ( reserve( pWriter, (size_t)length + 1 ) == false )
+        {
+            return;
+        }
+        va_start( args, pFormat );
+        vsnprintf( &pWriter->pBlock[pWriter->used], pWriter->size - pWriter->used, pFormat, args );
+        va_end( args );
+    }
+    pWriter->used += (size_t)length;
+}
+
+void UT_xml_writer_write( UT_xml_writer_t *pWriter, const char *pData, size_t length )
+{
+    if ( reserve( pWriter, length ) == false )
+    {
+        return;
+    }
+    memcpy( &pWriter->pBlock[pWriter->used], pData, length );
+    pWriter->used += length;
+}
+
+void UT_xml_writer_escaped( UT_xml_writer_t *pWriter, const char *pText )
+{
+    if ( pText == NULL )
+    {
+        return;
+    }
+
+    for ( ; *pText != '\0'; pText++ )
+    {
+        const char *pEntity = NULL;
+
+        switch ( *pText )
+        {
+            case '&': pEntity = "&amp;"; break;
+            case '>': pEntity = "&gt;"; break;
+            case '<': pEntity = "&lt;"; break;
+            case '"': pEntity = "&quot;"; break;
+            default: break;
+        }
+
+        if ( pEntity != NULL )
+        {
+            UT_xml_writer_write( pWriter, pEntity, strlen(pEntity) );
+        }
+        else if ( reserve( pWriter, 1 ) == true )
+        {
+            pWriter->pBlock[pWriter->used++] = *pText;
+        }
+    }
+}
+
+long UT_xml_writer_tell( UT_xml_writer_t *pWriter )
+{
+    return pWriter->flushed + (long)pWriter->used;
+}
+
+void UT_xml_writer_patch( UT_xml_writer_t *pWriter, long offset, const char *pData, size_t length )
+{
+    size_t inFile = 0;
+
+    if ( (offset < 0) || ((offset + (long)length) > UT_xml_writer_tell( pWriter )) )
+    {
+        return;
+    }
+
+    /* The part already flushed is patched in the file, the rest in the block */
+    if ( offset < pWriter->flushed )
+    {
+        inFile = (size_t)(pWriter->flushed - offset);
+        if ( inFile > length )
+        {
+            inFile = length;
+        }
+        if ( pwrite( pWriter->fd, pData, inFile, offset ) != (ssize_t)inFile )
+        {
+            pWriter->bError = true;
+        }
+    }
+    if ( inFile < length )
+    {
+        memcpy( &pWriter->pBlock[(offset + (long)inFile) - pWriter->flushed], &pData[inFile], length - inFile );
+    }
+}
+
+int UT_xml_writer_flush( UT_xml_writer_t *pWriter )
+{
+    if ( pWriter->used == 0 )
+    {
+        return pWriter->bError ? -1 : 0;
+    }
+
+    if ( write_all( pWriter->fd, pWriter->pBlock, pWriter->used ) != 0 )
+    {
+        pWriter->bError = true;
+    }
+    pWriter->flushed += (long)pWriter->used;
+    pWriter->used = 0;
+    return pWriter->bError ? -1 : 0;
+}
+
+int UT_xml_writer_sync( UT_xml_writer_t *pWriter )
+{
+    UT_xml_writer_flush( pWriter );
+    if ( (gbFsync == true) && (fsync( pWriter->fd ) != 0) )
+    {
+        pWriter->bError = true;
+    }
+    return pWriter->bError ? -1 : 0;
+}
+
+void UT_xml_writer_set_fsync( bool bEnable )
+{
+    gbFsync = bEnable;
+}
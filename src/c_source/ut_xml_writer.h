@@ -0,0 +1,106 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT_CUNIT
+ * @{
+ */
+
+/** @brief Buffered writer for the automated results file
+ *
+ * Output is collected in one large block and written with a single write() at each flush point,
+ * instead of a small unbuffered write for every fprintf(). XML escaping is done directly into
+ * the block, so no temporary escape buffers are allocated.
+ */
+
+#ifndef __UT_XML_WRITER_H
+#define __UT_XML_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct UT_xml_writer UT_xml_writer_t;  /*!< Opaque writer handle */
+
+/**
+ * @brief Creates the file and a writer for it
+ *
+ * @param pFilename - file to create, truncated if it exists
+ * @return UT_xml_writer_t* - the writer, NULL on failure
+ */
+extern UT_xml_writer_t *UT_xml_writer_open(const char *pFilename);
+
+/**
+ * @brief Flushes, closes the file and releases the writer
+ *
+ * @param pWriter - the writer
+ * @return int - 0 on success, -1 if any write or the close failed
+ */
+extern int UT_xml_writer_close(UT_xml_writer_t *pWriter);
+
+/**
+ * @brief Appends formatted text
+ */
+extern void UT_xml_writer_printf(UT_xml_writer_t *pWriter, const char *pFormat, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Appends raw bytes
+ */
+extern void UT_xml_writer_write(UT_xml_writer_t *pWriter, const char *pData, size_t length);
+
+/**
+ * @brief Appends text with the XML special characters & < > " replaced by their entities
+ *
+ * @param pText - text to escape, NULL appends nothing
+ */
+extern void UT_xml_writer_escaped(UT_xml_writer_t *pWriter, const char *pText);
+
+/**
+ * @brief Gets the file offset of the next byte to be written
+ */
+extern long UT_xml_writer_tell(UT_xml_writer_t *pWriter);
+
+/**
+ * @brief Overwrites bytes already written, in the block or in the file
+ *
+ * @param offset - file offset from UT_xml_writer_tell()
+ * @param pData - replacement bytes
+ * @param length - number of bytes, must not extend past the current end
+ */
+extern void UT_xml_writer_patch(UT_xml_writer_t *pWriter, long offset, const char *pData, size_t length);
+
+/**
+ * @brief Writes the block to the file
+ *
+ * @return int - 0 on success, -1 on a write failure
+ */
+extern int UT_xml_writer_flush(UT_xml_writer_t *pWriter);
+
+/**
+ * @brief Writes the block and, when enabled, commits the file to storage with fsync()
+ *
+ * @return int - 0 on success, -1 on a write or sync failure
+ */
+extern int UT_xml_writer_sync(UT_xml_writer_t *pWriter);
+
+/**
+ * @brief Enables fsync() in UT_xml_writer_sync(), off by default
+ */
+extern void UT_xml_writer_set_fsync(bool bEnable);
+
+#endif  /*  __UT_XML_WRITER_H  */
+/** @} */
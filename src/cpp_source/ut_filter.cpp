@@ -0,0 +1,193 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <algorithm>
+#include <sstream>
+
+#include "ut_filter.h"
+
+/**
+ * @brief Matches a name against a `*` / `?` wildcard pattern.
+ *
+ * Backtracks only to the most recent `*`, so the cost is linear in the name for
+ * the patterns used in test filters.
+ *
+ * @param pattern The wildcard pattern.
+ * @param name The name to match.
+ * @return true if the pattern matches the whole name.
+ */
+static bool matchWildcard(const std::string &pattern, const std::string &name)
+{
+    size_t p = 0;
+    size_t n = 0;
+    size_t star = std::string::npos;
+    size_t resume = 0;
+
+    while (n < name.size())
+    {
+        if ((p < pattern.size()) && ((pattern[p] == '?') || (pattern[p] == name[n])))
+        {
+            p++;
+            n++;
+        }
+        else if ((p < pattern.size()) && (pattern[p] == '*'))
+        {
+            star = p++;
+            resume = n;
+        }
+        else if (star != std::string::npos)
+        {
+            p = star + 1;
+            n = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while ((p < pattern.size()) && (pattern[p] == '*'))
+    {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+int UTFilterPatterns::child(int node, char c) const
+{
+    const auto &children = trie[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(c, 0));
+
+    return ((it != children.end()) && (it->first == c)) ? it->second : -1;
+}
+
+void UTFilterPatterns::add(const std::string &pattern)
+{
+    size_t wildcard = pattern.find_first_of("*?");
+    bool isPrefix = !pattern.empty() && (wildcard == pattern.size() - 1) && (pattern.back() == '*');
+
+    source.push_back(pattern);
+
+    if ((wildcard != std::string::npos) && !isPrefix)
+    {
+        wildcards.push_back(pattern);
+        return;
+    }
+
+    size_t length = isPrefix ? wildcard : pattern.size();
+    int node = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        int next = child(node, pattern[i]);
+        if (next < 0)
+        {
+            next = static_cast<int>(trie.size());
+            trie.emplace_back();
+            auto &children = trie[node].children;
+            children.insert(std::lower_bound(children.begin(), children.end(), std::make_pair(pattern[i], 0)), {pattern[i], next});
+        }
+        node = next;
+    }
+
+    if (isPrefix)
+    {
+        trie[node].prefix = true;
+    }
+    else
+    {
+        trie[node].literal = true;
+    }
+}
+
+bool UTFilterPatterns::matches(const std::string &name) const
+{
+    int node = 0;
+
+    for (size_t i = 0; (node >= 0) && (i <= name.size()); i++)
+    {
+        if (trie[node].prefix || ((i == name.size()) && trie[node].literal))
+        {
+            return true;
+        }
+        node = (i < name.size()) ? child(node, name[i]) : -1;
+    }
+
+    for (const auto &pattern : wildcards)
+    {
+        if (matchWildcard(pattern, name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+UTFilter::UTFilter(const std::string &filter)
+{
+    std::stringstream ss(filter);
+    std::string pattern;
+
+    while (std::getline(ss, pattern, ':'))
+    {
+        if (pattern.empty() || (pattern == "*"))
+        {
+            continue; // Skip the default filter
+        }
+
+        if (pattern.front() == '-')
+        {
+            exclude(pattern.substr(1));
+        }
+        else
+        {
+            include(pattern);
+        }
+    }
+}
+
+std::string UTFilter::negativeFilter() const
+{
+    std::string result = "-";
+    const auto &patterns = negative.patterns();
+
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        result += patterns[i];
+        if (i < patterns.size() - 1)
+        {
+            result += ":*";
+        }
+    }
+    return result;
+}
+
+std::string UTFilter::toString() const
+{
+    std::string result;
+
+    for (const auto &pattern : positive.patterns())
+    {
+        result += (result.empty() ? "" : ":") + pattern;
+    }
+    for (const auto &pattern : negative.patterns())
+    {
+        result += (result.empty() ? "-" : ":-") + pattern;
+    }
+    return result.empty() ? "*" : result;
+}
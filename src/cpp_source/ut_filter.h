@@ -0,0 +1,144 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @brief
+ * Compiled gtest style test filter.
+ *
+ * The ':' separated filter is compiled once, literal and `prefix*` patterns go into a
+ * character trie so a name is checked against all of them in a single pass, and only
+ * the remaining wildcard patterns are matched one by one.
+ */
+/** @addtogroup UT_GTEST
+ * @{
+ */
+
+#ifndef __UT_FILTER_H
+#define __UT_FILTER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @class UTFilterPatterns
+ * @brief A compiled set of `*` / `?` wildcard patterns.
+ */
+class UTFilterPatterns
+{
+public:
+    /**
+     * @brief Adds a pattern to the set.
+     *
+     * @param pattern The pattern, `*` matches any string and `?` any single character.
+     */
+    void add(const std::string &pattern);
+
+    /**
+     * @brief Checks if a name matches any pattern in the set.
+     *
+     * @param name The name to check, e.g. "Suite.Test".
+     * @return true if any pattern matches the whole name.
+     */
+    bool matches(const std::string &name) const;
+
+    /**
+     * @brief Gets the patterns in the order they were added.
+     */
+    const std::vector<std::string> &patterns() const { return source; }
+
+    bool empty() const { return source.empty(); }
+
+private:
+    /** Trie node, children are kept sorted by character */
+    struct Node
+    {
+        std::vector<std::pair<char, int>> children;
+        bool literal = false;   /*!< A literal pattern ends here */
+        bool prefix = false;    /*!< A `prefix*` pattern ends here */
+    };
+
+    int child(int node, char c) const;
+
+    std::vector<std::string> source;    /*!< Patterns as added */
+    std::vector<Node> trie{1};          /*!< Literal and `prefix*` patterns, node 0 is the root */
+    std::vector<std::string> wildcards; /*!< Patterns with any other wildcards */
+};
+
+/**
+ * @class UTFilter
+ * @brief A compiled gtest filter of positive and negative (`-` prefixed) patterns.
+ */
+class UTFilter
+{
+public:
+    UTFilter() = default;
+
+    /**
+     * @brief Compiles a filter string.
+     *
+     * @param filter A ':' separated filter, patterns starting with '-' are negative and "*" is skipped.
+     */
+    explicit UTFilter(const std::string &filter);
+
+    /**
+     * @brief Adds a positive pattern.
+     */
+    void include(const std::string &pattern) { positive.add(pattern); }
+
+    /**
+     * @brief Adds a negative pattern, without the leading '-'.
+     */
+    void exclude(const std::string &pattern) { negative.add(pattern); }
+
+    /**
+     * @brief Checks if a test is excluded by a negative pattern.
+     *
+     * @param fullName The full test name, "Suite.Test".
+     */
+    bool isExcluded(const std::string &fullName) const { return negative.matches(fullName); }
+
+    /**
+     * @brief Checks if a test is selected by a positive pattern.
+     *
+     * @param fullName The full test name, "Suite.Test".
+     */
+    bool isIncluded(const std::string &fullName) const { return positive.matches(fullName); }
+
+    bool empty() const { return positive.empty() && negative.empty(); }
+
+    /**
+     * @brief Formats the negative patterns as a gtest filter.
+     *
+     * @return A filter with a leading '-', the patterns separated by ":*".
+     */
+    std::string negativeFilter() const;
+
+    /**
+     * @brief Formats the filter as a gtest filter string.
+     *
+     * @return The positive patterns then the '-' prefixed negative patterns, ':' separated, "*" if empty.
+     */
+    std::string toString() const;
+
+private:
+    UTFilterPatterns positive;
+    UTFilterPatterns negative;
+};
+
+#endif  /*  __UT_FILTER_H  */
+/** @} */
@@ -20,12 +20,45 @@
 #include <ut.h>
 #include <ut_log.h>
 #include <ut_internal.h>
+#include <ut_kvp_profile.h>
+#include <ut_log_async.h>
+#include <ut_trace.h>
+#include <ut_stress.h>
+#include <ut_impact.h>
+#include <ut_coverage.h>
+#include <ut_perf.h>
+#include <ut_memory.h>
+#include <ut_fixture.h>
+#include "ut_filter.h"
+#include "ut_histogram.h"
+#include "ut_report.h"
+#include "ut_shard.h"
 
 #include <iomanip>
-#include <regex>
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
 
 static TestMode_t  gTestMode;
+static int gShardIndex = 0;              /*!< Index of this shard, 0 based */
+static int gShardCount = 1;              /*!< Total number of shards, 1 disables sharding */
+static std::string gShardHistory;        /*!< Comma separated reports used to weight the suites */
+static std::string gResultsFilenameRoot; /*!< Results filename root, without extension */
+static unsigned int gTestTimeout = 0;    /*!< Per test timeout in seconds, 0 disables */
+static unsigned int gSuiteTimeout = 0;   /*!< Per suite timeout in seconds, 0 disables */
+static int gParallelJobs = 1;            /*!< Number of worker processes used by UT_run_tests() */
+static int gWorkerIndex = -1;            /*!< Index of this worker process, -1 in the parent */
+static std::vector<pid_t> gWorkerPids;   /*!< One per worker of the pool, -1 if not started, empty without a pool */
 #define STRING_FORMAT(x) x
 
 #define UT_MAX_DISPLAYED_TEST_WIDTH (8)
@@ -57,12 +90,585 @@ struct TestSuiteInfo {
 
 // Initialize static variables
 std::unordered_map<std::string, UT_groupID_t> UTCore::suiteToGroup;
+std::unordered_set<UT_groupID_t> UTCore::parallelSafeGroups = {UT_TESTS_L1, UT_TESTS_L2, UT_TESTS_L3};
+
+static std::string shardSuffix()
+{
+    return (gShardCount > 1) ? "-shard" + std::to_string(gShardIndex) : std::string();
+}
+
+/**
+ * @brief Gets the suffix of the files written by this process, for its shard and its part of a worker pool.
+ */
+static std::string resultsSuffix()
+{
+    if (gWorkerIndex >= 0)
+    {
+        return shardSuffix() + "-worker" + std::to_string(gWorkerIndex);
+    }
+    if (!gWorkerPids.empty())
+    {
+        return shardSuffix() + "-serial";
+    }
+    return shardSuffix();
+}
+
+/**
+ * @brief Fails hung tests, a watchdog thread is armed from test start to test end.
+ *
+ * Google Test cannot leave a running test body, so a timeout aborts the run. The watchdog does not
+ * touch the state of Google Test, which the test body is still using: the results of the tests that
+ * have ended are handed to it under its mutex, and on overrun it writes the xml report from them,
+ * with the hung test failed, then the process exits.
+ */
+class UTTimeoutListener : public ::testing::EmptyTestEventListener
+{
+public:
+    UTTimeoutListener() : armed(false), stop(false), watchdog(&UTTimeoutListener::watch, this) {}
+
+    ~UTTimeoutListener() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cond.notify_one();
+        watchdog.join();
+    }
+
+    void OnTestProgramStart(const ::testing::UnitTest &) override
+    {
+        std::string output = ::testing::FLAGS_gtest_output;
+        char timestamp[32] = "";
+        time_t now = time(nullptr);
+        struct tm local;
+
+        if (localtime_r(&now, &local) != nullptr)
+        {
+            strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &local);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        report = (output.rfind("xml:", 0) == 0) ? output.substr(4) : std::string();
+        reportTimestamp = timestamp;
+        runStart = std::chrono::steady_clock::now();
+    }
+
+    void OnTestIterationStart(const ::testing::UnitTest &, int) override
+    {
+        // Like the report of Google Test, the report holds the last iteration
+        std::lock_guard<std::mutex> lock(mutex);
+        suiteBlocks.clear();
+        totals = UTMergedReport();
+    }
+
+    void OnTestSuiteStart(const ::testing::TestSuite &test_suite) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        suiteStart = std::chrono::steady_clock::now();
+        suiteName = test_suite.name();
+        suiteTests.clear();
+    }
+
+    void OnTestStart(const ::testing::TestInfo &test_info) override
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto testDeadline = std::chrono::steady_clock::time_point::max();
+        auto suiteDeadline = std::chrono::steady_clock::time_point::max();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (gTestTimeout > 0)
+        {
+            testDeadline = now + std::chrono::seconds(gTestTimeout);
+        }
+        if (gSuiteTimeout > 0)
+        {
+            suiteDeadline = suiteStart + std::chrono::seconds(gSuiteTimeout);
+        }
+
+        if (testDeadline <= suiteDeadline)
+        {
+            reason = "Test timeout of " + std::to_string(gTestTimeout) + "s exceeded by [" + test_info.name() + "]";
+            deadline = testDeadline;
+        }
+        else
+        {
+            reason = "Suite timeout of " + std::to_string(gSuiteTimeout) + "s exceeded by [" + test_info.name() + "]";
+            deadline = suiteDeadline;
+        }
+        testName = test_info.name();
+        testStart = now;
+        armed = true;
+        cond.notify_one();
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        const ::testing::TestResult *result = test_info.result();
+        UTReportTest test;
+
+        test.name = test_info.name();
+        test.seconds = (double)result->elapsed_time() / 1000.0;
+        test.skipped = result->Skipped();
+        for (int i = 0; i < result->total_part_count(); ++i)
+        {
+            const ::testing::TestPartResult &part = result->GetTestPartResult(i);
+
+            if (part.failed())
+            {
+                test.failures.push_back(std::string((part.file_name() != nullptr) ? part.file_name() : "") + ":" +
+                                        std::to_string(part.line_number()) + "\n" + part.message());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        totals.tests++;
+        totals.failures += test.failures.empty() ? 0 : 1;
+        suiteTests.push_back(std::move(test));
+        armed = false;
+        cond.notify_one();
+    }
+
+    void OnTestSuiteEnd(const ::testing::TestSuite &) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        suiteBlocks += testSuiteBlock(suiteName, suiteTests);
+        suiteTests.clear();
+    }
+
+private:
+    void watch()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!stop)
+        {
+            if (!armed)
+            {
+                cond.wait(lock);
+            }
+            else if (cond.wait_until(lock, deadline) == std::cv_status::timeout && armed && !stop)
+            {
+                overrun();
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the report of the tests so far, and the hung test, then exits. Called with the mutex held.
+     */
+    void overrun()
+    {
+        UTReportTest hung;
+        UTMergedReport failed = totals;
+
+        UT_LOG_ERROR("Watchdog: %s", reason.c_str());
+        hung.name = testName;
+        hung.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - testStart).count();
+        hung.failures.push_back(reason);
+        suiteTests.push_back(hung);
+        failed.tests++;
+        failed.failures++;
+
+        if (!report.empty() &&
+            !writeReport(report, failed, reportTimestamp,
+                         std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count(),
+                         suiteBlocks + testSuiteBlock(suiteName, suiteTests)))
+        {
+            UT_LOG_ERROR("Unable to write the report [%s]", report.c_str());
+        }
+        UT_log_async_flush();
+        std::cout << std::flush;
+        _exit(1);
+    }
+
+    std::mutex mutex;   /*!< Guards every member below, the watchdog and the test events share them */
+    std::condition_variable cond;
+    std::chrono::steady_clock::time_point runStart;
+    std::chrono::steady_clock::time_point suiteStart;
+    std::chrono::steady_clock::time_point testStart;
+    std::chrono::steady_clock::time_point deadline;
+    std::string reason;
+    std::string report;             /*!< The xml report, empty when Google Test writes none */
+    std::string reportTimestamp;
+    std::string suiteName;
+    std::string testName;
+    std::vector<UTReportTest> suiteTests;   /*!< Tests of the running suite that have ended */
+    std::string suiteBlocks;                /*!< `<testsuite>` blocks of the suites that have ended */
+    UTMergedReport totals;
+    bool armed;
+    bool stop;
+    std::thread watchdog;   /*!< Declared last, it starts once the members it reads are constructed */
+};
+
+/**
+ * @brief Feeds the --trace file from the Google Test events.
+ *
+ * Google Test only reports the failed assertions, and SUCCEED(), as test part results.
+ */
+class UTTraceListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestSuiteStart(const ::testing::TestSuite &test_suite) override
+    {
+        UT_trace_suiteStart(test_suite.name());
+    }
+
+    void OnTestStart(const ::testing::TestInfo &test_info) override
+    {
+        UT_trace_testStart(test_info.test_suite_name(), test_info.name());
+    }
+
+    void OnTestPartResult(const ::testing::TestPartResult &result) override
+    {
+        UT_trace_assert(result.file_name(), (result.line_number() > 0) ? (unsigned int)result.line_number() : 0,
+                        result.summary(), !result.failed(), result.fatally_failed());
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        const ::testing::TestResult *result = test_info.result();
+        unsigned int failed = 0;
+
+        for (int i = 0; i < result->total_part_count(); ++i)
+        {
+            failed += result->GetTestPartResult(i).failed() ? 1 : 0;
+        }
+        UT_trace_testEnd(result->Skipped() ? "skipped" : (result->Failed() ? "failed" : "passed"),
+                         (unsigned int)result->total_part_count(), failed);
+    }
+
+    void OnTestSuiteEnd(const ::testing::TestSuite &) override
+    {
+        UT_trace_suiteEnd();
+    }
+};
+
+/**
+ * @brief Records the outcome and duration of every test that ran for the stress report, see ut_stress.h.
+ */
+class UTStressListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestStart(const ::testing::TestInfo &) override
+    {
+        start = UT_get_monotonic_ns();
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        const ::testing::TestResult *result = test_info.result();
+
+        if (!result->Skipped())
+        {
+            UT_stress_record(test_info.test_suite_name(), test_info.name(), result->Passed(), UT_get_monotonic_ns() - start);
+        }
+    }
+
+private:
+    uint64_t start = 0;
+};
+
+/**
+ * @brief Writes the functions each test entered to the impact map, see ut_impact.h.
+ */
+class UTImpactListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        UT_impact_test_end(test_info.test_suite_name(), test_info.name());
+    }
+};
+
+/**
+ * @brief Writes the coverage counters of each test to its own directory, see ut_coverage.h.
+ */
+class UTCoverageListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        UT_coverage_test_end(test_info.test_suite_name(), test_info.name());
+    }
+};
+
+/**
+ * @brief Tears down the fixtures of each suite as it ends, see UT_add_fixture().
+ */
+class UTFixtureListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestSuiteEnd(const ::testing::TestSuite &test_suite) override
+    {
+        UT_fixture_suite_end(test_suite.name());
+    }
+};
+
+/**
+ * @brief Counts the perf events of each test and records them as `perf_<counter>` properties, see ut_perf.h.
+ *
+ * Appended after the other listeners bar UTMemoryListener, Google Test starts it after and ends it before them.
+ */
+class UTPerfListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestStart(const ::testing::TestInfo &) override
+    {
+        UT_perf_test_start();
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        UT_perf_sample_t sample;
+
+        if (UT_perf_test_end(test_info.test_suite_name(), test_info.name(), &sample) == false)
+        {
+            return;
+        }
+        for (int i = 0; i < UT_PERF_COUNTERS; i++)
+        {
+            if (sample.bValid[i])
+            {
+                ::testing::Test::RecordProperty(UT_perf_counter_name(static_cast<UT_perf_counter_t>(i)), std::to_string(sample.value[i]));
+            }
+        }
+    }
+};
+
+/**
+ * @brief Records the net allocation and peak memory of each test, and fails those over the leak budget, see ut_memory.h.
+ *
+ * Appended last, so the properties the other listeners record are not counted as allocated by the test.
+ */
+class UTMemoryListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestStart(const ::testing::TestInfo &) override
+    {
+        UT_memory_test_start();
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        char condition[128];
+        UT_memory_sample_t sample;
+
+        // The test is still current, the failure is recorded against it ahead of the printer and xml report
+        if (UT_memory_over_budget(condition, sizeof(condition)))
+        {
+            ADD_FAILURE() << condition;
+        }
+        if (UT_memory_test_end(test_info.test_suite_name(), test_info.name(), &sample) == false)
+        {
+            return;
+        }
+        if (sample.bNetValid)
+        {
+            ::testing::Test::RecordProperty("memory_net_bytes", std::to_string(sample.netBytes));
+        }
+        if (sample.bPeakValid)
+        {
+            ::testing::Test::RecordProperty("memory_peak_bytes", std::to_string(sample.peakBytes));
+        }
+    }
+};
+
+/**
+ * @brief Collects latency histograms of every test and suite, in microseconds.
+ *
+ * The histograms cover every iteration of a run, so a run with `--gtest_repeat` (or the
+ * repeat option of the console menu) gives the spread of each test rather than one sample.
+ * They are cleared when a run starts and written to `<results root>-latency.json` when it ends.
+ */
+class UTLatencyListener : public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestProgramStart(const ::testing::UnitTest &) override
+    {
+        tests.clear();
+        suites.clear();
+        iterations = 0;
+    }
+
+    void OnTestIterationStart(const ::testing::UnitTest &, int) override
+    {
+        iterations++;
+    }
+
+    void OnTestSuiteStart(const ::testing::TestSuite &) override
+    {
+        suiteStart = std::chrono::steady_clock::now();
+    }
+
+    void OnTestStart(const ::testing::TestInfo &) override
+    {
+        testStart = std::chrono::steady_clock::now();
+    }
+
+    void OnTestEnd(const ::testing::TestInfo &test_info) override
+    {
+        if (!test_info.should_run() || test_info.result()->Skipped())
+        {
+            return;
+        }
+        tests[std::string(test_info.test_suite_name()) + "." + test_info.name()].record(elapsedUs(testStart));
+    }
+
+    void OnTestSuiteEnd(const ::testing::TestSuite &test_suite) override
+    {
+        if (test_suite.test_to_run_count() > 0)
+        {
+            suites[test_suite.name()].record(elapsedUs(suiteStart));
+        }
+    }
+
+    void OnTestProgramEnd(const ::testing::UnitTest &) override
+    {
+        std::string filename = latencyFilename();
+
+        if (!filename.empty())
+        {
+            writeJson(filename);
+        }
+    }
+
+    /**
+     * @brief Prints the percentiles of every suite, and of every test that ran more than once.
+     */
+    void printSummary(std::ostream &out) const
+    {
+        if (suites.empty())
+        {
+            return;
+        }
+
+        out << "\nLatency (us) over " << iterations << " iteration" << ((iterations == 1) ? "" : "s") << ":\n"
+            << std::left << std::setw(48) << "Suite / Test" << std::right
+            << std::setw(8) << "Count" << std::setw(11) << "Min" << std::setw(11) << "p50"
+            << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11) << "Max" << "\n";
+        for (const auto &suite : suites)
+        {
+            printRow(out, suite.first, suite.second);
+            for (const auto &test : tests)
+            {
+                if ((test.second.count() > 1) && (test.first.compare(0, suite.first.size() + 1, suite.first + ".") == 0))
+                {
+                    printRow(out, "  " + test.first.substr(suite.first.size() + 1), test.second);
+                }
+            }
+        }
+    }
+
+private:
+    static uint64_t elapsedUs(std::chrono::steady_clock::time_point start)
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void printRow(std::ostream &out, const std::string &name, const UTHistogram &histogram)
+    {
+        out << std::left << std::setw(48) << name.substr(0, 47) << std::right
+            << std::setw(8) << histogram.count() << std::setw(11) << histogram.min()
+            << std::setw(11) << histogram.percentile(50) << std::setw(11) << histogram.percentile(90)
+            << std::setw(11) << histogram.percentile(99) << std::setw(11) << histogram.max() << "\n";
+    }
+
+    static std::string latencyFilename()
+    {
+        if (gResultsFilenameRoot.empty())
+        {
+            return std::string();
+        }
+        return gResultsFilenameRoot + "-latency" + resultsSuffix() + ".json";
+    }
+
+    static std::string jsonString(const std::string &text)
+    {
+        std::ostringstream out;
+
+        out << '"';
+        for (unsigned char c : text)
+        {
+            if ((c == '"') || (c == '\\'))
+            {
+                out << '\\' << c;
+            }
+            else if (c < 0x20)
+            {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+            }
+            else
+            {
+                out << c;
+            }
+        }
+        out << '"';
+        return out.str();
+    }
+
+    static void writeHistograms(std::ostream &out, const std::map<std::string, UTHistogram> &histograms)
+    {
+        const char *separator = "";
+
+        out << "[";
+        for (const auto &entry : histograms)
+        {
+            const UTHistogram &histogram = entry.second;
+            const char *bucketSeparator = "";
+
+            out << separator << "\n    {\"name\": " << jsonString(entry.first)
+                << ", \"count\": " << histogram.count() << ", \"min\": " << histogram.min()
+                << ", \"mean\": " << std::fixed << std::setprecision(1) << histogram.mean()
+                << ", \"p50\": " << histogram.percentile(50) << ", \"p90\": " << histogram.percentile(90)
+                << ", \"p99\": " << histogram.percentile(99) << ", \"p999\": " << histogram.percentile(99.9)
+                << ", \"max\": " << histogram.max() << ", \"buckets\": [";
+            for (const auto &bucket : histogram.buckets())
+            {
+                out << bucketSeparator << "[" << bucket.first << ", " << bucket.second << "]";
+                bucketSeparator = ", ";
+            }
+            out << "]}";
+            separator = ",";
+        }
+        out << "\n  ]";
+    }
+
+    /**
+     * @brief Writes the histograms, buckets are [lowest value, count] pairs of the buckets holding values.
+     */
+    void writeJson(const std::string &filename) const
+    {
+        std::ofstream out(filename, std::ios::trunc);
+
+        if (!out)
+        {
+            UT_LOG_WARNING("Unable to write the latency histograms to [%s]", filename.c_str());
+            return;
+        }
+        out << "{\n  \"version\": 1,\n  \"unit\": \"us\",\n  \"subBucketBits\": " << UT_HISTOGRAM_SUB_BUCKET_BITS
+            << ",\n  \"timestamp\": " << (long long)std::time(nullptr)
+            << ",\n  \"iterations\": " << iterations << ",\n  \"suites\": ";
+        writeHistograms(out, suites);
+        out << ",\n  \"tests\": ";
+        writeHistograms(out, tests);
+        out << "\n}\n";
+    }
+
+    std::map<std::string, UTHistogram> tests;    /*!< Keyed by "Suite.Test" */
+    std::map<std::string, UTHistogram> suites;
+    std::chrono::steady_clock::time_point suiteStart;
+    std::chrono::steady_clock::time_point testStart;
+    int iterations = 0;
+};
 
 class UTTestRunner
 {
 
 private:
     static std::vector<TestSuiteInfo> suites;
+    static UTLatencyListener *latency;  /*!< Owned by Google Test once appended */
+    std::vector<std::pair<std::string, int>> poolShares;   /*!< Parallel suites of a worker pool and their worker */
 
 public:
     static std::unordered_set<UT_groupID_t> enabledGroups;
@@ -72,17 +678,17 @@ public:
      * @brief Constructs a UTTestRunner object and initializes Google Test framework.
      *
      * This constructor initializes the Google Test framework with a single argument
-     * "test_runner". It retrieves the test filter string from UTCore, parses it into
-     * active and inactive filters, and processes each test suite accordingly.
+     * "test_runner". It retrieves the test filter string from UTCore, compiles it once
+     * into a UTFilter, and processes each test suite accordingly.
      *
      * The constructor performs the following steps:
      * 1. Initializes Google Test with a single argument.
      * 2. Retrieves the test filter string from UTCore.
-     * 3. Parses the filter string into active and inactive filters.
-     * 4. Checks if both filters are empty.
-     * 5. Iterates through all test suites and determines their active status based on the filters.
+     * 3. Compiles the filter string into positive and negative patterns.
+     * 4. Iterates through all tests, a test is active unless a negative pattern matches "Suite.Test".
+     * 5. Marks a suite active if any of its tests are active.
      * 6. Collects test information for each test suite and stores it in the `suites` vector.
-     * 7. Formats the inactive filter string and sets it as the test filter.
+     * 7. Formats the negative filter string and sets it as the test filter.
      *
      * The `suites` vector contains information about each test suite, including its
      * index, name, active status, and a list of tests with their respective indices,
@@ -94,22 +700,14 @@ public:
         char *argv[1] = {(char *)"test_runner"};
         ::testing::InitGoogleTest(&argc, argv);
         const ::testing::UnitTest &unit_test = *::testing::UnitTest::GetInstance();
-        std::string filter = UTCore::UT_get_test_filter();
-        std::vector<std::string> activeFilters;
-        std::vector<std::string> inactiveFilters;
-        parseFilterString(filter, activeFilters, inactiveFilters);
-
-        // Check if both filters are empty
-        bool noFilters = activeFilters.empty() && inactiveFilters.empty();
+        UTFilter filter(UTCore::UT_get_test_filter());
 
+        suites.reserve(unit_test.total_test_suite_count());
         for (int i = 0; i < unit_test.total_test_suite_count(); ++i)
         {
             const ::testing::TestSuite *test_suite = unit_test.GetTestSuite(i);
             std::string suiteName = test_suite->name();
-
-            // If no filters are provided, consider all suites as active
-            bool isActive = noFilters || (!matchesAnyPattern(suiteName, activeFilters) && !matchesAnyPattern(suiteName, inactiveFilters)) ||
-                            (matchesAnyPattern(suiteName, activeFilters) && !matchesAnyPattern(suiteName, inactiveFilters));
+            bool isActive = (test_suite->total_test_count() == 0);
 
             std::vector<TestInfo> testInfos;
             testInfos.reserve(test_suite->total_test_count());
@@ -117,141 +715,283 @@ public:
             for (int j = 0; j < test_suite->total_test_count(); ++j)
             {
                 const ::testing::TestInfo *test_info = test_suite->GetTestInfo(j);
-                bool testIsActive = isActive;
+                bool testIsActive = !filter.isExcluded(suiteName + "." + test_info->name());
+                isActive = isActive || testIsActive;
                 testInfos.push_back(TestInfo{j + 1, test_info->name(), testIsActive});
             }
 
             suites.push_back(TestSuiteInfo{i + 1, suiteName, isActive, std::move(testInfos)});
         }
-
-        std::string inactiveFilterString = formatPatterns(inactiveFilters);
-        setTestFilter(inactiveFilterString);
+
+        std::string inactiveFilterString = filter.negativeFilter();
+        applyImpact(inactiveFilterString);
+        applyShard(inactiveFilterString);
+        applyWorkerPool(inactiveFilterString);
+        setTestFilter(inactiveFilterString);
+
+        if ((gTestTimeout > 0) || (gSuiteTimeout > 0))
+        {
+            // Google Test owns, and deletes, the appended listener
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTTimeoutListener());
+        }
+        if (UT_trace_enabled())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTTraceListener());
+        }
+        if (UT_impact_recording())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTImpactListener());
+        }
+        if (UT_coverage_enabled())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTCoverageListener());
+        }
+        if (UT_stress_enabled())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTStressListener());
+        }
+        if (UT_fixture_registered())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTFixtureListener());
+        }
+
+        if (latency == nullptr)
+        {
+            latency = new UTLatencyListener();
+            ::testing::UnitTest::GetInstance()->listeners().Append(latency);
+        }
+        if (UT_perf_enabled())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTPerfListener());
+        }
+        if (UT_memory_enabled())
+        {
+            ::testing::UnitTest::GetInstance()->listeners().Append(new UTMemoryListener());
+        }
+    }
+
+    /**
+     * @brief Deals suites between parts, e.g. shards or worker processes, weighted by the shard history.
+     *
+     * @param candidates The suites to deal.
+     * @param parts The number of parts.
+     * @param load Set to the estimated weight of each part.
+     * @return The part of each candidate, in the order of the candidates, see ::dealSuites().
+     */
+    std::vector<int> dealSuites(const std::vector<TestSuiteInfo *> &candidates, int parts, std::vector<double> &load)
+    {
+        std::vector<UTDealtSuite> dealt;
+
+        for (const auto *suite : candidates)
+        {
+            dealt.push_back({suite->name, suite->tests.size()});
+        }
+        return ::dealSuites(dealt, parts, readSuiteDurations(gShardHistory), load);
+    }
+
+    /**
+     * @brief Marks a suite inactive and appends it to a negative filter.
+     */
+    static void excludeSuite(TestSuiteInfo &suite, std::string &filter)
+    {
+        suite.isActive = false;
+        for (auto &test : suite.tests)
+        {
+            test.isActive = false;
+        }
+        filter += (filter == "-") ? "" : ":";
+        filter += suite.name + ".*";
     }
 
     /**
-     * @brief Formats a list of patterns into a single string with a specific format.
+     * @brief Excludes the active suites that did not enter any of the changed functions.
      *
-     * This function takes a vector of strings (patterns) and concatenates them into a single
-     * string. Each pattern is separated by ":*". If a pattern starts with a '-', it is removed.
-     * The resulting string starts with a leading '-'.
+     * Applied before the shard and the worker pool, so they split the selected suites.
      *
-     * @param patterns A vector of strings representing the patterns to be formatted.
-     * @return A formatted string with each pattern separated by ":*".
+     * @param filter The negative filter string, updated in place.
      */
-    std::string formatPatterns(const std::vector<std::string> &patterns)
+    void applyImpact(std::string &filter)
     {
-        std::string result = "-"; // Leading '-'
-
-        for (size_t i = 0; i < patterns.size(); ++i)
+        if (!UT_impact_selecting())
         {
-            std::string modifiedPattern = patterns[i];
+            return;
+        }
 
-            // Remove leading '-' if present
-            if (!modifiedPattern.empty() && modifiedPattern[0] == '-')
+        int active = 0;
+        int skipped = 0;
+        for (auto &suite : suites)
+        {
+            if (!suite.isActive || suite.tests.empty())
             {
-                modifiedPattern = modifiedPattern.substr(1);
+                continue;
             }
-
-            // Append to result with separator ":*" (skip separator for the last item)
-            result += modifiedPattern;
-            if (i < patterns.size() - 1)
+            active++;
+            if (!UT_impact_suite_selected(suite.name.c_str()))
             {
-                result += ":*";
+                excludeSuite(suite, filter);
+                skipped++;
             }
         }
-
-        return result;
+        UT_LOG("Impact: running [%d] of [%d] active suites", active - skipped, active);
     }
 
-    // Function to split a string by a delimiter
     /**
-     * @brief Splits a given string into a vector of substrings based on a specified delimiter.
+     * @brief Restricts the active suites to the ones owned by this shard.
      *
-     * This function takes a string and a delimiter character, and splits the string into
-     * substrings wherever the delimiter character is found. The substrings are stored in
-     * a vector and returned.
+     * The active suites are partitioned deterministically by suite with dealSuites(), every shard
+     * must see the same suite list and history to agree on the split. Suites owned by other shards
+     * are marked inactive and appended to the negative filter.
      *
-     * @param str The input string to be split.
-     * @param delimiter The character used to split the string.
-     * @return std::vector<std::string> A vector containing the substrings obtained by splitting the input string.
+     * @param filter The negative filter string, updated in place.
      */
-    std::vector<std::string> split(const std::string &str, char delimiter)
+    void applyShard(std::string &filter)
     {
-        std::vector<std::string> tokens;
-        std::stringstream ss(str);
-        std::string token;
-        while (std::getline(ss, token, delimiter))
+        if (gShardCount <= 1)
         {
-            tokens.push_back(token);
+            return;
         }
-        return tokens;
+
+        std::vector<TestSuiteInfo *> active;
+        for (auto &suite : suites)
+        {
+            if (suite.isActive)
+            {
+                active.push_back(&suite);
+            }
+        }
+
+        std::vector<double> load;
+        std::vector<int> owners = dealSuites(active, gShardCount, load);
+        int ownSuites = 0;
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+            if (owners[i] == gShardIndex)
+            {
+                ownSuites++;
+                continue;
+            }
+            excludeSuite(*active[i], filter);
+        }
+
+        UT_LOG("Shard [%d/%d]: running [%d] of [%d] suites, estimated weight [%.3f]", gShardIndex, gShardCount, ownSuites, (int)active.size(), load[gShardIndex]);
     }
 
-    // Function to check if a string matches any regex pattern in a vector
     /**
-     * @brief Checks if a given string matches any pattern in a list of patterns.
+     * @brief Restricts the active suites to the ones this process runs in a `-j` worker pool.
      *
-     * This function iterates through a list of patterns and checks if the given string
-     * matches any of the patterns using regular expressions. If a pattern starts with
-     * a '-', it is removed before performing the match.
+     * Every process of the pool deals the active parallel safe suites between the workers with
+     * dealSuites(), so they agree on the split without talking to each other. A worker keeps its
+     * share, the parent keeps the other suites and the share of any worker that was not started.
      *
-     * @param str The string to be checked against the patterns.
-     * @param patterns A vector of patterns to match against the string.
-     * @return true if the string matches any of the patterns, false otherwise.
+     * @param filter The negative filter string, updated in place.
      */
-    bool matchesAnyPattern(const std::string &str, const std::vector<std::string> &patterns)
+    void applyWorkerPool(std::string &filter)
     {
-        for (const auto &pattern : patterns)
+        if (gWorkerPids.empty())
         {
-            std::string modifiedPattern = pattern;
+            return;
+        }
 
-            // Remove leading '-' if present
-            if (!modifiedPattern.empty() && modifiedPattern[0] == '-')
+        std::vector<TestSuiteInfo *> parallel;
+        std::vector<TestSuiteInfo *> serial;
+        for (auto &suite : suites)
+        {
+            if (suite.isActive && !suite.tests.empty())
             {
-                modifiedPattern = modifiedPattern.substr(1);
+                (UTCore::UT_is_suite_parallel_safe(suite.name) ? parallel : serial).push_back(&suite);
             }
+        }
+
+        std::vector<double> load;
+        std::vector<int> owners = dealSuites(parallel, (int)gWorkerPids.size(), load);
+        int ownSuites = 0;
+        poolShares.clear();
+        for (size_t i = 0; i < parallel.size(); ++i)
+        {
+            bool own = (gWorkerIndex >= 0) ? (owners[i] == gWorkerIndex) : (gWorkerPids[owners[i]] < 0);
 
-            std::regex regexPattern(modifiedPattern);
-            if (std::regex_search(str, regexPattern))
+            poolShares.emplace_back(parallel[i]->name, owners[i]);
+            if (own)
             {
-                return true;
+                ownSuites++;
+                continue;
             }
+            excludeSuite(*parallel[i], filter);
+        }
+        if (gWorkerIndex >= 0)
+        {
+            for (auto *suite : serial)
+            {
+                excludeSuite(*suite, filter);
+            }
+            UT_LOG("Worker [%d/%d]: running [%d] of [%d] parallel suites, estimated weight [%.3f]", gWorkerIndex, (int)gWorkerPids.size(), ownSuites, (int)parallel.size(), load[gWorkerIndex]);
+        }
+        else
+        {
+            UT_LOG("Workers [%d]: running [%d] suites after the workers", (int)gWorkerPids.size(), ownSuites + (int)serial.size());
         }
-        return false;
     }
 
-    // Function to parse the filter string into active and inactive filters
     /**
-     * @brief Parses a filter string and separates it into active and inactive filters.
-     *
-     * This function takes a filter string, splits it by the ':' character, and categorizes
-     * each filter as either active or inactive. Filters that start with a '-' character
-     * are considered inactive, while all other filters are considered active. The special
-     * filter "*" is ignored.
+     * @brief Merges the reports of the worker pool and of this process into the `-report.xml` file.
      *
-     * @param filter The filter string to be parsed.
-     * @param activeFilters A vector to store the active filters.
-     * @param inactiveFilters A vector to store the inactive filters.
+     * @param statuses The exit status of each worker, a worker that left no report fails its suites.
+     * @param seconds Elapsed time of the run.
+     * @return The totals of the merged report.
      */
-    void parseFilterString(const std::string &filter, std::vector<std::string> &activeFilters, std::vector<std::string> &inactiveFilters)
+    UTMergedReport mergePool(const std::vector<int> &statuses, double seconds) const
     {
-        auto filters = split(filter, ':');
-        for (const auto &f : filters)
+        std::vector<std::pair<std::string, std::string>> reports;
+        std::vector<std::string> order;
+
+        for (size_t worker = 0; worker < gWorkerPids.size(); ++worker)
         {
-            if (f == "*")
-            {
-                continue; // Skip the default filter
-            }
+            std::string missing;
 
-            if (f.front() == '-')
+            if (gWorkerPids[worker] < 0)
             {
-                inactiveFilters.push_back(f);
+                continue;
             }
-            else
+            for (const auto &[name, owner] : poolShares)
             {
-                activeFilters.push_back(f);
+                if (owner == (int)worker)
+                {
+                    missing += missingSuiteBlock(name, (int)worker, statuses[worker]);
+                }
             }
+            reports.emplace_back(gResultsFilenameRoot + "-report" + shardSuffix() + "-worker" + std::to_string(worker) + ".xml", missing);
+        }
+        reports.emplace_back(gResultsFilenameRoot + "-report" + resultsSuffix() + ".xml", std::string());
+
+        for (const auto &suite : suites)
+        {
+            order.push_back(suite.name);
+        }
+        return mergeReports(reports, order, gResultsFilenameRoot + "-report" + shardSuffix() + ".xml", seconds);
+    }
+
+    // Function to split a string by a delimiter
+    /**
+     * @brief Splits a given string into a vector of substrings based on a specified delimiter.
+     *
+     * This function takes a string and a delimiter character, and splits the string into
+     * substrings wherever the delimiter character is found. The substrings are stored in
+     * a vector and returned.
+     *
+     * @param str The input string to be split.
+     * @param delimiter The character used to split the string.
+     * @return std::vector<std::string> A vector containing the substrings obtained by splitting the input string.
+     */
+    std::vector<std::string> split(const std::string &str, char delimiter)
+    {
+        std::vector<std::string> tokens;
+        std::stringstream ss(str);
+        std::string token;
+        while (std::getline(ss, token, delimiter))
+        {
+            tokens.push_back(token);
         }
+        return tokens;
     }
 
     /**
@@ -300,6 +1040,22 @@ public:
         return RUN_ALL_TESTS();
     }
 
+    /**
+     * @brief Runs the tests once, or once per iteration of a stress run.
+     *
+     * @return int The result of the last iteration, which is the one left in the report.
+     */
+    int runIterations() const
+    {
+        int result;
+
+        do
+        {
+            result = runTests();
+        } while (UT_stress_next());
+        return result;
+    }
+
     /**
      * @brief Runs all tests with an optional custom setup function.
      *
@@ -526,38 +1282,20 @@ public:
         else
         {
             // Build the include and exclude filters
-            std::string include_filter;
-            std::string exclude_filter;
+            UTFilter suiteFilter;
 
             for (const auto &suite : suites)
             {
                 if (suite.isActive)
                 {
-                    if (!include_filter.empty())
-                        include_filter += ":";
-                    include_filter += suite.name + ".*";
+                    suiteFilter.include(suite.name + ".*");
                 }
                 else
                 {
-                    if (!exclude_filter.empty())
-                        exclude_filter += ":";
-                    exclude_filter += "-" + suite.name + ".*";
-                }
-            }
-
-            // Combine include and exclude filters
-            if (!include_filter.empty())
-            {
-                filter = include_filter;
-                if (!exclude_filter.empty())
-                {
-                    filter += ":" + exclude_filter;
+                    suiteFilter.exclude(suite.name + ".*");
                 }
             }
-            else
-            {
-                filter = exclude_filter;
-            }
+            filter = suiteFilter.toString();
         }
 
         // Provide feedback to the user
@@ -1093,6 +1831,11 @@ public:
                   << std::right << std::setw(9) << "n/a" << "\n"
                   << "\n"
                   << "Elapsed time = " << std::fixed << std::setprecision(3) << unit_test.elapsed_time() / 1000.0 << " seconds\n";
+
+        if (latency != nullptr)
+        {
+            latency->printSummary(std::cout);
+        }
     }
 
     /**
@@ -1108,6 +1851,7 @@ public:
 };
 
 std::vector<TestSuiteInfo> UTTestRunner::suites;
+UTLatencyListener *UTTestRunner::latency = nullptr;
 std::unordered_set<UT_groupID_t> UTTestRunner::enabledGroups;
 std::unordered_set<UT_groupID_t> UTTestRunner::disabledGroups;
 
@@ -1151,38 +1895,23 @@ std::string UTCore::UT_get_test_filter()
         return "*"; // No restrictions, run all tests
     }
 
-    std::ostringstream includeFilter, excludeFilter;
-    bool firstInclude = true, firstExclude = true;
+    UTFilter filter;
 
     for (const auto &[suiteName, group] : suiteToGroup)
     {
         if (UTTestRunner::disabledGroups.find(group) != UTTestRunner::disabledGroups.end())
         {
             // If the group is explicitly disabled, add it to the exclude filter
-            if (!firstExclude)
-                excludeFilter << ":";
-            excludeFilter << "-" << suiteName << ".*"; // Exclude tests from this suite
-            firstExclude = false;
+            filter.exclude(suiteName + ".*"); // Exclude tests from this suite
         }
         else if (UTTestRunner::enabledGroups.empty() || UTTestRunner::enabledGroups.find(group) != UTTestRunner::enabledGroups.end())
         {
             // If no groups are explicitly enabled, allow all (unless disabled)
-            if (!firstInclude)
-                includeFilter << ":";
-            includeFilter << suiteName << ".*"; // Include tests from this suite
-            firstInclude = false;
+            filter.include(suiteName + ".*"); // Include tests from this suite
         }
     }
 
-    // Combine the include and exclude filters
-    if (firstInclude)
-    {
-        std::string excludeFilterString = excludeFilter.str().empty() ? "*" : excludeFilter.str();
-        return excludeFilterString;
-    }
-
-    std::string includeFilterString = includeFilter.str() + (excludeFilter.str().empty() ? "" : ":" + excludeFilter.str());
-    return includeFilterString;
+    return filter.toString();
 }
 
 /**
@@ -1201,6 +1930,105 @@ bool UTCore::UT_add_suite_withGroupID(const std::string& testSuiteName, UT_group
     return true;
 }
 
+void UTCore::UT_set_group_parallel_safe(UT_groupID_t group, bool parallelSafe)
+{
+    if (parallelSafe)
+    {
+        parallelSafeGroups.insert(group);
+    }
+    else
+    {
+        parallelSafeGroups.erase(group);
+    }
+}
+
+/**
+ * @brief Checks whether a test suite may run in parallel with other suites.
+ *
+ * A parameterized suite is registered under its fixture name, the instantiation prefix is ignored.
+ *
+ * @param testSuiteName The name of the test suite.
+ * @return true if the suite belongs to a parallel safe group, suites without a group are not.
+ */
+bool UTCore::UT_is_suite_parallel_safe(const std::string &testSuiteName)
+{
+    auto it = suiteToGroup.find(testSuiteName);
+
+    if (it == suiteToGroup.end())
+    {
+        it = suiteToGroup.find(testSuiteName.substr(testSuiteName.find_last_of('/') + 1));
+    }
+    return (it != suiteToGroup.end()) && (parallelSafeGroups.count(it->second) > 0);
+}
+
+/**
+ * @brief Runs a micro-benchmark and records its statistics.
+ *
+ * The statistics are written to the log and recorded as properties of the running test,
+ * so they appear in the xml report.
+ *
+ * @param name The name of the benchmark.
+ * @param function The function to be benchmarked.
+ */
+void UTCore::UT_run_benchmark(const char *name, void (*function)(void))
+{
+    UT_benchmark_stats_t stats;
+    char value[32];
+
+    ASSERT_NE(nullptr, function) << "Benchmark function not set";
+
+    UT_benchmark_run(function, &stats);
+    UT_benchmark_log(name, &stats);
+
+    RecordProperty("benchmark_iterations", std::to_string(stats.iterations));
+    RecordProperty("benchmark_samples", std::to_string(stats.samples));
+    snprintf(value, sizeof(value), "%.1f", stats.min);
+    RecordProperty("benchmark_min_ns", value);
+    snprintf(value, sizeof(value), "%.1f", stats.median);
+    RecordProperty("benchmark_median_ns", value);
+    snprintf(value, sizeof(value), "%.1f", stats.p99);
+    RecordProperty("benchmark_p99_ns", value);
+    snprintf(value, sizeof(value), "%.1f", stats.mean);
+    RecordProperty("benchmark_mean_ns", value);
+    snprintf(value, sizeof(value), "%.1f", stats.stddev);
+    RecordProperty("benchmark_stddev_ns", value);
+}
+
+static std::vector<UTKVPListElement> listElements(const char *pListKey, uint32_t count)
+{
+    std::vector<UTKVPListElement> elements;
+
+    if (count == 0)
+    {
+        UT_LOG_WARNING("Profile list [%s] is empty or not in the profile, no tests added", pListKey);
+    }
+
+    elements.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        elements.push_back(UTKVPListElement{std::string(pListKey) + "/" + std::to_string(i), i});
+    }
+    return elements;
+}
+
+std::vector<UTKVPListElement> UTCore::UT_get_kvp_list_elements(const char *pListKey)
+{
+    if (pListKey == nullptr)
+    {
+        return std::vector<UTKVPListElement>();
+    }
+    return listElements(pListKey, ut_kvp_profile_getListCount(pListKey));
+}
+
+std::vector<UTKVPListElement> UTCore::UT_get_kvp_list_elements(ut_kvp_instance_t *pInstance, const char *pListKey)
+{
+    if ((pInstance == nullptr) || (pListKey == nullptr))
+    {
+        return std::vector<UTKVPListElement>();
+    }
+    return listElements(pListKey, ut_kvp_getListCount(pInstance, pListKey));
+}
+
 void UT_set_results_output_filename(const char* szFilenameRoot)
 {
     // Null pointer check
@@ -1228,12 +2056,71 @@ void UT_set_results_output_filename(const char* szFilenameRoot)
         filepath = filepath.substr(0, lastDot);
     }
 
+    // Each shard writes its own report, named after its shard index
+    gResultsFilenameRoot = filepath;
+    std::string report = filepath + "-report" + resultsSuffix() + ".xml";
+
     // Set the output format and path programmatically
-    ::testing::FLAGS_gtest_output = std::string("xml:") + filepath + "-report.xml";
-    std::cout << "Listing Filename: [" << filepath << "-report.xml]\n" << std::flush;
+    ::testing::FLAGS_gtest_output = std::string("xml:") + report;
+    std::cout << "Listing Filename: [" << report << "]\n" << std::flush;
     std::cout << "Results Filename: [" << filepath << ".log]\n" << std::flush;
 }
 
+void UT_set_shard(int shardIndex, int shardCount)
+{
+    gShardIndex = shardIndex;
+    gShardCount = shardCount;
+
+    // Rename the report now the shard is known
+    if (!gResultsFilenameRoot.empty())
+    {
+        std::string root = gResultsFilenameRoot + ".log";
+        UT_set_results_output_filename(root.c_str());
+    }
+}
+
+void UT_set_shard_history(const char *pReports)
+{
+    gShardHistory = (pReports != nullptr) ? pReports : "";
+}
+
+void UT_set_results_fsync(bool enable)
+{
+    if (enable)
+    {
+        UT_LOG_WARNING("Results fsync is not supported by the gtest runner, the report is written once at exit");
+    }
+    return;
+}
+
+void UT_set_result_cache(const char *pCacheFile, const char *pProfileFiles, bool bUseCached)
+{
+    (void)pProfileFiles;
+    (void)bUseCached;
+    if (pCacheFile != nullptr)
+    {
+        UT_LOG_WARNING("The result cache [%s] is not supported by the gtest runner, running all suites", pCacheFile);
+    }
+}
+
+void UT_set_isolation(UT_isolation_t isolation)
+{
+    if (isolation != UT_ISOLATION_NONE)
+    {
+        UT_LOG_WARNING("Test isolation is not supported by the gtest runner, use death tests for code expected to crash");
+    }
+}
+
+void UT_set_test_timeout(unsigned int seconds)
+{
+    gTestTimeout = seconds;
+}
+
+void UT_set_suite_timeout(unsigned int seconds)
+{
+    gSuiteTimeout = seconds;
+}
+
 void UT_set_test_mode(TestMode_t  mode)
 {
     gTestMode = mode;
@@ -1259,15 +2146,189 @@ void UT_toggle_suite_activation_based_on_groupID(UT_groupID_t groupId, bool enab
     return;
 }
 
+void UT_set_parallel_jobs(int jobs)
+{
+    gParallelJobs = (jobs > 1) ? jobs : 1;
+    return;
+}
+
 UT_status_t startup_system( void )
 {
     return UT_STATUS_OK;
 }
 
+/**
+ * @brief Counts the parallel safe suites, the parameterized ones included.
+ *
+ * Google Test registers the parameterized suites in InitGoogleTest(), which also fixes the xml report
+ * of the process, so this process cannot be initialised before the workers are forked. The suites are
+ * counted by a child that is initialised instead.
+ *
+ * @return The number of parallel safe suites, 0 if the child could not count them.
+ */
+static int countParallelSuites()
+{
+    int countPipe[2];
+    int count = 0;
+    int status = 0;
+
+    if (pipe(countPipe) != 0)
+    {
+        UT_LOG_ERROR("pipe() failed counting the parallel safe suites: %s", strerror(errno));
+        return 0;
+    }
+
+    // Anything buffered would otherwise be written by this process and again by the child
+    UT_log_async_flush();
+    std::cout << std::flush;
+    fflush(nullptr);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int argc = 1;
+        char *argv[1] = {(char *)"test_runner"};
+
+        close(countPipe[0]);
+        ::testing::InitGoogleTest(&argc, argv);
+        const ::testing::UnitTest &unit_test = *::testing::UnitTest::GetInstance();
+        for (int i = 0; i < unit_test.total_test_suite_count(); ++i)
+        {
+            count += UTCore::UT_is_suite_parallel_safe(unit_test.GetTestSuite(i)->name()) ? 1 : 0;
+        }
+        _exit((write(countPipe[1], &count, sizeof(count)) == (ssize_t)sizeof(count)) ? 0 : 1);
+    }
+    close(countPipe[1]);
+    if (pid < 0)
+    {
+        UT_LOG_ERROR("fork() failed counting the parallel safe suites: %s", strerror(errno));
+    }
+    else
+    {
+        if (read(countPipe[0], &count, sizeof(count)) != (ssize_t)sizeof(count))
+        {
+            count = 0;
+        }
+        waitpid(pid, &status, 0);
+    }
+    close(countPipe[0]);
+    return count;
+}
+
+/**
+ * @brief Runs the tests with a pool of `-j` worker processes.
+ *
+ * The workers are forked before Google Test is initialised, so each sets up its own report,
+ * `<results>-report-worker<n>.xml`, and its own listeners. Each worker runs its share of the
+ * parallel safe suites, see UTTestRunner::applyWorkerPool(). Once they have all exited this process
+ * runs the remaining suites one after the other, then merges every report into the `-report.xml` file.
+ *
+ * @return false if there are not enough parallel safe suites for a pool, nothing has run.
+ */
+static bool runWorkerPool(int jobs)
+{
+    const std::string results = gResultsFilenameRoot + ".log";
+    int parallelSuites = countParallelSuites();
+
+    jobs = std::min(jobs, parallelSuites);
+    if ((jobs < 2) || gResultsFilenameRoot.empty())
+    {
+        UT_LOG("Parallel jobs: [%d] parallel safe suites, running serially", parallelSuites);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> statuses(jobs, 0);
+    gWorkerPids.assign(jobs, -1);
+    for (int worker = 0; worker < jobs; ++worker)
+    {
+        // Anything buffered would otherwise be written by this process and again by the worker
+        UT_log_async_flush();
+        std::cout << std::flush;
+        fflush(nullptr);
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            UT_LOG_ERROR("fork() failed for worker [%d]: %s, its suites run after the workers", worker, strerror(errno));
+            continue;
+        }
+        if (pid == 0)
+        {
+            int result;
+
+            gWorkerIndex = worker;
+            UT_set_results_output_filename(results.c_str());
+            {
+                UTTestRunner runner;
+                result = runner.runIterations();
+            }
+            UT_perf_summary();
+            UT_memory_summary();
+            UT_fixture_run_end();
+            UT_log_async_flush();
+            std::cout << std::flush;
+            fflush(nullptr);
+            _exit((result == 0) ? 0 : 1);
+        }
+        gWorkerPids[worker] = pid;
+    }
+
+    for (int worker = 0; worker < jobs; ++worker)
+    {
+        if (gWorkerPids[worker] > 0)
+        {
+            waitpid(gWorkerPids[worker], &statuses[worker], 0);
+        }
+    }
+
+    // The suites left to this process, then the merge of every report
+    UT_set_results_output_filename(results.c_str());
+    UTTestRunner runner;
+    runner.runIterations();
+    UT_perf_summary();
+    UT_memory_summary();
+    UT_fixture_run_end();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    UTMergedReport merged = runner.mergePool(statuses, seconds);
+
+    UT_LOG("Parallel jobs: [%d] workers, [%d] tests, [%d] failed, [%.3f]s", jobs, merged.tests, merged.failures + merged.errors, seconds);
+    if (UT_get_test_mode() == UT_MODE_BASIC)
+    {
+        std::cout << "\nRun Summary (" << jobs << " workers):\n"
+                  << "  Tests     : " << merged.tests << "\n"
+                  << "  Failed    : " << merged.failures + merged.errors << "\n"
+                  << "  Disabled  : " << merged.disabled << "\n"
+                  << "  Elapsed   : " << std::fixed << std::setprecision(3) << seconds << "s\n" << std::flush;
+    }
+    return true;
+}
+
 UT_status_t UT_run_tests()
 {
     UT_STATUS eStatus = UT_STATUS_CONTINUE;
 
+    if ((gParallelJobs > 1) && (UT_get_test_mode() == UT_MODE_CONSOLE))
+    {
+        UT_LOG_WARNING("Parallel jobs are not supported in Console Mode, running serially");
+    }
+    if (UT_stress_enabled() && (UT_get_test_mode() == UT_MODE_CONSOLE))
+    {
+        UT_LOG_WARNING("Stress runs are not supported in Console Mode, running once");
+        UT_stress_configure(0, 0, false);
+    }
+
+    // The pool workers inherit the records file, each runs the iterations of its own suites
+    UT_stress_begin();
+    if ((gParallelJobs > 1) && (UT_get_test_mode() != UT_MODE_CONSOLE) && runWorkerPool(gParallelJobs))
+    {
+        UT_stress_end();
+        UT_LOG( UT_LOG_ASCII_GREEN "Logfile" UT_LOG_ASCII_NC ":[" UT_LOG_ASCII_YELLOW "%s" UT_LOG_ASCII_NC "]\n", UT_log_getLogFilename() );
+        UT_exit();
+        return UT_STATUS_OK;
+    }
+
     UTTestRunner testRunner;
 
     if (UT_get_test_mode() == UT_MODE_CONSOLE)
@@ -1345,13 +2406,17 @@ UT_status_t UT_run_tests()
     }
     else if (UT_get_test_mode() == UT_MODE_AUTOMATED)
     {
-        testRunner.runTests();
+        testRunner.runIterations();
     }
     else
     {
-        testRunner.runTests();
+        testRunner.runIterations();
         testRunner.displayRunSummary();
     }
+    UT_perf_summary();
+    UT_memory_summary();
+    UT_fixture_run_end();
+    UT_stress_end();
 
     UT_LOG( UT_LOG_ASCII_GREEN "Logfile" UT_LOG_ASCII_NC ":[" UT_LOG_ASCII_YELLOW "%s" UT_LOG_ASCII_NC "]\n", UT_log_getLogFilename() );
     UT_exit();
@@ -0,0 +1,133 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "ut_histogram.h"
+
+#define SUB_BUCKETS (1u << UT_HISTOGRAM_SUB_BUCKET_BITS)
+
+/*
+ * A value of magnitude 2^m, m >= UT_HISTOGRAM_SUB_BUCKET_BITS, keeps its top bits and loses
+ * shift = m - UT_HISTOGRAM_SUB_BUCKET_BITS low bits, bucket = shift * SUB_BUCKETS + (value >> shift).
+ * Smaller values have a shift of 0 and are their own bucket.
+ */
+size_t UTHistogram::bucketOf(uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return (size_t)value;
+    }
+    unsigned int shift = (63u - (unsigned int)__builtin_clzll(value)) - UT_HISTOGRAM_SUB_BUCKET_BITS;
+    return (size_t)shift * SUB_BUCKETS + (size_t)(value >> shift);
+}
+
+static unsigned int shiftOf(size_t bucket)
+{
+    return (bucket < 2 * SUB_BUCKETS) ? 0u : (unsigned int)(bucket / SUB_BUCKETS - 1);
+}
+
+uint64_t UTHistogram::lowestValueOf(size_t bucket)
+{
+    unsigned int shift = shiftOf(bucket);
+    return (uint64_t)(bucket - (size_t)shift * SUB_BUCKETS) << shift;
+}
+
+uint64_t UTHistogram::highestValueOf(size_t bucket)
+{
+    return lowestValueOf(bucket) + ((uint64_t)1 << shiftOf(bucket)) - 1;
+}
+
+void UTHistogram::record(uint64_t value)
+{
+    size_t bucket = bucketOf(value);
+
+    if (bucket >= counts.size())
+    {
+        counts.resize(bucket + 1, 0);
+    }
+    counts[bucket]++;
+    total++;
+    sum += value;
+    lowest = std::min(lowest, value);
+    highest = std::max(highest, value);
+}
+
+void UTHistogram::merge(const UTHistogram &other)
+{
+    if (other.counts.size() > counts.size())
+    {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    lowest = std::min(lowest, other.lowest);
+    highest = std::max(highest, other.highest);
+}
+
+void UTHistogram::clear()
+{
+    counts.clear();
+    total = 0;
+    sum = 0;
+    lowest = UINT64_MAX;
+    highest = 0;
+}
+
+uint64_t UTHistogram::percentile(double percentile) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // The rank of the value at the percentile, 1 based
+    double wanted = std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * (double)total);
+    uint64_t rank = std::max<uint64_t>((uint64_t)wanted, 1);
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return std::min(highestValueOf(i), highest);
+        }
+    }
+    return highest;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> UTHistogram::buckets() const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> used;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        if (counts[i] != 0)
+        {
+            used.emplace_back(lowestValueOf(i), counts[i]);
+        }
+    }
+    return used;
+}
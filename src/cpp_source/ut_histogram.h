@@ -0,0 +1,107 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @brief
+ * HDR style latency histogram.
+ *
+ * Values below 2^UT_HISTOGRAM_SUB_BUCKET_BITS are counted exactly, larger values fall in
+ * log-linear buckets, each power of 2 split into 2^UT_HISTOGRAM_SUB_BUCKET_BITS equal steps. A
+ * recorded value is therefore known to within 1/32 of itself, whatever its magnitude, and the
+ * bucket array only grows as far as the largest value recorded.
+ */
+/** @addtogroup UT_GTEST
+ * @{
+ */
+
+#ifndef __UT_HISTOGRAM_H
+#define __UT_HISTOGRAM_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define UT_HISTOGRAM_SUB_BUCKET_BITS (5)
+
+/**
+ * @class UTHistogram
+ * @brief Counts values, e.g. durations in microseconds, and answers percentiles.
+ */
+class UTHistogram
+{
+public:
+    /**
+     * @brief Counts a value.
+     */
+    void record(uint64_t value);
+
+    /**
+     * @brief Adds the counts of another histogram.
+     */
+    void merge(const UTHistogram &other);
+
+    /**
+     * @brief Forgets every value.
+     */
+    void clear();
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return (total > 0) ? lowest : 0; }
+    uint64_t max() const { return highest; }
+    double mean() const { return (total > 0) ? (double)sum / (double)total : 0.0; }
+
+    /**
+     * @brief Gets the value at a percentile.
+     *
+     * @param percentile Percentile, 0 to 100.
+     * @return The highest value of the bucket holding the percentile, capped by max(), 0 when empty.
+     */
+    uint64_t percentile(double percentile) const;
+
+    /**
+     * @brief Gets the buckets holding values.
+     *
+     * @return Pairs of the lowest value of a bucket and its count, in value order.
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> buckets() const;
+
+    /**
+     * @brief Gets the bucket of a value.
+     */
+    static size_t bucketOf(uint64_t value);
+
+    /**
+     * @brief Gets the lowest value counted in a bucket.
+     */
+    static uint64_t lowestValueOf(size_t bucket);
+
+    /**
+     * @brief Gets the highest value counted in a bucket.
+     */
+    static uint64_t highestValueOf(size_t bucket);
+
+private:
+    std::vector<uint64_t> counts;   /*!< Per bucket, sized to the highest bucket used */
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t lowest = UINT64_MAX;
+    uint64_t highest = 0;
+};
+
+#endif /* __UT_HISTOGRAM_H */
+/** @} */
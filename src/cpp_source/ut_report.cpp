@@ -0,0 +1,238 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <sys/wait.h>
+
+#include <ut_log.h>
+#include "ut_report.h"
+
+/**
+ * @brief Gets an attribute of the first tag in a piece of xml, empty if it is not there.
+ */
+static std::string xmlAttribute(const std::string &xml, const std::string &name)
+{
+    std::string key = " " + name + "=\"";
+    size_t end = xml.find('>');
+    size_t pos = xml.find(key);
+
+    if ((pos == std::string::npos) || (pos > end))
+    {
+        return std::string();
+    }
+    pos += key.size();
+    return xml.substr(pos, xml.find('"', pos) - pos);
+}
+
+static int xmlCount(const std::string &xml, const std::string &name)
+{
+    std::string value = xmlAttribute(xml, name);
+    return value.empty() ? 0 : std::atoi(value.c_str());
+}
+
+std::string xmlEscape(const std::string &text)
+{
+    std::string escaped;
+
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            case '\'':
+                escaped += "&apos;";
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+std::string testSuiteBlock(const std::string &suiteName, const std::vector<UTReportTest> &tests)
+{
+    std::ostringstream block;
+    std::string suite = xmlEscape(suiteName);
+    double seconds = 0;
+    int failures = 0;
+    int skipped = 0;
+
+    for (const auto &test : tests)
+    {
+        seconds += test.seconds;
+        failures += test.failures.empty() ? 0 : 1;
+        skipped += test.skipped ? 1 : 0;
+    }
+
+    block << std::fixed << std::setprecision(3)
+          << "  <testsuite name=\"" << suite << "\" tests=\"" << tests.size() << "\" failures=\"" << failures
+          << "\" disabled=\"0\" skipped=\"" << skipped << "\" errors=\"0\" time=\"" << seconds << "\">\n";
+    for (const auto &test : tests)
+    {
+        block << "    <testcase name=\"" << xmlEscape(test.name) << "\" status=\"run\" result=\""
+              << (test.skipped ? "skipped" : "completed") << "\" time=\"" << test.seconds << "\" classname=\"" << suite << "\">\n";
+        for (const auto &failure : test.failures)
+        {
+            std::string message = xmlEscape(failure);
+            block << "      <failure message=\"" << message << "\" type=\"\">" << message << "</failure>\n";
+        }
+        if (test.skipped)
+        {
+            block << "      <skipped message=\"\"></skipped>\n";
+        }
+        block << "    </testcase>\n";
+    }
+    block << "  </testsuite>\n";
+    return block.str();
+}
+
+bool writeReport(const std::string &output, const UTMergedReport &totals, const std::string &timestamp, double seconds,
+                 const std::string &blocks)
+{
+    std::ofstream out(output, std::ios::trunc);
+
+    if (!out)
+    {
+        return false;
+    }
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<testsuites tests=\"" << totals.tests << "\" failures=\"" << totals.failures << "\" disabled=\"" << totals.disabled
+        << "\" errors=\"" << totals.errors << "\" timestamp=\"" << timestamp << "\" time=\"" << std::fixed << std::setprecision(3) << seconds
+        << "\" name=\"AllTests\">\n"
+        << blocks << "</testsuites>\n";
+    out.flush();
+    return out.good();
+}
+
+std::string missingSuiteBlock(const std::string &suiteName, int worker, int status)
+{
+    std::string reason = "Worker [" + std::to_string(worker) + "] left no report, ";
+
+    if (WIFSIGNALED(status))
+    {
+        reason += "killed by signal " + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+    }
+    else
+    {
+        reason += "exited with code " + std::to_string(WEXITSTATUS(status));
+    }
+    return "  <testsuite name=\"" + suiteName + "\" tests=\"1\" failures=\"1\" disabled=\"0\" skipped=\"0\" errors=\"0\" time=\"0\">\n"
+           "    <testcase name=\"worker\" status=\"run\" result=\"completed\" time=\"0\" classname=\"" + suiteName + "\">\n"
+           "      <failure message=\"" + reason + "\" type=\"\"><![CDATA[" + reason + "]]></failure>\n"
+           "    </testcase>\n"
+           "  </testsuite>\n";
+}
+
+UTMergedReport mergeReports(const std::vector<std::pair<std::string, std::string>> &reports, const std::vector<std::string> &order,
+                            const std::string &output, double seconds)
+{
+    UTMergedReport merged;
+    std::map<std::string, std::string> blocks;
+    std::string unordered;
+    std::string timestamp;
+
+    for (const auto &[filename, missing] : reports)
+    {
+        std::ifstream file(filename);
+        std::stringstream content;
+        std::string xml;
+        std::string body;
+
+        if (file.is_open())
+        {
+            content << file.rdbuf();
+            xml = content.str();
+        }
+
+        size_t root = xml.find("<testsuites");
+        size_t end = xml.rfind("</testsuites>");
+        if ((root == std::string::npos) || (end == std::string::npos))
+        {
+            UT_LOG_ERROR("Report [%s] is missing or incomplete", filename.c_str());
+            body = missing;
+        }
+        else
+        {
+            std::string header = xml.substr(root, xml.find('>', root) - root + 1);
+
+            body = xml.substr(root + header.size(), end - root - header.size());
+            if (timestamp.empty())
+            {
+                timestamp = xmlAttribute(header, "timestamp");
+            }
+        }
+        std::remove(filename.c_str());
+
+        for (size_t pos = body.find("<testsuite "); pos != std::string::npos; pos = body.find("<testsuite ", pos))
+        {
+            size_t close = body.find("</testsuite>", pos);
+            size_t next = (close == std::string::npos) ? body.size() : close + sizeof("</testsuite>") - 1;
+            std::string block = "  " + body.substr(pos, next - pos) + "\n";
+            std::string name = xmlAttribute(block.substr(2), "name");
+
+            merged.tests += xmlCount(block.substr(2), "tests");
+            merged.failures += xmlCount(block.substr(2), "failures");
+            merged.disabled += xmlCount(block.substr(2), "disabled");
+            merged.errors += xmlCount(block.substr(2), "errors");
+            if (std::find(order.begin(), order.end(), name) == order.end())
+            {
+                unordered += block;
+            }
+            else
+            {
+                blocks[name] += block;
+            }
+            pos = next;
+        }
+    }
+
+    std::string ordered;
+    for (const auto &name : order)
+    {
+        auto it = blocks.find(name);
+        if (it != blocks.end())
+        {
+            ordered += it->second;
+        }
+    }
+    if (writeReport(output, merged, timestamp, seconds, ordered + unordered) == false)
+    {
+        UT_LOG_ERROR("Unable to write the merged report [%s]", output.c_str());
+    }
+    return merged;
+}
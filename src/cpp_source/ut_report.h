@@ -0,0 +1,105 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @brief
+ * Merge of the gtest xml reports written by the processes of a `-j` worker pool, and the report
+ * written by the timeout watchdog.
+ */
+/** @addtogroup UT_GTEST
+ * @{
+ */
+
+#ifndef __UT_REPORT_H
+#define __UT_REPORT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Totals of a report merged by mergeReports().
+ */
+struct UTMergedReport
+{
+    int tests = 0;
+    int failures = 0;
+    int disabled = 0;
+    int errors = 0;
+};
+
+/**
+ * @brief A test written by testSuiteBlock().
+ */
+struct UTReportTest
+{
+    std::string name;
+    double seconds = 0;
+    bool skipped = false;
+    std::vector<std::string> failures;  /*!< Message of each failed assertion */
+};
+
+/**
+ * @brief Escapes the xml control characters of a name or message.
+ */
+std::string xmlEscape(const std::string &text);
+
+/**
+ * @brief Builds the `<testsuite>` of a suite from its tests, in the gtest xml report format.
+ */
+std::string testSuiteBlock(const std::string &suiteName, const std::vector<UTReportTest> &tests);
+
+/**
+ * @brief Writes a gtest xml report from its `<testsuite>` blocks.
+ *
+ * @param output The report.
+ * @param totals Totals of the `<testsuites>` element.
+ * @param timestamp Start of the run.
+ * @param seconds Elapsed time of the run.
+ * @param blocks The `<testsuite>` blocks.
+ * @return true if the report was written.
+ */
+bool writeReport(const std::string &output, const UTMergedReport &totals, const std::string &timestamp, double seconds,
+                 const std::string &blocks);
+
+/**
+ * @brief Builds the `<testsuite>` of a suite whose worker left no report, failing it.
+ *
+ * @param suiteName The suite.
+ * @param worker Index of the worker.
+ * @param status Exit status of the worker, from waitpid().
+ */
+std::string missingSuiteBlock(const std::string &suiteName, int worker, int status);
+
+/**
+ * @brief Merges gtest xml reports into one, then removes them.
+ *
+ * The `<testsuite>` blocks of every report are written in the order of the suites, the totals of
+ * `<testsuites>` are summed and its time is the elapsed time of the whole run.
+ *
+ * @param reports Each report, with the `<testsuite>` blocks to use should it be missing.
+ * @param order Suite names, in the order they are written.
+ * @param output The merged report.
+ * @param seconds Elapsed time of the run.
+ * @return The totals of the merged report.
+ */
+UTMergedReport mergeReports(const std::vector<std::pair<std::string, std::string>> &reports, const std::vector<std::string> &order,
+                            const std::string &output, double seconds);
+
+#endif  /*  __UT_REPORT_H  */
+/** @} */
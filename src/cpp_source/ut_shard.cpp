@@ -0,0 +1,103 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <utility>
+
+#include <ut_log.h>
+#include "ut_shard.h"
+
+std::map<std::string, double> readSuiteDurations(const std::string &reports)
+{
+    std::map<std::string, double> durations;
+    const std::regex suitePattern("<testsuite\\s[^>]*?name=\"([^\"]*)\"[^>]*?time=\"([0-9.]+)\"");
+    std::stringstream list(reports);
+    std::string report;
+
+    while (std::getline(list, report, ','))
+    {
+        std::ifstream file(report);
+        std::string line;
+
+        if (!file.is_open())
+        {
+            UT_LOG_WARNING("Shard history [%s] not found", report.c_str());
+            continue;
+        }
+        while (std::getline(file, line))
+        {
+            std::smatch match;
+            if (std::regex_search(line, match, suitePattern))
+            {
+                durations[match[1].str()] += std::stod(match[2].str());
+            }
+        }
+    }
+    return durations;
+}
+
+std::vector<int> dealSuites(const std::vector<UTDealtSuite> &suites, int parts, const std::map<std::string, double> &durations,
+                            std::vector<double> &load)
+{
+    double knownTime = 0.0;
+    size_t knownTests = 0;
+
+    for (const auto &suite : suites)
+    {
+        auto it = durations.find(suite.name);
+        if (it != durations.end())
+        {
+            knownTime += it->second;
+            knownTests += suite.tests;
+        }
+    }
+    double perTest = (knownTests > 0) ? (knownTime / knownTests) : 1.0;
+
+    std::vector<std::pair<double, size_t>> weighted;
+    for (size_t i = 0; i < suites.size(); ++i)
+    {
+        auto it = durations.find(suites[i].name);
+        double weight = (it != durations.end()) ? it->second : perTest * suites[i].tests;
+        weighted.emplace_back(weight, i);
+    }
+
+    std::sort(weighted.begin(), weighted.end(), [&suites](const auto &a, const auto &b)
+              { return (a.first != b.first) ? (a.first > b.first) : (suites[a.second].name < suites[b.second].name); });
+
+    // Part load is (weight, suite count) so zero weight suites are still spread out
+    std::vector<std::pair<double, int>> partLoad(parts, {0.0, 0});
+    std::vector<int> owners(suites.size(), 0);
+    for (const auto &[weight, index] : weighted)
+    {
+        int part = std::min_element(partLoad.begin(), partLoad.end()) - partLoad.begin();
+        partLoad[part].first += weight;
+        partLoad[part].second++;
+        owners[index] = part;
+    }
+
+    load.clear();
+    for (const auto &part : partLoad)
+    {
+        load.push_back(part.first);
+    }
+    return owners;
+}
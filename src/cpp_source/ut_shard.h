@@ -0,0 +1,74 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @brief
+ * Split of the gtest suites between shards, or between the processes of a `-j` worker pool.
+ */
+/** @addtogroup UT_GTEST
+ * @{
+ */
+
+#ifndef __UT_SHARD_H
+#define __UT_SHARD_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A suite to deal, see dealSuites().
+ */
+struct UTDealtSuite
+{
+    std::string name;
+    size_t tests = 0;
+};
+
+/**
+ * @brief Reads the per suite durations from previous gtest xml reports.
+ *
+ * Each report in the comma separated list is scanned for `<testsuite name="..." time="...">`
+ * entries, durations for the same suite found in more than one report are summed. A report
+ * that cannot be opened is logged and skipped.
+ *
+ * @param reports A comma separated list of report filenames.
+ * @return Suite name to duration in seconds.
+ */
+std::map<std::string, double> readSuiteDurations(const std::string &reports);
+
+/**
+ * @brief Deals suites between parts, e.g. shards or worker processes.
+ *
+ * Each suite is weighted by its duration in the history, suites without history use the
+ * mean per test duration times their test count, and with no history at all every test weighs
+ * the same. Suites are then handed out heaviest first to the least loaded part (ties broken by
+ * name, suite count and part index), so every process given the same suites and history agrees
+ * on the split.
+ *
+ * @param suites The suites to deal.
+ * @param parts The number of parts.
+ * @param durations The history, from readSuiteDurations().
+ * @param load Set to the estimated weight of each part.
+ * @return The part of each suite, in the order of the suites.
+ */
+std::vector<int> dealSuites(const std::vector<UTDealtSuite> &suites, int parts, const std::map<std::string, double> &durations,
+                            std::vector<double> &load);
+
+#endif  /*  __UT_SHARD_H  */
+/** @} */
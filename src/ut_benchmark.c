@@ -0,0 +1,125 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* stdlib */
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_internal.h"
+
+#define UT_BENCHMARK_WARMUP_NS     (10 * 1000 * 1000)   /*!< Time spent warming up before calibrating */
+#define UT_BENCHMARK_SAMPLE_NS     (1000 * 1000)        /*!< Target duration of one timed sample */
+#define UT_BENCHMARK_SAMPLES       (100)                /*!< Number of timed samples taken */
+#define UT_BENCHMARK_MAX_ITERATIONS (1u << 30)          /*!< Upper limit of iterations per sample */
+
+/**
+ * @brief Times a batch of calls
+ *
+ * @param pFunction - function to call
+ * @param iterations - number of calls
+ * @return uint64_t - elapsed time in nanoseconds
+ */
+static uint64_t benchmark_batch_ns( UT_benchmark_function_t pFunction, uint64_t iterations )
+{
+    uint64_t start = UT_get_monotonic_ns();
+
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        pFunction();
+    }
+    return UT_get_monotonic_ns() - start;
+}
+
+static int benchmark_compare( const void *a, const void *b )
+{
+    double lhs = *(const double *)a;
+    double rhs = *(const double *)b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+void UT_benchmark_run( UT_benchmark_function_t pFunction, UT_benchmark_stats_t *pStats )
+{
+    double samples[UT_BENCHMARK_SAMPLES];
+    uint64_t iterations = 1;
+    uint64_t start;
+    double sum = 0.0;
+    double variance = 0.0;
+
+    memset( pStats, 0, sizeof(*pStats) );
+    if ( pFunction == NULL )
+    {
+        return;
+    }
+
+    /* Warm up caches, branch predictors and any lazy initialisation */
+    start = UT_get_monotonic_ns();
+    do
+    {
+        pFunction();
+    } while ( (UT_get_monotonic_ns() - start) < UT_BENCHMARK_WARMUP_NS );
+
+    /* Calibrate, double the iterations until one sample takes long enough to time */
+    while ( (benchmark_batch_ns( pFunction, iterations ) < UT_BENCHMARK_SAMPLE_NS) &&
+            (iterations < UT_BENCHMARK_MAX_ITERATIONS) )
+    {
+        iterations *= 2;
+    }
+
+    for (int i = 0; i < UT_BENCHMARK_SAMPLES; i++)
+    {
+        samples[i] = (double)benchmark_batch_ns( pFunction, iterations ) / (double)iterations;
+        sum += samples[i];
+    }
+
+    qsort( samples, UT_BENCHMARK_SAMPLES, sizeof(samples[0]), benchmark_compare );
+
+    pStats->iterations = iterations;
+    pStats->samples = UT_BENCHMARK_SAMPLES;
+    pStats->mean = sum / UT_BENCHMARK_SAMPLES;
+    for (int i = 0; i < UT_BENCHMARK_SAMPLES; i++)
+    {
+        variance += (samples[i] - pStats->mean) * (samples[i] - pStats->mean);
+    }
+    pStats->stddev = sqrt( variance / (UT_BENCHMARK_SAMPLES - 1) );
+    pStats->min = samples[0];
+    pStats->median = (UT_BENCHMARK_SAMPLES % 2) ? samples[UT_BENCHMARK_SAMPLES / 2] :
+                     (samples[(UT_BENCHMARK_SAMPLES / 2) - 1] + samples[UT_BENCHMARK_SAMPLES / 2]) / 2.0;
+    /* Nearest rank, ceil(0.99 * N) - 1 */
+    pStats->p99 = samples[((99 * UT_BENCHMARK_SAMPLES + 99) / 100) - 1];
+}
+
+void UT_benchmark_log( const char *pName, const UT_benchmark_stats_t *pStats )
+{
+    UT_LOG( UT_LOG_ASCII_GREEN "Benchmark" UT_LOG_ASCII_NC " [%s] %llu x %u samples, ns/iteration: min [%.1f] median [%.1f] p99 [%.1f] mean [%.1f] stddev [%.1f]",
+            pName,
+            (unsigned long long)pStats->iterations,
+            pStats->samples,
+            pStats->min,
+            pStats->median,
+            pStats->p99,
+            pStats->mean,
+            pStats->stddev );
+}
@@ -0,0 +1,190 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_coverage.h"
+
+#define UT_COVERAGE_ROOT_SIZE   (512)
+#define UT_COVERAGE_PATH_SIZE   (1024)  /*!< Fits the root, the suite and test names and test.name */
+#define UT_COVERAGE_NAME_SIZE   (128)   /*!< Suite and test directory names are truncated to this */
+
+#ifdef UT_COVERAGE
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* libgcov, linked with --coverage */
+extern void __gcov_dump(void);
+extern void __gcov_reset(void);
+#ifdef __cplusplus
+}
+#endif
+
+static char gRoot[UT_COVERAGE_ROOT_SIZE];
+static char gOutsideTests[UT_COVERAGE_PATH_SIZE];
+
+/**
+ * @brief Creates a directory and its parents
+ */
+static int makeDirectories( const char *pPath )
+{
+    char path[UT_COVERAGE_PATH_SIZE];
+
+    snprintf( path, sizeof(path), "%s", pPath );
+    for (char *p = path + 1; *p != '\0'; p++)
+    {
+        if ( *p == '/' )
+        {
+            *p = '\0';
+            if ( (mkdir( path, 0755 ) != 0) && (errno != EEXIST) )
+            {
+                return -1;
+            }
+            *p = '/';
+        }
+    }
+    if ( (mkdir( path, 0755 ) != 0) && (errno != EEXIST) )
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copies a suite or test name into a directory name, characters other than [A-Za-z0-9._-] become '_'
+ */
+static void directoryName( char *pOut, size_t size, const char *pName )
+{
+    size_t i;
+
+    for (i = 0; (pName[i] != '\0') && (i < size - 1); i++)
+    {
+        char c = pName[i];
+        bool bKeep = ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) ||
+                     (c == '.') || (c == '_') || (c == '-');
+
+        pOut[i] = bKeep ? c : '_';
+    }
+    pOut[i] = '\0';
+    if ( (strcmp( pOut, "" ) == 0) || (strcmp( pOut, "." ) == 0) || (strcmp( pOut, ".." ) == 0) )
+    {
+        snprintf( pOut, size, "_" );
+    }
+}
+#endif
+
+static bool gbEnabled = false;
+
+int UT_coverage_start(const char *pDir)
+{
+#ifdef UT_COVERAGE
+    if ( pDir != NULL )
+    {
+        snprintf( gRoot, sizeof(gRoot), "%s", pDir );
+    }
+    else
+    {
+        const char *pLogFile = UT_log_getLogFilename();
+        const char *pSlash = ((pLogFile != NULL) ? strrchr( pLogFile, '/' ) : NULL);
+
+        if ( pSlash != NULL )
+        {
+            snprintf( gRoot, sizeof(gRoot), "%.*s/coverage", (int)(pSlash - pLogFile), pLogFile );
+        }
+        else
+        {
+            snprintf( gRoot, sizeof(gRoot), "coverage" );
+        }
+    }
+    snprintf( gOutsideTests, sizeof(gOutsideTests), "%s/outside-tests", gRoot );
+
+    if ( makeDirectories( gOutsideTests ) != 0 )
+    {
+        UT_LOG_ERROR( "Coverage: unable to create [%s]: %s, per test coverage is off\n", gOutsideTests, strerror( errno ) );
+        return -1;
+    }
+    /* Anything counted before the first test goes to it, the exit dump of libgcov uses this prefix */
+    setenv( "GCOV_PREFIX", gOutsideTests, 1 );
+    gbEnabled = true;
+    UT_LOG( "Coverage: per test counters under [%s]", gRoot );
+    return 0;
+#else
+    if ( pDir != NULL )
+    {
+        UT_LOG_WARNING( "Coverage: not a COVERAGE=1 build, per test coverage is off" );
+    }
+    return -1;
+#endif
+}
+
+bool UT_coverage_enabled(void)
+{
+    return gbEnabled;
+}
+
+void UT_coverage_test_end(const char *pSuite, const char *pTest)
+{
+#ifdef UT_COVERAGE
+    char suite[UT_COVERAGE_NAME_SIZE];
+    char test[UT_COVERAGE_NAME_SIZE];
+    char path[UT_COVERAGE_PATH_SIZE];
+    FILE *pName;
+
+    if ( gbEnabled == false )
+    {
+        return;
+    }
+
+    directoryName( suite, sizeof(suite), pSuite );
+    directoryName( test, sizeof(test), pTest );
+    snprintf( path, sizeof(path), "%s/tests/%s/%s", gRoot, suite, test );
+    if ( makeDirectories( path ) != 0 )
+    {
+        UT_LOG_ERROR( "Coverage: unable to create [%s]: %s\n", path, strerror( errno ) );
+        return;
+    }
+
+    /* The directory names are mangled, the report reads the real names from here */
+    snprintf( path, sizeof(path), "%s/tests/%s/%s/test.name", gRoot, suite, test );
+    pName = fopen( path, "w" );
+    if ( pName != NULL )
+    {
+        fprintf( pName, "%s\t%s\n", pSuite, pTest );
+        fclose( pName );
+    }
+
+    /* libgcov reads GCOV_PREFIX on every dump, and merges with the counters of an earlier run of the test */
+    snprintf( path, sizeof(path), "%s/tests/%s/%s", gRoot, suite, test );
+    setenv( "GCOV_PREFIX", path, 1 );
+    __gcov_dump();
+    __gcov_reset();
+    setenv( "GCOV_PREFIX", gOutsideTests, 1 );
+#else
+    (void)pSuite;
+    (void)pTest;
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Per test code coverage
+ *
+ * A `make COVERAGE=1` build compiles the weak stubs library with `--coverage`, as the HAL library
+ * should be, and defines UT_COVERAGE. As each test completes its counters are written with __gcov_dump() under
+ * `<dir>/tests/<suite>/<test>/`, then cleared with __gcov_reset(), so every test directory holds the
+ * coverage of that test alone. The counters of code run between tests, such as a suite set up, go
+ * to the next test. What runs after the last test is written to `<dir>/outside-tests/` at exit.
+ *
+ * `scripts/ut_coverage_report.py` merges the test directories and lists the coverage of each test.
+ */
+
+#ifndef __UT_COVERAGE_H
+#define __UT_COVERAGE_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Starts writing the coverage of each test under a directory
+ *
+ * Called on every run, it only has an effect in a COVERAGE=1 build.
+ *
+ * @param pDir - coverage directory, NULL for `coverage/` beside the log file
+ * @return int - 0 on success, -1 if the binary is not built with COVERAGE=1
+ */
+extern int UT_coverage_start(const char *pDir);
+
+/**
+ * @brief Checks whether the coverage of each test is written
+ */
+extern bool UT_coverage_enabled(void);
+
+/**
+ * @brief Writes and clears the counters gathered since the last test completed, under a test
+ *
+ * @param pSuite - suite name
+ * @param pTest - test name
+ */
+extern void UT_coverage_test_end(const char *pSuite, const char *pTest);
+
+#endif  /*  __UT_COVERAGE_H  */
+/** @} */
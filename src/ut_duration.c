@@ -0,0 +1,63 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* stdlib */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+
+uint64_t UT_get_monotonic_ns( void )
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ull) + (uint64_t)now.tv_nsec;
+}
+
+double UT_get_duration_budget_ms( const char *pKey, double budgetMs )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    char *pEnd = NULL;
+    double overrideMs;
+
+    if ( pKey == NULL )
+    {
+        return budgetMs;
+    }
+
+    if ( (ut_kvp_profile_getLayerCount() == 0) ||
+         (ut_kvp_profile_getStringField( pKey, value, sizeof(value) ) != UT_KVP_STATUS_SUCCESS) )
+    {
+        return budgetMs;
+    }
+
+    overrideMs = strtod( value, &pEnd );
+    if ( (pEnd == value) || (overrideMs <= 0.0) )
+    {
+        UT_LOG_WARNING("Invalid duration budget [%s] for [%s], using [%.3f]ms", value, pKey, budgetMs);
+        return budgetMs;
+    }
+    return overrideMs;
+}
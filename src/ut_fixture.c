@@ -0,0 +1,180 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_fixture.h"
+
+/** A registered fixture */
+typedef struct UT_fixture_entry_s
+{
+    char *pSuite;                               /*!< Suite the fixture belongs to, NULL for the run */
+    char *pName;
+    UT_FixtureSetupFunction_t pSetup;
+    UT_FixtureTeardownFunction_t pTeardown;
+    void *pHandle;                              /*!< What pSetup returned */
+    pid_t setUpBy;                              /*!< A forked worker does not tear down what it inherited */
+    bool bSetUp;
+    bool bFailed;                               /*!< pSetup failed, it is not tried again until the scope ends */
+    struct UT_fixture_entry_s *pNext;           /*!< Next registered fixture */
+    struct UT_fixture_entry_s *pNextSetUp;      /*!< Fixture set up before this one */
+} UT_fixture_entry_t;
+
+static UT_fixture_entry_t *gpFixtures = NULL;   /*!< Registered fixtures */
+static UT_fixture_entry_t *gpSetUp = NULL;      /*!< Fixtures that are set up, most recent first */
+
+UT_fixture_t *UT_add_fixture(const char *pSuiteTitle, const char *pName, UT_FixtureSetupFunction_t pSetup, UT_FixtureTeardownFunction_t pTeardown)
+{
+    UT_fixture_entry_t *pEntry;
+
+    if ( (pName == NULL) || (pSetup == NULL) )
+    {
+        return NULL;
+    }
+
+    for (pEntry = gpFixtures; pEntry != NULL; pEntry = pEntry->pNext)
+    {
+        bool bSameScope = (pEntry->pSuite == NULL) ? (pSuiteTitle == NULL) : ((pSuiteTitle != NULL) && (strcmp( pEntry->pSuite, pSuiteTitle ) == 0));
+
+        if ( bSameScope && (strcmp( pEntry->pName, pName ) == 0) )
+        {
+            UT_LOG_WARNING( "Fixture [%s] of [%s] is already registered", pName, (pSuiteTitle != NULL) ? pSuiteTitle : "run" );
+            return (UT_fixture_t *)pEntry;
+        }
+    }
+
+    pEntry = (UT_fixture_entry_t *)calloc( 1, sizeof(UT_fixture_entry_t) );
+    if ( pEntry == NULL )
+    {
+        return NULL;
+    }
+    pEntry->pSuite = (pSuiteTitle != NULL) ? strdup( pSuiteTitle ) : NULL;
+    pEntry->pName = strdup( pName );
+    if ( (pEntry->pName == NULL) || ((pSuiteTitle != NULL) && (pEntry->pSuite == NULL)) )
+    {
+        free( pEntry->pSuite );
+        free( pEntry->pName );
+        free( pEntry );
+        return NULL;
+    }
+    pEntry->pSetup = pSetup;
+    pEntry->pTeardown = pTeardown;
+    pEntry->pNext = gpFixtures;
+    gpFixtures = pEntry;
+    return (UT_fixture_t *)pEntry;
+}
+
+void *UT_get_fixture(UT_fixture_t *pFixture)
+{
+    UT_fixture_entry_t *pEntry = (UT_fixture_entry_t *)pFixture;
+    uint64_t start;
+
+    if ( pEntry == NULL )
+    {
+        return NULL;
+    }
+    if ( pEntry->bSetUp )
+    {
+        return pEntry->pHandle;
+    }
+    if ( pEntry->bFailed )
+    {
+        return NULL;
+    }
+
+    start = UT_get_monotonic_ns();
+    pEntry->pHandle = pEntry->pSetup();
+    if ( pEntry->pHandle == NULL )
+    {
+        UT_LOG_ERROR( "Fixture [%s] of [%s] failed to set up", pEntry->pName, (pEntry->pSuite != NULL) ? pEntry->pSuite : "run" );
+        pEntry->bFailed = true;
+        return NULL;
+    }
+    UT_LOG( "Fixture [%s] of [%s] set up in [%.3f]ms", pEntry->pName, (pEntry->pSuite != NULL) ? pEntry->pSuite : "run",
+            (double)(UT_get_monotonic_ns() - start) / 1e6 );
+    pEntry->bSetUp = true;
+    pEntry->setUpBy = getpid();
+    pEntry->pNextSetUp = gpSetUp;
+    gpSetUp = pEntry;
+    return pEntry->pHandle;
+}
+
+bool UT_fixture_registered(void)
+{
+    return gpFixtures != NULL;
+}
+
+/**
+ * @brief Tears down the fixtures that are set up, those of a suite, or every one
+ *
+ * @param bAll - true for every fixture, false for those of pSuite
+ */
+static void tearDown( bool bAll, const char *pSuite )
+{
+    UT_fixture_entry_t **ppEntry = &gpSetUp;
+
+    while ( *ppEntry != NULL )
+    {
+        UT_fixture_entry_t *pEntry = *ppEntry;
+
+        if ( (bAll == false) && ((pEntry->pSuite == NULL) || (strcmp( pEntry->pSuite, pSuite ) != 0)) )
+        {
+            ppEntry = &pEntry->pNextSetUp;
+            continue;
+        }
+
+        *ppEntry = pEntry->pNextSetUp;
+        if ( (pEntry->pTeardown != NULL) && (pEntry->setUpBy == getpid()) )
+        {
+            pEntry->pTeardown( pEntry->pHandle );
+            UT_LOG( "Fixture [%s] of [%s] torn down", pEntry->pName, (pEntry->pSuite != NULL) ? pEntry->pSuite : "run" );
+        }
+        pEntry->pHandle = NULL;
+        pEntry->bSetUp = false;
+        pEntry->pNextSetUp = NULL;
+    }
+
+    /* The next scope tries the failed fixtures again */
+    for (UT_fixture_entry_t *pEntry = gpFixtures; pEntry != NULL; pEntry = pEntry->pNext)
+    {
+        if ( bAll || ((pEntry->pSuite != NULL) && (strcmp( pEntry->pSuite, pSuite ) == 0)) )
+        {
+            pEntry->bFailed = false;
+        }
+    }
+}
+
+void UT_fixture_suite_end(const char *pSuite)
+{
+    if ( pSuite != NULL )
+    {
+        tearDown( false, pSuite );
+    }
+}
+
+void UT_fixture_run_end(void)
+{
+    tearDown( true, NULL );
+}
@@ -0,0 +1,53 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Scope ends of the lazy fixtures, see UT_add_fixture()
+ *
+ * The fixtures themselves are registered and used through ut.h. The runners end their scopes:
+ * a suite's fixtures as the suite completes, and every fixture still set up as the run ends.
+ */
+
+#ifndef __UT_FIXTURE_H
+#define __UT_FIXTURE_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Checks whether any fixture is registered
+ */
+extern bool UT_fixture_registered(void);
+
+/**
+ * @brief Tears down the fixtures of a suite that are set up, most recently set up first
+ *
+ * @param pSuite - suite name
+ */
+extern void UT_fixture_suite_end(const char *pSuite);
+
+/**
+ * @brief Tears down every fixture that is set up, most recently set up first
+ */
+extern void UT_fixture_run_end(void);
+
+#endif  /*  __UT_FIXTURE_H  */
+/** @} */
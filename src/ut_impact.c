@@ -0,0 +1,401 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* dladdr() */
+#endif
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_impact.h"
+
+#define UT_IMPACT_NO_INSTRUMENT __attribute__((no_instrument_function))
+#define UT_IMPACT_LINE_SIZE     (1024)
+#define UT_IMPACT_MAX_PROBES    (32)    /*!< Slots tried before a function is counted as an overflow */
+
+#ifdef UT_IMPACT
+#ifdef __cplusplus
+extern "C" {
+#endif
+void __cyg_profile_func_enter(void *pFunction, void *pCallSite) UT_IMPACT_NO_INSTRUMENT;
+void __cyg_profile_func_exit(void *pFunction, void *pCallSite) UT_IMPACT_NO_INSTRUMENT;
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/** A sorted, de-duplicated list of names */
+typedef struct
+{
+    char **ppNames;
+    size_t count;
+    size_t capacity;
+} UT_impact_names_t;
+
+static int gMapFd = -1;
+static void *gEntered[UT_IMPACT_MAX_FUNCTIONS];  /*!< Open addressed set of the entered functions, NULL is empty */
+static unsigned int gEnteredOverflow = 0;       /*!< Functions that did not fit in the set since the last test */
+static bool gbSelecting = false;
+static UT_impact_names_t gKnownSuites;
+static UT_impact_names_t gAffectedSuites;
+
+#ifdef UT_IMPACT
+/**
+ * @brief Called on the entry of every instrumented function, adds it to the set
+ *
+ * Tests may start threads, slots are claimed with a compare and swap so nothing is lost or locked.
+ * The probe sequence is bounded, so a set filling up does not slow every call down.
+ */
+void __cyg_profile_func_enter(void *pFunction, void *pCallSite)
+{
+    uintptr_t hash;
+
+    (void)pCallSite;
+    if ( __atomic_load_n( &gMapFd, __ATOMIC_RELAXED ) < 0 )
+    {
+        return;
+    }
+
+    hash = ((uintptr_t)pFunction >> 4) * 0x9E3779B1u;
+    for (unsigned int probe = 0; probe < UT_IMPACT_MAX_PROBES; probe++)
+    {
+        void **ppSlot = &gEntered[(hash + probe) & (UT_IMPACT_MAX_FUNCTIONS - 1)];
+        void *pExpected = NULL;
+
+        if ( __atomic_load_n( ppSlot, __ATOMIC_RELAXED ) == pFunction )
+        {
+            return;
+        }
+        if ( __atomic_compare_exchange_n( ppSlot, &pExpected, pFunction, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ||
+             (pExpected == pFunction) )
+        {
+            return;
+        }
+    }
+    __atomic_fetch_add( &gEnteredOverflow, 1, __ATOMIC_RELAXED );
+}
+
+void __cyg_profile_func_exit(void *pFunction, void *pCallSite)
+{
+    (void)pFunction;
+    (void)pCallSite;
+}
+#endif
+
+int UT_impact_record_start(const char *pMapFile)
+{
+#ifdef UT_IMPACT
+    int fd = open( pMapFile, O_WRONLY | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+
+    if ( fd < 0 )
+    {
+        UT_LOG_ERROR( "Impact: unable to open [%s]: %s, not recording\n", pMapFile, strerror( errno ) );
+        return -1;
+    }
+    memset( gEntered, 0, sizeof(gEntered) );
+    __atomic_store_n( &gMapFd, fd, __ATOMIC_RELEASE );
+    return 0;
+#else
+    (void)pMapFile;
+    UT_LOG_WARNING( "Impact: not an IMPACT=1 build, not recording" );
+    return -1;
+#endif
+}
+
+bool UT_impact_recording(void)
+{
+    return gMapFd >= 0;
+}
+
+static int compareNames( const void *a, const void *b )
+{
+    return strcmp( *(const char * const *)a, *(const char * const *)b );
+}
+
+void UT_impact_test_end(const char *pSuite, const char *pTest)
+{
+    static const char *pNames[UT_IMPACT_MAX_FUNCTIONS];
+    char line[UT_IMPACT_LINE_SIZE];
+    size_t count = 0;
+    unsigned int overflow;
+
+    if ( gMapFd < 0 )
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < UT_IMPACT_MAX_FUNCTIONS; i++)
+    {
+        void *pFunction = __atomic_exchange_n( &gEntered[i], (void *)NULL, __ATOMIC_RELAXED );
+        Dl_info info;
+
+        if ( pFunction == NULL )
+        {
+            continue;
+        }
+        /* Only exported functions have a name, link the test binary with -rdynamic for its own */
+        if ( (dladdr( pFunction, &info ) == 0) || (info.dli_sname == NULL) )
+        {
+            continue;
+        }
+        pNames[count++] = info.dli_sname;
+    }
+    overflow = __atomic_exchange_n( &gEnteredOverflow, 0u, __ATOMIC_RELAXED );
+    if ( overflow > 0 )
+    {
+        UT_LOG_WARNING( "Impact: [%s.%s] filled the set of [%d] functions, [%u] entries not recorded", pSuite, pTest, UT_IMPACT_MAX_FUNCTIONS, overflow );
+    }
+
+    /* A test that entered nothing named still has a line, with no symbol, so the suite is known to the map */
+    if ( count == 0 )
+    {
+        pNames[count++] = "";
+    }
+
+    /* Sorted so that a test writes the same lines on every run, and the map diffs cleanly */
+    qsort( pNames, count, sizeof(const char *), compareNames );
+    for (size_t i = 0; i < count; i++)
+    {
+        int length;
+
+        if ( (i > 0) && (strcmp( pNames[i], pNames[i - 1] ) == 0) )
+        {
+            continue;
+        }
+        /* One write per line, -j workers append to the same map */
+        length = snprintf( line, sizeof(line), "%s\t%s\t%s\n", pSuite, pTest, pNames[i] );
+        if ( (length > 0) && ((size_t)length < sizeof(line)) && (write( gMapFd, line, (size_t)length ) < 0) )
+        {
+            UT_LOG_ERROR( "Impact: write failed: %s\n", strerror( errno ) );
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Adds a name to a sorted list, if it is not there already
+ *
+ * @return int - 0 on success, -1 if out of memory
+ */
+static int addName( UT_impact_names_t *pList, const char *pName )
+{
+    size_t low = 0;
+    size_t high = pList->count;
+
+    while ( low < high )
+    {
+        size_t middle = (low + high) / 2;
+        int order = strcmp( pList->ppNames[middle], pName );
+
+        if ( order == 0 )
+        {
+            return 0;
+        }
+        if ( order < 0 )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ( pList->count == pList->capacity )
+    {
+        size_t capacity = (pList->capacity == 0) ? 64 : (pList->capacity * 2);
+        char **ppGrown = (char **)realloc( pList->ppNames, capacity * sizeof(char *) );
+
+        if ( ppGrown == NULL )
+        {
+            return -1;
+        }
+        pList->ppNames = ppGrown;
+        pList->capacity = capacity;
+    }
+    memmove( &pList->ppNames[low + 1], &pList->ppNames[low], (pList->count - low) * sizeof(char *) );
+    pList->ppNames[low] = strdup( pName );
+    if ( pList->ppNames[low] == NULL )
+    {
+        memmove( &pList->ppNames[low], &pList->ppNames[low + 1], (pList->count - low) * sizeof(char *) );
+        return -1;
+    }
+    pList->count++;
+    return 0;
+}
+
+static bool hasName( const UT_impact_names_t *pList, const char *pName )
+{
+    return (pList->count > 0) &&
+           (bsearch( &pName, pList->ppNames, pList->count, sizeof(char *), compareNames ) != NULL);
+}
+
+static void releaseNames( UT_impact_names_t *pList )
+{
+    for (size_t i = 0; i < pList->count; i++)
+    {
+        free( pList->ppNames[i] );
+    }
+    free( pList->ppNames );
+    memset( pList, 0, sizeof(*pList) );
+}
+
+/**
+ * @brief Strips leading and trailing white space in place
+ */
+static char *trim( char *pText )
+{
+    char *pEnd;
+
+    while ( (*pText == ' ') || (*pText == '\t') )
+    {
+        pText++;
+    }
+    pEnd = pText + strlen( pText );
+    while ( (pEnd > pText) && ((pEnd[-1] == ' ') || (pEnd[-1] == '\t') || (pEnd[-1] == '\r') || (pEnd[-1] == '\n')) )
+    {
+        *--pEnd = '\0';
+    }
+    return pText;
+}
+
+/**
+ * @brief Reads the changed functions, comma separated or `@<file>` with one per line and `#` comments
+ */
+static int loadChanged( const char *pChanged, UT_impact_names_t *pList )
+{
+    char line[UT_IMPACT_LINE_SIZE];
+
+    if ( pChanged[0] == '@' )
+    {
+        FILE *pFile = fopen( &pChanged[1], "r" );
+
+        if ( pFile == NULL )
+        {
+            UT_LOG_ERROR( "Impact: unable to read the changed functions [%s]: %s\n", &pChanged[1], strerror( errno ) );
+            return -1;
+        }
+        while ( fgets( line, sizeof(line), pFile ) != NULL )
+        {
+            char *pName = trim( line );
+
+            if ( (pName[0] != '\0') && (pName[0] != '#') && (addName( pList, pName ) != 0) )
+            {
+                fclose( pFile );
+                return -1;
+            }
+        }
+        fclose( pFile );
+        return 0;
+    }
+
+    for (const char *pStart = pChanged; *pStart != '\0'; )
+    {
+        const char *pComma = strchr( pStart, ',' );
+        size_t length = (pComma != NULL) ? (size_t)(pComma - pStart) : strlen( pStart );
+        char *pName;
+
+        snprintf( line, sizeof(line), "%.*s", (int)length, pStart );
+        pName = trim( line );
+        if ( (pName[0] != '\0') && (addName( pList, pName ) != 0) )
+        {
+            return -1;
+        }
+        pStart += length + ((pComma != NULL) ? 1 : 0);
+    }
+    return 0;
+}
+
+int UT_impact_select(const char *pMapFile, const char *pChanged)
+{
+    char line[UT_IMPACT_LINE_SIZE];
+    UT_impact_names_t changed;
+    FILE *pFile;
+    int result = 0;
+
+    memset( &changed, 0, sizeof(changed) );
+    if ( loadChanged( pChanged, &changed ) != 0 )
+    {
+        releaseNames( &changed );
+        return -1;
+    }
+
+    pFile = fopen( pMapFile, "r" );
+    if ( pFile == NULL )
+    {
+        UT_LOG_ERROR( "Impact: unable to read the map [%s]: %s, running all suites\n", pMapFile, strerror( errno ) );
+        releaseNames( &changed );
+        return -1;
+    }
+
+    while ( (result == 0) && (fgets( line, sizeof(line), pFile ) != NULL) )
+    {
+        char *pTest = strchr( line, '\t' );
+        char *pSymbol = (pTest != NULL) ? strchr( pTest + 1, '\t' ) : NULL;
+
+        if ( pSymbol == NULL )
+        {
+            continue;
+        }
+        *pTest = '\0';
+        pSymbol = trim( pSymbol + 1 );
+        result = addName( &gKnownSuites, line );
+        if ( (result == 0) && hasName( &changed, pSymbol ) )
+        {
+            result = addName( &gAffectedSuites, line );
+        }
+    }
+    fclose( pFile );
+    releaseNames( &changed );
+
+    if ( result != 0 )
+    {
+        UT_LOG_ERROR( "Impact: out of memory loading [%s], running all suites\n", pMapFile );
+        releaseNames( &gKnownSuites );
+        releaseNames( &gAffectedSuites );
+        return -1;
+    }
+    gbSelecting = true;
+    UT_LOG( "Impact: [%u] of the [%u] mapped suites entered a changed function", (unsigned int)gAffectedSuites.count, (unsigned int)gKnownSuites.count );
+    return 0;
+}
+
+bool UT_impact_selecting(void)
+{
+    return gbSelecting;
+}
+
+bool UT_impact_suite_selected(const char *pSuite)
+{
+    if ( gbSelecting == false )
+    {
+        return true;
+    }
+    return hasName( &gAffectedSuites, pSuite ) || (hasName( &gKnownSuites, pSuite ) == false);
+}
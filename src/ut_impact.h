@@ -0,0 +1,90 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Test impact map and selection
+ *
+ * Code built with `-finstrument-functions` (`make IMPACT=1`, and the HAL library built with the
+ * same flag) calls __cyg_profile_func_enter() on the entry of every function. ut-core only defines
+ * it in an IMPACT=1 build, which also defines UT_IMPACT. While
+ * `--impact-record <map>` is set the entered functions are collected in a fixed, lock free set and,
+ * as each test completes, resolved with dladdr() and appended to the map as `suite<TAB>test<TAB>symbol`
+ * lines, or a `suite<TAB>test<TAB>` line for a test that entered no named function. Functions entered
+ * between tests, such as a suite set up, are charged to the next test.
+ *
+ * `--impact-select <map>` with `--impact-changed <function>[,<function>]` (or `@<file>`, one per
+ * line) then runs only the suites that entered a changed function, and the suites the map does
+ * not know, which have never been recorded.
+ */
+
+#ifndef __UT_IMPACT_H
+#define __UT_IMPACT_H
+
+#include <stdbool.h>
+
+#define UT_IMPACT_MAX_FUNCTIONS (8192)  /*!< Distinct functions recorded per test, must be a power of 2 */
+
+/**
+ * @brief Starts recording the functions entered by each test
+ *
+ * @param pMapFile - map to write, truncated
+ * @return int - 0 on success, -1 if the map cannot be opened
+ */
+extern int UT_impact_record_start(const char *pMapFile);
+
+/**
+ * @brief Checks whether the functions entered by the tests are being recorded
+ */
+extern bool UT_impact_recording(void);
+
+/**
+ * @brief Appends the functions entered since the last test completed to the map, under a test
+ *
+ * @param pSuite - suite name
+ * @param pTest - test name
+ */
+extern void UT_impact_test_end(const char *pSuite, const char *pTest);
+
+/**
+ * @brief Loads a map and the changed functions, and works out the suites they affect
+ *
+ * @param pMapFile - map written by a previous --impact-record run
+ * @param pChanged - changed functions, comma separated, or `@<file>` with one per line
+ * @return int - 0 on success, -1 if either cannot be read, all suites then run
+ */
+extern int UT_impact_select(const char *pMapFile, const char *pChanged);
+
+/**
+ * @brief Checks whether only the affected suites are to run
+ */
+extern bool UT_impact_selecting(void);
+
+/**
+ * @brief Checks whether a suite is to run
+ *
+ * @param pSuite - suite name
+ * @return bool - true if the suite entered a changed function, or is not in the map
+ */
+extern bool UT_impact_suite_selected(const char *pSuite);
+
+#endif  /*  __UT_IMPACT_H  */
+/** @} */
@@ -33,10 +33,12 @@
 #define __UT_INTERNAL_H
 
 #include <string.h>
+#include <stdint.h>
 
 #define UT_MAX_FILENAME_STRING_SIZE (32)
 #define MAX_OPTIONS 50
-#define MAX_GROUPS 100
+#define UT_MAX_PARALLEL_JOBS 64
+#define UT_MAX_SHARDS 1024
 
 /**
  * @brief Enumerates the different testing modes supported by the UT framework.
@@ -48,6 +50,16 @@ typedef enum
     UT_MODE_CONSOLE     /**< Console Mode: Runs tests and interacts with the user through the console. */
 } TestMode_t;
 
+/**
+ * @brief Enumerates how test bodies are isolated from the test runner.
+ */
+typedef enum
+{
+    UT_ISOLATION_NONE=0,    /**< Test bodies run in the runner process (Default). */
+    UT_ISOLATION_TEST,      /**< Every test body runs in a fresh worker process. */
+    UT_ISOLATION_SUITE      /**< The tests of a suite share a worker process, replaced when it dies. */
+} UT_isolation_t;
+
 /**
  * @brief Structure to hold configuration options and flags for the UT framework.
  */
@@ -68,6 +80,25 @@ typedef struct
     bool        help; /**< Flag to indicate whether to display help information. */
 } optionFlags_t;
 
+/**
+ * @brief Function measured by the benchmark runner
+ */
+typedef void (*UT_benchmark_function_t)(void);
+
+/**
+ * @brief Statistics of a benchmark run, times are in nanoseconds per iteration
+ */
+typedef struct
+{
+    uint64_t iterations;    /**< Calibrated iterations per timed sample */
+    unsigned int samples;   /**< Number of timed samples */
+    double min;             /**< Fastest sample */
+    double median;          /**< Median sample */
+    double p99;             /**< 99th percentile sample */
+    double mean;            /**< Mean of the samples */
+    double stddev;          /**< Standard deviation of the samples */
+} UT_benchmark_stats_t;
+
 #define TEST_INFO(x) printf x; // Consider replacing with a more robust logging mechanism
 
 /**
@@ -107,6 +138,90 @@ extern void UT_Manage_Suite_Activation(int groupID, bool enable_disable);
  */
 extern void UT_toggle_all_suites(bool enable_disable);
 
+/**
+ * @brief Sets the number of worker processes used to run the registered suites
+ *
+ * @param jobs number of workers, 1 (the default) runs all suites serially in-process
+ */
+extern void UT_set_parallel_jobs(int jobs);
+
+/**
+ * @brief Restricts the run to one shard of the registered suites
+ *
+ * Every shard of a run must be given the same suite list and shard history so they agree on the split.
+ *
+ * @param shardIndex index of this shard, from 0 to shardCount - 1
+ * @param shardCount total number of shards, 1 disables sharding
+ */
+extern void UT_set_shard(int shardIndex, int shardCount);
+
+/**
+ * @brief Sets the reports from a previous run used to weight the shards by suite duration
+ *
+ * @param pReports comma separated list of report filenames
+ */
+extern void UT_set_shard_history(const char *pReports);
+
+/**
+ * @brief Commits the results file to storage with fsync() as each suite completes
+ *
+ * The results are always written at the end of every test, this guards them against a power loss as well as a crash.
+ *
+ * @param enable true to fsync, false (the default) to leave it to the system
+ */
+extern void UT_set_results_fsync(bool enable);
+
+/**
+ * @brief Enables the result cache, suites that passed with the same binary, libraries and profile are skipped
+ *
+ * The results of the skipped suites are copied from the cache into the results file (Automated Mode).
+ *
+ * @param pCacheFile cache file, created if it does not exist
+ * @param pProfileFiles comma separated profile files hashed into the cache key, or NULL
+ * @param bUseCached false to run every suite, the cache is still refreshed from the results
+ */
+extern void UT_set_result_cache(const char *pCacheFile, const char *pProfileFiles, bool bUseCached);
+
+/**
+ * @brief Sets the time a single test may run before it is failed as hung
+ *
+ * @param seconds timeout in seconds, 0 (the default) for none
+ */
+extern void UT_set_test_timeout(unsigned int seconds);
+
+/**
+ * @brief Sets the time the tests of a suite may run in total, once exceeded its remaining tests fail
+ *
+ * @param seconds timeout in seconds, 0 (the default) for none
+ */
+extern void UT_set_suite_timeout(unsigned int seconds);
+
+/**
+ * @brief Runs the test bodies in forked worker processes, so a crash fails only the test that crashed
+ *
+ * @param isolation UT_ISOLATION_NONE (the default), UT_ISOLATION_TEST or UT_ISOLATION_SUITE
+ */
+extern void UT_set_isolation(UT_isolation_t isolation);
+
+/**
+ * @brief Benchmarks a function
+ *
+ * The function is warmed up, the iterations per sample are calibrated to a measurable duration,
+ * then a fixed number of samples are timed with CLOCK_MONOTONIC.
+ *
+ * @param pFunction function to benchmark
+ * @param pStats statistics of the run
+ */
+extern void UT_benchmark_run(UT_benchmark_function_t pFunction, UT_benchmark_stats_t *pStats);
+
+/**
+ * @brief Writes the statistics of a benchmark run to the log
+ *
+ * @param pName name of the benchmark
+ * @param pStats statistics of the run
+ */
+extern void UT_benchmark_log(const char *pName, const UT_benchmark_stats_t *pStats);
+
 /**
  * @brief Initializes and starts up the system.
  *
@@ -0,0 +1,219 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ut_kvp_image.h>
+#include <ut_log.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_OFFSET_BASIS (0xcbf29ce484222325ull)
+#define FNV_PRIME        (0x100000001b3ull)
+
+struct ut_kvp_image
+{
+    const uint8_t *pBase;       /*!< the mapping */
+    size_t size;
+    const ut_kvp_image_header_t *pHeader;
+    const uint32_t *pBuckets;
+    const ut_kvp_image_entry_t *pEntries;
+    const char *pStrings;
+};
+
+static bool inBounds( size_t size, uint64_t offset, uint64_t length )
+{
+    return (offset <= size) && (length <= size - offset);
+}
+
+/**
+ * @brief Checks every offset in the image, so a lookup never reads outside the mapping
+ */
+static bool validate( ut_kvp_image_t *pImage )
+{
+    const ut_kvp_image_header_t *pHeader = (const ut_kvp_image_header_t *)pImage->pBase;
+
+    if ( (pImage->size < sizeof(ut_kvp_image_header_t)) ||
+         (memcmp( pHeader->magic, UT_KVP_IMAGE_MAGIC, sizeof(pHeader->magic) ) != 0) ||
+         (pHeader->version != UT_KVP_IMAGE_VERSION) ||
+         (pHeader->headerSize < sizeof(ut_kvp_image_header_t)) ||
+         (pHeader->bucketCount == 0) || ((pHeader->bucketCount & (pHeader->bucketCount - 1)) != 0) ||
+         (pHeader->entryCount >= pHeader->bucketCount) ||
+         ((pHeader->bucketsOffset % sizeof(uint32_t)) != 0) ||
+         ((pHeader->entriesOffset % sizeof(uint64_t)) != 0) ||
+         !inBounds( pImage->size, pHeader->bucketsOffset, (uint64_t)pHeader->bucketCount * sizeof(uint32_t) ) ||
+         !inBounds( pImage->size, pHeader->entriesOffset, (uint64_t)pHeader->entryCount * sizeof(ut_kvp_image_entry_t) ) ||
+         !inBounds( pImage->size, pHeader->stringsOffset, pHeader->stringsSize ) ||
+         (pHeader->stringsSize == 0) ||
+         (pImage->pBase[pHeader->stringsOffset + pHeader->stringsSize - 1] != '\0') )
+    {
+        return false;
+    }
+
+    pImage->pHeader = pHeader;
+    pImage->pBuckets = (const uint32_t *)(pImage->pBase + pHeader->bucketsOffset);
+    pImage->pEntries = (const ut_kvp_image_entry_t *)(pImage->pBase + pHeader->entriesOffset);
+    pImage->pStrings = (const char *)(pImage->pBase + pHeader->stringsOffset);
+
+    for (uint32_t i = 0; i < pHeader->bucketCount; i++)
+    {
+        if ( pImage->pBuckets[i] > pHeader->entryCount )
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < pHeader->entryCount; i++)
+    {
+        const ut_kvp_image_entry_t *pEntry = &pImage->pEntries[i];
+
+        if ( ((uint64_t)pEntry->keyOffset + pEntry->keyLength >= pHeader->stringsSize) ||
+             ((uint64_t)pEntry->valueOffset + pEntry->valueLength >= pHeader->stringsSize) ||
+             (pImage->pStrings[pEntry->keyOffset + pEntry->keyLength] != '\0') ||
+             (pImage->pStrings[pEntry->valueOffset + pEntry->valueLength] != '\0') )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ut_kvp_image_isImage( const char *pFileName )
+{
+    char magic[sizeof(UT_KVP_IMAGE_MAGIC) - 1];
+    bool isImage = false;
+    int fd = open( pFileName, O_RDONLY );
+
+    if ( fd < 0 )
+    {
+        return false;
+    }
+    if ( read( fd, magic, sizeof(magic) ) == (ssize_t)sizeof(magic) )
+    {
+        isImage = (memcmp( magic, UT_KVP_IMAGE_MAGIC, sizeof(magic) ) == 0);
+    }
+    close( fd );
+    return isImage;
+}
+
+ut_kvp_image_t *ut_kvp_image_open( const char *pFileName )
+{
+    ut_kvp_image_t *pImage;
+    struct stat status;
+    void *pBase;
+    int fd;
+
+    fd = open( pFileName, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return NULL;
+    }
+    if ( (fstat( fd, &status ) != 0) || (status.st_size < (off_t)sizeof(ut_kvp_image_header_t)) )
+    {
+        close( fd );
+        return NULL;
+    }
+    pBase = mmap( NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( pBase == MAP_FAILED )
+    {
+        return NULL;
+    }
+
+    pImage = (ut_kvp_image_t *)calloc( 1, sizeof(ut_kvp_image_t) );
+    if ( pImage == NULL )
+    {
+        munmap( pBase, (size_t)status.st_size );
+        return NULL;
+    }
+    pImage->pBase = (const uint8_t *)pBase;
+    pImage->size = (size_t)status.st_size;
+
+    if ( validate( pImage ) == false )
+    {
+        UT_LOG_WARNING("Profile image [%s] is invalid or of another version, recompile it", pFileName);
+        ut_kvp_image_close( pImage );
+        return NULL;
+    }
+    return pImage;
+}
+
+void ut_kvp_image_close( ut_kvp_image_t *pImage )
+{
+    if ( pImage == NULL )
+    {
+        return;
+    }
+    munmap( (void *)pImage->pBase, pImage->size );
+    free( pImage );
+}
+
+const ut_kvp_image_entry_t *ut_kvp_image_find( const ut_kvp_image_t *pImage, const char *pszKey )
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    uint32_t mask;
+    size_t length = 0;
+
+    if ( (pImage == NULL) || (pszKey == NULL) )
+    {
+        return NULL;
+    }
+
+    for (const char *pChar = pszKey; *pChar != '\0'; pChar++, length++)
+    {
+        hash ^= (unsigned char)((*pChar == '.') ? '/' : *pChar);
+        hash *= FNV_PRIME;
+    }
+
+    mask = pImage->pHeader->bucketCount - 1;
+    for (uint32_t slot = (uint32_t)hash & mask; pImage->pBuckets[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const ut_kvp_image_entry_t *pEntry = &pImage->pEntries[pImage->pBuckets[slot] - 1];
+        const char *pKey = &pImage->pStrings[pEntry->keyOffset];
+        size_t i;
+
+        if ( (pEntry->hash != hash) || (pEntry->keyLength != length) )
+        {
+            continue;
+        }
+        for (i = 0; (i < length) && (pKey[i] == ((pszKey[i] == '.') ? '/' : pszKey[i])); i++)
+        {
+        }
+        if ( i == length )
+        {
+            return pEntry;
+        }
+    }
+    return NULL;
+}
+
+const char *ut_kvp_image_getString( const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry )
+{
+    return &pImage->pStrings[pEntry->valueOffset];
+}
+
+uint64_t ut_kvp_image_getNumber( const ut_kvp_image_entry_t *pEntry, uint64_t maximum )
+{
+    if ( ((pEntry->flags & UT_KVP_IMAGE_NUMBER) == 0) || (pEntry->number > maximum) )
+    {
+        return 0;
+    }
+    return pEntry->number;
+}
@@ -0,0 +1,130 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @brief Compiled profile images
+ *
+ * scripts/ut_kvp_compile.py flattens a YAML or JSON profile into an image holding a hash table of
+ * every key, map and list node with its value already decoded. The image is mapped read only and
+ * used in place, nothing is parsed or copied when it is opened.
+ *
+ * Layout, little endian: ut_kvp_image_header_t, bucketCount uint32_t buckets holding an entry
+ * number (index + 1, 0 for an empty bucket), entryCount ut_kvp_image_entry_t, then the NUL
+ * terminated keys and values. Keys use '/' separators and list entries are numbered, "a/0/b".
+ */
+
+#ifndef __UT_KVP_IMAGE_H
+#define __UT_KVP_IMAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UT_KVP_IMAGE_MAGIC      "UTKVPIMG"  /*!< First 8 bytes of an image */
+#define UT_KVP_IMAGE_VERSION    (1)         /*!< Layout version, an image of another version is not used */
+#define UT_KVP_IMAGE_SUFFIX     ".kvpbin"   /*!< Appended to a profile name to find its compiled image */
+
+typedef enum
+{
+    UT_KVP_IMAGE_SCALAR = 0,
+    UT_KVP_IMAGE_MAP,
+    UT_KVP_IMAGE_LIST
+} ut_kvp_image_kind_t;
+
+typedef enum
+{
+    UT_KVP_IMAGE_NUMBER = (1 << 0),     /*!< number holds the value */
+    UT_KVP_IMAGE_TRUE = (1 << 1),       /*!< the value is "true", in any case */
+    UT_KVP_IMAGE_BOOL = (1 << 2)        /*!< the value is "true" or "false", in any case */
+} ut_kvp_image_flags_t;
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t entryCount;
+    uint32_t bucketCount;       /*!< a power of 2 */
+    uint32_t bucketsOffset;
+    uint32_t entriesOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+} ut_kvp_image_header_t;
+
+typedef struct
+{
+    uint64_t hash;              /*!< FNV-1a of the key */
+    uint32_t keyOffset;         /*!< offsets are into the strings */
+    uint32_t keyLength;
+    uint32_t valueOffset;
+    uint32_t valueLength;
+    uint64_t number;            /*!< valid with UT_KVP_IMAGE_NUMBER */
+    uint32_t listCount;         /*!< entries of a UT_KVP_IMAGE_LIST */
+    uint8_t kind;               /*!< ut_kvp_image_kind_t */
+    uint8_t flags;              /*!< ut_kvp_image_flags_t */
+    uint16_t reserved;
+} ut_kvp_image_entry_t;
+
+typedef struct ut_kvp_image ut_kvp_image_t;
+
+/**
+ * @brief Checks whether a file is a compiled image
+ *
+ * @param pFileName - file to check
+ * @return true - the file starts with UT_KVP_IMAGE_MAGIC
+ */
+extern bool ut_kvp_image_isImage(const char *pFileName);
+
+/**
+ * @brief Maps a compiled image
+ *
+ * @param pFileName - image file
+ * @return ut_kvp_image_t* - the image, NULL if it cannot be mapped, is truncated or is of another version
+ */
+extern ut_kvp_image_t *ut_kvp_image_open(const char *pFileName);
+
+/**
+ * @brief Unmaps an image, every pointer into it becomes invalid
+ */
+extern void ut_kvp_image_close(ut_kvp_image_t *pImage);
+
+/**
+ * @brief Finds a key
+ *
+ * @param pImage - image
+ * @param pszKey - key, with '/' or '.' separators
+ * @return const ut_kvp_image_entry_t* - the entry, NULL if the image does not hold the key
+ */
+extern const ut_kvp_image_entry_t *ut_kvp_image_find(const ut_kvp_image_t *pImage, const char *pszKey);
+
+/**
+ * @brief Gets the value of a scalar entry, in place in the image
+ *
+ * @return const char* - the NUL terminated value, "" for a map or list entry
+ */
+extern const char *ut_kvp_image_getString(const ut_kvp_image_t *pImage, const ut_kvp_image_entry_t *pEntry);
+
+/**
+ * @brief Gets the number of a scalar entry
+ *
+ * @param pEntry - entry
+ * @param maximum - largest value of the type read
+ * @return uint64_t - the number, 0 if the value is not a number or is above maximum
+ */
+extern uint64_t ut_kvp_image_getNumber(const ut_kvp_image_entry_t *pEntry, uint64_t maximum);
+
+#endif  /*  __UT_KVP_IMAGE_H  */
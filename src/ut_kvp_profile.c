@@ -18,37 +18,754 @@
  */
 
 #include <ut_kvp_profile.h>
+#include <ut_kvp_image.h>
+#include <ut_log.h>
 #include <assert.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
-static ut_kvp_instance_t *gKVP_Instance = NULL;
+#define UT_KVP_PROFILE_MAX_LAYERS   (16)    /*!< Maximum number of profiles opened at once */
+#define UT_KVP_PROFILE_INDEX_SIZE   (256)   /*!< Initial number of index slots, a power of 2 */
+
+#define FNV_OFFSET_BASIS (0xcbf29ce484222325ull)
+#define FNV_PRIME        (0x100000001b3ull)
+
+/* Values of an index entry, each is read from its layer on first use */
+typedef enum
+{
+    UT_KVP_CACHED_BOOL = (1 << 0),
+    UT_KVP_CACHED_UINT8 = (1 << 1),
+    UT_KVP_CACHED_UINT16 = (1 << 2),
+    UT_KVP_CACHED_UINT32 = (1 << 3),
+    UT_KVP_CACHED_UINT64 = (1 << 4),
+    UT_KVP_CACHED_LIST_COUNT = (1 << 5),
+    UT_KVP_CACHED_STRING = (1 << 6),
+} ut_kvp_cached_t;
+
+/* A profile, either parsed into an instance or a compiled image mapped in place */
+typedef struct
+{
+    ut_kvp_instance_t *pInstance;
+    ut_kvp_image_t *pImage;
+} ut_kvp_layer_t;
+
+typedef struct
+{
+    char *pKey;                     /*!< Key with '.' separators normalised to '/', NULL for an empty slot */
+    uint64_t hash;
+    const ut_kvp_layer_t *pLayer;   /*!< Highest precedence layer holding the key */
+    const ut_kvp_image_entry_t *pImageEntry;    /*!< Entry of the key when pLayer is an image */
+    uint32_t cached;                /*!< ut_kvp_cached_t bits of the values below that are valid */
+    bool boolValue;
+    uint8_t uint8Value;
+    uint16_t uint16Value;
+    uint32_t uint32Value;
+    uint64_t uint64Value;
+    uint32_t listCount;
+    ut_kvp_status_t stringStatus;
+    char *pString;
+    const ut_kvp_profile_handle_t *pHandle;    /*!< Handle of the key, owned by gProfile.pHandles */
+} ut_kvp_index_entry_t;
+
+/* A handle, followed by its key and string value */
+typedef struct ut_kvp_handle_block
+{
+    struct ut_kvp_handle_block *pNext;
+    ut_kvp_profile_handle_t handle;
+} ut_kvp_handle_block_t;
+
+/* Returned when a handle cannot be allocated, so a handle is never NULL */
+static const ut_kvp_profile_handle_t gMissingHandle = { "", UT_KVP_STATUS_KEY_NOT_FOUND, "", 0, false, 0, 0, 0, 0, 0 };
+
+static ut_kvp_layer_t gMerged = { NULL, NULL };     /*!< Every parsed profile merged, built from the layers on first use */
+
+static struct
+{
+    pthread_mutex_t mutex;
+    ut_kvp_layer_t layers[UT_KVP_PROFILE_MAX_LAYERS];   /*!< One per profile, in the order opened */
+    uint32_t layerCount;
+    ut_kvp_index_entry_t *pIndex;   /*!< Open addressed table of the keys looked up so far */
+    uint32_t indexSize;
+    uint32_t indexUsed;
+    ut_kvp_handle_block_t *pHandles;    /*!< Every handle created, released on close */
+    uint32_t mergedCount;           /*!< layerCount when gMerged was built */
+    char *pMergedData[UT_KVP_PROFILE_MAX_LAYERS];   /*!< Data of each layer merged, kept while gMerged may use it */
+} gProfile = { PTHREAD_MUTEX_INITIALIZER };
+
+static void releaseIndex( void )
+{
+    for (uint32_t i = 0; i < gProfile.indexSize; i++)
+    {
+        free( gProfile.pIndex[i].pKey );
+        free( gProfile.pIndex[i].pString );
+    }
+    free( gProfile.pIndex );
+    gProfile.pIndex = NULL;
+    gProfile.indexSize = 0;
+    gProfile.indexUsed = 0;
+}
+
+static void releaseMergedData( void )
+{
+    for (uint32_t i = 0; i < UT_KVP_PROFILE_MAX_LAYERS; i++)
+    {
+        free( gProfile.pMergedData[i] );
+        gProfile.pMergedData[i] = NULL;
+    }
+    gProfile.mergedCount = 0;
+}
+
+/**
+ * @brief Gets the merged view of the parsed layers
+ *
+ * A single parsed profile is its own merged view. Otherwise the layers are merged into gMerged
+ * from their parsed data, once for each set of layers, so no profile is parsed twice.
+ * Called with the mutex held.
+ *
+ * @return const ut_kvp_layer_t* - the view, its instance is NULL when no profile is open
+ */
+static const ut_kvp_layer_t *getMergedLayer( void )
+{
+    const ut_kvp_layer_t *pLast = NULL;
+    uint32_t instanceCount = 0;
+    uint32_t dataCount = 0;
+
+    for (uint32_t i = 0; i < gProfile.layerCount; i++)
+    {
+        if ( gProfile.layers[i].pInstance != NULL )
+        {
+            pLast = &gProfile.layers[i];
+            instanceCount++;
+        }
+    }
+    if ( instanceCount == 1 )
+    {
+        return pLast;
+    }
+    if ( (gProfile.layerCount == 0) || ((gMerged.pInstance != NULL) && (gProfile.mergedCount == gProfile.layerCount)) )
+    {
+        return &gMerged;
+    }
+
+    /* The instance is kept across rebuilds, so a pointer returned earlier stays valid */
+    if ( gMerged.pInstance == NULL )
+    {
+        gMerged.pInstance = ut_kvp_createInstance();
+    }
+    else
+    {
+        ut_kvp_close( gMerged.pInstance );
+    }
+    releaseMergedData();
+    for (uint32_t i = 0; (gMerged.pInstance != NULL) && (i < gProfile.layerCount); i++)
+    {
+        char *pData;
+
+        if ( gProfile.layers[i].pInstance == NULL )
+        {
+            continue;
+        }
+        pData = ut_kvp_getData( gProfile.layers[i].pInstance );
+        if ( (pData != NULL) && (ut_kvp_openMemory( gMerged.pInstance, pData, (uint32_t)strlen( pData ) ) == UT_KVP_STATUS_SUCCESS) )
+        {
+            gProfile.pMergedData[dataCount++] = pData;
+        }
+        else
+        {
+            free( pData );
+        }
+    }
+    gProfile.mergedCount = gProfile.layerCount;
+    return &gMerged;
+}
+
+/**
+ * @brief Hashes a key as if every '.' separator was a '/', so both forms share an entry
+ */
+static uint64_t hashKey( const char *pszKey )
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (; *pszKey != '\0'; pszKey++)
+    {
+        hash ^= (unsigned char)((*pszKey == '.') ? '/' : *pszKey);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool keyMatches( const char *pNormalised, const char *pszKey )
+{
+    for (; *pszKey != '\0'; pNormalised++, pszKey++)
+    {
+        if ( *pNormalised != ((*pszKey == '.') ? '/' : *pszKey) )
+        {
+            return false;
+        }
+    }
+    return *pNormalised == '\0';
+}
+
+static bool growIndex( void )
+{
+    uint32_t size = (gProfile.indexSize == 0) ? UT_KVP_PROFILE_INDEX_SIZE : gProfile.indexSize * 2;
+    ut_kvp_index_entry_t *pIndex = (ut_kvp_index_entry_t *)calloc( size, sizeof(ut_kvp_index_entry_t) );
+
+    if ( pIndex == NULL )
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < gProfile.indexSize; i++)
+    {
+        uint32_t slot;
+
+        if ( gProfile.pIndex[i].pKey == NULL )
+        {
+            continue;
+        }
+        for (slot = (uint32_t)gProfile.pIndex[i].hash & (size - 1); pIndex[slot].pKey != NULL; slot = (slot + 1) & (size - 1))
+        {
+        }
+        pIndex[slot] = gProfile.pIndex[i];
+    }
+    free( gProfile.pIndex );
+    gProfile.pIndex = pIndex;
+    gProfile.indexSize = size;
+    return true;
+}
+
+/**
+ * @brief Finds the layer holding a key, the highest precedence (last opened) layer wins
+ *
+ * Sets pEntry->pLayer to the layer, or to the merged view when no layer holds the key.
+ */
+static void findLayer( ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    for (uint32_t i = gProfile.layerCount; i > 0; i--)
+    {
+        const ut_kvp_layer_t *pLayer = &gProfile.layers[i - 1];
+
+        if ( pLayer->pImage != NULL )
+        {
+            const ut_kvp_image_entry_t *pImageEntry = ut_kvp_image_find( pLayer->pImage, pszKey );
+
+            if ( (pImageEntry != NULL) &&
+                 ((pImageEntry->kind == UT_KVP_IMAGE_SCALAR) || (pImageEntry->listCount > 0)) )
+            {
+                pEntry->pLayer = pLayer;
+                pEntry->pImageEntry = pImageEntry;
+                return;
+            }
+        }
+        else if ( (ut_kvp_getStringField( pLayer->pInstance, pszKey, value, sizeof(value) ) == UT_KVP_STATUS_SUCCESS) ||
+                  (ut_kvp_getListCount( pLayer->pInstance, pszKey ) > 0) )
+        {
+            pEntry->pLayer = pLayer;
+            return;
+        }
+    }
+    pEntry->pLayer = getMergedLayer();
+}
+
+/* Readers of a value from the layer of an entry, an image value is decoded by the compiler */
+static bool readBool( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return (pEntry->pImageEntry->flags & UT_KVP_IMAGE_TRUE) != 0;
+    }
+    return ut_kvp_getBoolField( pEntry->pLayer->pInstance, pszKey );
+}
+
+static uint8_t readUInt8( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return (uint8_t)ut_kvp_image_getNumber( pEntry->pImageEntry, UINT8_MAX );
+    }
+    return ut_kvp_getUInt8Field( pEntry->pLayer->pInstance, pszKey );
+}
+
+static uint16_t readUInt16( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return (uint16_t)ut_kvp_image_getNumber( pEntry->pImageEntry, UINT16_MAX );
+    }
+    return ut_kvp_getUInt16Field( pEntry->pLayer->pInstance, pszKey );
+}
+
+static uint32_t readUInt32( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return (uint32_t)ut_kvp_image_getNumber( pEntry->pImageEntry, UINT32_MAX );
+    }
+    return ut_kvp_getUInt32Field( pEntry->pLayer->pInstance, pszKey );
+}
+
+static uint64_t readUInt64( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return ut_kvp_image_getNumber( pEntry->pImageEntry, UINT64_MAX );
+    }
+    return ut_kvp_getUInt64Field( pEntry->pLayer->pInstance, pszKey );
+}
+
+static uint32_t readListCount( const ut_kvp_index_entry_t *pEntry, const char *pszKey )
+{
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        return pEntry->pImageEntry->listCount;
+    }
+    return ut_kvp_getListCount( pEntry->pLayer->pInstance, pszKey );
+}
+
+static ut_kvp_status_t readString( const ut_kvp_index_entry_t *pEntry, const char *pszKey, char *pszReturnedString, uint32_t uStringSize )
+{
+    if ( pEntry->pLayer->pImage == NULL )
+    {
+        return ut_kvp_getStringField( pEntry->pLayer->pInstance, pszKey, pszReturnedString, uStringSize );
+    }
+    if ( pEntry->pImageEntry->kind != UT_KVP_IMAGE_SCALAR )
+    {
+        return UT_KVP_STATUS_KEY_NOT_FOUND;
+    }
+    strncpy( pszReturnedString, ut_kvp_image_getString( pEntry->pLayer->pImage, pEntry->pImageEntry ), uStringSize - 1 );
+    pszReturnedString[uStringSize - 1] = '\0';
+    return UT_KVP_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Finds the index entry of a key, adding it on first use
+ *
+ * Called with the mutex held.
+ *
+ * @return ut_kvp_index_entry_t* - the entry, NULL if it could not be added
+ */
+static ut_kvp_index_entry_t *lookupKey( const char *pszKey )
+{
+    uint64_t hash = hashKey( pszKey );
+    ut_kvp_index_entry_t *pEntry;
+    uint32_t slot;
+
+    if ( (gProfile.indexSize == 0) || ((gProfile.indexUsed + 1) * 4 > gProfile.indexSize * 3) )
+    {
+        if ( growIndex() == false )
+        {
+            return NULL;
+        }
+    }
+
+    for (slot = (uint32_t)hash & (gProfile.indexSize - 1); gProfile.pIndex[slot].pKey != NULL; slot = (slot + 1) & (gProfile.indexSize - 1))
+    {
+        pEntry = &gProfile.pIndex[slot];
+        if ( (pEntry->hash == hash) && keyMatches( pEntry->pKey, pszKey ) )
+        {
+            return pEntry;
+        }
+    }
+
+    pEntry = &gProfile.pIndex[slot];
+    pEntry->pKey = strdup( pszKey );
+    if ( pEntry->pKey == NULL )
+    {
+        return NULL;
+    }
+    for (char *pChar = pEntry->pKey; *pChar != '\0'; pChar++)
+    {
+        *pChar = (*pChar == '.') ? '/' : *pChar;
+    }
+    pEntry->hash = hash;
+    findLayer( pEntry, pszKey );
+    gProfile.indexUsed++;
+    return pEntry;
+}
+
+/**
+ * @brief Maps a profile that is a compiled image
+ *
+ * Images are opt in, only a fileName that is itself an image is mapped. An image named
+ * \<profile\>UT_KVP_IMAGE_SUFFIX that is older than \<profile\> is stale, the profile is parsed instead.
+ *
+ * @param fileName - profile or image
+ * @param pSourceName - set to the profile to parse in place of a stale image, "" otherwise
+ * @param sourceSize - size of pSourceName
+ *
+ * @return ut_kvp_image_t* - the image, NULL to parse the profile
+ */
+static ut_kvp_image_t *openImage( const char *fileName, char *pSourceName, size_t sourceSize )
+{
+    size_t length = strlen( fileName );
+    size_t suffixLength = sizeof(UT_KVP_IMAGE_SUFFIX) - 1;
+    struct stat profileStatus;
+    struct stat imageStatus;
+
+    pSourceName[0] = '\0';
+    if ( ut_kvp_image_isImage( fileName ) == false )
+    {
+        return NULL;
+    }
+
+    if ( (length > suffixLength) && (length - suffixLength < sourceSize) &&
+         (strcmp( &fileName[length - suffixLength], UT_KVP_IMAGE_SUFFIX ) == 0) )
+    {
+        memcpy( pSourceName, fileName, length - suffixLength );
+        pSourceName[length - suffixLength] = '\0';
+        if ( (stat( pSourceName, &profileStatus ) == 0) &&
+             (stat( fileName, &imageStatus ) == 0) &&
+             (imageStatus.st_mtime < profileStatus.st_mtime) )
+        {
+            UT_LOG_WARNING("Profile image [%s] is older than [%s], parsing the profile", fileName, pSourceName);
+            return NULL;
+        }
+        pSourceName[0] = '\0';
+    }
+    return ut_kvp_image_open( fileName );
+}
 
 ut_kvp_status_t ut_kvp_profile_open(char *fileName)
 {
-    ut_kvp_status_t result;
+    char sourceName[UT_KVP_MAX_ELEMENT_SIZE] = "";
+    ut_kvp_status_t result = UT_KVP_STATUS_SUCCESS;
+    ut_kvp_instance_t *pInstance = NULL;
+    ut_kvp_image_t *pImage = NULL;
 
-    if (gKVP_Instance == NULL)
+    /* A compiled image is used in place, it is not parsed */
+    if ( fileName != NULL )
+    {
+        pImage = openImage( fileName, sourceName, sizeof(sourceName) );
+    }
+    if ( pImage == NULL )
     {
-        gKVP_Instance = ut_kvp_createInstance();
-        assert(gKVP_Instance != NULL);
+        pInstance = ut_kvp_createInstance();
+        assert(pInstance != NULL);
+        result = ut_kvp_open(pInstance, (sourceName[0] != '\0') ? sourceName : fileName);
+        assert( result == UT_KVP_STATUS_SUCCESS );
+        if ( result != UT_KVP_STATUS_SUCCESS )
+        {
+            ut_kvp_destroyInstance( pInstance );
+            return result;
+        }
     }
 
-    result = ut_kvp_open(gKVP_Instance, fileName);
-    assert( result == UT_KVP_STATUS_SUCCESS );
+    /* Each profile is kept on its own, so a later profile overrides an earlier one key by key */
+    pthread_mutex_lock( &gProfile.mutex );
+    if ( gProfile.layerCount < UT_KVP_PROFILE_MAX_LAYERS )
+    {
+        gProfile.layers[gProfile.layerCount].pInstance = pInstance;
+        gProfile.layers[gProfile.layerCount].pImage = pImage;
+        gProfile.layerCount++;
+        pInstance = NULL;
+        pImage = NULL;
+    }
+    else
+    {
+        result = UT_KVP_STATUS_INVALID_PARAM;
+    }
+    releaseIndex();
+    pthread_mutex_unlock( &gProfile.mutex );
 
+    if ( pInstance != NULL )
+    {
+        ut_kvp_destroyInstance( pInstance );
+    }
+    ut_kvp_image_close( pImage );
     return result;
 }
 
 void ut_kvp_profile_close(void)
 {
-    if ( gKVP_Instance != NULL )
+    pthread_mutex_lock( &gProfile.mutex );
+    releaseIndex();
+    releaseMergedData();
+    if ( gMerged.pInstance != NULL )
+    {
+        ut_kvp_destroyInstance( gMerged.pInstance );
+        gMerged.pInstance = NULL;
+    }
+    while ( gProfile.pHandles != NULL )
+    {
+        ut_kvp_handle_block_t *pNext = gProfile.pHandles->pNext;
+
+        free( gProfile.pHandles );
+        gProfile.pHandles = pNext;
+    }
+    for (uint32_t i = 0; i < gProfile.layerCount; i++)
     {
-        ut_kvp_destroyInstance(gKVP_Instance);
-        gKVP_Instance = NULL;
+        if ( gProfile.layers[i].pInstance != NULL )
+        {
+            ut_kvp_destroyInstance( gProfile.layers[i].pInstance );
+        }
+        ut_kvp_image_close( gProfile.layers[i].pImage );
+        gProfile.layers[i].pInstance = NULL;
+        gProfile.layers[i].pImage = NULL;
     }
+    gProfile.layerCount = 0;
+    pthread_mutex_unlock( &gProfile.mutex );
 }
 
 ut_kvp_instance_t *ut_kvp_profile_getInstance( void )
 {
-    return gKVP_Instance;
+    ut_kvp_instance_t *pInstance;
+
+    pthread_mutex_lock( &gProfile.mutex );
+    pInstance = getMergedLayer()->pInstance;
+    pthread_mutex_unlock( &gProfile.mutex );
+    return pInstance;
+}
+
+uint32_t ut_kvp_profile_getLayerCount( void )
+{
+    return gProfile.layerCount;
+}
+
+ut_kvp_instance_t *ut_kvp_profile_getLayer( uint32_t index )
+{
+    return (index < gProfile.layerCount) ? gProfile.layers[index].pInstance : NULL;
+}
+
+ut_kvp_instance_t *ut_kvp_profile_getInstanceForKey( const char *pszKey )
+{
+    ut_kvp_index_entry_t *pEntry = NULL;
+    ut_kvp_instance_t *pInstance;
+
+    pthread_mutex_lock( &gProfile.mutex );
+    if ( pszKey != NULL )
+    {
+        pEntry = lookupKey( pszKey );
+    }
+    pInstance = (pEntry != NULL) ? pEntry->pLayer->pInstance : getMergedLayer()->pInstance;
+    pthread_mutex_unlock( &gProfile.mutex );
+    return pInstance;
+}
+
+/* Reads a value through the index, from its layer on first use and from the entry after that */
+#define UT_KVP_PROFILE_GET_CACHED(type, flag, member, reader) \
+    type value = 0; \
+    ut_kvp_index_entry_t *pEntry = NULL; \
+    ut_kvp_index_entry_t merged = { NULL }; \
+    pthread_mutex_lock( &gProfile.mutex ); \
+    if ( pszKey != NULL ) \
+    { \
+        pEntry = lookupKey( pszKey ); \
+    } \
+    if ( pEntry == NULL ) \
+    { \
+        merged.pLayer = getMergedLayer(); \
+        value = reader( &merged, pszKey ); \
+    } \
+    else \
+    { \
+        if ( (pEntry->cached & (flag)) == 0 ) \
+        { \
+            pEntry->member = reader( pEntry, pszKey ); \
+            pEntry->cached |= (flag); \
+        } \
+        value = pEntry->member; \
+    } \
+    pthread_mutex_unlock( &gProfile.mutex ); \
+    return value;
+
+bool ut_kvp_profile_getBoolField( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( bool, UT_KVP_CACHED_BOOL, boolValue, readBool )
+}
+
+uint8_t ut_kvp_profile_getUInt8Field( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( uint8_t, UT_KVP_CACHED_UINT8, uint8Value, readUInt8 )
+}
+
+uint16_t ut_kvp_profile_getUInt16Field( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( uint16_t, UT_KVP_CACHED_UINT16, uint16Value, readUInt16 )
+}
+
+uint32_t ut_kvp_profile_getUInt32Field( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( uint32_t, UT_KVP_CACHED_UINT32, uint32Value, readUInt32 )
+}
+
+uint64_t ut_kvp_profile_getUInt64Field( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( uint64_t, UT_KVP_CACHED_UINT64, uint64Value, readUInt64 )
+}
+
+uint32_t ut_kvp_profile_getListCount( const char *pszKey )
+{
+    UT_KVP_PROFILE_GET_CACHED( uint32_t, UT_KVP_CACHED_LIST_COUNT, listCount, readListCount )
+}
+
+ut_kvp_status_t ut_kvp_profile_getStringField( const char *pszKey, char *pszReturnedString, uint32_t uStringSize )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    ut_kvp_index_entry_t *pEntry = NULL;
+    ut_kvp_status_t status;
+
+    pthread_mutex_lock( &gProfile.mutex );
+    if ( (pszKey != NULL) && (pszReturnedString != NULL) && (uStringSize != 0) )
+    {
+        pEntry = lookupKey( pszKey );
+    }
+    if ( pEntry == NULL )
+    {
+        status = ut_kvp_getStringField( getMergedLayer()->pInstance, pszKey, pszReturnedString, uStringSize );
+        pthread_mutex_unlock( &gProfile.mutex );
+        return status;
+    }
+
+    /* An image value is read in place, it is not copied into the index */
+    if ( pEntry->pLayer->pImage != NULL )
+    {
+        status = readString( pEntry, pszKey, pszReturnedString, uStringSize );
+        pthread_mutex_unlock( &gProfile.mutex );
+        return status;
+    }
+
+    if ( (pEntry->cached & UT_KVP_CACHED_STRING) == 0 )
+    {
+        pEntry->stringStatus = readString( pEntry, pszKey, value, sizeof(value) );
+        pEntry->pString = (pEntry->stringStatus == UT_KVP_STATUS_SUCCESS) ? strdup( value ) : NULL;
+        if ( (pEntry->stringStatus != UT_KVP_STATUS_SUCCESS) || (pEntry->pString != NULL) )
+        {
+            pEntry->cached |= UT_KVP_CACHED_STRING;
+        }
+    }
+
+    if ( (pEntry->cached & UT_KVP_CACHED_STRING) == 0 )
+    {
+        status = readString( pEntry, pszKey, pszReturnedString, uStringSize );
+    }
+    else
+    {
+        status = pEntry->stringStatus;
+        if ( status == UT_KVP_STATUS_SUCCESS )
+        {
+            strncpy( pszReturnedString, pEntry->pString, uStringSize - 1 );
+            pszReturnedString[uStringSize - 1] = '\0';
+        }
+    }
+    pthread_mutex_unlock( &gProfile.mutex );
+    return status;
+}
+
+/**
+ * @brief Checks a value is a number, as strtoull() reads it for the ut_kvp_getUInt*Field() getters
+ *
+ * Leading white space, a sign and a 0x or 0 prefix are accepted, anything left after the number is not.
+ */
+static bool isNumber( const char *pValue )
+{
+    char *pEnd = NULL;
+
+    (void)strtoull( pValue, &pEnd, 0 );
+    if ( pEnd == pValue )
+    {
+        return false;
+    }
+    while ( isspace( (unsigned char)*pEnd ) )
+    {
+        pEnd++;
+    }
+    return *pEnd == '\0';
+}
+
+/**
+ * @brief Reads a key from its layer and decodes every type it can be read as
+ *
+ * Only the readers matching the value are called, so a string is never decoded as a number.
+ *
+ * @return const ut_kvp_profile_handle_t* - the handle, NULL if it could not be allocated
+ */
+static const ut_kvp_profile_handle_t *createHandle( const char *pszKey, const ut_kvp_index_entry_t *pEntry )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    ut_kvp_status_t status;
+    ut_kvp_handle_block_t *pBlock;
+    ut_kvp_profile_handle_t *pHandle;
+    size_t keyLength = strlen( pszKey );
+    size_t valueLength;
+    char *pStorage;
+
+    status = readString( pEntry, pszKey, value, sizeof(value) );
+    if ( status != UT_KVP_STATUS_SUCCESS )
+    {
+        value[0] = '\0';
+    }
+    valueLength = strlen( value );
+
+    pBlock = (ut_kvp_handle_block_t *)calloc( 1, sizeof(ut_kvp_handle_block_t) + keyLength + valueLength + 2 );
+    if ( pBlock == NULL )
+    {
+        return NULL;
+    }
+    pStorage = (char *)(pBlock + 1);
+    memcpy( pStorage, pszKey, keyLength + 1 );
+    memcpy( &pStorage[keyLength + 1], value, valueLength + 1 );
+
+    pHandle = &pBlock->handle;
+    pHandle->pKey = pStorage;
+    pHandle->status = status;
+    pHandle->pString = &pStorage[keyLength + 1];
+    pHandle->length = (uint32_t)valueLength;
+
+    if ( status != UT_KVP_STATUS_SUCCESS )
+    {
+        pHandle->listCount = readListCount( pEntry, pszKey );
+    }
+    else if ( isNumber( value ) )
+    {
+        pHandle->uint8Value = readUInt8( pEntry, pszKey );
+        pHandle->uint16Value = readUInt16( pEntry, pszKey );
+        pHandle->uint32Value = readUInt32( pEntry, pszKey );
+        pHandle->uint64Value = readUInt64( pEntry, pszKey );
+    }
+    else if ( (strcasecmp( value, "true" ) == 0) || (strcasecmp( value, "false" ) == 0) )
+    {
+        pHandle->boolValue = readBool( pEntry, pszKey );
+    }
+
+    pBlock->pNext = gProfile.pHandles;
+    gProfile.pHandles = pBlock;
+    return pHandle;
 }
 
+const ut_kvp_profile_handle_t *ut_kvp_profile_getHandle( const char *pszKey )
+{
+    const ut_kvp_profile_handle_t *pHandle = NULL;
+    ut_kvp_index_entry_t *pEntry;
+    ut_kvp_index_entry_t merged = { NULL };
+
+    if ( pszKey == NULL )
+    {
+        return &gMissingHandle;
+    }
+
+    pthread_mutex_lock( &gProfile.mutex );
+    pEntry = lookupKey( pszKey );
+    merged.pLayer = getMergedLayer();
+    if ( (pEntry != NULL) && (pEntry->pHandle != NULL) )
+    {
+        pHandle = pEntry->pHandle;
+    }
+    else
+    {
+        pHandle = createHandle( pszKey, (pEntry != NULL) ? pEntry : &merged );
+        if ( pEntry != NULL )
+        {
+            pEntry->pHandle = pHandle;
+        }
+    }
+    pthread_mutex_unlock( &gProfile.mutex );
+
+    return (pHandle != NULL) ? pHandle : &gMissingHandle;
+}
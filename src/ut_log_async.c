@@ -0,0 +1,577 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ut_log.h>
+#include "ut_log_async.h"
+#include "ut_trace.h"
+
+#define UT_LOG_ASYNC_PREFIX_SIZE (64)       /*!< Size of the prefix kept with a line */
+#define UT_LOG_ASYNC_LINE_SIZE (UT_LOG_MAX_LINE_SIZE + 192)     /*!< Size of a line as written */
+#define UT_LOG_ASYNC_BATCH_SIZE (64 * 1024)  /*!< Most written by one write() */
+#define UT_LOG_ASYNC_IDLE_MS (100)          /*!< Longest the writer sleeps without being woken */
+#define UT_LOG_ASYNC_FULL_WAIT_US (50000)  /*!< Longest a line waits for room in a full ring */
+#define UT_LOG_ASYNC_FLUSH_MS (2000)        /*!< Longest a flush waits for the writer */
+
+/** A queued line, formatted by the caller */
+typedef struct
+{
+    uint64_t sequence;      /*!< Ring position the slot is ready for, see enqueue() and drain() */
+    struct timeval time;
+    const char *pFile;
+    int line;
+    char prefix[UT_LOG_ASYNC_PREFIX_SIZE];
+    char message[UT_LOG_MAX_LINE_SIZE];
+} UT_log_record_t;
+
+/* Fields shared between threads are only accessed with the __atomic builtins */
+static struct
+{
+    UT_log_record_t *pRecords;
+    uint64_t enqueuePosition;       /*!< Next slot claimed by a producer */
+    uint64_t dequeuePosition;       /*!< Next slot written, owned by whoever holds consumer */
+    uint64_t dropped;               /*!< Lines dropped on a full ring, not reported yet */
+    int consumer;                   /*!< 1 while a thread or signal handler drains the ring */
+    int sleeping;                   /*!< 1 while the writer waits on wake */
+    int enabled;
+    int stopping;
+    int held;                       /*!< 1 while the writer thread is held, see UT_log_async_hold() */
+    int writerStarted;              /*!< 1 once the writer runs, a forked child starts it on its first line */
+    sem_t wake;
+    pthread_t writer;
+    int logFd;
+    bool bHooksInstalled;           /*!< atexit() and pthread_atfork() are registered once */
+} gAsync;
+
+/* Owned by whoever holds gAsync.consumer */
+static char gBatch[UT_LOG_ASYNC_BATCH_SIZE];
+static size_t gBatchLength;
+
+static const int gFatalSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM, SIGINT };
+static struct sigaction gPreviousActions[sizeof(gFatalSignals) / sizeof(gFatalSignals[0])];
+
+static void *writerThread( void *pArg );
+static void fatalSignalHandler( int signal );
+
+/**
+ * @brief Claims a slot and fills it, lock free for any number of producers
+ *
+ * @return bool - false if the ring is full
+ */
+static bool enqueue( const char *pFile, int line, const char *pPrefix, const char *pMessage )
+{
+    uint64_t position = __atomic_load_n( &gAsync.enqueuePosition, __ATOMIC_RELAXED );
+    UT_log_record_t *pRecord;
+
+    for (;;)
+    {
+        uint64_t sequence;
+        int64_t difference;
+
+        pRecord = &gAsync.pRecords[position & (UT_LOG_ASYNC_SLOTS - 1)];
+        sequence = __atomic_load_n( &pRecord->sequence, __ATOMIC_ACQUIRE );
+        difference = (int64_t)(sequence - position);
+        if ( difference == 0 )
+        {
+            if ( __atomic_compare_exchange_n( &gAsync.enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+            {
+                break;
+            }
+        }
+        else if ( difference < 0 )
+        {
+            return false;
+        }
+        else
+        {
+            position = __atomic_load_n( &gAsync.enqueuePosition, __ATOMIC_RELAXED );
+        }
+    }
+
+    gettimeofday( &pRecord->time, NULL );
+    pRecord->pFile = pFile;
+    pRecord->line = line;
+    snprintf( pRecord->prefix, sizeof(pRecord->prefix), "%s", (pPrefix != NULL) ? pPrefix : "" );
+    snprintf( pRecord->message, sizeof(pRecord->message), "%s", pMessage );
+    __atomic_store_n( &pRecord->sequence, position + 1, __ATOMIC_SEQ_CST );
+
+    if ( __atomic_load_n( &gAsync.sleeping, __ATOMIC_SEQ_CST ) != 0 )
+    {
+        sem_post( &gAsync.wake );
+    }
+    return true;
+}
+
+/**
+ * @brief Formats a line as written to the console and the log file
+ *
+ * @param bSignalSafe - true from a signal handler, the local time is not looked up
+ * @return size_t - length of the line
+ */
+static size_t formatRecord( const UT_log_record_t *pRecord, char *pLine, size_t size, bool bSignalSafe )
+{
+    const char *pFile = (pRecord->pFile != NULL) ? strrchr( pRecord->pFile, '/' ) : NULL;
+    struct tm local;
+    size_t length = 0;
+    int written;
+
+    pFile = (pFile != NULL) ? (pFile + 1) : ((pRecord->pFile != NULL) ? pRecord->pFile : "");
+    if ( (bSignalSafe == false) && (localtime_r( &pRecord->time.tv_sec, &local ) != NULL) )
+    {
+        length = strftime( pLine, size, "%d/%m/%y - %H:%M:%S", &local );
+    }
+    else
+    {
+        written = snprintf( pLine, size, "%ld", (long)pRecord->time.tv_sec );
+        length = (written > 0) ? (size_t)written : 0;
+    }
+
+    written = snprintf( &pLine[length], size - length, ":%06ld %s[%s:%d] %s\n",
+                        (long)pRecord->time.tv_usec, pRecord->prefix, pFile, pRecord->line, pRecord->message );
+    if ( written > 0 )
+    {
+        length += ((size_t)written < size - length) ? (size_t)written : (size - length - 1);
+    }
+    return length;
+}
+
+static void writeAll( int fd, const char *pData, size_t length )
+{
+    while ( length > 0 )
+    {
+        ssize_t written = write( fd, pData, length );
+
+        if ( written < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            return;
+        }
+        pData += written;
+        length -= (size_t)written;
+    }
+}
+
+/**
+ * @brief Writes the batch to the console and the log file
+ *
+ * @param bSignalSafe - true from a signal handler, stdio is left alone
+ */
+static void writeBatch( bool bSignalSafe )
+{
+    if ( gBatchLength == 0 )
+    {
+        return;
+    }
+    if ( bSignalSafe == false )
+    {
+        /* Output already buffered by printf() goes first */
+        fflush( stdout );
+    }
+    writeAll( STDOUT_FILENO, gBatch, gBatchLength );
+    if ( gAsync.logFd >= 0 )
+    {
+        writeAll( gAsync.logFd, gBatch, gBatchLength );
+    }
+    gBatchLength = 0;
+}
+
+/**
+ * @brief Writes every published line, only one thread drains at a time
+ *
+ * Lines are collected into gBatch, so a burst costs a write() per batch and not per line.
+ *
+ * @param bSignalSafe - true from a signal handler, the local time is not looked up
+ * @return int - number of lines written, -1 if another thread is draining
+ */
+static int drain( bool bSignalSafe )
+{
+    int expected = 0;
+    int count = 0;
+    uint64_t dropped;
+
+    if ( !__atomic_compare_exchange_n( &gAsync.consumer, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+    {
+        return -1;
+    }
+
+    for (;;)
+    {
+        uint64_t position = gAsync.dequeuePosition;
+        UT_log_record_t *pRecord = &gAsync.pRecords[position & (UT_LOG_ASYNC_SLOTS - 1)];
+
+        if ( __atomic_load_n( &pRecord->sequence, __ATOMIC_ACQUIRE ) != position + 1 )
+        {
+            break;
+        }
+
+        if ( sizeof(gBatch) - gBatchLength < UT_LOG_ASYNC_LINE_SIZE )
+        {
+            writeBatch( bSignalSafe );
+        }
+        gBatchLength += formatRecord( pRecord, &gBatch[gBatchLength], sizeof(gBatch) - gBatchLength, bSignalSafe );
+        __atomic_store_n( &pRecord->sequence, position + UT_LOG_ASYNC_SLOTS, __ATOMIC_RELEASE );
+        __atomic_store_n( &gAsync.dequeuePosition, position + 1, __ATOMIC_RELEASE );
+        count++;
+    }
+
+    dropped = __atomic_exchange_n( &gAsync.dropped, 0, __ATOMIC_RELAXED );
+    if ( dropped > 0 )
+    {
+        if ( sizeof(gBatch) - gBatchLength < UT_LOG_ASYNC_LINE_SIZE )
+        {
+            writeBatch( bSignalSafe );
+        }
+        gBatchLength += (size_t)snprintf( &gBatch[gBatchLength], sizeof(gBatch) - gBatchLength,
+                                          "[ut-core] log ring full, [%llu] lines dropped\n", (unsigned long long)dropped );
+    }
+    writeBatch( bSignalSafe );
+
+    __atomic_store_n( &gAsync.consumer, 0, __ATOMIC_RELEASE );
+    return count;
+}
+
+static bool isEmpty( void )
+{
+    uint64_t position = __atomic_load_n( &gAsync.dequeuePosition, __ATOMIC_ACQUIRE );
+    UT_log_record_t *pRecord = &gAsync.pRecords[position & (UT_LOG_ASYNC_SLOTS - 1)];
+
+    return __atomic_load_n( &pRecord->sequence, __ATOMIC_SEQ_CST ) != position + 1;
+}
+
+static void *writerThread( void *pArg )
+{
+    (void)pArg;
+
+    for (;;)
+    {
+        struct timespec deadline;
+
+        bool bHeld = __atomic_load_n( &gAsync.held, __ATOMIC_ACQUIRE ) && !__atomic_load_n( &gAsync.stopping, __ATOMIC_ACQUIRE );
+
+        if ( (bHeld == false) && (drain( false ) > 0) )
+        {
+            continue;
+        }
+        if ( __atomic_load_n( &gAsync.stopping, __ATOMIC_ACQUIRE ) && isEmpty() )
+        {
+            break;
+        }
+
+        /* Sleeping is set before the last check, so a line published after it posts wake */
+        __atomic_store_n( &gAsync.sleeping, 1, __ATOMIC_SEQ_CST );
+        if ( (bHeld || isEmpty()) && !__atomic_load_n( &gAsync.stopping, __ATOMIC_ACQUIRE ) )
+        {
+            clock_gettime( CLOCK_REALTIME, &deadline );
+            deadline.tv_nsec += UT_LOG_ASYNC_IDLE_MS * 1000000L;
+            if ( deadline.tv_nsec >= 1000000000L )
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            while ( (sem_timedwait( &gAsync.wake, &deadline ) != 0) && (errno == EINTR) )
+            {
+            }
+        }
+        __atomic_store_n( &gAsync.sleeping, 0, __ATOMIC_SEQ_CST );
+    }
+    return NULL;
+}
+
+static void setHandler( size_t index )
+{
+    struct sigaction action;
+
+    memset( &action, 0, sizeof(action) );
+    action.sa_handler = fatalSignalHandler;
+    action.sa_flags = SA_NODEFER;
+    sigemptyset( &action.sa_mask );
+    sigaction( gFatalSignals[index], &action, NULL );
+}
+
+/**
+ * @brief Writes what is queued and passes the signal on to the handler installed before ours
+ *
+ * The previous action is reinstalled for the raise(), so a handler of the test or the framework
+ * still runs, and SIG_DFL still terminates. If that handler returns, ours is installed again.
+ */
+static void fatalSignalHandler( int signal )
+{
+    int saved = errno;
+    size_t index = 0;
+
+    /* The writer thread may be the one that faulted, so the ring is drained here if it is free */
+    for (int attempt = 0; (attempt < 100) && !isEmpty(); attempt++)
+    {
+        if ( drain( true ) < 0 )
+        {
+            struct timespec pause = { 0, 1000000L };
+
+            nanosleep( &pause, NULL );
+        }
+    }
+
+    while ( (index < sizeof(gFatalSignals) / sizeof(gFatalSignals[0])) && (gFatalSignals[index] != signal) )
+    {
+        index++;
+    }
+    if ( index < sizeof(gFatalSignals) / sizeof(gFatalSignals[0]) )
+    {
+        sigaction( signal, &gPreviousActions[index], NULL );
+        raise( signal );
+        setHandler( index );
+    }
+    errno = saved;
+}
+
+static void installSignalHandlers( void )
+{
+    for (size_t i = 0; i < sizeof(gFatalSignals) / sizeof(gFatalSignals[0]); i++)
+    {
+        sigaction( gFatalSignals[i], NULL, &gPreviousActions[i] );
+        setHandler( i );
+    }
+}
+
+static void restoreSignalHandlers( void )
+{
+    for (size_t i = 0; i < sizeof(gFatalSignals) / sizeof(gFatalSignals[0]); i++)
+    {
+        sigaction( gFatalSignals[i], &gPreviousActions[i], NULL );
+    }
+}
+
+static void atExit( void )
+{
+    UT_log_async_stop();
+}
+
+static void beforeFork( void )
+{
+    UT_log_async_flush();
+}
+
+/**
+ * @brief Starts the writer thread, once
+ *
+ * @return bool - false if it could not be started, the caller then logs synchronously
+ */
+static bool startWriter( void )
+{
+    int expected = 0;
+
+    if ( !__atomic_compare_exchange_n( &gAsync.writerStarted, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+    {
+        return true;
+    }
+    if ( pthread_create( &gAsync.writer, NULL, writerThread, NULL ) != 0 )
+    {
+        __atomic_store_n( &gAsync.writerStarted, 0, __ATOMIC_RELEASE );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Resets the ring consumer in a forked child, the parent's writer thread is not copied
+ *
+ * The child's writer is started by its first line, a child that never logs never starts one.
+ */
+static void afterForkInChild( void )
+{
+    if ( __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) == 0 )
+    {
+        return;
+    }
+    __atomic_store_n( &gAsync.consumer, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &gAsync.sleeping, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &gAsync.writerStarted, 0, __ATOMIC_RELEASE );
+    sem_init( &gAsync.wake, 0, 0 );
+}
+
+int UT_log_async_start( void )
+{
+    const char *pLogFile = UT_log_getLogFilename();
+
+    if ( __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) != 0 )
+    {
+        return 0;
+    }
+
+    /* The ring is kept after a stop, a producer may still be writing its last line into it */
+    if ( gAsync.pRecords == NULL )
+    {
+        gAsync.pRecords = (UT_log_record_t *)calloc( UT_LOG_ASYNC_SLOTS, sizeof(UT_log_record_t) );
+    }
+    if ( gAsync.pRecords == NULL )
+    {
+        return -1;
+    }
+    for (uint64_t i = 0; i < UT_LOG_ASYNC_SLOTS; i++)
+    {
+        gAsync.pRecords[i].sequence = i;
+    }
+    gAsync.enqueuePosition = 0;
+    gAsync.dequeuePosition = 0;
+    gAsync.dropped = 0;
+    gAsync.consumer = 0;
+    gAsync.sleeping = 0;
+    gAsync.stopping = 0;
+    gAsync.writerStarted = 0;
+    gAsync.logFd = ((pLogFile != NULL) && (pLogFile[0] != '\0')) ? open( pLogFile, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644 ) : -1;
+
+    if ( (sem_init( &gAsync.wake, 0, 0 ) != 0) || (startWriter() == false) )
+    {
+        if ( gAsync.logFd >= 0 )
+        {
+            close( gAsync.logFd );
+        }
+        return -1;
+    }
+
+    if ( gAsync.bHooksInstalled == false )
+    {
+        atexit( atExit );
+        pthread_atfork( beforeFork, NULL, afterForkInChild );
+        gAsync.bHooksInstalled = true;
+    }
+    installSignalHandlers();
+    __atomic_store_n( &gAsync.enabled, 1, __ATOMIC_RELEASE );
+    return 0;
+}
+
+void UT_log_async_flush( void )
+{
+    uint64_t target = __atomic_load_n( &gAsync.enqueuePosition, __ATOMIC_ACQUIRE );
+
+    if ( __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) == 0 )
+    {
+        return;
+    }
+
+    /* Lines claimed before the flush started are drained here, or waited for while the writer
+       drains them, up to UT_LOG_ASYNC_FLUSH_MS */
+    for (int waited = 0; waited < UT_LOG_ASYNC_FLUSH_MS; waited++)
+    {
+        struct timespec pause = { 0, 1000000L };
+
+        if ( __atomic_load_n( &gAsync.dequeuePosition, __ATOMIC_ACQUIRE ) >= target )
+        {
+            break;
+        }
+        if ( drain( false ) < 0 )
+        {
+            sem_post( &gAsync.wake );
+        }
+        nanosleep( &pause, NULL );
+    }
+    fflush( stdout );
+}
+
+void UT_log_async_stop( void )
+{
+    if ( __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) == 0 )
+    {
+        return;
+    }
+
+    UT_log_async_flush();
+    __atomic_store_n( &gAsync.enabled, 0, __ATOMIC_RELEASE );
+    __atomic_store_n( &gAsync.stopping, 1, __ATOMIC_RELEASE );
+    sem_post( &gAsync.wake );
+    if ( __atomic_exchange_n( &gAsync.writerStarted, 0, __ATOMIC_ACQ_REL ) != 0 )
+    {
+        pthread_join( gAsync.writer, NULL );
+    }
+    restoreSignalHandlers();
+
+    /* A line claimed after the stop is written by the last drain, nothing is queued after it */
+    drain( false );
+    sem_destroy( &gAsync.wake );
+    if ( gAsync.logFd >= 0 )
+    {
+        close( gAsync.logFd );
+        gAsync.logFd = -1;
+    }
+}
+
+bool UT_log_async_enabled( void )
+{
+    return __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) != 0;
+}
+
+bool UT_log_async_hooked( void )
+{
+    return (__atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) != 0) || UT_trace_enabled();
+}
+
+void UT_log_async_hold( bool bHold )
+{
+    __atomic_store_n( &gAsync.held, bHold ? 1 : 0, __ATOMIC_RELEASE );
+    if ( __atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) != 0 )
+    {
+        sem_post( &gAsync.wake );
+    }
+}
+
+void UT_log_async_logPrefix( const char *file, int line, const char *prefix, const char *format, ... )
+{
+    char message[UT_LOG_MAX_LINE_SIZE];
+    va_list args;
+
+    va_start( args, format );
+    vsnprintf( message, sizeof(message), format, args );
+    va_end( args );
+
+    UT_trace_log( file, line, prefix, message );
+
+    if ( (__atomic_load_n( &gAsync.enabled, __ATOMIC_ACQUIRE ) != 0) &&
+         ((__atomic_load_n( &gAsync.writerStarted, __ATOMIC_ACQUIRE ) != 0) || startWriter()) )
+    {
+        /* A full ring is given UT_LOG_ASYNC_FULL_WAIT_US to drain, the line is dropped after that */
+        for (int waited = 0; enqueue( file, line, prefix, message ) == false; waited += 100)
+        {
+            if ( waited >= UT_LOG_ASYNC_FULL_WAIT_US )
+            {
+                __atomic_fetch_add( &gAsync.dropped, 1, __ATOMIC_RELAXED );
+                break;
+            }
+            sem_post( &gAsync.wake );
+            usleep( 100 );
+        }
+        return;
+    }
+
+    (UT_logPrefix)( file, line, prefix, "%s", message );
+}
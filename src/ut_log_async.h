@@ -0,0 +1,90 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Asynchronous logging
+ *
+ * With `--log-async` every UT_LOG* line is formatted by the caller into a slot of a fixed ring,
+ * and written to the console and the log file by a writer thread. Logging threads never block
+ * on the console, they claim a slot with a compare and swap. When the ring is full a line waits
+ * briefly for the writer to make room, then it is dropped and counted, the writer reports the
+ * count with the next lines it writes. The memory used is fixed at UT_LOG_ASYNC_SLOTS lines.
+ *
+ * The ring is flushed by UT_exit(), at exit(), before a fork() and on a fatal signal. A forked
+ * child starts its own writer thread on its first line.
+ */
+
+#ifndef __UT_LOG_ASYNC_H
+#define __UT_LOG_ASYNC_H
+
+#include <stdbool.h>
+
+#define UT_LOG_ASYNC_SLOTS (1024)     /*!< Lines held by the ring, a power of 2 */
+
+/**
+ * @brief Starts the writer thread, the UT_LOG* lines are queued from then on
+ *
+ * @return int - 0 on success, -1 if the logger could not be started and logging stays synchronous
+ */
+extern int UT_log_async_start(void);
+
+/**
+ * @brief Waits for every queued line to be written
+ */
+extern void UT_log_async_flush(void);
+
+/**
+ * @brief Flushes the ring and stops the writer thread, logging is synchronous again
+ */
+extern void UT_log_async_stop(void);
+
+/**
+ * @brief Checks whether the asynchronous logger is running
+ */
+extern bool UT_log_async_enabled(void);
+
+/**
+ * @brief Checks whether a UT_LOG* line has to go through UT_log_async_logPrefix()
+ *
+ * @return true - the asynchronous logger or the --trace file is on
+ */
+extern bool UT_log_async_hooked(void);
+
+/**
+ * @brief Holds the writer thread, so the ring fills up, a flush still drains it
+ *
+ * For testing a full ring.
+ */
+extern void UT_log_async_hold(bool bHold);
+
+/**
+ * @brief Logs a line, queued when the logger is running and written by UT_logPrefix() otherwise
+ *
+ * The line is also recorded in the --trace file, see ut_trace.h.
+ *
+ * The UT_logPrefix() macro of ut.h calls this function while UT_log_async_hooked(), and calls
+ * ut-control's UT_logPrefix() directly otherwise.
+ */
+extern void UT_log_async_logPrefix(const char *file, int line, const char *prefix, const char *format, ...);
+
+#endif  /*  __UT_LOG_ASYNC_H  */
+/** @} */
@@ -25,11 +25,20 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 
 #include <ut.h>
 #include <ut_log.h>
 #include <ut_kvp_profile.h>
 #include <ut_internal.h>
+#include <ut_log_async.h>
+#include <ut_trace.h>
+#include <ut_stress.h>
+#include <ut_impact.h>
+#include <ut_coverage.h>
+#include <ut_perf.h>
+#include <ut_memory.h>
 
 
 #define DEFAULT_FILENAME "ut_test"
@@ -37,6 +46,36 @@
 #define UT_VERSION "Not Defined"
 #endif
 
+/* Long only options, kept outside of the short option character range */
+#define UT_OPTION_SHARD_INDEX   (256)
+#define UT_OPTION_SHARD_COUNT   (257)
+#define UT_OPTION_SHARD_HISTORY (258)
+#define UT_OPTION_RESULTS_FSYNC (259)
+#define UT_OPTION_TEST_TIMEOUT  (260)
+#define UT_OPTION_SUITE_TIMEOUT (261)
+#define UT_OPTION_CACHE         (262)
+#define UT_OPTION_NO_CACHE      (263)
+#define UT_OPTION_LOG_ASYNC     (264)
+#define UT_OPTION_TRACE         (265)
+#define UT_OPTION_ISOLATE       (266)
+#define UT_OPTION_REPEAT        (267)
+#define UT_OPTION_REPEAT_FOR    (268)
+#define UT_OPTION_UNTIL_FAIL    (269)
+#define UT_OPTION_IMPACT_RECORD (270)
+#define UT_OPTION_IMPACT_SELECT (271)
+#define UT_OPTION_IMPACT_CHANGED (272)
+#define UT_OPTION_COVERAGE_DIR  (273)
+#define UT_OPTION_PERF          (274)
+#define UT_OPTION_MEMORY        (275)
+#define UT_OPTION_LEAK_BUDGET   (276)
+
+/* Profile keys used when the timeout is not set on the command line */
+#define UT_PROFILE_TEST_TIMEOUT  "ut-core/testTimeout"
+#define UT_PROFILE_SUITE_TIMEOUT "ut-core/suiteTimeout"
+
+/* Profile key used when the leak budget is not set on the command line */
+#define UT_PROFILE_LEAK_BUDGET   "ut-core/leakBudget"
+
 /* Global variables */
 static optionFlags_t gOptions;  /*!< Control flags, should not be exposed outside of this file */
 
@@ -52,7 +91,27 @@ static void usage( void )
     TEST_INFO(( "-d - <group id> - Disable Group \n" ));
     TEST_INFO(( "-e - <group id> - Enable Group \n" ));
     TEST_INFO(( "-t - List all tests run to a file\n" ));
+    TEST_INFO(( "-j - <jobs> - Run the suites across <jobs> worker processes (Basic & Automated Modes)\n" ));
     TEST_INFO(( "-l - Set the log Path\n" ));
+    TEST_INFO(( "--shard-index <index> --shard-count <count> - Run only shard <index> (0 based) of <count> shards\n" ));
+    TEST_INFO(( "--shard-history <report>[,<report>] - Previous reports used to balance the shards by suite duration\n" ));
+    TEST_INFO(( "--results-fsync - fsync the results file as each suite completes (Automated Mode)\n" ));
+    TEST_INFO(( "--test-timeout <seconds> - Fail a test as hung once it has run for <seconds>\n" ));
+    TEST_INFO(( "--suite-timeout <seconds> - Fail the rest of a suite once its tests have run for <seconds>\n" ));
+    TEST_INFO(( "--cache <file> - Skip suites that passed with the same binary, libraries and profile (Automated Mode)\n" ));
+    TEST_INFO(( "--no-cache - Run every suite, the --cache file is still refreshed\n" ));
+    TEST_INFO(( "--log-async - Queue the UT_LOG lines and write them from a background thread\n" ));
+    TEST_INFO(( "--trace <file> - Append the suite, test, assertion and log events of the run to <file> as NDJSON\n" ));
+    TEST_INFO(( "--isolate <test|suite> - Run each test, or each suite, in its own process and fail the test on a crash\n" ));
+    TEST_INFO(( "--repeat <count> - Run the tests <count> times and report the flaky ones (Basic & Automated Modes)\n" ));
+    TEST_INFO(( "--repeat-for <seconds> - Keep running the tests until <seconds> have passed, and report the flaky ones\n" ));
+    TEST_INFO(( "--until-fail - Stop repeating the tests once one has failed\n" ));
+    TEST_INFO(( "--impact-record <map> - Write the functions each test enters to <map>, needs a build with IMPACT=1\n" ));
+    TEST_INFO(( "--perf - Count cycles, instructions, cache misses, context switches and page faults of each test\n" ));
+    TEST_INFO(( "--memory - Report the net allocation and peak memory of each test\n" ));
+    TEST_INFO(( "--leak-budget <bytes> - Fail a test that leaves more than <bytes> allocated, implies --memory\n" ));
+    TEST_INFO(( "--coverage-dir <dir> - Write the coverage of each test under <dir>, needs a build with COVERAGE=1\n" ));
+    TEST_INFO(( "--impact-select <map> --impact-changed <function>[,<function>]|@<file> - Run only the suites that enter a changed function\n" ));
     TEST_INFO(( "-p - <profile_filename> - specify the profile to load YAML or JSON, also used by kvp_assert\n" ));
     TEST_INFO(("- Group IDs are as below\n"));
     TEST_INFO(("- Group 1  : Level 1 basic tests are expected to be in this group\n"));
@@ -67,10 +126,118 @@ static void usage( void )
     TEST_INFO(( "-h - Help\n" ));
 }
 
+/**
+ * @brief Decodes a whole decimal value within a range
+ *
+ * @param pValue - the text to decode
+ * @param min - smallest value accepted
+ * @param max - largest value accepted
+ * @param pResult - set to the value, left as it is when the text is not valid
+ * @return bool - false if the text is not a number, has trailing characters or is out of range
+ */
+static bool decodeNumber( const char *pValue, long long min, long long max, long long *pResult )
+{
+    char *pEnd = NULL;
+    long long value;
+
+    errno = 0;
+    value = strtoll( pValue, &pEnd, 10 );
+    if ( (pEnd == pValue) || (*pEnd != '\0') || (errno == ERANGE) || (value < min) || (value > max) )
+    {
+        return false;
+    }
+    *pResult = value;
+    return true;
+}
+
+/**
+ * @brief Decodes the value of a numeric option, an invalid value is reported with the usage
+ *
+ * @param pOption - name of the option, for the report
+ * @param pValue - value of the option
+ * @param min - smallest value accepted
+ * @param max - largest value accepted
+ * @param pResult - set to the value
+ * @return bool - false if the value is not valid
+ */
+static bool decodeOptionNumber( const char *pOption, const char *pValue, long long min, long long max, long long *pResult )
+{
+    if ( decodeNumber( pValue, min, max, pResult ) == false )
+    {
+        TEST_INFO(("Invalid %s [%s], expected %lld to %lld\n", pOption, pValue, min, max));
+        usage();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a timeout from the profile
+ *
+ * @param pKey - profile key holding the timeout in seconds
+ * @return int - the timeout, or 0 when not in the profile
+ */
+static int getProfileTimeout( const char *pKey )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    long long timeout = 0;
+
+    if ( (ut_kvp_profile_getLayerCount() == 0) ||
+         (ut_kvp_profile_getStringField( pKey, value, sizeof(value) ) != UT_KVP_STATUS_SUCCESS) )
+    {
+        return 0;
+    }
+    if ( decodeNumber( value, 0, INT_MAX, &timeout ) == false )
+    {
+        TEST_INFO(("Invalid [%s] in the profile [%s], ignored\n", pKey, value));
+    }
+    return (int)timeout;
+}
+
+/**
+ * @brief Reads the leak budget from the profile
+ *
+ * @return int64_t - the budget in bytes, UT_MEMORY_NO_BUDGET when not in the profile
+ */
+static int64_t getProfileLeakBudget( void )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    long long budget = UT_MEMORY_NO_BUDGET;
+
+    if ( (ut_kvp_profile_getLayerCount() == 0) ||
+         (ut_kvp_profile_getStringField( UT_PROFILE_LEAK_BUDGET, value, sizeof(value) ) != UT_KVP_STATUS_SUCCESS) )
+    {
+        return UT_MEMORY_NO_BUDGET;
+    }
+    if ( decodeNumber( value, 0, INT64_MAX, &budget ) == false )
+    {
+        TEST_INFO(("Invalid [%s] in the profile [%s], ignored\n", UT_PROFILE_LEAK_BUDGET, value));
+    }
+    return budget;
+}
+
 static bool decodeOptions( int argc, char **argv )
 {
     int opt;
     int option_index = 0;
+    int shardIndex = 0;
+    int shardCount = 1;
+    int testTimeout = -1;
+    int suiteTimeout = -1;
+    const char *pCacheFile = NULL;
+    char profileFiles[1024] = "";
+    bool bUseCached = true;
+    bool bLogAsync = false;
+    int repeat = 0;
+    int repeatSeconds = 0;
+    bool bUntilFail = false;
+    const char *pImpactMap = NULL;
+    const char *pImpactChanged = NULL;
+    const char *pCoverageDir = NULL;
+    bool bPerf = false;
+    bool bMemory = false;
+    int64_t leakBudget = UT_MEMORY_NO_BUDGET;
+    long long value;
     ut_kvp_status_t status;
 
     memset(&gOptions,0,sizeof(gOptions));
@@ -81,6 +248,27 @@ static bool decodeOptions( int argc, char **argv )
     // Define long options
     static struct option long_options[] = {
         {"gtest_output", required_argument, 0, 0}, // 0 is used as a placeholder for gtest_output
+        {"shard-index", required_argument, 0, UT_OPTION_SHARD_INDEX},
+        {"shard-count", required_argument, 0, UT_OPTION_SHARD_COUNT},
+        {"shard-history", required_argument, 0, UT_OPTION_SHARD_HISTORY},
+        {"results-fsync", no_argument, 0, UT_OPTION_RESULTS_FSYNC},
+        {"test-timeout", required_argument, 0, UT_OPTION_TEST_TIMEOUT},
+        {"suite-timeout", required_argument, 0, UT_OPTION_SUITE_TIMEOUT},
+        {"cache", required_argument, 0, UT_OPTION_CACHE},
+        {"no-cache", no_argument, 0, UT_OPTION_NO_CACHE},
+        {"log-async", no_argument, 0, UT_OPTION_LOG_ASYNC},
+        {"trace", required_argument, 0, UT_OPTION_TRACE},
+        {"isolate", required_argument, 0, UT_OPTION_ISOLATE},
+        {"repeat", required_argument, 0, UT_OPTION_REPEAT},
+        {"repeat-for", required_argument, 0, UT_OPTION_REPEAT_FOR},
+        {"until-fail", no_argument, 0, UT_OPTION_UNTIL_FAIL},
+        {"impact-record", required_argument, 0, UT_OPTION_IMPACT_RECORD},
+        {"impact-select", required_argument, 0, UT_OPTION_IMPACT_SELECT},
+        {"impact-changed", required_argument, 0, UT_OPTION_IMPACT_CHANGED},
+        {"coverage-dir", required_argument, 0, UT_OPTION_COVERAGE_DIR},
+        {"perf", no_argument, 0, UT_OPTION_PERF},
+        {"memory", no_argument, 0, UT_OPTION_MEMORY},
+        {"leak-budget", required_argument, 0, UT_OPTION_LEAK_BUDGET},
         {0, 0, 0, 0} // Terminator
     };
 
@@ -88,7 +276,7 @@ static bool decodeOptions( int argc, char **argv )
     UT_log_setLogFilePath((char* )UT_LOG_DEFAULT_PATH);
     UT_set_results_output_filename( UT_log_getLogFilename() );
 
-    while ((opt = getopt_long(argc, argv, "cabhf:l:tp:d:e:", long_options, &option_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "cabhf:l:tp:d:e:j:", long_options, &option_index)) != -1)
     {
         switch(opt)
         {
@@ -128,15 +316,147 @@ static bool decodeOptions( int argc, char **argv )
                 TEST_INFO(("Enable group [%d]\n", atoi(optarg)));
                 UT_Manage_Suite_Activation(atoi(optarg), true);
                 break;
+            case 'j':
+                if (decodeOptionNumber("-j", optarg, 1, UT_MAX_PARALLEL_JOBS, &value) == false)
+                {
+                    return false;
+                }
+                TEST_INFO(("Parallel jobs [%lld]\n", value));
+                UT_set_parallel_jobs((int)value);
+                break;
             case 'p':
                 TEST_INFO(("Using Profile[%s]\n", optarg));
                 status = ut_kvp_profile_open(optarg);
+                if ((strlen(profileFiles) + strlen(optarg) + 2) < sizeof(profileFiles))
+                {
+                    strcat(profileFiles, (profileFiles[0] != '\0') ? "," : "");
+                    strcat(profileFiles, optarg);
+                }
                 if ( status != UT_KVP_STATUS_SUCCESS )
                 {
                     UT_LOG_ERROR("Failed to Load [%s]", optarg);
                 }
                 break;
 
+            case UT_OPTION_SHARD_INDEX:
+                if (decodeOptionNumber("--shard-index", optarg, 0, UT_MAX_SHARDS - 1, &value) == false)
+                {
+                    return false;
+                }
+                shardIndex = (int)value;
+                break;
+            case UT_OPTION_SHARD_COUNT:
+                if (decodeOptionNumber("--shard-count", optarg, 1, UT_MAX_SHARDS, &value) == false)
+                {
+                    return false;
+                }
+                shardCount = (int)value;
+                break;
+            case UT_OPTION_SHARD_HISTORY:
+                TEST_INFO(("Shard history [%s]\n", optarg));
+                UT_set_shard_history(optarg);
+                break;
+            case UT_OPTION_RESULTS_FSYNC:
+                TEST_INFO(("Results fsync enabled\n"));
+                UT_set_results_fsync(true);
+                break;
+            case UT_OPTION_TEST_TIMEOUT:
+                if (decodeOptionNumber("--test-timeout", optarg, 0, INT_MAX, &value) == false)
+                {
+                    return false;
+                }
+                testTimeout = (int)value;
+                break;
+            case UT_OPTION_SUITE_TIMEOUT:
+                if (decodeOptionNumber("--suite-timeout", optarg, 0, INT_MAX, &value) == false)
+                {
+                    return false;
+                }
+                suiteTimeout = (int)value;
+                break;
+            case UT_OPTION_CACHE:
+                TEST_INFO(("Result cache [%s]\n", optarg));
+                pCacheFile = optarg;
+                break;
+            case UT_OPTION_NO_CACHE:
+                TEST_INFO(("Result cache disabled, running all suites\n"));
+                bUseCached = false;
+                break;
+            case UT_OPTION_LOG_ASYNC:
+                bLogAsync = true;
+                break;
+            case UT_OPTION_TRACE:
+                if (UT_trace_open(optarg) == 0)
+                {
+                    TEST_INFO(("Trace [%s]\n", optarg));
+                }
+                else
+                {
+                    TEST_INFO(("Failed to open the trace [%s]\n", optarg));
+                }
+                break;
+            case UT_OPTION_ISOLATE:
+                if (strcmp(optarg, "test") == 0)
+                {
+                    UT_set_isolation(UT_ISOLATION_TEST);
+                }
+                else if (strcmp(optarg, "suite") == 0)
+                {
+                    UT_set_isolation(UT_ISOLATION_SUITE);
+                }
+                else
+                {
+                    TEST_INFO(("Unknown isolation [%s], expected test or suite\n", optarg));
+                    usage();
+                    return false;
+                }
+                TEST_INFO(("Isolation [%s]\n", optarg));
+                break;
+            case UT_OPTION_REPEAT:
+                if (decodeOptionNumber("--repeat", optarg, 0, INT_MAX, &value) == false)
+                {
+                    return false;
+                }
+                repeat = (int)value;
+                break;
+            case UT_OPTION_REPEAT_FOR:
+                if (decodeOptionNumber("--repeat-for", optarg, 0, INT_MAX, &value) == false)
+                {
+                    return false;
+                }
+                repeatSeconds = (int)value;
+                break;
+            case UT_OPTION_UNTIL_FAIL:
+                bUntilFail = true;
+                break;
+            case UT_OPTION_IMPACT_RECORD:
+                if (UT_impact_record_start(optarg) == 0)
+                {
+                    TEST_INFO(("Impact map [%s]\n", optarg));
+                }
+                break;
+            case UT_OPTION_IMPACT_SELECT:
+                pImpactMap = optarg;
+                break;
+            case UT_OPTION_IMPACT_CHANGED:
+                pImpactChanged = optarg;
+                break;
+            case UT_OPTION_COVERAGE_DIR:
+                pCoverageDir = optarg;
+                break;
+            case UT_OPTION_PERF:
+                bPerf = true;
+                break;
+            case UT_OPTION_MEMORY:
+                bMemory = true;
+                break;
+            case UT_OPTION_LEAK_BUDGET:
+                if (decodeOptionNumber("--leak-budget", optarg, 0, INT64_MAX, &value) == false)
+                {
+                    return false;
+                }
+                leakBudget = (int64_t)value;
+                break;
             case 'h':
                 TEST_INFO(("Help\n"));
                 usage();
@@ -156,6 +476,87 @@ static bool decodeOptions( int argc, char **argv )
         TEST_INFO(("unknown arguments: %s\n", argv[optind]));
     }
 
+    if ((shardCount < 1) || (shardCount > UT_MAX_SHARDS) || (shardIndex < 0) || (shardIndex >= shardCount))
+    {
+        TEST_INFO(("Invalid shard [%d] of [%d]\n", shardIndex, shardCount));
+        return false;
+    }
+    if (shardCount > 1)
+    {
+        TEST_INFO(("Shard [%d] of [%d]\n", shardIndex, shardCount));
+        UT_set_shard(shardIndex, shardCount);
+    }
+
+    /* The command line takes precedence over the profile */
+    if (testTimeout < 0)
+    {
+        testTimeout = getProfileTimeout(UT_PROFILE_TEST_TIMEOUT);
+    }
+    if (suiteTimeout < 0)
+    {
+        suiteTimeout = getProfileTimeout(UT_PROFILE_SUITE_TIMEOUT);
+    }
+    if (leakBudget == UT_MEMORY_NO_BUDGET)
+    {
+        leakBudget = getProfileLeakBudget();
+    }
+    if ((pImpactMap != NULL) != (pImpactChanged != NULL))
+    {
+        TEST_INFO(("--impact-select and --impact-changed are used together\n"));
+        usage();
+        return false;
+    }
+    if ((pImpactMap != NULL) && (UT_impact_select(pImpactMap, pImpactChanged) == 0))
+    {
+        TEST_INFO(("Impact selection [%s] changed [%s]\n", pImpactMap, pImpactChanged));
+    }
+
+    if ((repeat > 0) || (repeatSeconds > 0) || bUntilFail)
+    {
+        TEST_INFO(("Repeat [%d] for [%d]s until fail [%s] (0 is no limit)\n", repeat, repeatSeconds, bUntilFail ? "yes" : "no"));
+        UT_stress_configure((unsigned int)repeat, (unsigned int)repeatSeconds, bUntilFail);
+    }
+
+    if (testTimeout > 0)
+    {
+        TEST_INFO(("Test timeout [%d]s\n", testTimeout));
+        UT_set_test_timeout((unsigned int)testTimeout);
+    }
+    if (suiteTimeout > 0)
+    {
+        TEST_INFO(("Suite timeout [%d]s\n", suiteTimeout));
+        UT_set_suite_timeout((unsigned int)suiteTimeout);
+    }
+
+    if (pCacheFile != NULL)
+    {
+        UT_set_result_cache(pCacheFile, (profileFiles[0] != '\0') ? profileFiles : NULL, bUseCached);
+    }
+
+    /* Started last, the log file path is final once every option is decoded */
+    if (bLogAsync)
+    {
+        if (UT_log_async_start() == 0)
+        {
+            TEST_INFO(("Asynchronous logging enabled\n"));
+        }
+        else
+        {
+            TEST_INFO(("Asynchronous logging failed to start, logging synchronously\n"));
+        }
+    }
+
+    /* Always on in a COVERAGE=1 build, by default beside the log file */
+    UT_coverage_start(pCoverageDir);
+    if (bPerf)
+    {
+        UT_perf_enable();
+    }
+    if (bMemory || (leakBudget >= 0))
+    {
+        UT_memory_enable((leakBudget >= 0) ? leakBudget : UT_MEMORY_NO_BUDGET);
+    }
+
     UT_set_test_mode(gOptions.testMode);
     return true;
 }
@@ -191,5 +592,7 @@ UT_status_t UT_init(int argc, char** argv)
 
 void UT_exit( void )
 {
+    UT_log_async_stop();
+    UT_trace_close();
     ut_kvp_profile_close();
 }
@@ -0,0 +1,335 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_memory.h"
+
+#define UT_MEMORY_NAME_SIZE     (160)
+#define UT_MEMORY_STATUS_SIZE   (4096)  /*!< Fits /proc/self/status */
+#define UT_MEMORY_TCACHE_COUNT  (7)     /*!< Chunks glibc keeps per thread cache bin, unless tuned */
+#define UT_MEMORY_TCACHE_MAX    (1032)  /*!< Largest request glibc keeps in the thread cache, unless tuned */
+
+/** A test in the summary */
+typedef struct
+{
+    char name[UT_MEMORY_NAME_SIZE];
+    UT_memory_sample_t sample;
+} UT_memory_top_t;
+
+static bool gbEnabled = false;
+static bool gbHeap = false;                 /*!< mallinfo() is available */
+static bool gbPeak = false;                 /*!< The high-water mark can be reset */
+static int64_t gLeakBudget = UT_MEMORY_NO_BUDGET;
+static int64_t gHeapAtStart = 0;
+static int64_t gRssAtStart = 0;
+static int64_t gNetTotal = 0;
+static unsigned int gTests = 0;
+static unsigned int gLeakingTests = 0;
+static unsigned int gOverBudget = 0;
+static UT_memory_top_t gTop[UT_MEMORY_TOP_TESTS];
+static unsigned int gTopCount = 0;
+
+/**
+ * @brief Fills every bin of this thread's malloc cache
+ *
+ * mallinfo() counts the chunks held in the thread cache as in use, so a test that frees what it
+ * allocated into a bin that had room would read as a leak. With every bin full at both readings
+ * the cache holds the same bytes each time, and a chunk freed by the test goes back to the arena.
+ */
+static void fillThreadCache( void )
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 26)
+    void *volatile pChunks[UT_MEMORY_TCACHE_COUNT];    /* volatile, the pairs are not optimised away */
+
+    for (size_t size = sizeof(size_t); size <= UT_MEMORY_TCACHE_MAX; size += sizeof(size_t))
+    {
+        for (int i = 0; i < UT_MEMORY_TCACHE_COUNT; i++)
+        {
+            pChunks[i] = malloc( size );
+        }
+        for (int i = 0; i < UT_MEMORY_TCACHE_COUNT; i++)
+        {
+            free( pChunks[i] );
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Reads the bytes of heap in use, from every arena and the chunks mapped on their own
+ */
+static int64_t readHeap( void )
+{
+#if defined(__GLIBC__)
+    fillThreadCache();
+#if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = mallinfo2();
+
+    return (int64_t)info.uordblks + (int64_t)info.hblkhd;
+#else
+    struct mallinfo info = mallinfo();
+
+    /* int fields, they wrap past 2GB */
+    return (int64_t)(unsigned int)info.uordblks + (int64_t)(unsigned int)info.hblkhd;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Reads a field of /proc/self/status in bytes
+ *
+ * read() rather than stdio, so the reading does not allocate.
+ *
+ * @param pField - field with its colon, e.g. "VmRSS:"
+ * @return int64_t - the value in bytes, -1 if it cannot be read
+ */
+static int64_t readStatus( const char *pField )
+{
+    char status[UT_MEMORY_STATUS_SIZE];
+    ssize_t length;
+    char *pValue;
+    int fd = open( "/proc/self/status", O_RDONLY | O_CLOEXEC );
+
+    if ( fd < 0 )
+    {
+        return -1;
+    }
+    length = read( fd, status, sizeof(status) - 1 );
+    close( fd );
+    if ( length <= 0 )
+    {
+        return -1;
+    }
+    status[length] = '\0';
+
+    pValue = strstr( status, pField );
+    if ( pValue == NULL )
+    {
+        return -1;
+    }
+    return strtoll( pValue + strlen( pField ), NULL, 10 ) * 1024;
+}
+
+/**
+ * @brief Resets the resident set high-water mark to the current resident set, Linux 4.0 onwards
+ */
+static bool resetPeak( void )
+{
+    int fd = open( "/proc/self/clear_refs", O_WRONLY | O_CLOEXEC );
+    bool bReset;
+
+    if ( fd < 0 )
+    {
+        return false;
+    }
+    bReset = ( write( fd, "5", 1 ) == 1 );
+    close( fd );
+    return bReset;
+}
+
+int UT_memory_enable(int64_t leakBudget)
+{
+#if defined(__GLIBC__)
+    gbHeap = true;
+#endif
+    gbPeak = resetPeak() && (readStatus( "VmHWM:" ) >= 0) && (readStatus( "VmRSS:" ) >= 0);
+
+    if ( (gbHeap == false) && (gbPeak == false) )
+    {
+        UT_LOG_WARNING( "Memory: neither the heap in use nor the peak resident set can be read, accounting is off" );
+        return -1;
+    }
+    if ( (gbHeap == false) && (leakBudget != UT_MEMORY_NO_BUDGET) )
+    {
+        UT_LOG_WARNING( "Memory: the heap in use cannot be read, the leak budget is ignored" );
+        leakBudget = UT_MEMORY_NO_BUDGET;
+    }
+
+    gLeakBudget = leakBudget;
+    gbEnabled = true;
+    if ( gLeakBudget == UT_MEMORY_NO_BUDGET )
+    {
+        UT_LOG( "Memory: accounting [%s%s%s]", gbHeap ? "net" : "", (gbHeap && gbPeak) ? " " : "", gbPeak ? "peak" : "" );
+    }
+    else
+    {
+        UT_LOG( "Memory: accounting [%s%s%s] leak budget [%lld] bytes", gbHeap ? "net" : "", (gbHeap && gbPeak) ? " " : "",
+                gbPeak ? "peak" : "", (long long)gLeakBudget );
+    }
+    return 0;
+}
+
+bool UT_memory_enabled(void)
+{
+    return gbEnabled;
+}
+
+bool UT_memory_budget_set(void)
+{
+    return gbEnabled && (gLeakBudget != UT_MEMORY_NO_BUDGET);
+}
+
+int64_t UT_memory_leak_budget(void)
+{
+    return gbEnabled ? gLeakBudget : UT_MEMORY_NO_BUDGET;
+}
+
+void UT_memory_test_start(void)
+{
+    if ( gbEnabled == false )
+    {
+        return;
+    }
+
+    /* The heap last, nothing after it allocates */
+    if ( gbPeak )
+    {
+        resetPeak();
+        gRssAtStart = readStatus( "VmRSS:" );
+    }
+    gHeapAtStart = readHeap();
+}
+
+bool UT_memory_over_budget(char *pCondition, size_t size)
+{
+    int64_t net;
+
+    if ( UT_memory_budget_set() == false )
+    {
+        return false;
+    }
+
+    net = readHeap() - gHeapAtStart;
+    if ( net <= gLeakBudget )
+    {
+        return false;
+    }
+    gOverBudget++;
+    snprintf( pCondition, size, "Leak budget of %lld bytes exceeded, [%lld] bytes left allocated", (long long)gLeakBudget, (long long)net );
+    return true;
+}
+
+/**
+ * @brief Keeps the tests that left the most allocated, or without the heap reading that peaked the highest, most first
+ */
+static void addTop( const char *pSuite, const char *pTest, const UT_memory_sample_t *pSample )
+{
+    int64_t value = gbHeap ? pSample->netBytes : pSample->peakBytes;
+    unsigned int position = gTopCount;
+
+    if ( value <= 0 )
+    {
+        return;
+    }
+    while ( (position > 0) && ((gbHeap ? gTop[position - 1].sample.netBytes : gTop[position - 1].sample.peakBytes) < value) )
+    {
+        position--;
+    }
+    if ( position >= UT_MEMORY_TOP_TESTS )
+    {
+        return;
+    }
+    if ( gTopCount < UT_MEMORY_TOP_TESTS )
+    {
+        gTopCount++;
+    }
+    memmove( &gTop[position + 1], &gTop[position], (gTopCount - 1 - position) * sizeof(UT_memory_top_t) );
+    snprintf( gTop[position].name, sizeof(gTop[position].name), "%s.%s", pSuite, pTest );
+    gTop[position].sample = *pSample;
+}
+
+bool UT_memory_test_end(const char *pSuite, const char *pTest, UT_memory_sample_t *pSample)
+{
+    if ( gbEnabled == false )
+    {
+        return false;
+    }
+
+    /* The heap first, before anything here allocates */
+    pSample->netBytes = gbHeap ? (readHeap() - gHeapAtStart) : 0;
+    pSample->bNetValid = gbHeap;
+    pSample->peakBytes = 0;
+    pSample->bPeakValid = false;
+    if ( gbPeak && (gRssAtStart >= 0) )
+    {
+        int64_t peak = readStatus( "VmHWM:" );
+
+        pSample->bPeakValid = (peak >= 0);
+        pSample->peakBytes = (peak > gRssAtStart) ? (peak - gRssAtStart) : 0;
+    }
+
+    gTests++;
+    gNetTotal += pSample->netBytes;
+    gLeakingTests += (pSample->netBytes > 0) ? 1 : 0;
+    addTop( pSuite, pTest, pSample );
+    return true;
+}
+
+void UT_memory_summary(void)
+{
+    if ( (gbEnabled == false) || (gTests == 0) )
+    {
+        return;
+    }
+
+    UT_LOG( "\n" );
+    if ( gbHeap )
+    {
+        UT_LOG( UT_LOG_ASCII_GREEN "Memory Summary" UT_LOG_ASCII_NC " : tests [%u] net [%lld] bytes, left allocated by [%u] tests, over the leak budget [%u]",
+                gTests, (long long)gNetTotal, gLeakingTests, gOverBudget );
+        UT_LOG( "Most left allocated:" );
+    }
+    else
+    {
+        UT_LOG( UT_LOG_ASCII_GREEN "Memory Summary" UT_LOG_ASCII_NC " : tests [%u]", gTests );
+        UT_LOG( "Highest peak:" );
+    }
+    for (unsigned int i = 0; i < gTopCount; i++)
+    {
+        const UT_memory_sample_t *pSample = &gTop[i].sample;
+
+        if ( pSample->bNetValid && pSample->bPeakValid )
+        {
+            UT_LOG( "  %-48s net [%lld] peak [%lld]", gTop[i].name, (long long)pSample->netBytes, (long long)pSample->peakBytes );
+        }
+        else if ( pSample->bNetValid )
+        {
+            UT_LOG( "  %-48s net [%lld]", gTop[i].name, (long long)pSample->netBytes );
+        }
+        else
+        {
+            UT_LOG( "  %-48s peak [%lld]", gTop[i].name, (long long)pSample->peakBytes );
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Memory use and leak accounting of each test
+ *
+ * With `--memory`, or a leak budget, every test is bracketed by two readings of the process:
+ * - the heap in use, from mallinfo2() (mallinfo() before glibc 2.33), whose change is the net allocation of the test
+ * - the resident set, whose high-water mark is reset through `/proc/self/clear_refs` as the test starts,
+ *   so the peak above the starting resident set is that of the test
+ *
+ * Both are process wide, what other threads allocate while the test runs is counted too. A C
+ * library without mallinfo(), e.g. musl, gives the peak only.
+ *
+ * The readings are added to the test as `memory_net_bytes` and `memory_peak_bytes` properties, and
+ * the run ends with a summary of the tests that left the most allocated. A test that leaves more than
+ * the leak budget allocated fails.
+ */
+
+#ifndef __UT_MEMORY_H
+#define __UT_MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define UT_MEMORY_TOP_TESTS     (10)    /*!< Tests listed in the summary, by net allocation */
+#define UT_MEMORY_NO_BUDGET     (-1)    /*!< Leak budget when none is set */
+
+/** The readings of one test */
+typedef struct
+{
+    int64_t netBytes;       /*!< Heap in use at the end of the test less at its start */
+    int64_t peakBytes;      /*!< Peak resident set during the test above the resident set at its start */
+    bool bNetValid;         /*!< false without mallinfo() */
+    bool bPeakValid;        /*!< false if the high-water mark cannot be reset */
+} UT_memory_sample_t;
+
+/**
+ * @brief Starts the accounting
+ *
+ * @param leakBudget - bytes a test may leave allocated, UT_MEMORY_NO_BUDGET to only report
+ * @return int - 0 on success, -1 if neither reading is available
+ */
+extern int UT_memory_enable(int64_t leakBudget);
+
+/**
+ * @brief Checks whether the tests are accounted
+ */
+extern bool UT_memory_enabled(void);
+
+/**
+ * @brief Checks whether the tests are failed on a leak budget
+ */
+extern bool UT_memory_budget_set(void);
+
+/**
+ * @brief Gets the leak budget, UT_MEMORY_NO_BUDGET when the tests are not failed on one
+ */
+extern int64_t UT_memory_leak_budget(void);
+
+/**
+ * @brief Takes the readings at the start of a test
+ */
+extern void UT_memory_test_start(void);
+
+/**
+ * @brief Checks the heap in use since the test started against the leak budget
+ *
+ * @param pCondition - set to the failure condition when over budget
+ * @param size - size of pCondition
+ * @return bool - true if the test is over budget
+ */
+extern bool UT_memory_over_budget(char *pCondition, size_t size);
+
+/**
+ * @brief Takes the readings at the end of a test, and adds them to the run totals
+ *
+ * @param pSuite - suite name
+ * @param pTest - test name
+ * @param pSample - set to the readings of the test
+ * @return bool - false if the tests are not accounted, pSample is then untouched
+ */
+extern bool UT_memory_test_end(const char *pSuite, const char *pTest, UT_memory_sample_t *pSample);
+
+/**
+ * @brief Logs the totals of the tests accounted by this process, and the tests that left the most allocated
+ */
+extern void UT_memory_summary(void);
+
+#endif  /*  __UT_MEMORY_H  */
+/** @} */
@@ -0,0 +1,295 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <linux/perf_event.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_perf.h"
+
+#define UT_PERF_NAME_SIZE   (160)
+
+/** How each counter is opened */
+typedef struct
+{
+    uint32_t type;
+    uint64_t config;
+    const char *pName;
+} UT_perf_event_t;
+
+/** A read with PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING */
+typedef struct
+{
+    uint64_t value;
+    uint64_t enabled;
+    uint64_t running;
+} UT_perf_reading_t;
+
+/** A test in the summary */
+typedef struct
+{
+    char name[UT_PERF_NAME_SIZE];
+    UT_perf_sample_t sample;
+} UT_perf_top_t;
+
+static const UT_perf_event_t gEvents[UT_PERF_COUNTERS] =
+{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "perf_cycles" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "perf_instructions" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "perf_cache_misses" },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "perf_context_switches" },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "perf_page_faults" },
+};
+
+static bool gbEnabled = false;
+static pid_t gOpenedBy = -1;                /*!< Process the counters belong to, a forked worker opens its own */
+static bool gbUserOnly = false;             /*!< The kernel does not allow counting in kernel mode */
+static int gFds[UT_PERF_COUNTERS];
+static UT_perf_reading_t gStart[UT_PERF_COUNTERS];
+static uint64_t gTotal[UT_PERF_COUNTERS];
+static unsigned int gTests = 0;
+static UT_perf_top_t gTop[UT_PERF_TOP_TESTS];
+static unsigned int gTopCount = 0;
+static UT_perf_counter_t gRankBy = UT_PERF_CYCLES;  /*!< Cycles, or the first counter available without a PMU */
+
+static int openEvent( const UT_perf_event_t *pEvent, bool bUserOnly )
+{
+    struct perf_event_attr attr;
+
+    memset( &attr, 0, sizeof(attr) );
+    attr.size = sizeof(attr);
+    attr.type = pEvent->type;
+    attr.config = pEvent->config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = 1;   /* Threads the test starts are counted too */
+    attr.exclude_kernel = bUserOnly ? 1 : 0;
+    attr.exclude_hv = 1;
+
+    return (int)syscall( __NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC );
+}
+
+/**
+ * @brief Opens the counters of this process, closing any inherited from the process that forked it
+ *
+ * @return int - the number of counters opened
+ */
+static int openCounters( void )
+{
+    int opened = 0;
+
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        if ( (gOpenedBy >= 0) && (gFds[i] >= 0) )
+        {
+            close( gFds[i] );
+        }
+        gFds[i] = openEvent( &gEvents[i], gbUserOnly );
+        if ( (gFds[i] < 0) && ((errno == EACCES) || (errno == EPERM)) && (gbUserOnly == false) )
+        {
+            /* perf_event_paranoid 2 and above, user space only */
+            gbUserOnly = true;
+            gFds[i] = openEvent( &gEvents[i], gbUserOnly );
+        }
+        opened += (gFds[i] >= 0) ? 1 : 0;
+    }
+    gOpenedBy = getpid();
+    return opened;
+}
+
+static bool readCounter( int fd, UT_perf_reading_t *pReading )
+{
+    return (fd >= 0) && (read( fd, pReading, sizeof(*pReading) ) == (ssize_t)sizeof(*pReading));
+}
+
+int UT_perf_enable(void)
+{
+    char available[UT_PERF_NAME_SIZE] = "";
+    int opened = openCounters();
+
+    if ( opened == 0 )
+    {
+        UT_LOG_WARNING( "Perf: no counter could be opened (%s), check /proc/sys/kernel/perf_event_paranoid", strerror( errno ) );
+        return -1;
+    }
+
+    for (int i = UT_PERF_COUNTERS - 1; i >= 0; i--)
+    {
+        if ( gFds[i] >= 0 )
+        {
+            gRankBy = (UT_perf_counter_t)i;
+        }
+    }
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        if ( gFds[i] >= 0 )
+        {
+            size_t length = strlen( available );
+            snprintf( &available[length], sizeof(available) - length, "%s%s", (length > 0) ? " " : "", &gEvents[i].pName[5] );
+        }
+    }
+    gbEnabled = true;
+    UT_LOG( "Perf: counting [%s]%s", available, gbUserOnly ? " in user space only" : "" );
+    return 0;
+}
+
+bool UT_perf_enabled(void)
+{
+    return gbEnabled;
+}
+
+const char *UT_perf_counter_name(UT_perf_counter_t counter)
+{
+    return ((unsigned int)counter < UT_PERF_COUNTERS) ? gEvents[counter].pName : "";
+}
+
+void UT_perf_test_start(void)
+{
+    if ( gbEnabled == false )
+    {
+        return;
+    }
+    if ( gOpenedBy != getpid() )
+    {
+        openCounters();
+    }
+
+    /* Last, so that the reads are charged to the harness rather than the test */
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        if ( readCounter( gFds[i], &gStart[i] ) == false )
+        {
+            memset( &gStart[i], 0, sizeof(gStart[i]) );
+        }
+    }
+}
+
+/**
+ * @brief Keeps the tests that took the most cycles, or of the ranking counter, most first
+ */
+static void addTop( const char *pSuite, const char *pTest, const UT_perf_sample_t *pSample )
+{
+    unsigned int position = gTopCount;
+
+    while ( (position > 0) && (gTop[position - 1].sample.value[gRankBy] < pSample->value[gRankBy]) )
+    {
+        position--;
+    }
+    if ( position >= UT_PERF_TOP_TESTS )
+    {
+        return;
+    }
+    if ( gTopCount < UT_PERF_TOP_TESTS )
+    {
+        gTopCount++;
+    }
+    memmove( &gTop[position + 1], &gTop[position], (gTopCount - 1 - position) * sizeof(UT_perf_top_t) );
+    snprintf( gTop[position].name, sizeof(gTop[position].name), "%s.%s", pSuite, pTest );
+    gTop[position].sample = *pSample;
+}
+
+bool UT_perf_test_end(const char *pSuite, const char *pTest, UT_perf_sample_t *pSample)
+{
+    UT_perf_reading_t end[UT_PERF_COUNTERS];
+
+    if ( (gbEnabled == false) || (gOpenedBy != getpid()) )
+    {
+        return false;
+    }
+
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        pSample->bValid[i] = readCounter( gFds[i], &end[i] );
+    }
+
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        uint64_t value = end[i].value - gStart[i].value;
+        uint64_t enabled = end[i].enabled - gStart[i].enabled;
+        uint64_t running = end[i].running - gStart[i].running;
+
+        pSample->value[i] = 0;
+        if ( (pSample->bValid[i] == false) || (running == 0) )
+        {
+            /* Multiplexed out for the whole test, or the test took no time at all */
+            pSample->bValid[i] = pSample->bValid[i] && (enabled == 0);
+            continue;
+        }
+        pSample->value[i] = (running < enabled) ? (uint64_t)((double)value * ((double)enabled / (double)running)) : value;
+        gTotal[i] += pSample->value[i];
+    }
+    gTests++;
+    addTop( pSuite, pTest, pSample );
+    return true;
+}
+
+/**
+ * @brief Formats the counts of a test, or of the run, for the log
+ */
+static void formatSample( char *pOut, size_t size, const uint64_t *pValues, const bool *pValid )
+{
+    int length = 0;
+
+    pOut[0] = '\0';
+    for (int i = 0; (i < UT_PERF_COUNTERS) && (length >= 0) && ((size_t)length < size); i++)
+    {
+        if ( pValid[i] )
+        {
+            length += snprintf( &pOut[length], size - length, "%s [%llu] ", &gEvents[i].pName[5], (unsigned long long)pValues[i] );
+        }
+    }
+    if ( pValid[UT_PERF_CYCLES] && pValid[UT_PERF_INSTRUCTIONS] && (pValues[UT_PERF_CYCLES] > 0) &&
+         (length >= 0) && ((size_t)length < size) )
+    {
+        snprintf( &pOut[length], size - length, "IPC [%.2f]", (double)pValues[UT_PERF_INSTRUCTIONS] / (double)pValues[UT_PERF_CYCLES] );
+    }
+}
+
+void UT_perf_summary(void)
+{
+    char line[512];
+    bool bValid[UT_PERF_COUNTERS];
+
+    if ( (gbEnabled == false) || (gTests == 0) )
+    {
+        return;
+    }
+
+    for (int i = 0; i < UT_PERF_COUNTERS; i++)
+    {
+        bValid[i] = (gFds[i] >= 0);
+    }
+    formatSample( line, sizeof(line), gTotal, bValid );
+    UT_LOG( "\n" );
+    UT_LOG( UT_LOG_ASCII_GREEN "Perf Summary" UT_LOG_ASCII_NC " : tests [%u] %s", gTests, line );
+    UT_LOG( "Most %s:", &gEvents[gRankBy].pName[5] );
+    for (unsigned int i = 0; i < gTopCount; i++)
+    {
+        formatSample( line, sizeof(line), gTop[i].sample.value, gTop[i].sample.bValid );
+        UT_LOG( "  %-48s %s", gTop[i].name, line );
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Hardware and software counters around each test
+ *
+ * With `--perf` every test is bracketed by perf_event_open() counters of the test thread, and the
+ * threads it starts: cycles, instructions, cache misses, context switches and page faults. Counters
+ * the kernel or CPU does not provide, e.g. in a VM without a PMU, are left out. When the kernel
+ * multiplexes the hardware counters their values are scaled by the time each was counting.
+ *
+ * The counts are added to the test as `perf_<counter>` properties and the run ends with a summary
+ * of the totals and the tests that took the most cycles, or of the first counter available when
+ * there are no hardware counters.
+ */
+
+#ifndef __UT_PERF_H
+#define __UT_PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UT_PERF_TOP_TESTS   (10)    /*!< Tests listed in the summary */
+
+typedef enum
+{
+    UT_PERF_CYCLES = 0,
+    UT_PERF_INSTRUCTIONS,
+    UT_PERF_CACHE_MISSES,
+    UT_PERF_CONTEXT_SWITCHES,
+    UT_PERF_PAGE_FAULTS,
+    UT_PERF_COUNTERS
+} UT_perf_counter_t;
+
+/** The counts of one test */
+typedef struct
+{
+    uint64_t value[UT_PERF_COUNTERS];
+    bool bValid[UT_PERF_COUNTERS];  /*!< false if the counter is not available, or did not get to count */
+} UT_perf_sample_t;
+
+/**
+ * @brief Opens the counters, they are opened again in each forked worker as it starts a test
+ *
+ * @return int - 0 if at least one counter is available, -1 otherwise
+ */
+extern int UT_perf_enable(void);
+
+/**
+ * @brief Checks whether the tests are counted
+ */
+extern bool UT_perf_enabled(void);
+
+/**
+ * @brief Gets the property name of a counter, e.g. `perf_cycles`
+ */
+extern const char *UT_perf_counter_name(UT_perf_counter_t counter);
+
+/**
+ * @brief Takes the counts at the start of a test
+ */
+extern void UT_perf_test_start(void);
+
+/**
+ * @brief Takes the counts at the end of a test, and adds them to the run totals
+ *
+ * @param pSuite - suite name
+ * @param pTest - test name
+ * @param pSample - set to the counts of the test
+ * @return bool - false if the tests are not counted, pSample is then untouched
+ */
+extern bool UT_perf_test_end(const char *pSuite, const char *pTest, UT_perf_sample_t *pSample);
+
+/**
+ * @brief Logs the totals of the tests counted by this process, and the tests that took the most cycles
+ */
+extern void UT_perf_summary(void);
+
+#endif  /*  __UT_PERF_H  */
+/** @} */
@@ -0,0 +1,437 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_stress.h"
+
+#define UT_STRESS_NAME_SIZE         (240)   /*!< "Suite.Test", longer names are truncated */
+#define UT_STRESS_FILENAME_SIZE     (512)
+#define UT_STRESS_LISTED_FAILURES   (32)    /*!< Failed iterations listed per test in the report */
+
+/** A test outcome, the records file is an array of them */
+typedef struct
+{
+    uint32_t iteration;     /*!< 1 based */
+    uint32_t passed;
+    uint64_t durationNs;
+    char name[UT_STRESS_NAME_SIZE];
+} UT_stress_record_t;
+
+/** The records of one test, folded */
+typedef struct
+{
+    char name[UT_STRESS_NAME_SIZE];
+    uint32_t runs;
+    uint32_t failures;
+    uint32_t failedIterations[UT_STRESS_LISTED_FAILURES];
+    uint64_t *pDurations;   /*!< One per run, in microseconds */
+    uint32_t capacity;
+} UT_stress_test_t;
+
+static unsigned int gIterations = 0;
+static unsigned int gSeconds = 0;
+static bool gbUntilFail = false;
+static int gRecordsFd = -1;
+static unsigned int gIteration = 1;     /*!< Running iteration, 1 based */
+static uint64_t gStartNs = 0;
+static off_t gScannedOffset = 0;        /*!< The records before it have been checked by anyFailed() */
+static bool gbAnyFailed = false;        /*!< A failed record has been seen, it stays set */
+static char gRecordsFile[UT_STRESS_FILENAME_SIZE];
+static char gReportFile[UT_STRESS_FILENAME_SIZE];
+
+void UT_stress_configure(unsigned int iterations, unsigned int seconds, bool bUntilFail)
+{
+    gIterations = iterations;
+    gSeconds = seconds;
+    gbUntilFail = bUntilFail;
+}
+
+bool UT_stress_enabled(void)
+{
+    return (gIterations > 0) || (gSeconds > 0) || gbUntilFail;
+}
+
+int UT_stress_begin(void)
+{
+    const char *pLogFile = UT_log_getLogFilename();
+    char root[UT_STRESS_FILENAME_SIZE - 16];
+    char *pDot;
+
+    if ( UT_stress_enabled() == false )
+    {
+        return -1;
+    }
+
+    /* The files are named after the log, as the other reports are */
+    snprintf( root, sizeof(root), "%s", ((pLogFile != NULL) && (pLogFile[0] != '\0')) ? pLogFile : "/tmp/ut-log.log" );
+    pDot = strrchr( root, '.' );
+    if ( (pDot != NULL) && (strchr( pDot, '/' ) == NULL) )
+    {
+        *pDot = '\0';
+    }
+    snprintf( gRecordsFile, sizeof(gRecordsFile), "%s-stress.runs", root );
+    snprintf( gReportFile, sizeof(gReportFile), "%s-flaky.json", root );
+
+    gRecordsFd = open( gRecordsFile, O_RDWR | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if ( gRecordsFd < 0 )
+    {
+        UT_LOG_ERROR( "Stress: unable to open [%s]: %s, the runs are not recorded\n", gRecordsFile, strerror( errno ) );
+        return -1;
+    }
+    gIteration = 1;
+    gStartNs = UT_get_monotonic_ns();
+    gScannedOffset = 0;
+    gbAnyFailed = false;
+    UT_LOG( "Stress: iterations [%u] seconds [%u] (0 is no limit) until fail [%s], report [%s]",
+            gIterations, gSeconds, gbUntilFail ? "yes" : "no", gReportFile );
+    return 0;
+}
+
+void UT_stress_record(const char *pSuite, const char *pTest, bool bPassed, uint64_t durationNs)
+{
+    UT_stress_record_t record;
+    ssize_t written;
+
+    if ( gRecordsFd < 0 )
+    {
+        return;
+    }
+
+    memset( &record, 0, sizeof(record) );
+    record.iteration = gIteration;
+    record.passed = bPassed ? 1 : 0;
+    record.durationNs = durationNs;
+    snprintf( record.name, sizeof(record.name), "%s.%s", (pSuite != NULL) ? pSuite : "", (pTest != NULL) ? pTest : "" );
+
+    do
+    {
+        written = write( gRecordsFd, &record, sizeof(record) );
+    } while ( (written < 0) && (errno == EINTR) );
+    gbAnyFailed = gbAnyFailed || (bPassed == false);
+}
+
+/**
+ * @brief Checks the records of every process for a failure
+ *
+ * Only the records appended since the last check are read, and once a failure is seen it is not read again.
+ */
+static bool anyFailed( void )
+{
+    UT_stress_record_t records[64];
+    ssize_t got;
+
+    while ( (gbAnyFailed == false) && ((got = pread( gRecordsFd, records, sizeof(records), gScannedOffset )) > 0) )
+    {
+        size_t whole = (size_t)got / sizeof(UT_stress_record_t);
+
+        for (size_t i = 0; i < whole; i++)
+        {
+            gbAnyFailed = gbAnyFailed || (records[i].passed == 0);
+        }
+        /* A record being appended by another process is read again on the next check */
+        gScannedOffset += (off_t)(whole * sizeof(UT_stress_record_t));
+        if ( whole == 0 )
+        {
+            break;
+        }
+    }
+    return gbAnyFailed;
+}
+
+bool UT_stress_next(void)
+{
+    uint64_t elapsedNs = UT_get_monotonic_ns() - gStartNs;
+
+    if ( gRecordsFd < 0 )
+    {
+        return false;
+    }
+    if ( gbUntilFail && anyFailed() )
+    {
+        UT_LOG( "Stress: stopping after iteration [%u], a test failed", gIteration );
+        return false;
+    }
+    if ( (gIterations > 0) && (gIteration >= gIterations) )
+    {
+        return false;
+    }
+    if ( (gSeconds > 0) && (elapsedNs >= gSeconds * 1000000000ull) )
+    {
+        UT_LOG( "Stress: stopping after iteration [%u], [%u]s have passed", gIteration, gSeconds );
+        return false;
+    }
+    gIteration++;
+    UT_LOG( UT_LOG_ASCII_GREEN "---- stress iteration [%u] ----" UT_LOG_ASCII_NC, gIteration );
+    return true;
+}
+
+static int compareDurations( const void *a, const void *b )
+{
+    uint64_t lhs = *(const uint64_t *)a;
+    uint64_t rhs = *(const uint64_t *)b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * @brief Orders the tests flaky first, then always failing, then passing, by name within each
+ */
+static int compareTests( const void *a, const void *b )
+{
+    const UT_stress_test_t *pLhs = (const UT_stress_test_t *)a;
+    const UT_stress_test_t *pRhs = (const UT_stress_test_t *)b;
+    int lhsRank = (pLhs->failures == 0) ? 2 : ((pLhs->failures == pLhs->runs) ? 1 : 0);
+    int rhsRank = (pRhs->failures == 0) ? 2 : ((pRhs->failures == pRhs->runs) ? 1 : 0);
+
+    if ( lhsRank != rhsRank )
+    {
+        return lhsRank - rhsRank;
+    }
+    return strcmp( pLhs->name, pRhs->name );
+}
+
+static const char *testStatus( const UT_stress_test_t *pTest )
+{
+    if ( pTest->failures == 0 )
+    {
+        return "passing";
+    }
+    return (pTest->failures == pTest->runs) ? "failing" : "flaky";
+}
+
+/**
+ * @brief Finds the test of a record, adding it when it is new
+ *
+ * @return UT_stress_test_t * - the test, NULL if out of memory
+ */
+static UT_stress_test_t *findTest( UT_stress_test_t **ppTests, size_t *pCount, size_t *pCapacity, const char *pName )
+{
+    static size_t next = 0;
+    UT_stress_test_t *pTest;
+
+    /* Every iteration records the tests in the same order, so the test is most likely the one after the last found */
+    for (size_t i = 0; i < *pCount; i++)
+    {
+        size_t index = (next + i) % *pCount;
+
+        if ( strcmp( (*ppTests)[index].name, pName ) == 0 )
+        {
+            next = index + 1;
+            return &(*ppTests)[index];
+        }
+    }
+
+    if ( *pCount == *pCapacity )
+    {
+        size_t capacity = (*pCapacity == 0) ? 64 : (*pCapacity * 2);
+        UT_stress_test_t *pGrown = (UT_stress_test_t *)realloc( *ppTests, capacity * sizeof(UT_stress_test_t) );
+
+        if ( pGrown == NULL )
+        {
+            return NULL;
+        }
+        *ppTests = pGrown;
+        *pCapacity = capacity;
+    }
+    pTest = &(*ppTests)[(*pCount)++];
+    next = *pCount;
+    memset( pTest, 0, sizeof(*pTest) );
+    memcpy( pTest->name, pName, sizeof(pTest->name) );
+    pTest->name[sizeof(pTest->name) - 1] = '\0';
+    return pTest;
+}
+
+static bool addRecord( UT_stress_test_t *pTest, const UT_stress_record_t *pRecord )
+{
+    if ( pTest->runs == pTest->capacity )
+    {
+        uint32_t capacity = (pTest->capacity == 0) ? 64 : (pTest->capacity * 2);
+        uint64_t *pGrown = (uint64_t *)realloc( pTest->pDurations, capacity * sizeof(uint64_t) );
+
+        if ( pGrown == NULL )
+        {
+            return false;
+        }
+        pTest->pDurations = pGrown;
+        pTest->capacity = capacity;
+    }
+    pTest->pDurations[pTest->runs++] = pRecord->durationNs / 1000;
+    if ( pRecord->passed == 0 )
+    {
+        if ( pTest->failures < UT_STRESS_LISTED_FAILURES )
+        {
+            pTest->failedIterations[pTest->failures] = pRecord->iteration;
+        }
+        pTest->failures++;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets a percentile of sorted durations, nearest rank
+ */
+static uint64_t percentile( const uint64_t *pSorted, uint32_t count, uint32_t percent )
+{
+    uint32_t rank = (uint32_t)(((uint64_t)percent * count + 99) / 100);
+
+    return pSorted[(rank > 0) ? (rank - 1) : 0];
+}
+
+static void writeJsonString( FILE *pFile, const char *pText )
+{
+    fputc( '"', pFile );
+    for (const unsigned char *p = (const unsigned char *)pText; *p != '\0'; p++)
+    {
+        if ( (*p == '"') || (*p == '\\') )
+        {
+            fprintf( pFile, "\\%c", *p );
+        }
+        else if ( *p < 0x20 )
+        {
+            fprintf( pFile, "\\u%04x", *p );
+        }
+        else
+        {
+            fputc( *p, pFile );
+        }
+    }
+    fputc( '"', pFile );
+}
+
+static void writeReport( UT_stress_test_t *pTests, size_t count, double seconds )
+{
+    FILE *pFile = fopen( gReportFile, "w" );
+
+    if ( pFile == NULL )
+    {
+        UT_LOG_ERROR( "Stress: unable to write [%s]: %s\n", gReportFile, strerror( errno ) );
+        return;
+    }
+
+    fprintf( pFile, "{\n  \"version\": 1,\n  \"iterations\": %u,\n  \"seconds\": %.3f,\n  \"tests\": [", gIteration, seconds );
+    for (size_t i = 0; i < count; i++)
+    {
+        UT_stress_test_t *pTest = &pTests[i];
+        const uint64_t *pSorted = pTest->pDurations;
+        double mean = 0.0;
+        double variance = 0.0;
+
+        for (uint32_t j = 0; j < pTest->runs; j++)
+        {
+            mean += (double)pSorted[j];
+        }
+        mean /= pTest->runs;
+        for (uint32_t j = 0; j < pTest->runs; j++)
+        {
+            variance += ((double)pSorted[j] - mean) * ((double)pSorted[j] - mean);
+        }
+        variance /= pTest->runs;
+
+        fprintf( pFile, "%s\n    {\"name\": ", (i == 0) ? "" : "," );
+        writeJsonString( pFile, pTest->name );
+        fprintf( pFile, ", \"status\": \"%s\", \"runs\": %u, \"failures\": %u, \"passRate\": %.4f, \"failedIterations\": [",
+                 testStatus( pTest ), pTest->runs, pTest->failures, (double)(pTest->runs - pTest->failures) / pTest->runs );
+        for (uint32_t j = 0; (j < pTest->failures) && (j < UT_STRESS_LISTED_FAILURES); j++)
+        {
+            fprintf( pFile, "%s%u", (j == 0) ? "" : ", ", pTest->failedIterations[j] );
+        }
+        fprintf( pFile, "],\n     \"us\": {\"min\": %llu, \"mean\": %.1f, \"stddev\": %.1f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu}}",
+                 (unsigned long long)pSorted[0], mean, sqrt( variance ),
+                 (unsigned long long)percentile( pSorted, pTest->runs, 50 ), (unsigned long long)percentile( pSorted, pTest->runs, 90 ),
+                 (unsigned long long)percentile( pSorted, pTest->runs, 99 ), (unsigned long long)pSorted[pTest->runs - 1] );
+    }
+    fprintf( pFile, "\n  ]\n}\n" );
+    fclose( pFile );
+}
+
+void UT_stress_end(void)
+{
+    UT_stress_record_t records[64];
+    UT_stress_test_t *pTests = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    uint32_t flaky = 0;
+    off_t offset = 0;
+    ssize_t got;
+    double seconds;
+
+    if ( gRecordsFd < 0 )
+    {
+        return;
+    }
+    seconds = (double)(UT_get_monotonic_ns() - gStartNs) / 1e9;
+
+    while ( (got = pread( gRecordsFd, records, sizeof(records), offset )) > 0 )
+    {
+        for (size_t i = 0; i < (size_t)got / sizeof(UT_stress_record_t); i++)
+        {
+            UT_stress_test_t *pTest;
+
+            records[i].name[UT_STRESS_NAME_SIZE - 1] = '\0';
+            pTest = findTest( &pTests, &count, &capacity, records[i].name );
+            if ( (pTest == NULL) || (addRecord( pTest, &records[i] ) == false) )
+            {
+                UT_LOG_ERROR( "Stress: out of memory folding the runs, the report is incomplete\n" );
+                break;
+            }
+        }
+        offset += got;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        qsort( pTests[i].pDurations, pTests[i].runs, sizeof(uint64_t), compareDurations );
+    }
+    qsort( pTests, count, sizeof(UT_stress_test_t), compareTests );
+    writeReport( pTests, count, seconds );
+
+    UT_LOG( "\n" );
+    UT_LOG( UT_LOG_ASCII_GREEN "Stress Summary" UT_LOG_ASCII_NC " : iterations [%u] in [%.3f]s, tests [%u]", gIteration, seconds, (unsigned int)count );
+    for (size_t i = 0; i < count; i++)
+    {
+        UT_stress_test_t *pTest = &pTests[i];
+
+        if ( pTest->failures > 0 )
+        {
+            flaky += (pTest->failures < pTest->runs) ? 1 : 0;
+            UT_LOG( "  %-7s %s failed [%u/%u] (%.1f%%) first in iteration [%u], p50 [%llu]us p99 [%llu]us",
+                    testStatus( pTest ), pTest->name, pTest->failures, pTest->runs, 100.0 * pTest->failures / pTest->runs,
+                    pTest->failedIterations[0], (unsigned long long)percentile( pTest->pDurations, pTest->runs, 50 ),
+                    (unsigned long long)percentile( pTest->pDurations, pTest->runs, 99 ) );
+        }
+        free( pTest->pDurations );
+    }
+    UT_LOG( "  flaky tests [%u], report [%s]", flaky, gReportFile );
+    free( pTests );
+
+    close( gRecordsFd );
+    gRecordsFd = -1;
+    remove( gRecordsFile );
+}
@@ -0,0 +1,88 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Stress runs and flakiness statistics
+ *
+ * With `--repeat <n>`, `--repeat-for <seconds>` or `--until-fail` the selected tests are run as
+ * a whole over and over. The outcome and duration of every test of every iteration is appended
+ * to `<log>-stress.runs` as a fixed size record, written with a single write() to a file opened
+ * with O_APPEND, so `-j` and isolation workers add their own records to it.
+ *
+ * Once the iterations are over the records are folded per test into `<log>-flaky.json`: runs,
+ * failures, the iterations that failed and the spread of the durations, and the tests that both
+ * passed and failed are listed in the log.
+ */
+
+#ifndef __UT_STRESS_H
+#define __UT_STRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Sets when the iterations stop, stress runs are off unless one of them is set
+ *
+ * @param iterations - iterations to run, 0 for no limit
+ * @param seconds - time after which no further iteration starts, 0 for no limit
+ * @param bUntilFail - stop after the first iteration with a failed test
+ */
+extern void UT_stress_configure(unsigned int iterations, unsigned int seconds, bool bUntilFail);
+
+/**
+ * @brief Checks whether stress runs are configured
+ */
+extern bool UT_stress_enabled(void);
+
+/**
+ * @brief Opens the records file, called once before the first iteration
+ *
+ * @return int - 0 on success, -1 if stress runs are off or the file cannot be opened
+ */
+extern int UT_stress_begin(void);
+
+/**
+ * @brief Records the outcome of a test in the running iteration
+ *
+ * @param pSuite - suite name
+ * @param pTest - test name
+ * @param bPassed - outcome
+ * @param durationNs - time the test took
+ */
+extern void UT_stress_record(const char *pSuite, const char *pTest, bool bPassed, uint64_t durationNs);
+
+/**
+ * @brief Ends an iteration
+ *
+ * @return bool - true if another iteration is to run
+ */
+extern bool UT_stress_next(void);
+
+/**
+ * @brief Writes the flakiness report and the log summary, then removes the records file
+ *
+ * Called once, by the process that started the iterations, after every worker has finished.
+ */
+extern void UT_stress_end(void);
+
+#endif  /*  __UT_STRESS_H  */
+/** @} */
@@ -0,0 +1,325 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <ut_log.h>
+#include "ut_trace.h"
+
+#ifndef UT_VERSION
+#define UT_VERSION "Not Defined"
+#endif
+
+#define UT_TRACE_NAME_SIZE (256)
+#define UT_TRACE_EVENT_SIZE (6 * UT_LOG_MAX_LINE_SIZE + 4 * UT_TRACE_NAME_SIZE + 512)  /*!< Room for every field escaped */
+
+/** An event being formatted, fields are appended until it is written */
+typedef struct
+{
+    char data[UT_TRACE_EVENT_SIZE];
+    size_t length;
+} UT_trace_event_t;
+
+static int gTraceFd = -1;
+static pthread_mutex_t gTraceMutex = PTHREAD_MUTEX_INITIALIZER;    /*!< Guards the names below */
+static char gSuite[UT_TRACE_NAME_SIZE];
+static char gTest[UT_TRACE_NAME_SIZE];
+static bool gSuiteOpen;
+static bool gTestRunning;
+
+static void appendFormat( UT_trace_event_t *pEvent, const char *pFormat, ... )
+{
+    size_t room = sizeof(pEvent->data) - pEvent->length;
+    va_list args;
+    int written;
+
+    va_start( args, pFormat );
+    written = vsnprintf( &pEvent->data[pEvent->length], room, pFormat, args );
+    va_end( args );
+    if ( written > 0 )
+    {
+        pEvent->length += ((size_t)written < room) ? (size_t)written : (room - 1);
+    }
+}
+
+/**
+ * @brief Appends a "key":"value" field, escaped for JSON and without the ANSI colour sequences
+ */
+static void appendString( UT_trace_event_t *pEvent, const char *pKey, const char *pValue )
+{
+    const unsigned char *pChar = (const unsigned char *)((pValue != NULL) ? pValue : "");
+
+    appendFormat( pEvent, ",\"%s\":\"", pKey );
+    for (; *pChar != '\0'; pChar++)
+    {
+        /* Keep room for the longest escape and the closing quote, brace and newline */
+        if ( sizeof(pEvent->data) - pEvent->length < 16 )
+        {
+            break;
+        }
+        if ( (*pChar == 0x1b) && (pChar[1] == '[') )
+        {
+            for (pChar += 2; (*pChar != '\0') && ((*pChar < 0x40) || (*pChar > 0x7e)); pChar++)
+            {
+            }
+            if ( *pChar == '\0' )
+            {
+                break;
+            }
+            continue;
+        }
+        switch ( *pChar )
+        {
+            case '"':  appendFormat( pEvent, "\\\"" ); break;
+            case '\\': appendFormat( pEvent, "\\\\" ); break;
+            case '\n': appendFormat( pEvent, "\\n" ); break;
+            case '\r': appendFormat( pEvent, "\\r" ); break;
+            case '\t': appendFormat( pEvent, "\\t" ); break;
+            default:
+                if ( *pChar < 0x20 )
+                {
+                    appendFormat( pEvent, "\\u%04x", *pChar );
+                }
+                else
+                {
+                    pEvent->data[pEvent->length++] = (char)*pChar;
+                }
+                break;
+        }
+    }
+    appendFormat( pEvent, "\"" );
+}
+
+static void beginEvent( UT_trace_event_t *pEvent, const char *pType )
+{
+    struct timeval now;
+
+    gettimeofday( &now, NULL );
+    pEvent->length = 0;
+    appendFormat( pEvent, "{\"ts\":%lld,\"pid\":%d,\"ev\":\"%s\"",
+                  (long long)now.tv_sec * 1000000LL + now.tv_usec, (int)getpid(), pType );
+}
+
+/**
+ * @brief Writes the event as a single line with one write(), appends from other processes do not split it
+ */
+static void endEvent( UT_trace_event_t *pEvent )
+{
+    ssize_t written;
+
+    appendFormat( pEvent, "}\n" );
+    do
+    {
+        written = write( gTraceFd, pEvent->data, pEvent->length );
+    } while ( (written < 0) && (errno == EINTR) );
+}
+
+static void appendRunning( UT_trace_event_t *pEvent )
+{
+    appendString( pEvent, "suite", gSuiteOpen ? gSuite : "" );
+    appendString( pEvent, "test", gTestRunning ? gTest : "" );
+}
+
+/* Called with gTraceMutex held */
+static void endSuite( void )
+{
+    UT_trace_event_t event;
+
+    if ( gSuiteOpen == false )
+    {
+        return;
+    }
+    beginEvent( &event, "suite_end" );
+    appendString( &event, "suite", gSuite );
+    endEvent( &event );
+    gSuiteOpen = false;
+}
+
+/* Called with gTraceMutex held */
+static void startSuite( const char *pSuite )
+{
+    UT_trace_event_t event;
+
+    endSuite();
+    snprintf( gSuite, sizeof(gSuite), "%s", (pSuite != NULL) ? pSuite : "" );
+    gSuiteOpen = true;
+    beginEvent( &event, "suite_start" );
+    appendString( &event, "suite", gSuite );
+    endEvent( &event );
+}
+
+int UT_trace_open( const char *pFileName )
+{
+    UT_trace_event_t event;
+    char binary[UT_TRACE_NAME_SIZE] = "";
+    ssize_t length;
+
+    if ( gTraceFd >= 0 )
+    {
+        return 0;
+    }
+    gTraceFd = open( pFileName, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644 );
+    if ( gTraceFd < 0 )
+    {
+        return -1;
+    }
+
+    length = readlink( "/proc/self/exe", binary, sizeof(binary) - 1 );
+    binary[(length > 0) ? length : 0] = '\0';
+
+    beginEvent( &event, "run_start" );
+    appendString( &event, "version", UT_VERSION );
+    appendString( &event, "binary", binary );
+    endEvent( &event );
+    return 0;
+}
+
+void UT_trace_close( void )
+{
+    UT_trace_event_t event;
+
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &gTraceMutex );
+    endSuite();
+    beginEvent( &event, "run_end" );
+    endEvent( &event );
+    close( gTraceFd );
+    gTraceFd = -1;
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+bool UT_trace_enabled( void )
+{
+    return gTraceFd >= 0;
+}
+
+void UT_trace_suiteStart( const char *pSuite )
+{
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+    pthread_mutex_lock( &gTraceMutex );
+    startSuite( pSuite );
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+void UT_trace_suiteEnd( void )
+{
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+    pthread_mutex_lock( &gTraceMutex );
+    endSuite();
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+void UT_trace_testStart( const char *pSuite, const char *pTest )
+{
+    UT_trace_event_t event;
+
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &gTraceMutex );
+    if ( (gSuiteOpen == false) || (strcmp( gSuite, (pSuite != NULL) ? pSuite : "" ) != 0) )
+    {
+        startSuite( pSuite );
+    }
+    snprintf( gTest, sizeof(gTest), "%s", (pTest != NULL) ? pTest : "" );
+    gTestRunning = true;
+    beginEvent( &event, "test_start" );
+    appendRunning( &event );
+    endEvent( &event );
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+void UT_trace_assert( const char *pFile, unsigned int line, const char *pCondition, bool bPassed, bool bFatal )
+{
+    UT_trace_event_t event;
+
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &gTraceMutex );
+    beginEvent( &event, "assert" );
+    appendRunning( &event );
+    appendString( &event, "file", pFile );
+    appendFormat( &event, ",\"line\":%u", line );
+    appendString( &event, "cond", pCondition );
+    appendFormat( &event, ",\"ok\":%s,\"fatal\":%s", bPassed ? "true" : "false", bFatal ? "true" : "false" );
+    endEvent( &event );
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+void UT_trace_testEnd( const char *pResult, unsigned int asserts, unsigned int failed )
+{
+    UT_trace_event_t event;
+
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &gTraceMutex );
+    beginEvent( &event, "test_end" );
+    appendRunning( &event );
+    appendString( &event, "result", pResult );
+    appendFormat( &event, ",\"asserts\":%u,\"failed\":%u", asserts, failed );
+    endEvent( &event );
+    gTestRunning = false;
+    pthread_mutex_unlock( &gTraceMutex );
+}
+
+void UT_trace_log( const char *pFile, int line, const char *pPrefix, const char *pMessage )
+{
+    UT_trace_event_t event;
+
+    if ( gTraceFd < 0 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &gTraceMutex );
+    beginEvent( &event, "log" );
+    appendRunning( &event );
+    appendString( &event, "file", pFile );
+    appendFormat( &event, ",\"line\":%d", line );
+    appendString( &event, "prefix", pPrefix );
+    appendString( &event, "msg", pMessage );
+    endEvent( &event );
+    pthread_mutex_unlock( &gTraceMutex );
+}
@@ -0,0 +1,106 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/** @addtogroup UT
+ * @{
+ */
+
+/** @brief Event trace of a test run
+ *
+ * With `--trace <file>` every event of the run is appended to the file as one JSON object per
+ * line (NDJSON). Each event is written with a single write() to a file opened with O_APPEND, so
+ * events are never interleaved and `-j` workers share the file, told apart by their "pid".
+ *
+ * Every event holds "ts", microseconds since the epoch, "pid" and "ev", one of:
+ * - run_start: "version", "binary"
+ * - suite_start, suite_end: "suite"
+ * - test_start: "suite", "test"
+ * - assert: "suite", "test", "file", "line", "cond", "ok", "fatal"
+ * - test_end: "suite", "test", "result" (passed, failed or skipped), "asserts", "failed"
+ * - log: "suite", "test", "file", "line", "prefix", "msg", without the console colours
+ * - run_end
+ *
+ * scripts/ut_trace_decode.py rebuilds timelines and JUnit reports from the file.
+ */
+
+#ifndef __UT_TRACE_H
+#define __UT_TRACE_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Opens the trace file and writes the run_start event
+ *
+ * @param pFileName - file the events are appended to
+ * @return int - 0 on success, -1 if the file cannot be opened
+ */
+extern int UT_trace_open(const char *pFileName);
+
+/**
+ * @brief Ends the open suite, writes the run_end event and closes the trace file
+ */
+extern void UT_trace_close(void);
+
+/**
+ * @brief Checks whether a trace file is open
+ */
+extern bool UT_trace_enabled(void);
+
+/**
+ * @brief Starts a suite, the suite that was open is ended first
+ */
+extern void UT_trace_suiteStart(const char *pSuite);
+
+/**
+ * @brief Ends the open suite, if any
+ */
+extern void UT_trace_suiteEnd(void);
+
+/**
+ * @brief Starts a test, and its suite when it is not the open suite
+ */
+extern void UT_trace_testStart(const char *pSuite, const char *pTest);
+
+/**
+ * @brief Records an assertion of the running test
+ *
+ * @param pFile - file of the assertion
+ * @param line - line of the assertion
+ * @param pCondition - the condition or message
+ * @param bPassed - outcome
+ * @param bFatal - true if the assertion ends the test on failure
+ */
+extern void UT_trace_assert(const char *pFile, unsigned int line, const char *pCondition, bool bPassed, bool bFatal);
+
+/**
+ * @brief Ends the running test
+ *
+ * @param pResult - "passed", "failed" or "skipped"
+ * @param asserts - assertions evaluated by the test
+ * @param failed - assertions that failed
+ */
+extern void UT_trace_testEnd(const char *pResult, unsigned int asserts, unsigned int failed);
+
+/**
+ * @brief Records a log line, called for every UT_LOG* line
+ */
+extern void UT_trace_log(const char *pFile, int line, const char *pPrefix, const char *pMessage);
+
+#endif  /*  __UT_TRACE_H  */
+/** @} */
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <assert.h>
+#include <time.h>
 
 #include <ut.h>
 #include <ut_log.h>
@@ -554,6 +555,33 @@ void test_ut_assert_log_for_arg_function( void )
     UT_LOG_INFO("+++ This line SHOULD be seen\n");
 }
 
+static void sleep_ms( unsigned int ms )
+{
+    struct timespec delay = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep( &delay, NULL );
+}
+
+/* The registered checks of these asserts are in ut_test_duration.c */
+void test_ut_assert_duration( void )
+{
+    UT_LOG_STEP( "1: is expected to pass" );
+    UT_ASSERT_DURATION_LESS( sleep_ms(1), 1000 );
+
+    UT_LOG_STEP( "2: is expected to pass, budget from the profile when present" );
+    UT_ASSERT_DURATION_LESS_PROFILE( sleep_ms(1), 1000, "durationTest/budgetMs" );
+
+    UT_LOG_STEP( "3: is expected to fail" );
+    UT_ASSERT_DURATION_LESS( sleep_ms(20), 1 );   /* This line should assert, and record the measured duration */
+
+    UT_LOG_STEP( "4: is expected to pass" );
+    UT_ASSERT_DURATION_LESS_PROFILE_FATAL( sleep_ms(1), 1000, "durationTest/budgetMs" );
+
+    UT_LOG_STEP( "5: is expected to fail" );
+    UT_ASSERT_DURATION_LESS_FATAL( sleep_ms(20), 1 );   /* This line should assert & FATAL */
+
+    UT_LOG_ERROR("### This line SHOULD never be seen\n");
+}
+
 /**
  * @brief Main launch function for assert functions
  */
@@ -586,6 +614,7 @@ void register_assert_functions(void)
     UT_add_test( gpAssertSuite, "UT_ASSERT_TRUE_MSG", test_ut_assert_msg_true);
     UT_add_test( gpAssertSuite, "UT_ASSERT_FALSE_MSG", test_ut_assert_msg_false);
     UT_add_test( gpAssertSuite, "UT_ASSERT Log", test_ut_assert_log);
+    UT_add_test( gpAssertSuite, "UT_ASSERT_DURATION_LESS", test_ut_assert_duration);
 
     gpAssertSuite1 = UT_add_suite("ut-core-assert-tests-with_function_args", ut_init_function, ut_clean_function);
     assert(gpAssertSuite1 != NULL);
@@ -0,0 +1,277 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define SLEEP_US (50000)    /*!< Wall time of the sleeping target test */
+#define SPIN_S (0.05)       /*!< CPU time of the spinning target test */
+#define GOLDEN_FILE "assets/ut-automated-golden.xml"
+
+static UT_test_suite_t *gpAutomatedSuite = NULL;
+static char gResults[RESULTS_SIZE];
+static char gNormalised[RESULTS_SIZE];
+static char gGolden[RESULTS_SIZE];
+
+/* Target suites, only registered in the runner copy */
+static void test_target_sleep( void )
+{
+    usleep( SLEEP_US );
+    UT_ASSERT( true );
+}
+
+static void test_target_spin( void )
+{
+    clock_t start = clock();
+
+    while ( (double)(clock() - start) < (SPIN_S * CLOCKS_PER_SEC) )
+    {
+    }
+    UT_ASSERT( true );
+}
+
+static void test_target_fast( void )
+{
+    UT_ASSERT( true );
+}
+
+static void registerTimingTargets( void )
+{
+    UT_test_suite_t *pSuite = UT_add_suite_withGroupID("ut-timing", NULL, NULL, UT_TESTS_L3);
+
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "sleep", test_target_sleep);
+    UT_add_test(pSuite, "spin", test_target_spin);
+    UT_add_test(pSuite, "fast", test_target_fast);
+}
+
+static void test_target_pass( void )
+{
+    UT_ASSERT( true );
+}
+
+static void test_target_fail( void )
+{
+    UT_FAIL( "a & b < c > d \"e\" 'f'" );
+}
+
+static void test_target_fail_twice( void )
+{
+    UT_ASSERT( 1 == 2 );
+    UT_FAIL( "second" );
+}
+
+static int init_target_fail( void )
+{
+    return -1;
+}
+
+static void registerGoldenTargets( void )
+{
+    UT_test_suite_t *pSuite;
+
+    pSuite = UT_add_suite_withGroupID("ut-golden <&> \"suite\"", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "pass", test_target_pass);
+    UT_add_test(pSuite, "fail", test_target_fail);
+    UT_add_test(pSuite, "fail <twice> & 'more'", test_target_fail_twice);
+
+    /* Skipped, by its initialisation failing and by its group being disabled */
+    pSuite = UT_add_suite_withGroupID("ut-golden-init-fail", init_target_fail, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "not run", test_target_pass);
+
+    pSuite = UT_add_suite_withGroupID("ut-golden-disabled", NULL, NULL, UT_TESTS_L4);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "not run", test_target_pass);
+}
+
+static bool startsWith( const char *pText, const char *pPrefix )
+{
+    return strncmp( pText, pPrefix, strlen( pPrefix ) ) == 0;
+}
+
+/**
+ * @brief Removes what changes from run to run from a results file: the times, the timing properties,
+ * the directory of the source files, the line numbers, the padding of the suite time and the
+ * ut-core version record
+ */
+static void normalise( const char *pIn, char *pOut, size_t size )
+{
+    size_t out = 0;
+
+    while ( (*pIn != '\0') && (out + 2 < size) && !startsWith( pIn, "  <ut-core " ) )
+    {
+        if ( startsWith( pIn, "time=\"" ) || startsWith( pIn, "value=\"" ) )
+        {
+            while ( (*pIn != '"') && (out + 2 < size) )
+            {
+                pOut[out++] = *pIn++;
+            }
+            pOut[out++] = *pIn++;
+            pOut[out++] = '*';
+            while ( (*pIn != '\0') && (*pIn != '"') )
+            {
+                pIn++;
+            }
+        }
+        else if ( startsWith( pIn, "File     : " ) )
+        {
+            const char *pEnd = strchr( pIn, '\n' );
+
+            out += (size_t)snprintf( &pOut[out], size - out, "File     : " );
+            pIn += strlen( "File     : " );
+            for (const char *p = pIn; (pEnd != NULL) && (p < pEnd); p++)
+            {
+                if ( *p == '/' )
+                {
+                    pIn = p + 1;
+                }
+            }
+        }
+        else if ( startsWith( pIn, "Line     : " ) )
+        {
+            pIn += strlen( "Line     : " );
+            out += (size_t)snprintf( &pOut[out], size - out, "Line     : *" );
+            while ( (*pIn >= '0') && (*pIn <= '9') )
+            {
+                pIn++;
+            }
+        }
+        else if ( (*pIn == ' ') && (pIn[1] == ' ') && (pIn[strspn( pIn, " " )] == '>') )
+        {
+            pIn += strspn( pIn, " " ) - 1;
+        }
+        else
+        {
+            pOut[out++] = *pIn++;
+        }
+    }
+    pOut[out] = '\0';
+}
+
+/**
+ * @brief Gets a number attribute of the first tag, or property, found after pFrom
+ *
+ * @return double - the value, -1 if it is not there
+ */
+static double numberAfter( const char *pFrom, const char *pKey )
+{
+    const char *pFound = (pFrom != NULL) ? strstr( pFrom, pKey ) : NULL;
+
+    return (pFound != NULL) ? atof( pFound + strlen( pKey ) ) : -1.0;
+}
+
+static void test_automated_timing( void )
+{
+    const char *pSuite;
+    const char *pSleep;
+    const char *pSpin;
+    const char *pFast;
+    double sleepTime;
+    double spinTime;
+    double fastTime;
+    double suiteTime;
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "automated timing", NULL, gResults, sizeof(gResults), &others ) );
+
+    pSuite = strstr( gResults, "<testsuite errors=\"0\" failures=\"0\" tests=\"3\" name=\"ut-timing\" time=\"" );
+    pSleep = strstr( gResults, "name=\"sleep\" time=\"" );
+    pSpin = strstr( gResults, "name=\"spin\" time=\"" );
+    pFast = strstr( gResults, "name=\"fast\" time=\"" );
+    UT_ASSERT_FATAL( (pSuite != NULL) && (pSleep != NULL) && (pSpin != NULL) && (pFast != NULL) );
+
+    /* The wall time of each test is its time attribute, and its wall_time property */
+    sleepTime = numberAfter( pSleep, "time=\"" );
+    spinTime = numberAfter( pSpin, "time=\"" );
+    fastTime = numberAfter( pFast, "time=\"" );
+    UT_ASSERT( sleepTime >= (SLEEP_US / 1000000.0) );
+    UT_ASSERT( spinTime >= SPIN_S );
+    UT_ASSERT( (fastTime >= 0.0) && (fastTime < (SLEEP_US / 1000000.0)) );
+    UT_ASSERT( numberAfter( pSleep, "<property name=\"wall_time\" value=\"" ) == sleepTime );
+
+    /* Sleeping takes no CPU, spinning does */
+    UT_ASSERT( numberAfter( pSleep, "<property name=\"user_cpu_time\" value=\"" ) < SPIN_S );
+    UT_ASSERT( (numberAfter( pSpin, "<property name=\"user_cpu_time\" value=\"" ) +
+                numberAfter( pSpin, "<property name=\"system_cpu_time\" value=\"" )) >= (SPIN_S * 0.9) );
+
+    /* The suite time is the total of its tests, each rounded to the microsecond */
+    suiteTime = numberAfter( pSuite, "time=\"" );
+    UT_ASSERT( (suiteTime >= (sleepTime + spinTime + fastTime - 0.000003)) && (suiteTime <= (sleepTime + spinTime + fastTime + 0.000003)) );
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+static void test_automated_golden( void )
+{
+    static const char *const options[] = { "-d", "4", NULL };
+    FILE *pFile;
+    size_t length;
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "automated golden", options, gResults, sizeof(gResults), &others ) );
+    normalise( gResults, gNormalised, sizeof(gNormalised) );
+
+    pFile = fopen( GOLDEN_FILE, "r" );
+    UT_ASSERT_FATAL( pFile != NULL );
+    length = fread( gGolden, 1, sizeof(gGolden) - 1, pFile );
+    gGolden[length] = '\0';
+    fclose( pFile );
+
+    /* Passing and failing tests, with the suite name and conditions escaped, and no record of the skipped suites */
+    if ( strcmp( gNormalised, gGolden ) != 0 )
+    {
+        UT_LOG_ERROR( "Results differ from [%s]:\n%s", GOLDEN_FILE, gNormalised );
+        UT_FAIL( "results differ from the golden file" );
+    }
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+void register_automated_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "automated timing" ) == 0 )
+        {
+            registerTimingTargets();
+        }
+        else if ( strcmp( UT_test_runner_target(), "automated golden" ) == 0 )
+        {
+            registerGoldenTargets();
+        }
+        return;
+    }
+
+    gpAutomatedSuite = UT_add_suite_withGroupID("ut-automated", NULL, NULL, UT_TESTS_L2);
+    assert(gpAutomatedSuite != NULL);
+
+    UT_add_test(gpAutomatedSuite, "automated timing", test_automated_timing);
+    UT_add_test(gpAutomatedSuite, "automated golden", test_automated_golden);
+}
@@ -0,0 +1,42 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdlib.h>
+#include <assert.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+
+static UT_test_suite_t *gpBenchmarkSuite = NULL;
+static volatile int gBenchmarkCounter = 0;
+
+static void benchmark_increment(void)
+{
+    gBenchmarkCounter = gBenchmarkCounter + 1;
+}
+
+void register_benchmark_testing_functions(void)
+{
+    gpBenchmarkSuite = UT_add_suite_withGroupID("ut-benchmark", NULL, NULL, UT_TESTS_L2);
+    assert(gpBenchmarkSuite != NULL);
+
+    UT_ADD_BENCHMARK(gpBenchmarkSuite, "benchmark increment", benchmark_increment);
+}
@@ -0,0 +1,135 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* nftw() */
+#endif
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <ftw.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define COVERAGE_PATH_SIZE (512)
+
+static UT_test_suite_t *gpCoverageSuite = NULL;
+static char gResults[RESULTS_SIZE];
+
+/* Target suite, only registered in the runner copy */
+static void test_target_covered( void )
+{
+    UT_ASSERT( true );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite = UT_add_suite_withGroupID("ut-coverage target", NULL, NULL, UT_TESTS_L3);
+
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "covered/1", test_target_covered);
+    UT_add_test(pSuite, "covered 2", test_target_covered);
+}
+
+static int removeEntry( const char *pPath, const struct stat *pStat, int flag, struct FTW *pFtw )
+{
+    (void)pStat;
+    (void)flag;
+    (void)pFtw;
+    return remove( pPath );
+}
+
+#ifdef UT_COVERAGE
+static bool fileContains( const char *pFilename, const char *pText )
+{
+    char content[COVERAGE_PATH_SIZE];
+    FILE *pFile = fopen( pFilename, "r" );
+    size_t length;
+
+    if ( pFile == NULL )
+    {
+        return false;
+    }
+    length = fread( content, 1, sizeof(content) - 1, pFile );
+    content[length] = '\0';
+    fclose( pFile );
+    return (strcmp( content, pText ) == 0);
+}
+#endif
+
+static void test_coverage_per_test( void )
+{
+    char dir[] = "/tmp/ut-coverage-XXXXXX";
+    char root[COVERAGE_PATH_SIZE];
+    const char *options[] = { "--coverage-dir", root, NULL };
+    int others;
+
+    UT_ASSERT_FATAL( mkdtemp( dir ) != NULL );
+    snprintf( root, sizeof(root), "%s/coverage", dir );
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "coverage", options, gResults, sizeof(gResults), &others ) );
+    UT_ASSERT( strstr( gResults, "name=\"covered/1\"" ) != NULL );
+    UT_ASSERT( strstr( gResults, "name=\"covered 2\"" ) != NULL );
+    UT_ASSERT( strstr( gResults, "<failure " ) == NULL );
+    UT_ASSERT_EQUAL( others, 0 );
+
+#ifdef UT_COVERAGE
+    {
+        char path[COVERAGE_PATH_SIZE + 64];
+
+        /* A directory per test, the names made safe, with the real names beside the counters */
+        snprintf( path, sizeof(path), "%s/tests/ut-coverage_target/covered_1/test.name", root );
+        UT_ASSERT( fileContains( path, "ut-coverage target\tcovered/1\n" ) );
+        snprintf( path, sizeof(path), "%s/tests/ut-coverage_target/covered_2/test.name", root );
+        UT_ASSERT( fileContains( path, "ut-coverage target\tcovered 2\n" ) );
+        snprintf( path, sizeof(path), "%s/outside-tests", root );
+        UT_ASSERT( access( path, F_OK ) == 0 );
+    }
+#else
+    /* Without COVERAGE=1 there are no counters to write, the directory is not created */
+    UT_ASSERT( access( root, F_OK ) != 0 );
+#endif
+
+    nftw( dir, removeEntry, 16, FTW_DEPTH | FTW_PHYS );
+}
+
+void register_coverage_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "coverage" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpCoverageSuite = UT_add_suite_withGroupID("ut-coverage", NULL, NULL, UT_TESTS_L2);
+    assert(gpCoverageSuite != NULL);
+
+    UT_add_test(gpCoverageSuite, "coverage per test", test_coverage_per_test);
+}
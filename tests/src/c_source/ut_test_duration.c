@@ -0,0 +1,140 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define DURATION_KEY "durationTest/budgetMs"    /*!< 500ms in assets/test_kvp.yaml */
+
+static UT_test_suite_t *gpDurationSuite = NULL;
+static char gResults[RESULTS_SIZE];
+
+static void sleep_ms( unsigned int ms )
+{
+    struct timespec delay = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep( &delay, NULL );
+}
+
+/* Target suite, only registered in the runner copy */
+static void test_target_over_budget( void )
+{
+    UT_ASSERT_DURATION_LESS( sleep_ms(20), 1 );
+    UT_ASSERT_DURATION_LESS( sleep_ms(1), 1000 );
+}
+
+static void test_target_over_budget_fatal( void )
+{
+    UT_ASSERT_DURATION_LESS_FATAL( sleep_ms(20), 1 );
+    UT_FAIL( "duration fatal not stopped" );
+}
+
+static void test_target_profile_budget( void )
+{
+    /* Only passes with the 500ms budget of the profile */
+    UT_ASSERT_DURATION_LESS_PROFILE( sleep_ms(1), 0.001, DURATION_KEY );
+    UT_ASSERT_DURATION_LESS_PROFILE_FATAL( sleep_ms(1), 0.001, DURATION_KEY );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite = UT_add_suite_withGroupID("ut-duration-budget", NULL, NULL, UT_TESTS_L3);
+
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "over budget", test_target_over_budget);
+    UT_add_test(pSuite, "over budget fatal", test_target_over_budget_fatal);
+    UT_add_test(pSuite, "profile budget", test_target_profile_budget);
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+static void test_duration_pass( void )
+{
+    UT_ASSERT_DURATION_LESS( sleep_ms(1), 1000 );
+    UT_ASSERT_DURATION_LESS_FATAL( sleep_ms(1), 1000 );
+
+    /* Without a key, or without the key in the profile, the budget is the one given */
+    UT_ASSERT( UT_get_duration_budget_ms( NULL, 7.0 ) == 7.0 );
+    UT_ASSERT( UT_get_duration_budget_ms( "durationTest/missing", 7.0 ) == 7.0 );
+    UT_ASSERT( UT_get_monotonic_ns() > 0 );
+}
+
+static void test_duration_fail( void )
+{
+    static const char *const options[] = { "-p", "assets/test_kvp.yaml", NULL };
+    const char *pOver;
+    const char *pFatal;
+    const char *pProfile;
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "duration budget", options, gResults, sizeof(gResults), &others ) );
+
+    pOver = strstr( gResults, "name=\"over budget\"" );
+    pFatal = strstr( gResults, "name=\"over budget fatal\"" );
+    pProfile = strstr( gResults, "name=\"profile budget\"" );
+    UT_ASSERT_FATAL( (pOver != NULL) && (pFatal != NULL) && (pProfile != NULL) );
+
+    /* The failure records the statement, its measured duration and the budget */
+    UT_ASSERT_EQUAL( countOf( gResults, "<failure " ), 2 );
+    UT_ASSERT( strstr( pOver, "<failure message=\"sleep_ms(20) took " ) != NULL );
+    UT_ASSERT( atof( strstr( pOver, " took " ) + strlen( " took " ) ) >= 20.0 );
+    UT_ASSERT( strstr( pOver, "ms, budget 1.000ms\"" ) != NULL );
+    UT_ASSERT_EQUAL( countOf( gResults, "Condition: sleep_ms(20) took " ), 2 );
+
+    /* A fatal assertion ends the test, the profile budget overrides the one given */
+    UT_ASSERT( strstr( gResults, "duration fatal not stopped" ) == NULL );
+    UT_ASSERT( strstr( pProfile, "<failure " ) == NULL );
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+void register_duration_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "duration budget" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpDurationSuite = UT_add_suite_withGroupID("ut-duration", NULL, NULL, UT_TESTS_L1);
+    assert(gpDurationSuite != NULL);
+
+    UT_add_test(gpDurationSuite, "duration pass", test_duration_pass);
+    UT_add_test(gpDurationSuite, "duration fail", test_duration_fail);
+}
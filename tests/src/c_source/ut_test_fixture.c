@@ -0,0 +1,119 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdlib.h>
+#include <assert.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+
+#define FIXTURE_SUITE_TITLE "ut-fixture"
+
+static UT_test_suite_t *gpFixtureSuite = NULL;
+static UT_fixture_t *gpSuiteFixture = NULL;
+static UT_fixture_t *gpFailingFixture = NULL;
+static UT_fixture_t *gpRunFixture = NULL;
+
+static int gResource = 0;
+static int gSetUps = 0;
+static int gTearDowns = 0;
+static int gFailedSetUps = 0;
+
+static void *setUpResource(void)
+{
+    gSetUps++;
+    return &gResource;
+}
+
+static void tearDownResource(void *pHandle)
+{
+    if (pHandle == &gResource)
+    {
+        gTearDowns++;
+    }
+}
+
+static void *setUpFailing(void)
+{
+    gFailedSetUps++;
+    return NULL;
+}
+
+static void *setUpRunResource(void)
+{
+    return &gResource;
+}
+
+static int fixture_suite_init(void)
+{
+    gSetUps = 0;
+    gTearDowns = 0;
+    gFailedSetUps = 0;
+    return 0;
+}
+
+/* The fixtures of the suite are torn down before its clean up */
+static int fixture_suite_clean(void)
+{
+    return (gTearDowns == gSetUps) ? 0 : -1;
+}
+
+static void test_fixture_set_up_once(void)
+{
+    void *pFirst = UT_get_fixture(gpSuiteFixture);
+    void *pSecond = UT_get_fixture(gpSuiteFixture);
+
+    UT_ASSERT_PTR_EQUAL(pFirst, &gResource);
+    UT_ASSERT_PTR_EQUAL(pSecond, pFirst);
+    UT_ASSERT_EQUAL(gSetUps, 1);
+    UT_ASSERT_EQUAL(gTearDowns, 0);
+}
+
+static void test_fixture_failed_set_up(void)
+{
+    UT_ASSERT_PTR_NULL(UT_get_fixture(gpFailingFixture));
+    UT_ASSERT_PTR_NULL(UT_get_fixture(gpFailingFixture));
+    UT_ASSERT_EQUAL(gFailedSetUps, 1);
+    UT_ASSERT_PTR_NULL(UT_get_fixture(NULL));
+}
+
+static void test_fixture_run_scope(void)
+{
+    void *pFirst = UT_get_fixture(gpRunFixture);
+
+    UT_ASSERT_PTR_NOT_NULL(pFirst);
+    UT_ASSERT_PTR_EQUAL(UT_get_fixture(gpRunFixture), pFirst);
+}
+
+void register_fixture_testing_functions(void)
+{
+    gpFixtureSuite = UT_add_suite_withGroupID(FIXTURE_SUITE_TITLE, fixture_suite_init, fixture_suite_clean, UT_TESTS_L1);
+    assert(gpFixtureSuite != NULL);
+
+    gpSuiteFixture = UT_add_fixture(FIXTURE_SUITE_TITLE, "resource", setUpResource, tearDownResource);
+    gpFailingFixture = UT_add_fixture(FIXTURE_SUITE_TITLE, "failing", setUpFailing, NULL);
+    gpRunFixture = UT_add_fixture(NULL, "run resource", setUpRunResource, NULL);
+    assert((gpSuiteFixture != NULL) && (gpFailingFixture != NULL) && (gpRunFixture != NULL));
+
+    UT_add_test(gpFixtureSuite, "fixture set up once", test_fixture_set_up_once);
+    UT_add_test(gpFixtureSuite, "fixture failed set up", test_fixture_failed_set_up);
+    UT_add_test(gpFixtureSuite, "fixture run scope", test_fixture_run_scope);
+}
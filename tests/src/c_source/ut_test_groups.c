@@ -0,0 +1,131 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (262144)
+#define GROUPS_SUITES (300)     /*!< Past the initial capacity of the group list, so it grows twice */
+#define GROUPS_NAME_SIZE (32)
+
+static UT_test_suite_t *gpGroupsSuite = NULL;
+static char gResults[RESULTS_SIZE];
+static bool gSuiteInitialised = false;
+
+/* Target suites, only registered in the runner copy */
+static int init_target( void )
+{
+    gSuiteInitialised = true;
+    return 0;
+}
+
+static int clean_target( void )
+{
+    gSuiteInitialised = false;
+    return 0;
+}
+
+static void test_target_initialised( void )
+{
+    /* The suite is found by the init function wrapper after the list has grown */
+    UT_ASSERT( gSuiteInitialised );
+}
+
+static UT_groupID_t targetGroup( int suite )
+{
+    static const UT_groupID_t groups[] = { UT_TESTS_L3, UT_TESTS_L4, UT_TESTS_HUMAN_L3 };
+
+    return groups[suite % 3];
+}
+
+static void registerTargets( void )
+{
+    char name[GROUPS_NAME_SIZE];
+
+    for (int i = 0; i < GROUPS_SUITES; i++)
+    {
+        UT_test_suite_t *pSuite;
+
+        snprintf( name, sizeof(name), "ut-groups-%03d", i );
+        pSuite = UT_add_suite_withGroupID( name, init_target, clean_target, targetGroup( i ) );
+        assert(pSuite != NULL);
+        UT_add_test( pSuite, "initialised", test_target_initialised );
+    }
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+static void test_groups_toggle( void )
+{
+    /* Disable the L4 suites, disable then enable again the human L3 ones */
+    static const char *const options[] = { "-d", "4", "-d", "6", "-e", "6", NULL };
+    char name[GROUPS_NAME_SIZE];
+    int expected = 0;
+    int found = 0;
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "groups toggle", options, gResults, sizeof(gResults), &others ) );
+
+    for (int i = 0; i < GROUPS_SUITES; i++)
+    {
+        bool bActive = (targetGroup( i ) != UT_TESTS_L4);
+
+        snprintf( name, sizeof(name), "name=\"ut-groups-%03d\"", i );
+        expected += bActive ? 1 : 0;
+        found += ((strstr( gResults, name ) != NULL) == bActive) ? 1 : 0;
+    }
+    UT_ASSERT_EQUAL( found, GROUPS_SUITES );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), expected );
+    UT_ASSERT_EQUAL( countOf( gResults, "<failure " ), 0 );
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+void register_groups_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "groups toggle" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpGroupsSuite = UT_add_suite_withGroupID("ut-groups", NULL, NULL, UT_TESTS_L2);
+    assert(gpGroupsSuite != NULL);
+
+    UT_add_test(gpGroupsSuite, "groups toggle", test_groups_toggle);
+}
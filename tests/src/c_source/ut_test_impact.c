@@ -0,0 +1,202 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define MAP_SIZE (16384)
+#define IMPACT_PATH_SIZE (256)
+
+static UT_test_suite_t *gpImpactSuite = NULL;
+static char gResults[RESULTS_SIZE];
+static char gMap[MAP_SIZE];
+
+/* Target suites, only registered in the runner copy */
+static void test_target_pass( void )
+{
+    UT_ASSERT( true );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite;
+
+    pSuite = UT_add_suite_withGroupID("ut-impact-a", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "a1", test_target_pass);
+    UT_add_test(pSuite, "a2", test_target_pass);
+
+    pSuite = UT_add_suite_withGroupID("ut-impact-b", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "b1", test_target_pass);
+
+    /* Not in the map, so it is always selected */
+    pSuite = UT_add_suite_withGroupID("ut-impact-new", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "new1", test_target_pass);
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+static bool writeFile( const char *pFilename, const char *pText )
+{
+    FILE *pFile = fopen( pFilename, "w" );
+
+    if ( pFile == NULL )
+    {
+        return false;
+    }
+    fputs( pText, pFile );
+    return (fclose( pFile ) == 0);
+}
+
+/**
+ * @brief Runs the target suites selected by a map and the changed functions
+ *
+ * @param pMap - map file
+ * @param pChanged - changed functions, as given to --impact-changed
+ * @return int - bit 0 to 2 set for each of suite a, b and new found in the results, -1 if the copy failed
+ */
+static int runSelected( const char *pMap, const char *pChanged )
+{
+    const char *options[] = { "--impact-select", pMap, "--impact-changed", pChanged, NULL };
+    int others;
+
+    if ( (UT_test_runner_copy( "impact select", options, gResults, sizeof(gResults), &others ) == false) || (others != 0) ||
+         (countOf( gResults, "<failure " ) != 0) )
+    {
+        return -1;
+    }
+    return ((strstr( gResults, "name=\"ut-impact-a\"" ) != NULL) ? 1 : 0) |
+           ((strstr( gResults, "name=\"ut-impact-b\"" ) != NULL) ? 2 : 0) |
+           ((strstr( gResults, "name=\"ut-impact-new\"" ) != NULL) ? 4 : 0);
+}
+
+static void test_impact_select( void )
+{
+    char dir[] = "/tmp/ut-impact-XXXXXX";
+    char map[IMPACT_PATH_SIZE];
+    char changed[IMPACT_PATH_SIZE];
+    char changedFile[IMPACT_PATH_SIZE];
+
+    UT_ASSERT_FATAL( mkdtemp( dir ) != NULL );
+    snprintf( map, sizeof(map), "%s/map", dir );
+    snprintf( changedFile, sizeof(changedFile), "%s/changed", dir );
+    snprintf( changed, sizeof(changed), "@%s", changedFile );
+
+    /* suite<TAB>test<TAB>symbol, a test that entered nothing named has an empty symbol */
+    UT_ASSERT_FATAL( writeFile( map, "ut-impact-a\ta1\tfunction_a\n"
+                                     "ut-impact-a\ta1\tfunction_shared\n"
+                                     "ut-impact-a\ta2\t\n"
+                                     "ut-impact-b\tb1\tfunction_b\n"
+                                     "ut-impact-b\tb1\tfunction_shared\n" ) );
+    UT_ASSERT_FATAL( writeFile( changedFile, "function_a\n" ) );
+
+    /* The suites that entered a changed function run, with the suites the map does not know */
+    UT_ASSERT_EQUAL( runSelected( map, "function_b" ), 2 | 4 );
+    UT_ASSERT_EQUAL( runSelected( map, "function_none,function_shared" ), 1 | 2 | 4 );
+    UT_ASSERT_EQUAL( runSelected( map, "function_none" ), 4 );
+    UT_ASSERT_EQUAL( runSelected( map, changed ), 1 | 4 );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 3 );
+
+    /* A map that cannot be read runs every suite */
+    remove( map );
+    UT_ASSERT_EQUAL( runSelected( map, "function_b" ), 1 | 2 | 4 );
+
+    remove( changedFile );
+    rmdir( dir );
+}
+
+static void test_impact_record( void )
+{
+    char dir[] = "/tmp/ut-impact-XXXXXX";
+    char map[IMPACT_PATH_SIZE];
+    const char *options[] = { "--impact-record", map, NULL };
+    FILE *pFile;
+    size_t length = 0;
+    int others;
+
+    UT_ASSERT_FATAL( mkdtemp( dir ) != NULL );
+    snprintf( map, sizeof(map), "%s/map", dir );
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "impact select", options, gResults, sizeof(gResults), &others ) );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 4 );
+    UT_ASSERT_EQUAL( others, 0 );
+
+    pFile = fopen( map, "r" );
+    if ( pFile != NULL )
+    {
+        length = fread( gMap, 1, sizeof(gMap) - 1, pFile );
+        fclose( pFile );
+    }
+    gMap[length] = '\0';
+
+#ifdef UT_IMPACT
+    /* Every test has at least one line, which is suite<TAB>test<TAB>symbol */
+    UT_ASSERT_FATAL( pFile != NULL );
+    UT_ASSERT( countOf( gMap, "ut-impact-a\ta1\t" ) >= 1 );
+    UT_ASSERT( countOf( gMap, "ut-impact-a\ta2\t" ) >= 1 );
+    UT_ASSERT( countOf( gMap, "ut-impact-b\tb1\t" ) >= 1 );
+    UT_ASSERT( countOf( gMap, "ut-impact-new\tnew1\t" ) >= 1 );
+    UT_ASSERT_EQUAL( countOf( gMap, "\t" ), countOf( gMap, "\n" ) * 2 );
+#else
+    /* Without IMPACT=1 the functions entered are not known, no map is written and the run is unchanged */
+    UT_ASSERT( pFile == NULL );
+#endif
+
+    remove( map );
+    rmdir( dir );
+}
+
+void register_impact_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "impact select" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpImpactSuite = UT_add_suite_withGroupID("ut-impact", NULL, NULL, UT_TESTS_L2);
+    assert(gpImpactSuite != NULL);
+
+    UT_add_test(gpImpactSuite, "impact select", test_impact_select);
+    UT_add_test(gpImpactSuite, "impact record", test_impact_record);
+}
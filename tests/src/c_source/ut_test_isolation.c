@@ -0,0 +1,174 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_isolation.h"
+
+#define REPLAY_RECORDS (2)      /*!< Failure records sent back from the runner copy */
+
+/** What the runner copy replayed into its CUnit, sent back to the test */
+typedef struct
+{
+    unsigned int asserts;
+    unsigned int failures;
+    unsigned int line[REPLAY_RECORDS];
+    char file[REPLAY_RECORDS][256];
+    char condition[REPLAY_RECORDS][UT_LOG_MAX_LINE_SIZE];
+} UT_isolation_replay_t;
+
+static UT_test_suite_t *gpIsolationSuite = NULL;
+
+static void replayedBody( void )
+{
+    UT_ASSERT( true );
+    UT_ASSERT( true );
+    UT_FAIL( "isolation replayed failure" );
+    UT_FAIL_FATAL( "isolation replayed fatal" );
+    UT_ASSERT( false );
+}
+
+static void crashingBody( void )
+{
+    UT_ASSERT( true );
+    abort();
+}
+
+/**
+ * @brief Runs pBody in an isolated worker from a forked copy of the runner, so the replayed results
+ * land in the copy's CUnit rather than failing this test, and reads back what was replayed
+ */
+static bool runIsolated( UT_TestFunction_t pBody, UT_isolation_replay_t *pReplay )
+{
+    int replayPipe[2];
+    int status = -1;
+    ssize_t length;
+    pid_t pid;
+
+    memset( pReplay, 0, sizeof(*pReplay) );
+    if ( pipe( replayPipe ) != 0 )
+    {
+        return false;
+    }
+    fflush( NULL );
+    pid = fork();
+    if ( pid == 0 )
+    {
+        CU_pRunSummary pRunSummary = CU_get_run_summary();
+        unsigned int assertsBefore = pRunSummary->nAsserts;
+        unsigned int recordsBefore = CU_get_number_of_failure_records();
+        CU_pFailureRecord pRecord = NULL;
+        UT_isolation_replay_t replay;
+        int devNull = open( "/dev/null", O_WRONLY );
+
+        /* The crash is expected, its report is kept off the console */
+        if ( devNull >= 0 )
+        {
+            dup2( devNull, STDOUT_FILENO );
+            close( devNull );
+        }
+        close( replayPipe[0] );
+
+        UT_isolation_run( UT_ISOLATION_TEST, CU_get_current_test(), CU_get_current_suite(), pBody, 0, "" );
+        UT_isolation_stop();
+
+        memset( &replay, 0, sizeof(replay) );
+        replay.asserts = pRunSummary->nAsserts - assertsBefore;
+        replay.failures = CU_get_number_of_failure_records() - recordsBefore;
+        pRecord = CU_get_failure_list();
+        for (unsigned int i = 0; (i < recordsBefore) && (pRecord != NULL); i++)
+        {
+            pRecord = pRecord->pNext;
+        }
+        for (int i = 0; (i < REPLAY_RECORDS) && (pRecord != NULL); i++, pRecord = pRecord->pNext)
+        {
+            replay.line[i] = pRecord->uiLineNumber;
+            snprintf( replay.file[i], sizeof(replay.file[i]), "%s", (pRecord->strFileName != NULL) ? pRecord->strFileName : "" );
+            snprintf( replay.condition[i], sizeof(replay.condition[i]), "%s", (pRecord->strCondition != NULL) ? pRecord->strCondition : "" );
+        }
+        length = write( replayPipe[1], &replay, sizeof(replay) );
+        _exit( (length == (ssize_t)sizeof(replay)) ? 0 : 1 );
+    }
+    close( replayPipe[1] );
+    if ( pid < 0 )
+    {
+        close( replayPipe[0] );
+        return false;
+    }
+
+    length = read( replayPipe[0], pReplay, sizeof(*pReplay) );
+    close( replayPipe[0] );
+    waitpid( pid, &status, 0 );
+    return (length == (ssize_t)sizeof(*pReplay)) && WIFEXITED( status ) && (WEXITSTATUS( status ) == 0);
+}
+
+static void test_isolation_replay( void )
+{
+    UT_isolation_replay_t replay;
+
+    UT_ASSERT_FATAL( runIsolated( replayedBody, &replay ) );
+
+    /* The passed assertions are counted, the failed ones keep their file, line and condition */
+    UT_ASSERT_EQUAL( replay.asserts, 4 );
+    UT_ASSERT_EQUAL( replay.failures, 2 );
+    UT_ASSERT( replay.line[0] > 0 );
+    UT_ASSERT( strstr( replay.file[0], "ut_test_isolation.c" ) != NULL );
+    UT_ASSERT( strstr( replay.condition[0], "isolation replayed failure" ) != NULL );
+
+    /* A fatal assertion ends the body in the worker, which stays up to report it, the last assertion is not run */
+    UT_ASSERT( replay.line[1] > replay.line[0] );
+    UT_ASSERT( strstr( replay.condition[1], "isolation replayed fatal" ) != NULL );
+}
+
+static void test_isolation_crash_backtrace( void )
+{
+    UT_isolation_replay_t replay;
+
+    UT_ASSERT_FATAL( runIsolated( crashingBody, &replay ) );
+
+    /* The crash is the one failure, the assertions made before it are lost with the worker */
+    UT_ASSERT_EQUAL( replay.asserts, 1 );
+    UT_ASSERT_EQUAL( replay.failures, 1 );
+    UT_ASSERT_STRING_EQUAL( replay.file[0], "isolation" );
+    UT_ASSERT( strstr( replay.condition[0], "Test crashed: [" ) != NULL );
+    UT_ASSERT( strstr( replay.condition[0], "signal 6" ) != NULL );
+#if defined(__GLIBC__)
+    /* A frame per line follows the signal */
+    UT_ASSERT( strchr( replay.condition[0], '\n' ) != NULL );
+#endif
+}
+
+void register_isolation_testing_functions(void)
+{
+    gpIsolationSuite = UT_add_suite_withGroupID("ut-isolation", NULL, NULL, UT_TESTS_L2);
+    assert(gpIsolationSuite != NULL);
+
+    UT_add_test(gpIsolationSuite, "isolation worker replay", test_isolation_replay);
+    UT_add_test(gpIsolationSuite, "isolation crash backtrace", test_isolation_crash_backtrace);
+}
@@ -0,0 +1,355 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include <ut_kvp_image.h>
+
+#define IMAGE_BUCKETS   (8)
+#define IMAGE_SIZE      (1024)
+
+typedef struct
+{
+    const char *pKey;
+    const char *pValue;
+    uint64_t number;
+    uint32_t listCount;
+    uint8_t kind;
+    uint8_t flags;
+} image_value_t;
+
+/* Values of the test image, decoded as scripts/ut_kvp_compile.py decodes them */
+static const image_value_t gValues[] =
+{
+    { "decodeTest", "", 0, 0, UT_KVP_IMAGE_MAP, 0 },
+    { "decodeTest/checkUint32IsDeadBeefHex", "0xdeadbeef", 0xdeadbeef, 0, UT_KVP_IMAGE_SCALAR, UT_KVP_IMAGE_NUMBER },
+    { "decodeTest/checkString", "compiled", 0, 0, UT_KVP_IMAGE_SCALAR, 0 },
+    { "decodeTest/checkBoolTrue", "TRUE", 0, 0, UT_KVP_IMAGE_SCALAR, UT_KVP_IMAGE_BOOL | UT_KVP_IMAGE_TRUE },
+    { "decodeTest/checkList", "", 0, 2, UT_KVP_IMAGE_LIST, 0 },
+};
+
+static UT_test_suite_t *gpImageSuite = NULL;
+static char gDirectory[] = "/tmp/ut_kvp_image_XXXXXX";
+static char gProfileName[sizeof(gDirectory) + 32];
+static char gImageName[sizeof(gProfileName) + sizeof(UT_KVP_IMAGE_SUFFIX)];
+static char gCorruptName[sizeof(gDirectory) + 32];
+
+static uint64_t hashKey( const char *pszKey )
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (; *pszKey != '\0'; pszKey++)
+    {
+        hash ^= (unsigned char)*pszKey;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Lays out an image of gValues
+ *
+ * @return size_t - the size of the image
+ */
+static size_t buildImage( uint8_t *pImage )
+{
+    const uint32_t count = sizeof(gValues) / sizeof(gValues[0]);
+    ut_kvp_image_header_t *pHeader = (ut_kvp_image_header_t *)pImage;
+    uint32_t *pBuckets = (uint32_t *)(pImage + sizeof(ut_kvp_image_header_t));
+    ut_kvp_image_entry_t *pEntries = (ut_kvp_image_entry_t *)(pBuckets + IMAGE_BUCKETS);
+    char *pStrings = (char *)(pEntries + count);
+    uint32_t stringsSize = 1;
+
+    memset( pImage, 0, IMAGE_SIZE );
+    memcpy( pHeader->magic, UT_KVP_IMAGE_MAGIC, sizeof(pHeader->magic) );
+    pHeader->version = UT_KVP_IMAGE_VERSION;
+    pHeader->headerSize = sizeof(ut_kvp_image_header_t);
+    pHeader->entryCount = count;
+    pHeader->bucketCount = IMAGE_BUCKETS;
+    pHeader->bucketsOffset = (uint32_t)((uint8_t *)pBuckets - pImage);
+    pHeader->entriesOffset = (uint32_t)((uint8_t *)pEntries - pImage);
+    pHeader->stringsOffset = (uint32_t)((uint8_t *)pStrings - pImage);
+
+    /* Offset 0 is the empty string */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ut_kvp_image_entry_t *pEntry = &pEntries[i];
+        uint32_t slot;
+
+        pEntry->hash = hashKey( gValues[i].pKey );
+        pEntry->keyOffset = stringsSize;
+        pEntry->keyLength = (uint32_t)strlen( gValues[i].pKey );
+        memcpy( &pStrings[stringsSize], gValues[i].pKey, pEntry->keyLength + 1 );
+        stringsSize += pEntry->keyLength + 1;
+        pEntry->valueLength = (uint32_t)strlen( gValues[i].pValue );
+        pEntry->valueOffset = (pEntry->valueLength == 0) ? 0 : stringsSize;
+        memcpy( &pStrings[pEntry->valueOffset], gValues[i].pValue, pEntry->valueLength + 1 );
+        stringsSize += (pEntry->valueLength == 0) ? 0 : pEntry->valueLength + 1;
+        pEntry->number = gValues[i].number;
+        pEntry->listCount = gValues[i].listCount;
+        pEntry->kind = gValues[i].kind;
+        pEntry->flags = gValues[i].flags;
+
+        for (slot = (uint32_t)pEntry->hash & (IMAGE_BUCKETS - 1); pBuckets[slot] != 0; slot = (slot + 1) & (IMAGE_BUCKETS - 1))
+        {
+        }
+        pBuckets[slot] = i + 1;
+    }
+    pHeader->stringsSize = stringsSize;
+    assert( pHeader->stringsOffset + stringsSize <= IMAGE_SIZE );
+    return pHeader->stringsOffset + stringsSize;
+}
+
+static bool writeFile( const char *pFileName, const void *pData, size_t size )
+{
+    FILE *pFile = fopen( pFileName, "wb" );
+    bool written;
+
+    if ( pFile == NULL )
+    {
+        return false;
+    }
+    written = (fwrite( pData, 1, size, pFile ) == size);
+    fclose( pFile );
+    return written;
+}
+
+/* Sets the modification time of a file, seconds from now */
+static bool touchFile( const char *pFileName, long offset )
+{
+    struct timeval times[2];
+
+    gettimeofday( &times[0], NULL );
+    times[0].tv_sec += offset;
+    times[1] = times[0];
+    return utimes( pFileName, times ) == 0;
+}
+
+/* Writes the image corrupted by pCorrupt and checks it is refused */
+static void checkCorruptImage( const char *pStep, void (*pCorrupt)(uint8_t *pImage, size_t *pSize) )
+{
+    uint8_t image[IMAGE_SIZE];
+    size_t size = buildImage( image );
+    ut_kvp_image_t *pImage;
+
+    UT_LOG_STEP( "%s", pStep );
+    pCorrupt( image, &size );
+    UT_ASSERT_FATAL( writeFile( gCorruptName, image, size ) );
+    pImage = ut_kvp_image_open( gCorruptName );
+    UT_ASSERT_PTR_NULL( pImage );
+    ut_kvp_image_close( pImage );
+}
+
+static void corruptMagic( uint8_t *pImage, size_t *pSize )
+{
+    (void)pSize;
+    pImage[0] = 'X';
+}
+
+static void corruptVersion( uint8_t *pImage, size_t *pSize )
+{
+    (void)pSize;
+    ((ut_kvp_image_header_t *)pImage)->version = UT_KVP_IMAGE_VERSION + 1;
+}
+
+static void corruptTruncated( uint8_t *pImage, size_t *pSize )
+{
+    (void)pImage;
+    *pSize = *pSize / 2;
+}
+
+static void corruptHeaderOnly( uint8_t *pImage, size_t *pSize )
+{
+    (void)pImage;
+    *pSize = sizeof(ut_kvp_image_header_t) - 1;
+}
+
+static void corruptBucketCount( uint8_t *pImage, size_t *pSize )
+{
+    (void)pSize;
+    ((ut_kvp_image_header_t *)pImage)->bucketCount = IMAGE_BUCKETS - 1;
+}
+
+static void corruptBucket( uint8_t *pImage, size_t *pSize )
+{
+    const ut_kvp_image_header_t *pHeader = (const ut_kvp_image_header_t *)pImage;
+
+    (void)pSize;
+    ((uint32_t *)(pImage + pHeader->bucketsOffset))[0] = pHeader->entryCount + 1;
+}
+
+static void corruptKeyOffset( uint8_t *pImage, size_t *pSize )
+{
+    const ut_kvp_image_header_t *pHeader = (const ut_kvp_image_header_t *)pImage;
+
+    (void)pSize;
+    ((ut_kvp_image_entry_t *)(pImage + pHeader->entriesOffset))[1].keyOffset = pHeader->stringsSize;
+}
+
+static void corruptUnterminated( uint8_t *pImage, size_t *pSize )
+{
+    const ut_kvp_image_header_t *pHeader = (const ut_kvp_image_header_t *)pImage;
+    const ut_kvp_image_entry_t *pEntry = &((const ut_kvp_image_entry_t *)(pImage + pHeader->entriesOffset))[1];
+
+    (void)pSize;
+    pImage[pHeader->stringsOffset + pEntry->keyOffset + pEntry->keyLength] = 'X';
+}
+
+static int test_ut_kvp_image_init( void )
+{
+    uint8_t image[IMAGE_SIZE];
+    size_t size = buildImage( image );
+    static const char profile[] = "---\ndecodeTest:\n  checkString: parsed\n";
+
+    if ( mkdtemp( gDirectory ) == NULL )
+    {
+        return -1;
+    }
+    snprintf( gProfileName, sizeof(gProfileName), "%s/test_kvp_image.yaml", gDirectory );
+    snprintf( gImageName, sizeof(gImageName), "%s" UT_KVP_IMAGE_SUFFIX, gProfileName );
+    snprintf( gCorruptName, sizeof(gCorruptName), "%s/corrupt" UT_KVP_IMAGE_SUFFIX, gDirectory );
+    if ( !writeFile( gProfileName, profile, sizeof(profile) - 1 ) || !writeFile( gImageName, image, size ) )
+    {
+        return -1;
+    }
+    ut_kvp_profile_close();
+    return 0;
+}
+
+static int test_ut_kvp_image_clean( void )
+{
+    ut_kvp_profile_close();
+    unlink( gProfileName );
+    unlink( gImageName );
+    unlink( gCorruptName );
+    rmdir( gDirectory );
+    return 0;
+}
+
+static void test_ut_kvp_image_lookup( void )
+{
+    ut_kvp_image_t *pImage;
+    const ut_kvp_image_entry_t *pEntry;
+
+    UT_LOG_STEP( "test_ut_kvp_image_lookup - start" );
+
+    UT_ASSERT( ut_kvp_image_isImage( gImageName ) );
+    UT_ASSERT( ut_kvp_image_isImage( gProfileName ) == false );
+    pImage = ut_kvp_image_open( gImageName );
+    UT_ASSERT_PTR_NOT_NULL_FATAL( pImage );
+
+    /* Both separators find the same entry */
+    pEntry = ut_kvp_image_find( pImage, "decodeTest/checkUint32IsDeadBeefHex" );
+    UT_ASSERT_PTR_NOT_NULL_FATAL( pEntry );
+    UT_ASSERT_PTR_EQUAL( ut_kvp_image_find( pImage, "decodeTest.checkUint32IsDeadBeefHex" ), pEntry );
+    UT_ASSERT_EQUAL( ut_kvp_image_getNumber( pEntry, UINT32_MAX ), 0xdeadbeef );
+    UT_ASSERT_EQUAL( ut_kvp_image_getNumber( pEntry, UINT16_MAX ), 0 );
+    UT_ASSERT_STRING_EQUAL( ut_kvp_image_getString( pImage, pEntry ), "0xdeadbeef" );
+
+    pEntry = ut_kvp_image_find( pImage, "decodeTest/checkString" );
+    UT_ASSERT_PTR_NOT_NULL_FATAL( pEntry );
+    UT_ASSERT_STRING_EQUAL( ut_kvp_image_getString( pImage, pEntry ), "compiled" );
+    UT_ASSERT_EQUAL( ut_kvp_image_getNumber( pEntry, UINT64_MAX ), 0 );
+
+    pEntry = ut_kvp_image_find( pImage, "decodeTest/checkList" );
+    UT_ASSERT_PTR_NOT_NULL_FATAL( pEntry );
+    UT_ASSERT_EQUAL( pEntry->kind, UT_KVP_IMAGE_LIST );
+    UT_ASSERT_EQUAL( pEntry->listCount, 2 );
+
+    UT_ASSERT_PTR_NULL( ut_kvp_image_find( pImage, "decodeTest/checkStr" ) );
+    UT_ASSERT_PTR_NULL( ut_kvp_image_find( pImage, NULL ) );
+    UT_ASSERT_PTR_NULL( ut_kvp_image_find( NULL, "decodeTest" ) );
+    ut_kvp_image_close( pImage );
+
+    UT_LOG_STEP( "test_ut_kvp_image_lookup - end" );
+}
+
+static void test_ut_kvp_image_validation( void )
+{
+    UT_LOG_STEP( "test_ut_kvp_image_validation - start" );
+
+    checkCorruptImage( "Bad magic", corruptMagic );
+    checkCorruptImage( "Another version", corruptVersion );
+    checkCorruptImage( "Truncated", corruptTruncated );
+    checkCorruptImage( "Shorter than its header", corruptHeaderOnly );
+    checkCorruptImage( "Bucket count not a power of 2", corruptBucketCount );
+    checkCorruptImage( "Bucket past the entries", corruptBucket );
+    checkCorruptImage( "Key past the strings", corruptKeyOffset );
+    checkCorruptImage( "Key not terminated", corruptUnterminated );
+    UT_ASSERT_PTR_NULL( ut_kvp_image_open( "/this/image/does/not/exist" UT_KVP_IMAGE_SUFFIX ) );
+
+    UT_LOG_STEP( "test_ut_kvp_image_validation - end" );
+}
+
+static void test_ut_kvp_image_profile( void )
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    UT_LOG_STEP( "test_ut_kvp_image_profile - start" );
+
+    /* The image next to a profile is not used unless it is opened */
+    UT_ASSERT_FATAL( touchFile( gImageName, 10 ) );
+    UT_ASSERT_EQUAL_FATAL( ut_kvp_profile_open( gProfileName ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_EQUAL( ut_kvp_profile_getStringField( "decodeTest/checkString", value, sizeof(value) ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( value, "parsed" );
+    UT_ASSERT_PTR_NOT_NULL( ut_kvp_profile_getLayer( 0 ) );
+    ut_kvp_profile_close();
+
+    /* Opened, it is a layer of its own read through the getters */
+    UT_ASSERT_EQUAL_FATAL( ut_kvp_profile_open( gImageName ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_EQUAL( ut_kvp_profile_getLayerCount(), 1 );
+    UT_ASSERT_PTR_NULL( ut_kvp_profile_getLayer( 0 ) );
+    UT_ASSERT_EQUAL( ut_kvp_profile_getStringField( "decodeTest/checkString", value, sizeof(value) ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( value, "compiled" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_UINT32( 0xdeadbeef, "decodeTest.checkUint32IsDeadBeefHex" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_BOOL( true, "decodeTest/checkBoolTrue" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_LIST_COUNT( 2, "decodeTest/checkList" );
+    UT_ASSERT_EQUAL( ut_kvp_profile_getStringField( "decodeTest/missing", value, sizeof(value) ), UT_KVP_STATUS_KEY_NOT_FOUND );
+    ut_kvp_profile_close();
+
+    /* An image older than its profile is stale, the profile is parsed */
+    UT_ASSERT_FATAL( touchFile( gImageName, -10 ) );
+    UT_ASSERT_EQUAL_FATAL( ut_kvp_profile_open( gImageName ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_PTR_NOT_NULL( ut_kvp_profile_getLayer( 0 ) );
+    UT_ASSERT_EQUAL( ut_kvp_profile_getStringField( "decodeTest/checkString", value, sizeof(value) ), UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_STRING_EQUAL( value, "parsed" );
+    ut_kvp_profile_close();
+
+    UT_LOG_STEP( "test_ut_kvp_image_profile - end" );
+}
+
+void register_kvp_image_testing_functions(void)
+{
+    gpImageSuite = UT_add_suite_withGroupID("ut-kvp - compiled images", test_ut_kvp_image_init, test_ut_kvp_image_clean, UT_TESTS_L2);
+    assert(gpImageSuite != NULL);
+
+    UT_add_test(gpImageSuite, "kvp image lookup", test_ut_kvp_image_lookup);
+    UT_add_test(gpImageSuite, "kvp image validation", test_ut_kvp_image_validation);
+    UT_add_test(gpImageSuite, "kvp image profile", test_ut_kvp_image_profile);
+}
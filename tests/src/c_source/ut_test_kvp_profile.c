@@ -31,10 +31,13 @@
 
 #define KVP_VALID_TEST_ASSERT_YAML_FILE "assets/test_kvp.yaml"
 #define KVP_VALID_TEST_ASSERT_JSON_FILE "assets/test_kvp.json"
+#define KVP_VALID_TEST_OVERRIDE_YAML_FILE "assets/test_kvp_override.yaml"
 
 static UT_test_suite_t *gpAssertSuite1 = NULL;
 static UT_test_suite_t *gpAssertSuite2 = NULL;
 static UT_test_suite_t *gpAssertSuite3 = NULL;
+static UT_test_suite_t *gpAssertSuite4 = NULL;
+static UT_test_suite_t *gpAssertSuite5 = NULL;
 
 void test_ut_kvp_profile_uint8(void)
 {
@@ -165,6 +168,38 @@ void test_ut_kvp_profile_list_count(void)
     UT_LOG_STEP( "test_ut_kvp_profile_list_count - end" );
 }
 
+void test_ut_kvp_profile_handle(void)
+{
+    const ut_kvp_profile_handle_t *pUint32;
+    const ut_kvp_profile_handle_t *pString;
+    const ut_kvp_profile_handle_t *pBool;
+    const ut_kvp_profile_handle_t *pList;
+    const ut_kvp_profile_handle_t *pMissing;
+
+    UT_LOG_STEP("test_ut_kvp_profile_handle - start");
+
+    pUint32 = UT_KVP_PROFILE_HANDLE("decodeTest/checkUint32IsDeadBeefHex");
+    pString = UT_KVP_PROFILE_HANDLE("decodeTest.checkStringDeadBeef");
+    pBool = UT_KVP_PROFILE_HANDLE("decodeTest/checkBooltrue");
+    pList = UT_KVP_PROFILE_HANDLE("decodeTest/checkStringList");
+    pMissing = UT_KVP_PROFILE_HANDLE("decodeTest/thisKeyDoesNotExist");
+
+    /* A key is resolved once, both separators give the same handle */
+    UT_ASSERT( pUint32 == UT_KVP_PROFILE_HANDLE("decodeTest.checkUint32IsDeadBeefHex") );
+    UT_ASSERT( pString == UT_KVP_PROFILE_HANDLE("decodeTest/checkStringDeadBeef") );
+
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( 0xdeadbeef, pUint32 );
+    UT_ASSERT_KVP_EQUAL_HANDLE_STRING( "the beef is dead", pString );
+    UT_ASSERT_KVP_EQUAL_HANDLE_BOOL( true, pBool );
+    UT_ASSERT_KVP_EQUAL_HANDLE_LIST_COUNT( 3, pList );
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT64( 0xdeadbeef, pUint32 );
+    UT_ASSERT( pMissing != NULL );
+    UT_ASSERT( pMissing->status != UT_KVP_STATUS_SUCCESS );
+    UT_ASSERT_EQUAL( pMissing->length, 0 );
+
+    UT_LOG_STEP("test_ut_kvp_profile_handle - end");
+}
+
 void test_ut_kvp_profile_open( void )
 {
     UT_LOG_STEP( "test_ut_kvp_profile_open - start" );
@@ -236,6 +271,85 @@ void test_ut_kvp_get_instance( void )
     UT_LOG_STEP("Tested for profile : assets/5d.yaml");
 }
 
+int test_ut_kvp_profile_init_layers( void )
+{
+    ut_kvp_profile_close();
+    ut_kvp_profile_open( KVP_VALID_TEST_ASSERT_YAML_FILE );
+    ut_kvp_profile_open( KVP_VALID_TEST_OVERRIDE_YAML_FILE );
+    return 0;
+}
+
+void test_ut_kvp_profile_layer_override(void)
+{
+    uint32_t count;
+
+    UT_LOG_STEP("test_ut_kvp_profile_layer_override - start");
+
+    count = ut_kvp_profile_getLayerCount();
+    UT_ASSERT_EQUAL( count, 2 );
+
+    /* The last profile opened wins */
+    UT_ASSERT_KVP_EQUAL_PROFILE_STRING( "the beef is overridden", "decodeTest/checkStringDeadBeef" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_UINT32( 1234, "decodeTest/checkUint32IsDeadBeefDec" );
+    UT_ASSERT( ut_kvp_profile_getInstanceForKey("decodeTest/checkStringDeadBeef") == ut_kvp_profile_getLayer(count - 1) );
+
+    /* Keys only in the earlier profile fall through to it */
+    UT_ASSERT_KVP_EQUAL_PROFILE_UINT8( 0xde, "decodeTest/checkUint8IsDeHex" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_LIST_COUNT( 3, "decodeTest/checkStringList" );
+    UT_ASSERT( ut_kvp_profile_getInstanceForKey("decodeTest/checkUint8IsDeHex") == ut_kvp_profile_getLayer(0) );
+
+    UT_LOG_STEP("test_ut_kvp_profile_layer_override - end");
+}
+
+void test_ut_kvp_profile_layer_index(void)
+{
+    UT_LOG_STEP("test_ut_kvp_profile_layer_index - start");
+
+    /* Both separators resolve to the same entry, a repeated lookup returns the indexed value */
+    UT_ASSERT_KVP_EQUAL_PROFILE_STRING( "the beef is overridden", "decodeTest/checkStringDeadBeef" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_STRING( "the beef is overridden", "decodeTest.checkStringDeadBeef" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_BOOL( true, "decodeTest/checkBooltrue" );
+    UT_ASSERT_KVP_EQUAL_PROFILE_UINT16( 0xdead, "decodeTest.checkUint16IsDeadHex" );
+    UT_ASSERT( ut_kvp_profile_getInstanceForKey("decodeTest.checkStringDeadBeef") == ut_kvp_profile_getInstanceForKey("decodeTest/checkStringDeadBeef") );
+
+    UT_LOG_STEP("test_ut_kvp_profile_layer_index - end");
+}
+
+void test_ut_kvp_profile_layer_handle(void)
+{
+    const ut_kvp_profile_handle_t *pSigned;
+    const ut_kvp_profile_handle_t *pSpaced;
+    const ut_kvp_profile_handle_t *pText;
+
+    UT_LOG_STEP("test_ut_kvp_profile_layer_handle - start");
+
+    /* A number is decoded as the ut_kvp_getUInt*Field() getters read it, whatever its first character */
+    pSigned = UT_KVP_PROFILE_HANDLE("decodeTest/checkUint32IsSigned");
+    pSpaced = UT_KVP_PROFILE_HANDLE("decodeTest/checkUint32IsSpaced");
+    pText = UT_KVP_PROFILE_HANDLE("decodeTest/checkStringStartsWithDigit");
+
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( ut_kvp_profile_getUInt32Field("decodeTest/checkUint32IsSigned"), pSigned );
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( 5, pSigned );
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( ut_kvp_profile_getUInt32Field("decodeTest/checkUint32IsSpaced"), pSpaced );
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( 42, pSpaced );
+
+    /* A string is never decoded as a number */
+    UT_ASSERT_KVP_EQUAL_HANDLE_STRING( "3 beefs", pText );
+    UT_ASSERT_KVP_EQUAL_HANDLE_UINT32( 0, pText );
+
+    UT_LOG_STEP("test_ut_kvp_profile_layer_handle - end");
+}
+
+void test_ut_kvp_profile_list_element(const char *pElementKey, uint32_t index)
+{
+    static const uint32_t expected[] = { 720, 800, 1080 };
+
+    UT_LOG_STEP("test_ut_kvp_profile_list_element [%s]", pElementKey);
+
+    UT_ASSERT_FATAL( index < sizeof(expected) / sizeof(expected[0]) );
+    UT_ASSERT_KVP_EQUAL_PROFILE_UINT32( expected[index], pElementKey );
+}
+
 void register_kvp_profile_testing_functions(void)
 {
     gpAssertSuite1 = UT_add_suite_withGroupID("ut-kvp - assert open / close", NULL, NULL, UT_TESTS_L1);
@@ -256,6 +370,7 @@ void register_kvp_profile_testing_functions(void)
     UT_add_test(gpAssertSuite2, "kvp profile list count", test_ut_kvp_profile_list_count);
     UT_add_test(gpAssertSuite2, "kvp profile right string long", test_ut_kvp_profile_right_string_long);
     UT_add_test(gpAssertSuite2, "kvp profile left string long", test_ut_kvp_profile_left_string_long);
+    UT_add_test(gpAssertSuite2, "kvp profile handle", test_ut_kvp_profile_handle);
 
     gpAssertSuite3 = UT_add_suite("ut-kvp - assert testing json ", test_ut_kvp_profile_init_json, test_ut_kvp_profile_cleanup);
     assert(gpAssertSuite3 != NULL);
@@ -267,4 +382,18 @@ void register_kvp_profile_testing_functions(void)
     UT_add_test(gpAssertSuite3, "kvp profile string", test_ut_kvp_profile_string);
     UT_add_test(gpAssertSuite3, "kvp profile bool", test_ut_kvp_profile_bool);
     UT_add_test(gpAssertSuite3, "kvp profile list count", test_ut_kvp_profile_list_count);
+    UT_add_test(gpAssertSuite3, "kvp profile handle", test_ut_kvp_profile_handle);
+
+    gpAssertSuite4 = UT_add_suite_withGroupID("ut-kvp - layered profiles", test_ut_kvp_profile_init_layers, test_ut_kvp_profile_cleanup, UT_TESTS_L2);
+    assert(gpAssertSuite4 != NULL);
+
+    UT_add_test(gpAssertSuite4, "kvp profile layer override", test_ut_kvp_profile_layer_override);
+    UT_add_test(gpAssertSuite4, "kvp profile layer index", test_ut_kvp_profile_layer_index);
+    UT_add_test(gpAssertSuite4, "kvp profile layer handle", test_ut_kvp_profile_layer_handle);
+
+    /* One case per element of the list in the -p profile */
+    gpAssertSuite5 = UT_add_suite_withGroupID("ut-kvp - parameterized list", test_ut_kvp_profile_init_yaml, test_ut_kvp_profile_cleanup, UT_TESTS_L2);
+    assert(gpAssertSuite5 != NULL);
+
+    UT_add_param_tests(gpAssertSuite5, "kvp profile list element", test_ut_kvp_profile_list_element, "decodeTest/checkUint32List");
 }
@@ -0,0 +1,182 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_log_async.h>
+
+#define OVERFLOW_LINES (3)      /*!< Lines logged past a full ring, each waits 50ms before it is dropped */
+#define EXIT_LINES (100)
+
+static UT_test_suite_t *gpLogAsyncSuite = NULL;
+static bool gbStarted = false;  /*!< The suite started the logger, it stops it again */
+static int gSavedStdout = -1;
+static long gLogOffset;
+
+static int test_log_async_init( void )
+{
+    if ( UT_log_async_enabled() == false )
+    {
+        if ( UT_log_async_start() != 0 )
+        {
+            return -1;
+        }
+        gbStarted = true;
+    }
+    return 0;
+}
+
+static int test_log_async_clean( void )
+{
+    if ( gbStarted )
+    {
+        UT_log_async_stop();
+        gbStarted = false;
+    }
+    return 0;
+}
+
+/* The lines of a test go to the log file only, the console is not flooded */
+static void quietStart( void )
+{
+    struct stat status;
+    int devNull;
+
+    UT_log_async_flush();
+    gLogOffset = (stat( UT_log_getLogFilename(), &status ) == 0) ? (long)status.st_size : 0;
+    fflush( stdout );
+    gSavedStdout = dup( STDOUT_FILENO );
+    devNull = open( "/dev/null", O_WRONLY );
+    if ( devNull >= 0 )
+    {
+        dup2( devNull, STDOUT_FILENO );
+        close( devNull );
+    }
+}
+
+static void quietEnd( void )
+{
+    UT_log_async_flush();
+    if ( gSavedStdout >= 0 )
+    {
+        dup2( gSavedStdout, STDOUT_FILENO );
+        close( gSavedStdout );
+        gSavedStdout = -1;
+    }
+}
+
+/* Counts the lines written to the log file since quietStart() that hold pMarker */
+static int countLogLines( const char *pMarker )
+{
+    char line[UT_LOG_MAX_LINE_SIZE + 256];
+    FILE *pLog = fopen( UT_log_getLogFilename(), "r" );
+    int count = 0;
+
+    if ( pLog == NULL )
+    {
+        return -1;
+    }
+    fseek( pLog, gLogOffset, SEEK_SET );
+    while ( fgets( line, sizeof(line), pLog ) != NULL )
+    {
+        count += (strstr( line, pMarker ) != NULL) ? 1 : 0;
+    }
+    fclose( pLog );
+    return count;
+}
+
+static void test_log_async_wrap( void )
+{
+    quietStart();
+    for (int i = 0; i < 3 * UT_LOG_ASYNC_SLOTS; i++)
+    {
+        UT_LOG( "log-async wrap %d", i );
+    }
+    quietEnd();
+
+    /* Every line is written although the ring wrapped twice */
+    UT_ASSERT_EQUAL( countLogLines( "log-async wrap " ), 3 * UT_LOG_ASYNC_SLOTS );
+}
+
+static void test_log_async_overflow( void )
+{
+    char dropped[64];
+
+    quietStart();
+    UT_log_async_hold( true );
+    for (int i = 0; i < UT_LOG_ASYNC_SLOTS + OVERFLOW_LINES; i++)
+    {
+        UT_LOG( "log-async overflow %d", i );
+    }
+    UT_log_async_hold( false );
+    quietEnd();
+
+    /* The ring is written as it was when full, the lines past it are counted */
+    snprintf( dropped, sizeof(dropped), "log ring full, [%d] lines dropped", OVERFLOW_LINES );
+    UT_ASSERT_EQUAL( countLogLines( "log-async overflow " ), UT_LOG_ASYNC_SLOTS );
+    UT_ASSERT_EQUAL( countLogLines( dropped ), 1 );
+}
+
+static void test_log_async_drain_at_exit( void )
+{
+    pid_t pid;
+    int status = -1;
+
+    quietStart();
+    pid = fork();
+    if ( pid == 0 )
+    {
+        /* The child starts its own writer on its first line, exit() drains what it has not written */
+        for (int i = 0; i < EXIT_LINES; i++)
+        {
+            UT_LOG( "log-async exit %d", i );
+        }
+        exit( 0 );
+    }
+    if ( pid > 0 )
+    {
+        waitpid( pid, &status, 0 );
+    }
+    quietEnd();
+
+    UT_ASSERT_FATAL( pid > 0 );
+    UT_ASSERT( WIFEXITED( status ) && (WEXITSTATUS( status ) == 0) );
+    UT_ASSERT_EQUAL( countLogLines( "log-async exit " ), EXIT_LINES );
+}
+
+void register_log_async_testing_functions(void)
+{
+    gpLogAsyncSuite = UT_add_suite_withGroupID("ut-log-async", test_log_async_init, test_log_async_clean, UT_TESTS_L2);
+    assert(gpLogAsyncSuite != NULL);
+
+    UT_add_test(gpLogAsyncSuite, "log async ring wrap", test_log_async_wrap);
+    UT_add_test(gpLogAsyncSuite, "log async ring overflow", test_log_async_overflow);
+    UT_add_test(gpLogAsyncSuite, "log async drain at exit", test_log_async_drain_at_exit);
+}
@@ -0,0 +1,108 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define MEMORY_FREED_MAX (2048)     /*!< Past the sizes glibc keeps in its thread cache */
+#define MEMORY_LEAKED (256)
+
+static UT_test_suite_t *gpMemorySuite = NULL;
+static char gResults[RESULTS_SIZE];
+static void *gpLeaked = NULL;
+
+/* Target suite, only registered in the runner copy */
+static void test_target_freed( void )
+{
+    /* Freed small chunks are held by the allocator, they are not left allocated by the test */
+    for (size_t size = 8; size <= MEMORY_FREED_MAX; size += 8)
+    {
+        char *volatile pChunk = (char *)malloc( size );
+
+        UT_ASSERT_FATAL( pChunk != NULL );
+        memset( pChunk, 0, size );
+        free( pChunk );
+    }
+}
+
+static void test_target_leaked( void )
+{
+    gpLeaked = malloc( MEMORY_LEAKED );
+    UT_ASSERT( gpLeaked != NULL );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite = UT_add_suite_withGroupID("ut-memory-budget", NULL, NULL, UT_TESTS_L3);
+
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "freed", test_target_freed);
+    UT_add_test(pSuite, "leaked", test_target_leaked);
+}
+
+static void test_memory_leak_budget( void )
+{
+    static const char *const options[] = { "--memory", "--leak-budget", "0", NULL };
+    const char *pFreed;
+    const char *pLeaked;
+    const char *pNet;
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "memory budget", options, gResults, sizeof(gResults), &others ) );
+
+    pFreed = strstr( gResults, "name=\"freed\"" );
+    pLeaked = strstr( gResults, "name=\"leaked\"" );
+    UT_ASSERT_FATAL( (pFreed != NULL) && (pLeaked != NULL) && (pFreed < pLeaked) );
+
+    /* Only the test that kept its allocation is over the budget */
+    pNet = strstr( pFreed, "<property name=\"memory_net_bytes\" value=\"0\"/>" );
+    UT_ASSERT( (pNet != NULL) && (pNet < pLeaked) );
+    UT_ASSERT( strstr( pFreed, "<failure " ) > pLeaked );
+    UT_ASSERT( strstr( pLeaked, "<failure message=\"Leak budget of 0 bytes exceeded" ) != NULL );
+    pNet = strstr( pLeaked, "<property name=\"memory_net_bytes\" value=\"" );
+    UT_ASSERT_FATAL( pNet != NULL );
+    UT_ASSERT( atoi( pNet + strlen( "<property name=\"memory_net_bytes\" value=\"" ) ) >= MEMORY_LEAKED );
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+void register_memory_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "memory budget" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpMemorySuite = UT_add_suite_withGroupID("ut-memory", NULL, NULL, UT_TESTS_L2);
+    assert(gpMemorySuite != NULL);
+
+    UT_add_test(gpMemorySuite, "memory leak budget", test_memory_leak_budget);
+}
@@ -0,0 +1,189 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+
+static UT_test_suite_t *gpParallelSuite = NULL;
+static char gResults[RESULTS_SIZE];
+
+/* Target suites, only registered in the runner copy */
+static void test_target_pass( void )
+{
+    UT_ASSERT( UT_test_runner_in_copy() == false );
+}
+
+static void test_target_fail( void )
+{
+    UT_FAIL( "parallel target failure" );
+}
+
+static void test_target_crash( void )
+{
+    if ( strcmp( UT_test_runner_target(), "parallel crash" ) == 0 )
+    {
+        abort();
+    }
+    UT_ASSERT( UT_test_runner_in_copy() == false );
+}
+
+static void test_target_serial( void )
+{
+    UT_ASSERT( UT_test_runner_in_copy() );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite;
+
+    /* Dealt to 2 workers: a and c to worker 0, b to worker 1 */
+    pSuite = UT_add_suite_withGroupID("ut-parallel-a", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "a pass", test_target_pass);
+    UT_add_test(pSuite, "a fail", test_target_fail);
+
+    pSuite = UT_add_suite_withGroupID("ut-parallel-b", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "b pass", test_target_pass);
+    UT_add_test(pSuite, "b pass again", test_target_pass);
+    UT_add_test(pSuite, "b crash", test_target_crash);
+
+    pSuite = UT_add_suite_withGroupID("ut-parallel-c", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "c pass", test_target_pass);
+
+    /* Module control suites are kept out of the pool */
+    pSuite = UT_add_suite_withGroupID("ut-parallel-serial", NULL, NULL, UT_TESTS_L4);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "serial in runner", test_target_serial);
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Runs the target suites across 2 workers in a copy of this runner and reads back its results
+ *
+ * @param pTarget - the run to make, "parallel pass" or "parallel crash"
+ * @param pLeftover - set to the number of worker and parent results files left behind
+ */
+static bool runPool( const char *pTarget, int *pLeftover )
+{
+    static const char *const options[] = { "-j", "2", NULL };
+
+    return UT_test_runner_copy( pTarget, options, gResults, sizeof(gResults), pLeftover );
+}
+
+static void test_parallel_pool( void )
+{
+    const char *pSerial;
+    int leftover;
+
+    UT_ASSERT_FATAL( runPool( "parallel pass", &leftover ) );
+
+    /* The parallel tests assert they are in a worker, the serial one that it is in the runner */
+    UT_ASSERT( strstr( gResults, "<testsuites errors=\"0\" failures=\"1\" tests=\"7\" name=\"\">" ) != NULL );
+    UT_ASSERT_EQUAL( countOf( gResults, "<failure " ), 1 );
+    UT_ASSERT( strstr( gResults, "parallel target failure" ) != NULL );
+
+    /* The suite kept out of the pool runs after the workers */
+    pSerial = strstr( gResults, "name=\"ut-parallel-serial\"" );
+    UT_ASSERT_FATAL( pSerial != NULL );
+    UT_ASSERT( strstr( pSerial + 1, "name=\"ut-parallel-" ) == NULL );
+}
+
+static void test_parallel_merge( void )
+{
+    const char *pA;
+    const char *pB;
+    const char *pC;
+    int leftover;
+
+    UT_ASSERT_FATAL( runPool( "parallel pass", &leftover ) );
+
+    /* Each worker's results in worker order, the share files are removed */
+    pA = strstr( gResults, "name=\"ut-parallel-a\"" );
+    pB = strstr( gResults, "name=\"ut-parallel-b\"" );
+    pC = strstr( gResults, "name=\"ut-parallel-c\"" );
+    UT_ASSERT_FATAL( (pA != NULL) && (pB != NULL) && (pC != NULL) );
+    UT_ASSERT( (pA < pC) && (pC < pB) );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 7 );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testsuites " ), 1 );
+    UT_ASSERT( strstr( gResults, "name=\"b pass again\"" ) != NULL );
+    UT_ASSERT_EQUAL( leftover, 0 );
+}
+
+static void test_parallel_worker_crash( void )
+{
+    const char *pB;
+    int leftover;
+
+    UT_ASSERT_FATAL( runPool( "parallel crash", &leftover ) );
+
+    /* Each test of the worker that died is written as failed, the other worker's results are kept */
+    UT_ASSERT( strstr( gResults, "<testsuites errors=\"0\" failures=\"4\" tests=\"7\" name=\"\">" ) != NULL );
+    UT_ASSERT_EQUAL( countOf( gResults, "<failure message=\"Worker terminated abnormally before reporting its results\"" ), 3 );
+    pB = strstr( gResults, "<testsuite errors=\"0\" failures=\"3\" tests=\"3\" name=\"ut-parallel-b\"" );
+    UT_ASSERT_FATAL( pB != NULL );
+    UT_ASSERT( strstr( pB, "name=\"b pass\"" ) != NULL );
+    UT_ASSERT( strstr( pB, "name=\"b pass again\"" ) != NULL );
+    UT_ASSERT( strstr( pB, "name=\"b crash\"" ) != NULL );
+    UT_ASSERT( strstr( gResults, "name=\"ut-parallel-a\"" ) != NULL );
+    UT_ASSERT( strstr( gResults, "name=\"ut-parallel-c\"" ) != NULL );
+    UT_ASSERT( strstr( gResults, "name=\"serial in runner\"" ) != NULL );
+    UT_ASSERT_EQUAL( leftover, 0 );
+}
+
+void register_parallel_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strncmp( UT_test_runner_target(), "parallel ", 9 ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpParallelSuite = UT_add_suite_withGroupID("ut-parallel", NULL, NULL, UT_TESTS_L2);
+    assert(gpParallelSuite != NULL);
+
+    UT_add_test(gpParallelSuite, "parallel pool", test_parallel_pool);
+    UT_add_test(gpParallelSuite, "parallel merge", test_parallel_merge);
+    UT_add_test(gpParallelSuite, "parallel worker crash", test_parallel_worker_crash);
+}
@@ -0,0 +1,170 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (16384)
+#define PERF_PROPERTY "<property name=\"perf_"
+
+static UT_test_suite_t *gpPerfSuite = NULL;
+static char gResults[RESULTS_SIZE];
+
+/* Target suite, only registered in the runner copy */
+static void test_target_counted( void )
+{
+    volatile unsigned long total = 0;
+
+    for (unsigned long i = 0; i < 100000; i++)
+    {
+        total += i;
+    }
+    UT_ASSERT( total > 0 );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite = UT_add_suite_withGroupID("ut-perf-target", NULL, NULL, UT_TESTS_L3);
+
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "counted 1", test_target_counted);
+    UT_add_test(pSuite, "counted 2", test_target_counted);
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+/* Checks whether this process may count its own context switches, the counter every kernel has */
+static bool softwareCounterAvailable( void )
+{
+    struct perf_event_attr attr;
+    int fd;
+
+    memset( &attr, 0, sizeof(attr) );
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = (int)syscall( __NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC );
+    if ( fd < 0 )
+    {
+        return false;
+    }
+    close( fd );
+    return true;
+}
+
+/* Checks that every counter property is one of the counters, with a whole number value */
+static bool propertiesWellFormed( const char *pResults )
+{
+    static const char *const names[] = { "cycles", "instructions", "cache_misses", "context_switches", "page_faults" };
+
+    for (const char *p = strstr( pResults, PERF_PROPERTY ); p != NULL; p = strstr( p + 1, PERF_PROPERTY ))
+    {
+        const char *pName = p + strlen( PERF_PROPERTY );
+        const char *pValue = NULL;
+
+        for (size_t i = 0; (i < sizeof(names) / sizeof(names[0])) && (pValue == NULL); i++)
+        {
+            if ( (strncmp( pName, names[i], strlen( names[i] ) ) == 0) &&
+                 (strncmp( pName + strlen( names[i] ), "\" value=\"", 9 ) == 0) )
+            {
+                pValue = pName + strlen( names[i] ) + 9;
+            }
+        }
+        if ( (pValue == NULL) || (strspn( pValue, "0123456789" ) == 0) || (strncmp( pValue + strspn( pValue, "0123456789" ), "\"/>", 3 ) != 0) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_perf_counters( void )
+{
+    static const char *const options[] = { "--perf", NULL };
+    int others;
+
+    UT_ASSERT_FATAL( UT_test_runner_copy( "perf", options, gResults, sizeof(gResults), &others ) );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 2 );
+    UT_ASSERT( strstr( gResults, "<failure " ) == NULL );
+    UT_ASSERT( propertiesWellFormed( gResults ) );
+    UT_ASSERT_EQUAL( others, 0 );
+
+    /* Each test has the same counters, and at least the context switches wherever they can be counted */
+    UT_ASSERT_EQUAL( countOf( gResults, PERF_PROPERTY ) % 2, 0 );
+    if ( softwareCounterAvailable() )
+    {
+        UT_ASSERT_EQUAL( countOf( gResults, PERF_PROPERTY "context_switches\" value=\"" ), 2 );
+    }
+    else
+    {
+        UT_LOG_WARNING( "perf_event_open() is not permitted here, only the run without counters is checked" );
+        UT_ASSERT_EQUAL( countOf( gResults, PERF_PROPERTY ), 0 );
+    }
+}
+
+static void test_perf_disabled( void )
+{
+    int others;
+
+    /* Without --perf the tests are not counted */
+    UT_ASSERT_FATAL( UT_test_runner_copy( "perf", NULL, gResults, sizeof(gResults), &others ) );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 2 );
+    UT_ASSERT_EQUAL( countOf( gResults, PERF_PROPERTY ), 0 );
+    UT_ASSERT_EQUAL( others, 0 );
+}
+
+void register_perf_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "perf" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpPerfSuite = UT_add_suite_withGroupID("ut-perf", NULL, NULL, UT_TESTS_L2);
+    assert(gpPerfSuite != NULL);
+
+    UT_add_test(gpPerfSuite, "perf counters", test_perf_counters);
+    UT_add_test(gpPerfSuite, "perf disabled", test_perf_disabled);
+}
@@ -0,0 +1,250 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include "ut_test_runner.h"
+
+#define RESULTS_SIZE (32768)
+#define CACHE_RUNS_ENV "UT_TEST_CACHE_RUNS"     /*!< File the target tests record each run in */
+#define CACHE_LONG_NAME_SIZE (301)              /*!< Escaped, the long suite name is past the lookup buffer */
+#define CACHE_MAGIC "ut-core-result-cache 1 "
+
+static UT_test_suite_t *gpResultCacheSuite = NULL;
+static char gResults[RESULTS_SIZE];
+static char gFirstResults[RESULTS_SIZE];
+static char gCache[RESULTS_SIZE];
+static char gRuns[RESULTS_SIZE];
+static char gLongName[CACHE_LONG_NAME_SIZE];
+
+/* Target suites, only registered in the runner copy */
+static void recordRun( const char *pName )
+{
+    const char *pRunsFile = getenv( CACHE_RUNS_ENV );
+    FILE *pFile = (pRunsFile != NULL) ? fopen( pRunsFile, "a" ) : NULL;
+
+    if ( pFile != NULL )
+    {
+        fprintf( pFile, "%s\n", pName );
+        fclose( pFile );
+    }
+}
+
+static void test_target_pass( void )
+{
+    recordRun( "pass" );
+    UT_ASSERT( true );
+}
+
+static void test_target_fail( void )
+{
+    recordRun( "fail" );
+    UT_FAIL( "cache target failure" );
+}
+
+static void test_target_long( void )
+{
+    recordRun( "long" );
+    UT_ASSERT( true );
+}
+
+static void registerTargets( void )
+{
+    UT_test_suite_t *pSuite;
+
+    pSuite = UT_add_suite_withGroupID("ut-cache-pass", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "pass", test_target_pass);
+
+    pSuite = UT_add_suite_withGroupID("ut-cache-fail", NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "fail", test_target_fail);
+
+    /* Passes, but its escaped name is too long to be looked up, so it always runs */
+    memset( gLongName, '&', sizeof(gLongName) - 1 );
+    gLongName[sizeof(gLongName) - 1] = '\0';
+    pSuite = UT_add_suite_withGroupID(gLongName, NULL, NULL, UT_TESTS_L3);
+    assert(pSuite != NULL);
+    UT_add_test(pSuite, "long", test_target_long);
+}
+
+static int countOf( const char *pText, const char *pPart )
+{
+    int count = 0;
+
+    for (const char *p = strstr( pText, pPart ); p != NULL; p = strstr( p + 1, pPart ))
+    {
+        count++;
+    }
+    return count;
+}
+
+static void readFile( const char *pFilename, char *pBuffer, size_t size )
+{
+    FILE *pFile = fopen( pFilename, "r" );
+    size_t length = 0;
+
+    if ( pFile != NULL )
+    {
+        length = fread( pBuffer, 1, size - 1, pFile );
+        fclose( pFile );
+    }
+    pBuffer[length] = '\0';
+}
+
+/**
+ * @brief Runs the target suites with a cache file and reads back the results, the cache and the tests that ran
+ *
+ * @param pDir - directory of the cache and runs files
+ * @param ppOptions - options added to the --cache one, NULL terminated, or NULL for none
+ */
+static bool runCached( const char *pDir, const char *const *ppOptions )
+{
+    const char *options[8] = { "--cache", NULL };
+    char cacheFile[256];
+    char runsFile[256];
+    int count = 2;
+    int others;
+    bool bResult;
+
+    snprintf( cacheFile, sizeof(cacheFile), "%s/cache", pDir );
+    snprintf( runsFile, sizeof(runsFile), "%s/runs", pDir );
+    options[1] = cacheFile;
+    for (int i = 0; (ppOptions != NULL) && (ppOptions[i] != NULL) && (count < 7); i++)
+    {
+        options[count++] = ppOptions[i];
+    }
+    options[count] = NULL;
+
+    remove( runsFile );
+    setenv( CACHE_RUNS_ENV, runsFile, 1 );
+    bResult = UT_test_runner_copy( "result cache", options, gResults, sizeof(gResults), &others );
+    unsetenv( CACHE_RUNS_ENV );
+
+    readFile( cacheFile, gCache, sizeof(gCache) );
+    readFile( runsFile, gRuns, sizeof(gRuns) );
+    return bResult && (others == 0);
+}
+
+/* Gets the key of the cache file, 0 if there is none */
+static unsigned long long cacheKey( void )
+{
+    return (strncmp( gCache, CACHE_MAGIC, strlen( CACHE_MAGIC ) ) == 0) ? strtoull( gCache + strlen( CACHE_MAGIC ), NULL, 16 ) : 0;
+}
+
+/* Gets the testsuite block of the passing suite, or NULL */
+static char *passBlock( char *pText )
+{
+    char *pStart = strstr( pText, "<testsuite errors=\"0\" failures=\"0\" tests=\"1\" name=\"ut-cache-pass\"" );
+    char *pEnd = (pStart != NULL) ? strstr( pStart, "</testsuite>" ) : NULL;
+
+    if ( pEnd == NULL )
+    {
+        return NULL;
+    }
+    pEnd[strlen( "</testsuite>" )] = '\0';
+    return pStart;
+}
+
+static void test_result_cache( void )
+{
+    static const char *const timeout[] = { "--test-timeout", "30", NULL };
+    static const char *const groups[] = { "-d", "4", NULL };
+    static const char *const noCache[] = { "--no-cache", NULL };
+    char dir[] = "/tmp/ut-result-cache-XXXXXX";
+    char path[256];
+    unsigned long long key;
+    const char *pSpliced;
+    char *pBlock;
+
+    UT_ASSERT_FATAL( mkdtemp( dir ) != NULL );
+
+    /* Miss: every suite runs, only the passing ones are stored under the key */
+    UT_ASSERT_FATAL( runCached( dir, NULL ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 1 );
+    UT_ASSERT_EQUAL( countOf( gRuns, "fail\n" ), 1 );
+    UT_ASSERT_EQUAL( countOf( gRuns, "long\n" ), 1 );
+    key = cacheKey();
+    UT_ASSERT( key != 0 );
+    UT_ASSERT( strstr( gCache, "name=\"ut-cache-pass\"" ) != NULL );
+    UT_ASSERT( strstr( gCache, "name=\"ut-cache-fail\"" ) == NULL );
+    memcpy( gFirstResults, gResults, sizeof(gResults) );
+    pBlock = passBlock( gFirstResults );
+    UT_ASSERT_FATAL( pBlock != NULL );
+
+    /* Hit: the passing suite is skipped and its block spliced in as it was, the failing one runs again */
+    UT_ASSERT_FATAL( runCached( dir, NULL ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 0 );
+    UT_ASSERT_EQUAL( countOf( gRuns, "fail\n" ), 1 );
+    UT_ASSERT_EQUAL( cacheKey(), key );
+    pSpliced = strstr( gResults, pBlock );
+    UT_ASSERT( pSpliced != NULL );
+    UT_ASSERT_EQUAL( countOf( gResults, "<testcase " ), 3 );
+    UT_ASSERT_EQUAL( countOf( gResults, "<failure " ), 1 );
+    UT_ASSERT( strstr( gResults, "cache target failure" ) != NULL );
+
+    /* A suite name that cannot be looked up runs again rather than matching another */
+    UT_ASSERT_EQUAL( countOf( gRuns, "long\n" ), 1 );
+
+    /* The options that can change a result are part of the key, each change is a miss */
+    UT_ASSERT_FATAL( runCached( dir, timeout ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 1 );
+    UT_ASSERT( (cacheKey() != 0) && (cacheKey() != key) );
+    UT_ASSERT_FATAL( runCached( dir, groups ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 1 );
+    UT_ASSERT( (cacheKey() != 0) && (cacheKey() != key) );
+
+    /* Back to the first options, with --no-cache every suite runs and the cache is refreshed */
+    UT_ASSERT_FATAL( runCached( dir, noCache ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 1 );
+    UT_ASSERT_EQUAL( cacheKey(), key );
+    UT_ASSERT_FATAL( runCached( dir, NULL ) );
+    UT_ASSERT_EQUAL( countOf( gRuns, "pass\n" ), 0 );
+
+    snprintf( path, sizeof(path), "%s/cache", dir );
+    remove( path );
+    snprintf( path, sizeof(path), "%s/runs", dir );
+    remove( path );
+    rmdir( dir );
+}
+
+void register_result_cache_testing_functions(void)
+{
+    if ( UT_test_runner_target() != NULL )
+    {
+        if ( strcmp( UT_test_runner_target(), "result cache" ) == 0 )
+        {
+            registerTargets();
+        }
+        return;
+    }
+
+    gpResultCacheSuite = UT_add_suite_withGroupID("ut-result-cache", NULL, NULL, UT_TESTS_L2);
+    assert(gpResultCacheSuite != NULL);
+
+    UT_add_test(gpResultCacheSuite, "result cache", test_result_cache);
+}
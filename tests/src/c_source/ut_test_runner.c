@@ -0,0 +1,136 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* Module Includes */
+#include "ut_test_runner.h"
+
+#define RUNNER_MAX_ARGS (32)
+#define RUNNER_LOG "ut-log.log"
+#define RUNNER_RESULTS "ut-log.log-Results.xml"
+
+const char *UT_test_runner_target( void )
+{
+    return getenv( UT_TEST_TARGET_ENV );
+}
+
+bool UT_test_runner_in_copy( void )
+{
+    const char *pPid = getenv( UT_TEST_RUNNER_PID_ENV );
+
+    return (pPid != NULL) && (atoi( pPid ) == (int)getpid());
+}
+
+/* Removes the files of the copy, counting the ones beside its log and results file */
+static int removeDirectory( const char *pDir )
+{
+    char path[512];
+    struct dirent *pEntry;
+    DIR *pDirectory = opendir( pDir );
+    int others = 0;
+
+    if ( pDirectory == NULL )
+    {
+        return -1;
+    }
+    while ( (pEntry = readdir( pDirectory )) != NULL )
+    {
+        if ( (strcmp( pEntry->d_name, "." ) == 0) || (strcmp( pEntry->d_name, ".." ) == 0) )
+        {
+            continue;
+        }
+        if ( (strcmp( pEntry->d_name, RUNNER_LOG ) != 0) && (strcmp( pEntry->d_name, RUNNER_RESULTS ) != 0) )
+        {
+            others++;
+        }
+        snprintf( path, sizeof(path), "%s/%s", pDir, pEntry->d_name );
+        remove( path );
+    }
+    closedir( pDirectory );
+    rmdir( pDir );
+    return others;
+}
+
+bool UT_test_runner_copy( const char *pTarget, const char *const *ppOptions, char *pResults, size_t size, int *pOtherFiles )
+{
+    char dir[] = "/tmp/ut-runner-XXXXXX";
+    char results[512];
+    size_t length = 0;
+    int status = -1;
+    FILE *pFile;
+    pid_t pid;
+
+    pResults[0] = '\0';
+    *pOtherFiles = -1;
+    if ( mkdtemp( dir ) == NULL )
+    {
+        return false;
+    }
+    fflush( NULL );
+    pid = fork();
+    if ( pid == 0 )
+    {
+        /* The groups of the binary's own suites are disabled, the target suites are in the others */
+        const char *argv[RUNNER_MAX_ARGS] = { "ut-test", "-a", "-l", dir, "-d", "1", "-d", "2", "-d", "9" };
+        int argc = 10;
+        char pidValue[32];
+        int devNull = open( "/dev/null", O_WRONLY );
+
+        for (int i = 0; (ppOptions != NULL) && (ppOptions[i] != NULL) && (argc < (RUNNER_MAX_ARGS - 1)); i++)
+        {
+            argv[argc++] = ppOptions[i];
+        }
+        argv[argc] = NULL;
+
+        if ( devNull >= 0 )
+        {
+            dup2( devNull, STDOUT_FILENO );
+            dup2( devNull, STDERR_FILENO );
+            close( devNull );
+        }
+        snprintf( pidValue, sizeof(pidValue), "%d", (int)getpid() );
+        setenv( UT_TEST_TARGET_ENV, pTarget, 1 );
+        setenv( UT_TEST_RUNNER_PID_ENV, pidValue, 1 );
+        execv( "/proc/self/exe", (char *const *)argv );
+        _exit( 127 );
+    }
+    if ( pid > 0 )
+    {
+        waitpid( pid, &status, 0 );
+    }
+
+    snprintf( results, sizeof(results), "%s/%s", dir, RUNNER_RESULTS );
+    pFile = fopen( results, "r" );
+    if ( pFile != NULL )
+    {
+        length = fread( pResults, 1, size - 1, pFile );
+        fclose( pFile );
+    }
+    pResults[length] = '\0';
+    *pOtherFiles = removeDirectory( dir );
+    return (pid > 0) && WIFEXITED( status ) && (WEXITSTATUS( status ) == 0) && (length > 0);
+}
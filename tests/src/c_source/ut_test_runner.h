@@ -0,0 +1,62 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @brief
+ * Runs a copy of the test binary, for the tests of the runner itself: the pool, the results file
+ * and the options that act on a whole run.
+ *
+ * The copy is started with UT_TEST_TARGET_ENV set to the target. A register function that sees it
+ * registers the suites of that target, in UT_TESTS_L3 or UT_TESTS_L4, and not its own tests. The
+ * other groups of the binary are disabled in the copy, so only the target suites run.
+ */
+
+#ifndef __UT_TEST_RUNNER_H
+#define __UT_TEST_RUNNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define UT_TEST_TARGET_ENV "UT_TEST_TARGET"         /*!< Target of the copy, the suites it registers */
+#define UT_TEST_RUNNER_PID_ENV "UT_TEST_RUNNER_PID" /*!< Process ID of the copy */
+
+/**
+ * @brief Gets the target of this process
+ *
+ * @return const char* - the target, NULL unless this is a copy started by UT_test_runner_copy()
+ */
+const char *UT_test_runner_target( void );
+
+/**
+ * @brief Checks whether this is the copy itself, rather than a worker forked by it
+ */
+bool UT_test_runner_in_copy( void );
+
+/**
+ * @brief Runs a copy of the test binary in Automated Mode and reads back its results file
+ *
+ * @param pTarget - target of the copy
+ * @param ppOptions - further options of the copy, NULL terminated, or NULL for none
+ * @param pResults - filled with the results file, 0 terminated
+ * @param size - size of pResults
+ * @param pOtherFiles - set to the number of files left by the copy beside its log and results file
+ * @return bool - true if the copy exited with 0 and wrote a results file
+ */
+bool UT_test_runner_copy( const char *pTarget, const char *const *ppOptions, char *pResults, size_t size, int *pOtherFiles );
+
+#endif  /*  __UT_TEST_RUNNER_H  */
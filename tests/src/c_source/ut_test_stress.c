@@ -0,0 +1,184 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_stress.h>
+
+#define REPORT_SIZE (8192)
+#define TIMED_RUNS (100)
+
+static UT_test_suite_t *gpStressSuite = NULL;
+static char gReportFile[512];
+static char gRecordsFile[512];
+static char gReport[REPORT_SIZE];
+
+/* The stress state is the run's own, the tests need it to themselves */
+static bool stressInUse( void )
+{
+    const char *pLogFile = UT_log_getLogFilename();
+    char root[480];
+    char *pDot;
+
+    if ( UT_stress_enabled() )
+    {
+        UT_LOG_WARNING( "--repeat, --repeat-for or --until-fail is set, the test is not run" );
+        return true;
+    }
+
+    /* Named after the log, as UT_stress_begin() names them */
+    snprintf( root, sizeof(root), "%s", ((pLogFile != NULL) && (pLogFile[0] != '\0')) ? pLogFile : "/tmp/ut-log.log" );
+    pDot = strrchr( root, '.' );
+    if ( (pDot != NULL) && (strchr( pDot, '/' ) == NULL) )
+    {
+        *pDot = '\0';
+    }
+    snprintf( gReportFile, sizeof(gReportFile), "%s-flaky.json", root );
+    snprintf( gRecordsFile, sizeof(gRecordsFile), "%s-stress.runs", root );
+    return false;
+}
+
+/* Ends the stress run, reads its report back and turns stress runs off again */
+static bool endStress( void )
+{
+    FILE *pReport;
+    size_t length = 0;
+
+    UT_stress_end();
+    UT_stress_configure( 0, 0, false );
+
+    gReport[0] = '\0';
+    pReport = fopen( gReportFile, "r" );
+    if ( pReport == NULL )
+    {
+        return false;
+    }
+    length = fread( gReport, 1, sizeof(gReport) - 1, pReport );
+    gReport[length] = '\0';
+    fclose( pReport );
+    remove( gReportFile );
+    return length > 0;
+}
+
+static const char *findTest( const char *pName )
+{
+    char key[64];
+
+    snprintf( key, sizeof(key), "{\"name\": \"%s\"", pName );
+    return strstr( gReport, key );
+}
+
+static void test_stress_report( void )
+{
+    const char *pFlaky;
+    const char *pFailing;
+    const char *pPassing;
+
+    if ( stressInUse() )
+    {
+        return;
+    }
+    UT_stress_configure( 3, 0, false );
+    UT_ASSERT_FATAL( UT_stress_begin() == 0 );
+
+    /* The durations are recorded out of order, 1 to TIMED_RUNS microseconds */
+    for (int i = 0; i < TIMED_RUNS; i++)
+    {
+        UT_stress_record( "stress", "passing", true, (uint64_t)(((i * 37) % TIMED_RUNS) + 1) * 1000 );
+    }
+    for (unsigned int iteration = 1; iteration <= 3; iteration++)
+    {
+        UT_stress_record( "stress", "flaky", iteration != 2, 5000 );
+        UT_stress_record( "stress", "failing", false, 1000 );
+        UT_ASSERT( UT_stress_next() == (iteration < 3) );
+    }
+
+    UT_ASSERT_FATAL( endStress() );
+    UT_ASSERT( access( gRecordsFile, F_OK ) != 0 );
+    UT_ASSERT( strstr( gReport, "\"iterations\": 3," ) != NULL );
+
+    /* Flaky first, then failing, then passing */
+    pFlaky = findTest( "stress.flaky" );
+    pFailing = findTest( "stress.failing" );
+    pPassing = findTest( "stress.passing" );
+    UT_ASSERT_FATAL( (pFlaky != NULL) && (pFailing != NULL) && (pPassing != NULL) );
+    UT_ASSERT( (pFlaky < pFailing) && (pFailing < pPassing) );
+
+    UT_ASSERT( strstr( gReport, "{\"name\": \"stress.flaky\", \"status\": \"flaky\", \"runs\": 3, \"failures\": 1, \"passRate\": 0.6667, \"failedIterations\": [2]" ) == pFlaky );
+    UT_ASSERT( strstr( pFailing, "\"status\": \"failing\", \"runs\": 3, \"failures\": 3, \"passRate\": 0.0000, \"failedIterations\": [1, 2, 3]" ) != NULL );
+
+    /* Nearest rank percentiles, the population standard deviation of 1 to 100 is 28.87 */
+    UT_ASSERT( strstr( pPassing, "\"status\": \"passing\", \"runs\": 100, \"failures\": 0" ) != NULL );
+    UT_ASSERT( strstr( pPassing, "\"us\": {\"min\": 1, \"mean\": 50.5, \"stddev\": 28.9, \"p50\": 50, \"p90\": 90, \"p99\": 99, \"max\": 100}" ) != NULL );
+}
+
+static void test_stress_until_fail( void )
+{
+    pid_t pid;
+    int status = -1;
+
+    if ( stressInUse() )
+    {
+        return;
+    }
+    UT_stress_configure( 0, 0, true );
+    UT_ASSERT_FATAL( UT_stress_begin() == 0 );
+
+    UT_stress_record( "stress", "other", true, 1000 );
+    UT_stress_record( "stress", "worker", true, 1000 );
+    UT_ASSERT( UT_stress_next() );
+
+    /* A failure recorded by another process, as a -j or isolation worker does, is read from the records */
+    pid = fork();
+    if ( pid == 0 )
+    {
+        UT_stress_record( "stress", "worker", false, 1000 );
+        _exit( 0 );
+    }
+    if ( pid > 0 )
+    {
+        waitpid( pid, &status, 0 );
+    }
+    UT_stress_record( "stress", "other", true, 1000 );
+    UT_ASSERT( UT_stress_next() == false );
+
+    UT_ASSERT_FATAL( endStress() );
+    UT_ASSERT_FATAL( pid > 0 );
+    UT_ASSERT( strstr( gReport, "\"iterations\": 2," ) != NULL );
+    UT_ASSERT( strstr( gReport, "{\"name\": \"stress.worker\", \"status\": \"flaky\", \"runs\": 2, \"failures\": 1, \"passRate\": 0.5000, \"failedIterations\": [2]" ) != NULL );
+    UT_ASSERT( strstr( gReport, "{\"name\": \"stress.other\", \"status\": \"passing\", \"runs\": 2, \"failures\": 0" ) != NULL );
+}
+
+void register_stress_testing_functions(void)
+{
+    gpStressSuite = UT_add_suite_withGroupID("ut-stress", NULL, NULL, UT_TESTS_L1);
+    assert(gpStressSuite != NULL);
+
+    UT_add_test(gpStressSuite, "stress report", test_stress_report);
+    UT_add_test(gpStressSuite, "stress until fail", test_stress_until_fail);
+}
@@ -0,0 +1,230 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Standard Libraries */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+/* Module Includes */
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_trace.h>
+
+#define TRACE_MAX_EVENTS (32)
+#define TRACE_EVENT_SIZE (64)
+
+static UT_test_suite_t *gpTraceSuite = NULL;
+static char gTraceFile[] = "/tmp/ut-test-trace-XXXXXX";
+
+/* Each event read back as "<ev>" or "<ev>:<suite>" for the suite events */
+static char gEvents[TRACE_MAX_EVENTS][TRACE_EVENT_SIZE];
+static int gEventCount;
+static char gLogLine[UT_LOG_MAX_LINE_SIZE * 2];
+
+static int test_trace_init( void )
+{
+    int fd = mkstemp( gTraceFile );
+
+    if ( fd < 0 )
+    {
+        return -1;
+    }
+    close( fd );
+    return 0;
+}
+
+/* The trace of the run is the only trace, the tests need it to themselves */
+static bool traceInUse( void )
+{
+    if ( UT_trace_enabled() )
+    {
+        UT_LOG_WARNING( "--trace is set, the test is not run" );
+        return true;
+    }
+    truncate( gTraceFile, 0 );
+    return false;
+}
+
+static int test_trace_clean( void )
+{
+    unlink( gTraceFile );
+    return 0;
+}
+
+/* Copies the string value of pKey on pLine to pValue, false if there is none */
+static bool getField( const char *pLine, const char *pKey, char *pValue, size_t size )
+{
+    char key[32];
+    const char *pStart;
+    const char *pEnd;
+
+    snprintf( key, sizeof(key), "\"%s\":\"", pKey );
+    pStart = strstr( pLine, key );
+    if ( pStart == NULL )
+    {
+        return false;
+    }
+    pStart += strlen( key );
+    for (pEnd = pStart; (*pEnd != '\0') && (*pEnd != '"'); pEnd++)
+    {
+        if ( (*pEnd == '\\') && (pEnd[1] != '\0') )
+        {
+            pEnd++;
+        }
+    }
+    snprintf( pValue, size, "%.*s", (int)(pEnd - pStart), pStart );
+    return true;
+}
+
+/* Reads the trace back, every line must be one whole event */
+static bool readTrace( void )
+{
+    char line[UT_LOG_MAX_LINE_SIZE * 8];
+    char type[TRACE_EVENT_SIZE / 2];
+    char suite[TRACE_EVENT_SIZE / 2];
+    FILE *pTrace = fopen( gTraceFile, "r" );
+    bool bWhole = true;
+
+    gEventCount = 0;
+    gLogLine[0] = '\0';
+    if ( pTrace == NULL )
+    {
+        return false;
+    }
+    while ( fgets( line, sizeof(line), pTrace ) != NULL )
+    {
+        size_t length = strlen( line );
+
+        bWhole = bWhole && (line[0] == '{') && (length > 2) && (strcmp( &line[length - 2], "}\n" ) == 0);
+        if ( (getField( line, "ev", type, sizeof(type) ) == false) || (gEventCount == TRACE_MAX_EVENTS) )
+        {
+            bWhole = false;
+            continue;
+        }
+        if ( strncmp( type, "suite_", 6 ) == 0 )
+        {
+            getField( line, "suite", suite, sizeof(suite) );
+            snprintf( gEvents[gEventCount++], TRACE_EVENT_SIZE, "%s:%s", type, suite );
+        }
+        else
+        {
+            snprintf( gEvents[gEventCount++], TRACE_EVENT_SIZE, "%s", type );
+        }
+        if ( strcmp( type, "log" ) == 0 )
+        {
+            snprintf( gLogLine, sizeof(gLogLine), "%s", line );
+        }
+    }
+    fclose( pTrace );
+    return bWhole;
+}
+
+static bool expectEvents( const char **ppExpected, int count )
+{
+    if ( gEventCount != count )
+    {
+        UT_LOG_ERROR( "[%d] events in the trace, expected [%d]", gEventCount, count );
+        return false;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if ( strcmp( gEvents[i], ppExpected[i] ) != 0 )
+        {
+            UT_LOG_ERROR( "Event [%d] is [%s], expected [%s]", i, gEvents[i], ppExpected[i] );
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_trace_pairing( void )
+{
+    static const char *pExpected[] =
+    {
+        "run_start",
+        "suite_start:alpha", "test_start", "assert", "test_end",
+        "suite_end:alpha", "suite_start:beta", "test_start", "test_end", "suite_end:beta",
+        "suite_start:gamma", "test_start", "test_end", "suite_end:gamma",
+        "run_end",
+    };
+
+    if ( traceInUse() )
+    {
+        return;
+    }
+    UT_ASSERT_FATAL( UT_trace_open( gTraceFile ) == 0 );
+
+    UT_trace_suiteStart( "alpha" );
+    UT_trace_testStart( "alpha", "first" );
+    UT_trace_assert( "file.c", 1, "condition", false, false );
+    UT_trace_testEnd( "failed", 1, 1 );
+
+    /* A test of another suite ends the open suite, ending it twice writes one suite_end */
+    UT_trace_testStart( "beta", "second" );
+    UT_trace_testEnd( "passed", 0, 0 );
+    UT_trace_suiteEnd();
+    UT_trace_suiteEnd();
+
+    /* A suite left open is ended by the close */
+    UT_trace_testStart( "gamma", "third" );
+    UT_trace_testEnd( "passed", 0, 0 );
+    UT_trace_close();
+
+    UT_ASSERT( readTrace() );
+    UT_ASSERT( expectEvents( pExpected, sizeof(pExpected) / sizeof(pExpected[0]) ) );
+}
+
+static void test_trace_escaping( void )
+{
+    char value[UT_LOG_MAX_LINE_SIZE];
+
+    if ( traceInUse() )
+    {
+        return;
+    }
+    UT_ASSERT_FATAL( UT_trace_open( gTraceFile ) == 0 );
+    UT_trace_log( "dir\\file.c", 7, "\"prefix\"",
+                  "quote\" backslash\\ newline\n tab\t cr\r bell\a " UT_LOG_ASCII_RED "red" UT_LOG_ASCII_NC " end" );
+    UT_trace_close();
+
+    UT_ASSERT_FATAL( readTrace() );
+    UT_ASSERT_FATAL( gLogLine[0] != '\0' );
+
+    UT_ASSERT( getField( gLogLine, "file", value, sizeof(value) ) );
+    UT_ASSERT_STRING_EQUAL( value, "dir\\\\file.c" );
+    UT_ASSERT( getField( gLogLine, "prefix", value, sizeof(value) ) );
+    UT_ASSERT_STRING_EQUAL( value, "\\\"prefix\\\"" );
+
+    /* The console colours are dropped, the other control characters escaped */
+    UT_ASSERT( getField( gLogLine, "msg", value, sizeof(value) ) );
+    UT_ASSERT_STRING_EQUAL( value, "quote\\\" backslash\\\\ newline\\n tab\\t cr\\r bell\\u0007 red end" );
+    UT_ASSERT( strstr( gLogLine, "\"line\":7," ) != NULL );
+}
+
+void register_trace_testing_functions(void)
+{
+    gpTraceSuite = UT_add_suite_withGroupID("ut-trace", test_trace_init, test_trace_clean, UT_TESTS_L1);
+    assert(gpTraceSuite != NULL);
+
+    UT_add_test(gpTraceSuite, "trace event pairing", test_trace_pairing);
+    UT_add_test(gpTraceSuite, "trace string escaping", test_trace_escaping);
+}
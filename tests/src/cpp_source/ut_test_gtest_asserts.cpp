@@ -21,6 +21,7 @@
 #define __TEST_UT_GTEST_H
 
 #include <ut.h>
+#include <time.h>
 
 // Test fixture class
 class UTGTestTest : public UTCore
@@ -278,4 +279,44 @@ UT_ADD_TEST(UTGTestTest, SameNameTest)
     UT_FAIL("This test has the same name as another test in a different suite");
 }
 
+static void sleepMs(unsigned int ms)
+{
+    struct timespec delay = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    nanosleep(&delay, nullptr);
+}
+
+// Test case for UT_ASSERT_DURATION_LESS
+UT_ADD_TEST(UTGTestTest, UT_ASSERT_DURATION_LESS_Test)
+{
+    UT_ASSERT_DURATION_LESS(sleepMs(1), 1000);
+}
+
+// Test case for UT_ASSERT_DURATION_LESS_FATAL
+UT_ADD_TEST(UTGTestTest, UT_ASSERT_DURATION_LESS_FATAL_Test)
+{
+    UT_ASSERT_DURATION_LESS_FATAL(sleepMs(1), 1000);
+}
+
+// Test case for UT_ASSERT_DURATION_LESS_PROFILE, the budget comes from the profile when present
+UT_ADD_TEST(UTGTestTest, UT_ASSERT_DURATION_LESS_PROFILE_Test)
+{
+    UT_ASSERT_DURATION_LESS_PROFILE(sleepMs(1), 1000, "durationTest/budgetMs");
+}
+
+// Test case for UT_ASSERT_DURATION_LESS_PROFILE_FATAL
+UT_ADD_TEST(UTGTestTest, UT_ASSERT_DURATION_LESS_PROFILE_FATAL_Test)
+{
+    UT_ASSERT_DURATION_LESS_PROFILE_FATAL(sleepMs(1), 1000, "durationTest/budgetMs");
+}
+
+static volatile int gBenchmarkCounter = 0;
+
+static void benchmarkIncrement(void)
+{
+    gBenchmarkCounter = gBenchmarkCounter + 1;
+}
+
+// Benchmark for UT_ADD_BENCHMARK
+UT_ADD_BENCHMARK(UTGTestTest, UT_ADD_BENCHMARK_Test, benchmarkIncrement)
+
 #endif  // __TEST_UT_GTEST_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <ut.h>
+#include "ut_filter.h"
+
+// Test fixture class
+class UTGTestFilterTest : public UTCore
+{
+};
+
+// Automatically register test suite before test execution
+UT_ADD_TEST_TO_GROUP(UTGTestFilterTest, UT_TESTS_L1)
+
+// Literal and prefix patterns are matched through the trie
+UT_ADD_TEST(UTGTestFilterTest, TriePatterns)
+{
+    UTFilterPatterns patterns;
+    patterns.add("Suite.*");
+    patterns.add("Other.Exact");
+
+    UT_ASSERT_TRUE(patterns.matches("Suite.Test"));
+    UT_ASSERT_TRUE(patterns.matches("Suite."));
+    UT_ASSERT_TRUE(patterns.matches("Other.Exact"));
+    UT_ASSERT_FALSE(patterns.matches("Other.Exactly"));
+    UT_ASSERT_FALSE(patterns.matches("MySuite.Test"));
+    UT_ASSERT_FALSE(patterns.matches("Suite"));
+}
+
+// Remaining wildcard patterns are matched as globs
+UT_ADD_TEST(UTGTestFilterTest, WildcardPatterns)
+{
+    UTFilterPatterns patterns;
+    patterns.add("*Suite.Te?t");
+    patterns.add("A*B*C");
+
+    UT_ASSERT_TRUE(patterns.matches("MySuite.Test"));
+    UT_ASSERT_TRUE(patterns.matches("Suite.Text"));
+    UT_ASSERT_FALSE(patterns.matches("Suite.Tests"));
+    UT_ASSERT_TRUE(patterns.matches("AxxBxxBC"));
+    UT_ASSERT_FALSE(patterns.matches("AxxCxxB"));
+
+    UTFilterPatterns all;
+    all.add("*");
+    UT_ASSERT_TRUE(all.matches(""));
+    UT_ASSERT_TRUE(all.matches("Anything.AtAll"));
+}
+
+// Filter strings are parsed into positive and negative patterns and formatted back
+UT_ADD_TEST(UTGTestFilterTest, FilterStrings)
+{
+    UTFilter filter("A.*:B.*:-C.*:-D.Test:*");
+
+    UT_ASSERT_TRUE(filter.isIncluded("A.Test"));
+    UT_ASSERT_FALSE(filter.isIncluded("C.Test"));
+    UT_ASSERT_TRUE(filter.isExcluded("C.Test"));
+    UT_ASSERT_TRUE(filter.isExcluded("D.Test"));
+    UT_ASSERT_FALSE(filter.isExcluded("D.Other"));
+    UT_ASSERT_EQUAL(filter.toString(), std::string("A.*:B.*:-C.*:-D.Test"));
+    UT_ASSERT_EQUAL(filter.negativeFilter(), std::string("-C.*:*D.Test"));
+
+    UTFilter empty("*");
+    UT_ASSERT_TRUE(empty.empty());
+    UT_ASSERT_EQUAL(empty.toString(), std::string("*"));
+    UT_ASSERT_EQUAL(empty.negativeFilter(), std::string("-"));
+}
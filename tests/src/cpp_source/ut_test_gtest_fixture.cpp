@@ -0,0 +1,81 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ut.h>
+
+static int gResource = 0;
+static int gSetUps = 0;
+static int gTearDowns = 0;
+
+static void *setUpResource(void)
+{
+    gSetUps++;
+    return &gResource;
+}
+
+static void tearDownResource(void *pHandle)
+{
+    if (pHandle == &gResource)
+    {
+        gTearDowns++;
+    }
+}
+
+static void *setUpFailing(void)
+{
+    return nullptr;
+}
+
+// Test fixture class
+class UTGTestFixtureTest : public UTCore
+{
+};
+
+// Automatically register test suite before test execution
+UT_ADD_TEST_TO_GROUP(UTGTestFixtureTest, UT_TESTS_L1)
+
+static UT_fixture_t *gpSuiteFixture = UT_add_fixture("UTGTestFixtureTest", "resource", setUpResource, tearDownResource);
+static UT_fixture_t *gpFailingFixture = UT_add_fixture("UTGTestFixtureTest", "failing", setUpFailing, nullptr);
+
+// Set up on first use, then shared by the tests of the suite until it ends
+UT_ADD_TEST(UTGTestFixtureTest, SetUpOnce)
+{
+    int setUps = gSetUps;
+    void *pFirst = UT_get_fixture(gpSuiteFixture);
+
+    UT_ASSERT_EQUAL(pFirst, static_cast<void *>(&gResource));
+    UT_ASSERT_EQUAL(UT_get_fixture(gpSuiteFixture), pFirst);
+    UT_ASSERT_LESS_EQUAL(gSetUps, setUps + 1);
+    UT_ASSERT_EQUAL(gSetUps, gTearDowns + 1);
+}
+
+UT_ADD_TEST(UTGTestFixtureTest, Shared)
+{
+    int setUps = gSetUps;
+
+    UT_ASSERT_EQUAL(UT_get_fixture(gpSuiteFixture), static_cast<void *>(&gResource));
+    UT_ASSERT_LESS_EQUAL(gSetUps, setUps + 1);
+    UT_ASSERT_EQUAL(gSetUps, gTearDowns + 1);
+}
+
+UT_ADD_TEST(UTGTestFixtureTest, FailedSetUp)
+{
+    UT_ASSERT_NULL(UT_get_fixture(gpFailingFixture));
+    UT_ASSERT_NULL(UT_get_fixture(gpFailingFixture));
+}
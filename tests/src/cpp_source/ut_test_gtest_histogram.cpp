@@ -0,0 +1,87 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <ut.h>
+#include "ut_histogram.h"
+
+// Test fixture class
+class UTGTestHistogramTest : public UTCore
+{
+};
+
+// Automatically register test suite before test execution
+UT_ADD_TEST_TO_GROUP(UTGTestHistogramTest, UT_TESTS_L1)
+
+// Every bucket starts where the previous one ended, small values are exact
+UT_ADD_TEST(UTGTestHistogramTest, BucketBoundaries)
+{
+    for (uint64_t value = 0; value < 64; ++value)
+    {
+        UT_ASSERT_EQUAL(UTHistogram::lowestValueOf(UTHistogram::bucketOf(value)), value);
+    }
+    for (size_t bucket = 1; bucket < 1024; ++bucket)
+    {
+        UT_ASSERT_EQUAL(UTHistogram::lowestValueOf(bucket), UTHistogram::highestValueOf(bucket - 1) + 1);
+    }
+    UT_ASSERT_EQUAL(UTHistogram::bucketOf(UTHistogram::highestValueOf(700)), 700u);
+    UT_ASSERT_EQUAL(UTHistogram::highestValueOf(UTHistogram::bucketOf(UINT64_MAX)), UINT64_MAX);
+}
+
+// Percentiles are within a bucket of the exact value, and capped by the values seen
+UT_ADD_TEST(UTGTestHistogramTest, Percentiles)
+{
+    UTHistogram histogram;
+
+    UT_ASSERT_EQUAL(histogram.percentile(50), 0u);
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value);
+    }
+
+    UT_ASSERT_EQUAL(histogram.count(), 1000u);
+    UT_ASSERT_EQUAL(histogram.min(), 1u);
+    UT_ASSERT_EQUAL(histogram.max(), 1000u);
+    UT_ASSERT_DOUBLE_EQUAL(histogram.mean(), 500.5, 0.001);
+    UT_ASSERT_TRUE((histogram.percentile(50) >= 500) && (histogram.percentile(50) < 500 + 500 / 32 + 1));
+    UT_ASSERT_TRUE((histogram.percentile(99) >= 990) && (histogram.percentile(99) <= 1000));
+    UT_ASSERT_EQUAL(histogram.percentile(100), 1000u);
+    UT_ASSERT_EQUAL(histogram.percentile(0), 1u);
+}
+
+// Merging gives the same counts as recording into one histogram
+UT_ADD_TEST(UTGTestHistogramTest, Merge)
+{
+    UTHistogram first;
+    UTHistogram second;
+
+    first.record(10);
+    first.record(100000);
+    second.record(3);
+    first.merge(second);
+
+    UT_ASSERT_EQUAL(first.count(), 3u);
+    UT_ASSERT_EQUAL(first.min(), 3u);
+    UT_ASSERT_EQUAL(first.max(), 100000u);
+    UT_ASSERT_EQUAL(first.buckets().size(), 3u);
+    UT_ASSERT_EQUAL(first.buckets().front().first, 3u);
+
+    first.clear();
+    UT_ASSERT_EQUAL(first.count(), 0u);
+    UT_ASSERT_TRUE(first.buckets().empty());
+}
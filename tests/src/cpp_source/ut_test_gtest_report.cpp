@@ -0,0 +1,191 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ut.h>
+#include "ut_report.h"
+
+// Test fixture class, each test has its own directory for the reports
+class UTGTestReportTest : public UTCore
+{
+protected:
+    void SetUp() override
+    {
+        char path[] = "/tmp/ut-report-XXXXXX";
+
+        UT_ASSERT_TRUE_FATAL(mkdtemp(path) != nullptr);
+        dir = path;
+    }
+
+    void TearDown() override
+    {
+        std::remove((dir + "/merged.xml").c_str());
+        rmdir(dir.c_str());
+    }
+
+    std::string write(const std::string &name, const std::string &content)
+    {
+        std::string filename = dir + "/" + name;
+        std::ofstream(filename) << content;
+        return filename;
+    }
+
+    std::string read(const std::string &name)
+    {
+        std::ifstream file(dir + "/" + name);
+        std::stringstream content;
+
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    bool exists(const std::string &name)
+    {
+        return access((dir + "/" + name).c_str(), F_OK) == 0;
+    }
+
+    // The exit status of a child that ended with the exit code, or was killed by the signal
+    static int childStatus(int exitCode, int signal)
+    {
+        int status = 0;
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            if (signal != 0)
+            {
+                raise(signal);
+            }
+            _exit(exitCode);
+        }
+        waitpid(pid, &status, 0);
+        return status;
+    }
+
+    static std::string report(const std::string &timestamp, const std::string &suites)
+    {
+        return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<testsuites tests=\"0\" failures=\"0\" disabled=\"0\" errors=\"0\" timestamp=\"" + timestamp + "\" time=\"1\" name=\"AllTests\">\n" +
+               suites + "</testsuites>\n";
+    }
+
+    static std::string suite(const std::string &name, int tests, int failures)
+    {
+        return "  <testsuite name=\"" + name + "\" tests=\"" + std::to_string(tests) + "\" failures=\"" + std::to_string(failures) +
+               "\" disabled=\"1\" skipped=\"0\" errors=\"0\" time=\"0\">\n"
+               "    <testcase name=\"" + name + "Case\" status=\"run\" result=\"completed\" time=\"0\" classname=\"" + name + "\" />\n"
+               "  </testsuite>\n";
+    }
+
+    std::string dir;
+};
+
+// Automatically register test suite before test execution
+UT_ADD_TEST_TO_GROUP(UTGTestReportTest, UT_TESTS_L1)
+
+// The suites are written in the given order, the ones not in it last, and the totals are summed
+UT_ADD_TEST(UTGTestReportTest, MergeInOrder)
+{
+    std::vector<std::pair<std::string, std::string>> reports = {
+        {write("worker0.xml", report("2024-01-01T00:00:00", suite("Beta", 2, 1) + suite("Extra", 1, 0))), ""},
+        {write("parent.xml", report("2024-01-02T00:00:00", suite("Alpha", 3, 0))), ""},
+    };
+
+    UTMergedReport merged = mergeReports(reports, {"Alpha", "Beta"}, dir + "/merged.xml", 2.5);
+    std::string xml = read("merged.xml");
+
+    UT_ASSERT_EQUAL(merged.tests, 6);
+    UT_ASSERT_EQUAL(merged.failures, 1);
+    UT_ASSERT_EQUAL(merged.disabled, 3);
+    UT_ASSERT_EQUAL(merged.errors, 0);
+    UT_ASSERT_TRUE(xml.find("<testsuites tests=\"6\" failures=\"1\" disabled=\"3\" errors=\"0\" timestamp=\"2024-01-01T00:00:00\" time=\"2.500\"") != std::string::npos);
+
+    size_t alpha = xml.find("<testsuite name=\"Alpha\"");
+    size_t beta = xml.find("<testsuite name=\"Beta\"");
+    size_t extra = xml.find("<testsuite name=\"Extra\"");
+    UT_ASSERT_TRUE_FATAL((alpha != std::string::npos) && (beta != std::string::npos) && (extra != std::string::npos));
+    UT_ASSERT_TRUE((alpha < beta) && (beta < extra));
+    UT_ASSERT_TRUE(xml.find("</testsuites>") > extra);
+
+    // The merged reports are removed
+    UT_ASSERT_FALSE(exists("worker0.xml"));
+    UT_ASSERT_FALSE(exists("parent.xml"));
+}
+
+// A report that is missing, or cut short, is replaced by its failed suites
+UT_ADD_TEST(UTGTestReportTest, MissingReports)
+{
+    std::string truncated = report("2024-01-01T00:00:00", suite("Gamma", 4, 0));
+    std::vector<std::pair<std::string, std::string>> reports = {
+        {dir + "/worker0.xml", missingSuiteBlock("Alpha", 0, childStatus(0, SIGKILL))},
+        {write("worker1.xml", truncated.substr(0, truncated.size() / 2)), missingSuiteBlock("Gamma", 1, childStatus(3, 0))},
+        {write("parent.xml", report("2024-01-01T00:00:00", suite("Beta", 1, 0))), ""},
+    };
+
+    UTMergedReport merged = mergeReports(reports, {"Alpha", "Beta", "Gamma"}, dir + "/merged.xml", 1.0);
+    std::string xml = read("merged.xml");
+
+    UT_ASSERT_EQUAL(merged.tests, 3);
+    UT_ASSERT_EQUAL(merged.failures, 2);
+    UT_ASSERT_TRUE(xml.find("Worker [0] left no report, killed by signal " + std::to_string(SIGKILL)) != std::string::npos);
+    UT_ASSERT_TRUE(xml.find("Worker [1] left no report, exited with code 3") != std::string::npos);
+    UT_ASSERT_TRUE(xml.find("<testsuite name=\"Alpha\"") < xml.find("<testsuite name=\"Beta\""));
+    UT_ASSERT_TRUE(xml.find("<testsuite name=\"Beta\"") < xml.find("<testsuite name=\"Gamma\""));
+    UT_ASSERT_FALSE(exists("worker1.xml"));
+}
+
+// The report of the timeout watchdog, built from the tests that have ended, merges like one from Google Test
+UT_ADD_TEST(UTGTestReportTest, WatchdogReport)
+{
+    UTReportTest passed;
+    UTReportTest hung;
+    UTReportTest skipped;
+    UTMergedReport totals;
+
+    passed.name = "Passed";
+    passed.seconds = 0.25;
+    hung.name = "Hung <a & b>";
+    hung.seconds = 1.5;
+    hung.failures.push_back("Test timeout of 1s exceeded by [Hung <a & b>]");
+    skipped.name = "Skipped";
+    skipped.skipped = true;
+    totals.tests = 3;
+    totals.failures = 1;
+
+    std::string block = testSuiteBlock("Suite\"1\"", {passed, hung, skipped});
+    UT_ASSERT_TRUE(block.find("<testsuite name=\"Suite&quot;1&quot;\" tests=\"3\" failures=\"1\" disabled=\"0\" skipped=\"1\" errors=\"0\" time=\"1.750\">") != std::string::npos);
+    UT_ASSERT_TRUE(block.find("<testcase name=\"Hung &lt;a &amp; b&gt;\" status=\"run\" result=\"completed\" time=\"1.500\" classname=\"Suite&quot;1&quot;\">") != std::string::npos);
+    UT_ASSERT_TRUE(block.find("<failure message=\"Test timeout of 1s exceeded by [Hung &lt;a &amp; b&gt;]\" type=\"\">") != std::string::npos);
+    UT_ASSERT_TRUE(block.find("<testcase name=\"Skipped\" status=\"run\" result=\"skipped\"") != std::string::npos);
+
+    UT_ASSERT_TRUE_FATAL(writeReport(dir + "/worker0.xml", totals, "2024-01-01T00:00:00", 2.0, block));
+    UTMergedReport merged = mergeReports({{dir + "/worker0.xml", ""}}, {"Suite\"1\""}, dir + "/merged.xml", 2.0);
+    std::string xml = read("merged.xml");
+
+    UT_ASSERT_EQUAL(merged.tests, 3);
+    UT_ASSERT_EQUAL(merged.failures, 1);
+    UT_ASSERT_TRUE(xml.find("left no report") == std::string::npos);
+    UT_ASSERT_TRUE(xml.find("<testcase name=\"Passed\"") != std::string::npos);
+}
@@ -0,0 +1,119 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+#include <ut.h>
+#include "ut_shard.h"
+
+// Test fixture class, each test has its own directory for the history reports
+class UTGTestShardTest : public UTCore
+{
+protected:
+    void SetUp() override
+    {
+        char path[] = "/tmp/ut-shard-XXXXXX";
+
+        UT_ASSERT_TRUE_FATAL(mkdtemp(path) != nullptr);
+        dir = path;
+    }
+
+    void TearDown() override
+    {
+        for (const auto &filename : files)
+        {
+            std::remove(filename.c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    std::string write(const std::string &name, const std::string &content)
+    {
+        std::string filename = dir + "/" + name;
+        std::ofstream(filename) << content;
+        files.push_back(filename);
+        return filename;
+    }
+
+    std::string dir;
+    std::vector<std::string> files;
+};
+
+// Automatically register test suite before test execution
+UT_ADD_TEST_TO_GROUP(UTGTestShardTest, UT_TESTS_L1)
+
+// Without history every test weighs the same, the suites go heaviest first to the least loaded shard
+UT_ADD_TEST(UTGTestShardTest, MembershipWithoutHistory)
+{
+    std::vector<UTDealtSuite> suites = {{"Delta", 2}, {"Alpha", 3}, {"Echo", 1}, {"Charlie", 2}, {"Bravo", 1}};
+    std::vector<double> load;
+
+    // Alpha 3 to 0, Charlie 2 to 1, Delta 2 to 1, then Bravo 1 to 0, Echo 1 to 0 as the ties go to the first shard
+    std::vector<int> owners = dealSuites(suites, 2, {}, load);
+    UT_ASSERT_TRUE(owners == std::vector<int>({1, 0, 0, 1, 0}));
+    UT_ASSERT_TRUE(load == std::vector<double>({5.0, 4.0}));
+
+    // The split depends on the suites, not on the order they are listed in
+    std::vector<UTDealtSuite> reordered = {suites[4], suites[3], suites[2], suites[1], suites[0]};
+    std::vector<int> reorderedOwners = dealSuites(reordered, 2, {}, load);
+    UT_ASSERT_TRUE(reorderedOwners == std::vector<int>({0, 1, 0, 0, 1}));
+}
+
+// Every suite is in exactly one shard, and a shard is left empty once there are more shards than suites
+UT_ADD_TEST(UTGTestShardTest, EverySuiteOnce)
+{
+    std::vector<UTDealtSuite> suites = {{"Alpha", 1}, {"Bravo", 1}, {"Charlie", 1}};
+    std::vector<double> load;
+
+    std::vector<int> owners = dealSuites(suites, 4, {}, load);
+    UT_ASSERT_TRUE(owners == std::vector<int>({0, 1, 2}));
+    UT_ASSERT_TRUE(load == std::vector<double>({1.0, 1.0, 1.0, 0.0}));
+}
+
+// The history durations of a suite are summed across reports, suites without history weigh the mean per test
+UT_ADD_TEST(UTGTestShardTest, HistoryWeighting)
+{
+    std::string first = write("first.xml", "<testsuites>\n"
+                                           "  <testsuite name=\"Alpha\" tests=\"1\" failures=\"0\" time=\"4.5\">\n"
+                                           "  <testsuite name=\"Bravo\" tests=\"1\" failures=\"0\" time=\"1\">\n"
+                                           "</testsuites>\n");
+    std::string second = write("second.xml", "<testsuites>\n"
+                                             "  <testsuite name=\"Alpha\" tests=\"1\" failures=\"0\" time=\"5.5\">\n"
+                                             "</testsuites>\n");
+    std::vector<double> load;
+
+    std::map<std::string, double> durations = readSuiteDurations(first + "," + dir + "/missing.xml," + second);
+    UT_ASSERT_EQUAL(durations.size(), 2u);
+    UT_ASSERT_EQUAL(durations["Alpha"], 10.0);
+    UT_ASSERT_EQUAL(durations["Bravo"], 1.0);
+
+    // Charlie has 2 tests at (10 + 1) / 2 each, so it weighs 11 and goes first, Alpha and Bravo share the other shard
+    std::vector<UTDealtSuite> suites = {{"Alpha", 1}, {"Bravo", 1}, {"Charlie", 2}};
+    std::vector<int> owners = dealSuites(suites, 2, durations, load);
+    UT_ASSERT_TRUE(owners == std::vector<int>({1, 1, 0}));
+    UT_ASSERT_TRUE(load == std::vector<double>({11.0, 11.0}));
+
+    // Without the history the suites are split by their test count
+    owners = dealSuites(suites, 2, {}, load);
+    UT_ASSERT_TRUE(owners == std::vector<int>({1, 1, 0}));
+    UT_ASSERT_TRUE(load == std::vector<double>({2.0, 2.0}));
+}
@@ -80,4 +80,52 @@ UT_ADD_TEST(UTKVPProfileTestL1, TestProfileClose)
     UT_PASS("Profile close success");
 }
 
-// Other test cases as needed...
\ No newline at end of file
+// Other test cases as needed...
+
+// The cases and their expectations are both read from the fixture file, the -p profile is left as it is
+class UTKVPProfileListTestL2 : public UTKVPListTest
+{
+public:
+    static ut_kvp_instance_t *Fixture()
+    {
+        if (mpFixture == nullptr)
+        {
+            mpFixture = ut_kvp_createInstance();
+            if ((mpFixture != nullptr) && (ut_kvp_open(mpFixture, (char *)KVP_VALID_TEST_YAML_FILE) != UT_KVP_STATUS_SUCCESS))
+            {
+                ut_kvp_destroyInstance(mpFixture);
+                mpFixture = nullptr;
+            }
+        }
+        return mpFixture;
+    }
+
+    static void TearDownTestSuite()
+    {
+        if (mpFixture != nullptr)
+        {
+            ut_kvp_destroyInstance(mpFixture);
+            mpFixture = nullptr;
+        }
+    }
+
+private:
+    static ut_kvp_instance_t *mpFixture;
+};
+
+ut_kvp_instance_t *UTKVPProfileListTestL2::mpFixture = nullptr;
+
+UT_ADD_TEST_TO_GROUP(UTKVPProfileListTestL2, UT_TESTS_L2)
+
+// One case per element of the list in the fixture file
+UT_ADD_PARAM_TEST(UTKVPProfileListTestL2, TestProfileListElement)
+{
+    static const uint32_t expected[] = { 720, 800, 1080 };
+    const UTKVPListElement &element = GetParam();
+
+    ASSERT_LT(element.index, sizeof(expected) / sizeof(expected[0]));
+    UT_ASSERT_EQUAL(ut_kvp_getUInt32Field(Fixture(), element.key.c_str()), expected[element.index]);
+}
+
+INSTANTIATE_TEST_SUITE_P(, UTKVPProfileListTestL2,
+                         ::testing::ValuesIn(UTCore::UT_get_kvp_list_elements(UTKVPProfileListTestL2::Fixture(), "decodeTest/checkUint32List")));
@@ -21,6 +21,22 @@
 
 extern void register_assert_functions(void);
 extern void register_kvp_profile_testing_functions(void);
+extern void register_benchmark_testing_functions(void);
+extern void register_fixture_testing_functions(void);
+extern void register_kvp_image_testing_functions(void);
+extern void register_log_async_testing_functions(void);
+extern void register_trace_testing_functions(void);
+extern void register_isolation_testing_functions(void);
+extern void register_stress_testing_functions(void);
+extern void register_parallel_testing_functions(void);
+extern void register_automated_testing_functions(void);
+extern void register_duration_testing_functions(void);
+extern void register_groups_testing_functions(void);
+extern void register_result_cache_testing_functions(void);
+extern void register_memory_testing_functions(void);
+extern void register_impact_testing_functions(void);
+extern void register_coverage_testing_functions(void);
+extern void register_perf_testing_functions(void);
 /**
  * @brief Main launch function for the test app
  * 
@@ -38,6 +54,22 @@ int main(int argc, char** argv)
     // register_assert_functions(); /* FIXME: Enable when any change is performed to the UT_ASSERT functions.
     // Since this always fails we want it outside our normal testing, which currently is 100% PASS */
     register_kvp_profile_testing_functions();
+    register_benchmark_testing_functions();
+    register_fixture_testing_functions();
+    register_kvp_image_testing_functions();
+    register_log_async_testing_functions();
+    register_trace_testing_functions();
+    register_isolation_testing_functions();
+    register_stress_testing_functions();
+    register_parallel_testing_functions();
+    register_automated_testing_functions();
+    register_duration_testing_functions();
+    register_groups_testing_functions();
+    register_result_cache_testing_functions();
+    register_memory_testing_functions();
+    register_impact_testing_functions();
+    register_coverage_testing_functions();
+    register_perf_testing_functions();
 #endif
 
     UT_run_tests();